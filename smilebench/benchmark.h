@@ -0,0 +1,52 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter (Benchmark Suite)
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#ifndef __STDAFX_H__
+#include "stdafx.h"
+#endif
+
+/// <summary>
+/// One benchmark.  The driver calls 'prepare' once (to load files and build any input data, none
+/// of which is timed), then calls 'run' repeatedly, timing each call, and finally calls 'cleanup'.
+/// Each of the three may fail by returning False, after printing why to stderr.
+/// </summary>
+typedef struct BenchmarkStruct {
+	const char *name;			// The benchmark's name, as used on the command line and in the JSON.
+	const char *kind;			// "smile" for a Smile program, or "c" for a C microbenchmark.
+	const char *filename;		// For a Smile program, the name of its source file.
+
+	Bool (*prepare)(struct BenchmarkStruct *benchmark, const char *programDir);
+	Bool (*run)(struct BenchmarkStruct *benchmark);
+	Bool (*cleanup)(struct BenchmarkStruct *benchmark);
+
+	void *data;					// Whatever 'prepare' made for 'run' to use.
+	String expectedResult;		// For a Smile program, what its first run produced.
+	Bool verbose;				// Whether to print each run's result.
+} *Benchmark;
+
+String LoadFile(const char *filename);
+
+extern struct BenchmarkStruct ProgramBenchmarks[];
+extern Int NumProgramBenchmarks;
+
+extern struct BenchmarkStruct MicroBenchmarks[];
+extern Int NumMicroBenchmarks;
+
+#endif
@@ -0,0 +1,483 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter (Benchmark Suite)
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "benchmark.h"
+
+#define DEFAULT_RUNS 5
+#define DEFAULT_WARMUP_RUNS 1
+#define DEFAULT_THRESHOLD 10
+
+typedef struct CommandLineArgsStruct {
+	const char *programDir;		// --programs=dir
+	const char *jsonFile;		// --json=file
+	const char *baselineFile;	// --baseline=file
+	Int runs;					// --runs=N
+	Int warmupRuns;				// --warmup=N
+	Int threshold;				// --threshold=percent
+	Bool list;					// -l --list
+	Bool verbose;				// -v --verbose
+	Bool quiet;					// -q --quiet
+	const char **names;			// name...
+	Int numNames;
+} *CommandLineArgs;
+
+/// <summary>
+/// The timings of one benchmark, in microseconds.
+/// </summary>
+typedef struct BenchmarkResultStruct {
+	Benchmark benchmark;
+	Bool succeeded;
+	UInt64 min, median, mean, max;
+	Bool hasBaseline;
+	UInt64 baselineMin, baselineMedian;
+} *BenchmarkResult;
+
+static void PrintHelp(void)
+{
+	printf(
+		"\n"
+		"Usage: smilebench [options] [name...]\n"
+		"\n"
+		"Runs the Smile benchmarks named (or all of them), and writes their timings as JSON.\n"
+		"\n"
+		"Options:\n"
+		"  --programs=dir   Directory holding the benchmark .sm programs (default: programs)\n"
+		"  --runs=N         Timed runs of each benchmark (default: " TOSTRING_AT_COMPILE_TIME(DEFAULT_RUNS) ")\n"
+		"  --warmup=N       Untimed runs of each benchmark first (default: " TOSTRING_AT_COMPILE_TIME(DEFAULT_WARMUP_RUNS) ")\n"
+		"  --json=file      Write the JSON results to 'file' instead of to stdout\n"
+		"  --baseline=file  Compare the median timings against a saved JSON result\n"
+		"  --threshold=N    Count a benchmark over N%% slower than baseline as a regression\n"
+		"                   (default: " TOSTRING_AT_COMPILE_TIME(DEFAULT_THRESHOLD) ")\n"
+		"  -l --list        List the benchmarks, and exit\n"
+		"  -q --quiet       Don't print progress to stderr\n"
+		"  -v --verbose     Print each Smile program's result\n"
+		"  -h --help        Help (you're looking at it)\n"
+		"\n"
+		"Exits with 1 if any benchmark fails, or 2 if any regressed against the baseline.\n"
+		"\n"
+	);
+}
+
+static Bool ParseCountArgument(const char *arg, const char *value, Int min, Int *result)
+{
+	char *end;
+	long number = strtol(value, &end, 10);
+
+	if (*value == '\0' || *end != '\0' || number < min) {
+		fprintf(stderr, "smilebench: Invalid command-line argument \"%s\".\n", arg);
+		return False;
+	}
+
+	*result = (Int)number;
+	return True;
+}
+
+static CommandLineArgs ParseCommandLine(int argc, const char **argv)
+{
+	CommandLineArgs options;
+	const char *arg;
+	int i;
+
+	options = GC_MALLOC_STRUCT(struct CommandLineArgsStruct);
+	if (options == NULL)
+		Smile_Abort_OutOfMemory();
+
+	options->programDir = "programs";
+	options->jsonFile = NULL;
+	options->baselineFile = NULL;
+	options->runs = DEFAULT_RUNS;
+	options->warmupRuns = DEFAULT_WARMUP_RUNS;
+	options->threshold = DEFAULT_THRESHOLD;
+	options->list = False;
+	options->verbose = False;
+	options->quiet = False;
+	options->names = GC_MALLOC_STRUCT_ARRAY(const char *, argc);
+	options->numNames = 0;
+
+	for (i = 1; i < argc; i++) {
+		arg = argv[i];
+
+		if (arg[0] != '-') {
+			options->names[options->numNames++] = arg;
+		}
+		else if (!strcmp(arg, "-h") || !strcmp(arg, "-?") || !strcmp(arg, "--help")) {
+			PrintHelp();
+			return NULL;
+		}
+		else if (!strcmp(arg, "-l") || !strcmp(arg, "--list")) {
+			options->list = True;
+		}
+		else if (!strcmp(arg, "-q") || !strcmp(arg, "--quiet")) {
+			options->quiet = True;
+		}
+		else if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose")) {
+			options->verbose = True;
+		}
+		else if (!strncmp(arg, "--programs=", 11) && arg[11] != '\0') {
+			options->programDir = arg + 11;
+		}
+		else if (!strncmp(arg, "--json=", 7) && arg[7] != '\0') {
+			options->jsonFile = arg + 7;
+		}
+		else if (!strncmp(arg, "--baseline=", 11) && arg[11] != '\0') {
+			options->baselineFile = arg + 11;
+		}
+		else if (!strncmp(arg, "--runs=", 7)) {
+			if (!ParseCountArgument(arg, arg + 7, 1, &options->runs)) return NULL;
+		}
+		else if (!strncmp(arg, "--warmup=", 9)) {
+			if (!ParseCountArgument(arg, arg + 9, 0, &options->warmupRuns)) return NULL;
+		}
+		else if (!strncmp(arg, "--threshold=", 12)) {
+			if (!ParseCountArgument(arg, arg + 12, 0, &options->threshold)) return NULL;
+		}
+		else {
+			fprintf(stderr, "smilebench: Invalid command-line argument \"%s\".\n", arg);
+			return NULL;
+		}
+	}
+
+	return options;
+}
+
+/// <summary>
+/// Read the given file into a string, or print an error and return NULL if it can't be read.
+/// </summary>
+String LoadFile(const char *filename)
+{
+	FILE *fp;
+	StringBuilder stringBuilder;
+	Byte *buffer;
+	size_t readLength;
+
+	const int ReadLength = 0x10000;	// Read 64K at a time.
+
+	if ((fp = fopen(filename, "rb")) == NULL) {
+		fprintf(stderr, "smilebench: Cannot open \"%s\" for reading.\n", filename);
+		return NULL;
+	}
+
+	stringBuilder = StringBuilder_Create();
+
+	buffer = GC_MALLOC_ATOMIC(ReadLength);
+	if (buffer == NULL)
+		Smile_Abort_OutOfMemory();
+
+	while ((readLength = fread(buffer, 1, ReadLength, fp)) > 0) {
+		StringBuilder_Append(stringBuilder, buffer, 0, readLength);
+	}
+
+	fclose(fp);
+
+	return StringBuilder_ToString(stringBuilder);
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Running and timing.
+
+static Bool IsSelected(CommandLineArgs options, Benchmark benchmark)
+{
+	Int i;
+
+	if (options->numNames == 0) return True;
+
+	// A name selects the benchmark of that name, or every benchmark of that kind ("smile" or "c").
+	for (i = 0; i < options->numNames; i++) {
+		if (!strcmp(options->names[i], benchmark->name) || !strcmp(options->names[i], benchmark->kind))
+			return True;
+	}
+	return False;
+}
+
+static int CompareTicks(const void *a, const void *b)
+{
+	UInt64 x = *(const UInt64 *)a, y = *(const UInt64 *)b;
+	return x < y ? -1 : x > y ? +1 : 0;
+}
+
+static Bool RunBenchmark(CommandLineArgs options, Benchmark benchmark, BenchmarkResult result)
+{
+	UInt64 *times;
+	UInt64 startTicks, endTicks, total;
+	Int i;
+
+	result->benchmark = benchmark;
+	result->succeeded = False;
+
+	benchmark->verbose = options->verbose;
+
+	if (benchmark->prepare != NULL && !benchmark->prepare(benchmark, options->programDir))
+		return False;
+
+	for (i = 0; i < options->warmupRuns; i++) {
+		if (!benchmark->run(benchmark))
+			goto done;
+	}
+
+	times = GC_MALLOC_ATOMIC(sizeof(UInt64) * options->runs);
+	if (times == NULL)
+		Smile_Abort_OutOfMemory();
+
+	for (i = 0; i < options->runs; i++) {
+		// Start each run with a clean heap, so that one run's garbage isn't charged to the next.
+		GC_gcollect();
+
+		startTicks = Smile_GetTicks();
+		if (!benchmark->run(benchmark))
+			goto done;
+		endTicks = Smile_GetTicks();
+
+		times[i] = Smile_TicksToMicroseconds(endTicks - startTicks);
+	}
+
+	qsort(times, (size_t)options->runs, sizeof(UInt64), CompareTicks);
+
+	total = 0;
+	for (i = 0; i < options->runs; i++) {
+		total += times[i];
+	}
+
+	result->min = times[0];
+	result->max = times[options->runs - 1];
+	result->mean = total / options->runs;
+	result->median = (options->runs & 1) ? times[options->runs / 2]
+		: (times[options->runs / 2 - 1] + times[options->runs / 2]) / 2;
+	result->succeeded = True;
+
+done:
+	if (benchmark->cleanup != NULL && !benchmark->cleanup(benchmark))
+		result->succeeded = False;
+
+	return result->succeeded;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  JSON output, and reading a saved baseline back in.
+
+static void WriteJson(FILE *fp, CommandLineArgs options, BenchmarkResult results, Int numResults)
+{
+	BenchmarkResult result;
+	Bool first;
+	Int i;
+
+	// One benchmark per line, which keeps the output easy to diff, and easy for ReadBaseline() to read.
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"version\": \"%d.%d\",\n", SMILE_MAJOR_VERSION, SMILE_MINOR_VERSION);
+	fprintf(fp, "\t\"runs\": %d,\n", (int)options->runs);
+	fprintf(fp, "\t\"units\": \"us\",\n");
+	fprintf(fp, "\t\"benchmarks\": [");
+
+	first = True;
+	for (i = 0; i < numResults; i++) {
+		result = &results[i];
+		if (!result->succeeded) continue;
+
+		fprintf(fp, "%s\n\t\t{ \"name\": \"%s\", \"kind\": \"%s\", \"min\": %llu, \"median\": %llu, \"mean\": %llu, \"max\": %llu }",
+			first ? "" : ",",
+			result->benchmark->name, result->benchmark->kind,
+			(unsigned long long)result->min, (unsigned long long)result->median,
+			(unsigned long long)result->mean, (unsigned long long)result->max);
+		first = False;
+	}
+
+	fprintf(fp, "\n\t]\n}\n");
+}
+
+static Bool FindJsonNumber(const char *start, const char *end, const char *key, UInt64 *value)
+{
+	const char *ptr;
+	Int keyLength = StrLen(key);
+
+	for (ptr = start; ptr + keyLength < end; ptr++) {
+		if (*ptr == '"' && !strncmp(ptr + 1, key, keyLength) && ptr[keyLength + 1] == '"') {
+			for (ptr += keyLength + 2; ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == ':'); ptr++) ;
+			if (ptr >= end || *ptr < '0' || *ptr > '9') return False;
+			*value = (UInt64)strtoull(ptr, NULL, 10);
+			return True;
+		}
+	}
+	return False;
+}
+
+/// <summary>
+/// Read a baseline written by WriteJson(), and attach its timings to the matching results.  This
+/// isn't a general JSON parser; it just finds each object with a "name" and reads its "min" and
+/// "median" from within the same braces.
+/// </summary>
+static Bool ReadBaseline(const char *filename, BenchmarkResult results, Int numResults)
+{
+	String json;
+	const char *text, *ptr, *objectStart, *objectEnd, *nameEnd;
+	UInt64 min, median;
+	Int i, nameLength;
+
+	if ((json = LoadFile(filename)) == NULL)
+		return False;
+	text = String_ToC(json);
+
+	for (ptr = text; (ptr = strstr(ptr, "\"name\"")) != NULL; ptr = objectEnd) {
+		for (objectStart = ptr; objectStart > text && *objectStart != '{'; objectStart--) ;
+		if ((objectEnd = strchr(ptr, '}')) == NULL) break;
+
+		for (ptr += 6; *ptr == ' ' || *ptr == '\t' || *ptr == ':'; ptr++) ;
+		if (*ptr++ != '"' || (nameEnd = strchr(ptr, '"')) == NULL) continue;
+		nameLength = nameEnd - ptr;
+
+		if (!FindJsonNumber(objectStart, objectEnd, "median", &median)
+			|| !FindJsonNumber(objectStart, objectEnd, "min", &min))
+			continue;
+
+		for (i = 0; i < numResults; i++) {
+			if (StrLen(results[i].benchmark->name) == nameLength && !strncmp(results[i].benchmark->name, ptr, nameLength)) {
+				results[i].hasBaseline = True;
+				results[i].baselineMin = min;
+				results[i].baselineMedian = median;
+			}
+		}
+	}
+
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  The report.
+
+static Bool IsRegression(CommandLineArgs options, BenchmarkResult result)
+{
+	return result->succeeded && result->hasBaseline
+		&& (double)result->median > (double)result->baselineMedian * (1.0 + options->threshold / 100.0);
+}
+
+static void PrintResult(CommandLineArgs options, BenchmarkResult result)
+{
+	double change;
+
+	if (!result->succeeded) {
+		fprintf(stderr, "  %-18s FAILED\n", result->benchmark->name);
+		return;
+	}
+
+	fprintf(stderr, "  %-18s median %10.3f ms   min %10.3f ms",
+		result->benchmark->name, result->median / 1000.0, result->min / 1000.0);
+
+	if (result->hasBaseline && result->baselineMedian > 0) {
+		change = ((double)result->median - (double)result->baselineMedian) * 100.0 / (double)result->baselineMedian;
+		fprintf(stderr, "   baseline %10.3f ms  %+6.1f%%%s",
+			result->baselineMedian / 1000.0, change, IsRegression(options, result) ? "  SLOWER" : "");
+	}
+
+	fprintf(stderr, "\n");
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Main.
+
+static int SmileBenchMain(int argc, const char **argv)
+{
+	CommandLineArgs options;
+	Benchmark *benchmarks;
+	BenchmarkResult results;
+	Int numBenchmarks, numFailures, numRegressions, i;
+	FILE *fp;
+
+	Smile_Init();
+
+	if ((options = ParseCommandLine(argc, argv)) == NULL)
+		return 1;
+
+	// Collect the selected benchmarks:  Smile programs first, then the C microbenchmarks.
+	benchmarks = GC_MALLOC_STRUCT_ARRAY(Benchmark, NumProgramBenchmarks + NumMicroBenchmarks);
+	if (benchmarks == NULL)
+		Smile_Abort_OutOfMemory();
+	numBenchmarks = 0;
+	for (i = 0; i < NumProgramBenchmarks; i++) {
+		if (IsSelected(options, &ProgramBenchmarks[i]))
+			benchmarks[numBenchmarks++] = &ProgramBenchmarks[i];
+	}
+	for (i = 0; i < NumMicroBenchmarks; i++) {
+		if (IsSelected(options, &MicroBenchmarks[i]))
+			benchmarks[numBenchmarks++] = &MicroBenchmarks[i];
+	}
+
+	if (options->list) {
+		for (i = 0; i < NumProgramBenchmarks; i++)
+			printf("%-18s smile  %s\n", ProgramBenchmarks[i].name, ProgramBenchmarks[i].filename);
+		for (i = 0; i < NumMicroBenchmarks; i++)
+			printf("%-18s c\n", MicroBenchmarks[i].name);
+		return 0;
+	}
+
+	if (numBenchmarks == 0) {
+		fprintf(stderr, "smilebench: No benchmarks match the given names.\n");
+		return 1;
+	}
+
+	results = GC_MALLOC_STRUCT_ARRAY(struct BenchmarkResultStruct, numBenchmarks);
+	if (results == NULL)
+		Smile_Abort_OutOfMemory();
+
+	// Load the baseline first, so that each result can be compared as soon as it's known.
+	for (i = 0; i < numBenchmarks; i++) {
+		results[i].benchmark = benchmarks[i];
+		results[i].succeeded = False;
+		results[i].hasBaseline = False;
+	}
+	if (options->baselineFile != NULL && !ReadBaseline(options->baselineFile, results, numBenchmarks))
+		return 1;
+
+	// Run them all, reporting on each (on stderr, since the JSON may be going to stdout).
+	numFailures = numRegressions = 0;
+	for (i = 0; i < numBenchmarks; i++) {
+		if (!RunBenchmark(options, benchmarks[i], &results[i]))
+			numFailures++;
+		else if (IsRegression(options, &results[i]))
+			numRegressions++;
+		else if (options->quiet)
+			continue;
+		PrintResult(options, &results[i]);
+	}
+
+	if (numFailures > 0)
+		fprintf(stderr, "%d benchmark(s) failed.\n", (int)numFailures);
+	if (numRegressions > 0)
+		fprintf(stderr, "%d benchmark(s) were more than %d%% slower than the baseline.\n",
+			(int)numRegressions, (int)options->threshold);
+
+	// Write the results.
+	if (options->jsonFile != NULL) {
+		if ((fp = fopen(options->jsonFile, "wb")) == NULL) {
+			fprintf(stderr, "smilebench: Cannot open \"%s\" for writing.\n", options->jsonFile);
+			return 1;
+		}
+		WriteJson(fp, options, results, numBenchmarks);
+		fclose(fp);
+	}
+	else {
+		WriteJson(stdout, options, results, numBenchmarks);
+		fflush(stdout);
+	}
+
+	Smile_End();
+
+	return numFailures > 0 ? 1 : numRegressions > 0 ? 2 : 0;
+}
+
+int main(int argc, const char **argv)
+{
+	return SmileBenchMain(argc, argv);
+}
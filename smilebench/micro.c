@@ -0,0 +1,286 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter (Benchmark Suite)
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "benchmark.h"
+
+//-------------------------------------------------------------------------------------------------
+//  C microbenchmarks.
+//
+//  These call the runtime's core data structures directly, without the interpreter in the way.
+//  Each one checks its own answers, so that an "optimization" that breaks them can't pass
+//  unnoticed, and folds its work into _sink, so that the compiler can't discard it.
+
+#define NUM_INT32DICT_KEYS 1000000
+#define NUM_STRINGDICT_KEYS 100000
+#define INDEXOF_HAYSTACK_LENGTH 0x100000
+#define SIPHASH_BUFFER_LENGTH 0x10000
+#define NUM_STRINGBUILDER_APPENDS 1000000
+
+static volatile UInt64 _sink;
+
+static Bool Micro_Fail(Benchmark benchmark, const char *message)
+{
+	fprintf(stderr, "%s: %s\n", benchmark->name, message);
+	return False;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Int32Dict:  Add, look up, and remove scattered integer keys.
+
+Inline Int32 Int32DictBench_Key(Int32 i)
+{
+	return (Int32)((UInt32)i * 2654435761U);
+}
+
+static Bool Int32DictBench_Run(Benchmark benchmark)
+{
+	Int32Dict dict;
+	Int32 i;
+	void *value;
+	UInt64 sum;
+
+	dict = Int32Dict_Create();
+
+	for (i = 0; i < NUM_INT32DICT_KEYS; i++) {
+		if (!Int32Dict_Add(dict, Int32DictBench_Key(i), (void *)(PtrInt)(i + 1)))
+			return Micro_Fail(benchmark, "Int32Dict_Add() rejected a new key.");
+	}
+
+	sum = 0;
+	for (i = 0; i < NUM_INT32DICT_KEYS; i++) {
+		if (!Int32Dict_TryGetValue(dict, Int32DictBench_Key(i), &value) || (PtrInt)value != i + 1)
+			return Micro_Fail(benchmark, "Int32Dict_TryGetValue() lost a key.");
+		sum += (PtrInt)value;
+	}
+
+	for (i = 0; i < NUM_INT32DICT_KEYS; i += 2) {
+		if (!Int32Dict_Remove(dict, Int32DictBench_Key(i)))
+			return Micro_Fail(benchmark, "Int32Dict_Remove() lost a key.");
+	}
+
+	for (i = 0; i < NUM_INT32DICT_KEYS; i++) {
+		if (Int32Dict_TryGetValue(dict, Int32DictBench_Key(i), &value) != (i & 1))
+			return Micro_Fail(benchmark, "Int32Dict_Remove() removed the wrong key.");
+	}
+
+	if (Int32Dict_Count(dict) != NUM_INT32DICT_KEYS / 2)
+		return Micro_Fail(benchmark, "Int32Dict has the wrong count.");
+
+	_sink += sum;
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  StringDict:  Add, look up, and remove string keys (made ahead of time, so only the dictionary
+//  itself, and the key hashing, are timed).
+
+static Bool StringDictBench_Prepare(Benchmark benchmark, const char *programDir)
+{
+	String *keys;
+	Int i;
+
+	UNUSED(programDir);
+
+	keys = GC_MALLOC_STRUCT_ARRAY(String, NUM_STRINGDICT_KEYS);
+	if (keys == NULL)
+		Smile_Abort_OutOfMemory();
+
+	for (i = 0; i < NUM_STRINGDICT_KEYS; i++) {
+		keys[i] = String_Format("key-%d", (int)i);
+	}
+
+	benchmark->data = keys;
+	return True;
+}
+
+static Bool StringDictBench_Run(Benchmark benchmark)
+{
+	String *keys = (String *)benchmark->data;
+	StringDict dict;
+	Int i;
+	void *value;
+	UInt64 sum;
+
+	dict = StringDict_Create();
+
+	for (i = 0; i < NUM_STRINGDICT_KEYS; i++) {
+		if (!StringDict_Add(dict, keys[i], (void *)(PtrInt)(i + 1)))
+			return Micro_Fail(benchmark, "StringDict_Add() rejected a new key.");
+	}
+
+	sum = 0;
+	for (i = 0; i < NUM_STRINGDICT_KEYS; i++) {
+		if (!StringDict_TryGetValue(dict, keys[i], &value) || (PtrInt)value != i + 1)
+			return Micro_Fail(benchmark, "StringDict_TryGetValue() lost a key.");
+		sum += (PtrInt)value;
+	}
+
+	for (i = 0; i < NUM_STRINGDICT_KEYS; i += 2) {
+		if (!StringDict_Remove(dict, keys[i]))
+			return Micro_Fail(benchmark, "StringDict_Remove() lost a key.");
+	}
+
+	for (i = 0; i < NUM_STRINGDICT_KEYS; i++) {
+		if (StringDict_TryGetValue(dict, keys[i], &value) != (i & 1))
+			return Micro_Fail(benchmark, "StringDict_Remove() removed the wrong key.");
+	}
+
+	_sink += sum;
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  String_IndexOf:  Search a large string made of a small alphabet (so that partial matches are
+//  common) for patterns of several lengths, all of which only match at the very end.
+
+static const char *_indexOfPatterns[] = {
+	"z",
+	"abcz",
+	"abcdabcdabcdabcz",
+	"abcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcz",
+};
+
+static Bool IndexOfBench_Prepare(Benchmark benchmark, const char *programDir)
+{
+	StringBuilder stringBuilder;
+	UInt32 seed;
+	Int i;
+
+	UNUSED(programDir);
+
+	stringBuilder = StringBuilder_Create();
+
+	seed = 12345;
+	for (i = 0; i < INDEXOF_HAYSTACK_LENGTH; i++) {
+		seed = seed * 1103515245 + 12345;
+		StringBuilder_AppendByte(stringBuilder, (seed >> 16) & 7 ? (Byte)('a' + (i & 3)) : (Byte)('a' + ((seed >> 20) & 3)));
+	}
+	StringBuilder_AppendC(stringBuilder, _indexOfPatterns[3], 0, StrLen(_indexOfPatterns[3]));
+
+	benchmark->data = StringBuilder_ToString(stringBuilder);
+	return True;
+}
+
+static Bool IndexOfBench_Run(Benchmark benchmark)
+{
+	String haystack = (String)benchmark->data;
+	String pattern;
+	Int i, round, index;
+
+	for (round = 0; round < 4; round++) {
+		for (i = 0; i < (Int)(sizeof(_indexOfPatterns) / sizeof(const char *)); i++) {
+			pattern = String_FromC(_indexOfPatterns[i]);
+			index = String_IndexOf(haystack, pattern, 0);
+			if (index != String_Length(haystack) - String_Length(pattern))
+				return Micro_Fail(benchmark, "String_IndexOf() found the pattern in the wrong place.");
+			_sink += index;
+		}
+	}
+
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  SipHash:  Hash one large buffer, and then many short keys of the sizes dictionaries see.
+
+static Bool SipHashBench_Prepare(Benchmark benchmark, const char *programDir)
+{
+	Byte *buffer;
+	Int i;
+
+	UNUSED(programDir);
+
+	buffer = GC_MALLOC_ATOMIC(SIPHASH_BUFFER_LENGTH);
+	if (buffer == NULL)
+		Smile_Abort_OutOfMemory();
+
+	for (i = 0; i < SIPHASH_BUFFER_LENGTH; i++) {
+		buffer[i] = (Byte)(i * 31 + (i >> 8));
+	}
+
+	benchmark->data = buffer;
+	return True;
+}
+
+static Bool SipHashBench_Run(Benchmark benchmark)
+{
+	const Byte *buffer = (const Byte *)benchmark->data;
+	UInt64 hash, first;
+	Int i, round;
+
+	hash = 0;
+	for (round = 0; round < 1000; round++) {
+		hash ^= SipHash(buffer, SIPHASH_BUFFER_LENGTH, 0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL);
+	}
+
+	first = SipHash(buffer, 17, 0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL);
+	for (round = 0; round < 200; round++) {
+		for (i = 0; i + 24 <= SIPHASH_BUFFER_LENGTH; i += 24) {
+			hash += SipHash(buffer + i, 1 + (i & 15), 0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL);
+		}
+	}
+
+	if (SipHash(buffer, 17, 0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL) != first)
+		return Micro_Fail(benchmark, "SipHash() is not deterministic.");
+
+	_sink += hash;
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  StringBuilder:  Build a large string from single bytes, short C strings, and formatted numbers.
+
+static Bool StringBuilderBench_Run(Benchmark benchmark)
+{
+	StringBuilder stringBuilder;
+	String result;
+	Int i, expectedLength;
+
+	stringBuilder = StringBuilder_Create();
+	expectedLength = 0;
+
+	for (i = 0; i < NUM_STRINGBUILDER_APPENDS; i++) {
+		StringBuilder_AppendByte(stringBuilder, (Byte)('a' + (i % 26)));
+		StringBuilder_AppendC(stringBuilder, "xyzzy", 0, 5);
+		expectedLength += 6;
+		if ((i & 7) == 0) {
+			StringBuilder_AppendFormat(stringBuilder, "%d,", (int)i);
+			expectedLength += (i < 10 ? 1 : i < 100 ? 2 : i < 1000 ? 3 : i < 10000 ? 4 : i < 100000 ? 5 : 6) + 1;
+		}
+	}
+
+	result = StringBuilder_ToString(stringBuilder);
+	if (String_Length(result) != expectedLength)
+		return Micro_Fail(benchmark, "StringBuilder built a string of the wrong length.");
+
+	_sink += String_Length(result);
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  The table of microbenchmarks.
+
+struct BenchmarkStruct MicroBenchmarks[] = {
+	{ "int32dict", "c", NULL, NULL, Int32DictBench_Run, NULL },
+	{ "stringdict", "c", NULL, StringDictBench_Prepare, StringDictBench_Run, NULL },
+	{ "string-indexof", "c", NULL, IndexOfBench_Prepare, IndexOfBench_Run, NULL },
+	{ "siphash", "c", NULL, SipHashBench_Prepare, SipHashBench_Run, NULL },
+	{ "stringbuilder", "c", NULL, NULL, StringBuilderBench_Run, NULL },
+};
+
+Int NumMicroBenchmarks = sizeof(MicroBenchmarks) / sizeof(struct BenchmarkStruct);
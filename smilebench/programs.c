@@ -0,0 +1,199 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter (Benchmark Suite)
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "benchmark.h"
+
+//-------------------------------------------------------------------------------------------------
+//  Smile-program benchmarks.
+//
+//  Each of these is a program in the 'programs' directory, which is parsed, compiled, and
+//  evaluated from scratch on every run, exactly as the 'smile' runner would do it.  Every run
+//  must produce the same result as the first one, or the benchmark fails.
+
+// The line-count program's input file, which we generate, and its size.
+#define LINE_COUNT_FILENAME "smilebench-lines.tmp"
+#define LINE_COUNT_NUM_LINES 100000
+
+static String _inputFile;
+
+static Bool Program_PrintParseMessages(Benchmark benchmark, SmileList messages)
+{
+	ParseMessage parseMessage;
+	LexerPosition position;
+	Bool hasErrors = False;
+
+	for (; SMILE_KIND(messages) != SMILE_KIND_NULL; messages = LIST_REST(messages)) {
+		parseMessage = (ParseMessage)LIST_FIRST(messages);
+		if (parseMessage->messageKind != PARSEMESSAGE_ERROR) continue;
+
+		position = parseMessage->position;
+		fprintf(stderr, "%s:%d: %s\n", benchmark->filename,
+			position != NULL ? (int)position->line : 0, String_ToC(parseMessage->message));
+		hasErrors = True;
+	}
+
+	return hasErrors;
+}
+
+static Bool Program_Prepare(Benchmark benchmark, const char *programDir)
+{
+	String path = String_Format("%s/%s", programDir, benchmark->filename);
+
+	if ((benchmark->data = LoadFile(String_ToC(path))) == NULL)
+		return False;
+
+	benchmark->expectedResult = NULL;
+	return True;
+}
+
+static Bool Program_Run(Benchmark benchmark)
+{
+	String source = (String)benchmark->data;
+	Lexer lexer;
+	Parser parser;
+	ParseScope globalScope;
+	ClosureInfo closureInfo;
+	SmileObject parsedScript;
+	EvalResult evalResult;
+	SmileArg unboxedResult;
+	String result;
+	Int i;
+
+	closureInfo = ClosureInfo_Create(NULL, CLOSURE_KIND_GLOBAL);
+	Smile_SetGlobalClosureInfo(closureInfo);
+	Smile_InitCommonGlobals(closureInfo);
+	Smile_SetGlobalVariableC("input-file", (SmileObject)(_inputFile != NULL ? _inputFile : String_Empty));
+
+	globalScope = ParseScope_CreateRoot();
+	ParseScope_DeclareVariablesFromClosureInfo(globalScope, closureInfo);
+
+	lexer = Lexer_Create(source, 0, String_Length(source), String_FromC(benchmark->filename), 1, 1);
+	lexer->symbolTable = Smile_SymbolTable;
+	parser = Parser_Create();
+
+	parsedScript = Parser_Parse(parser, lexer, globalScope);
+
+	if (Program_PrintParseMessages(benchmark, parser->firstMessage))
+		return False;
+
+	evalResult = Smile_EvalInScope(closureInfo, parsedScript);
+
+	switch (evalResult->evalResultKind) {
+		case EVAL_RESULT_EXCEPTION:
+			{
+				String message = (String)SMILE_VCALL1(evalResult->exception, getProperty, Smile_KnownSymbols.message);
+				fprintf(stderr, "%s: Exception thrown: %s\n", benchmark->filename,
+					SMILE_KIND(message) == SMILE_KIND_STRING ? String_ToC(message) : "");
+			}
+			return False;
+
+		case EVAL_RESULT_BREAK:
+			fprintf(stderr, "%s: Stopped at breakpoint.\n", benchmark->filename);
+			return False;
+
+		case EVAL_RESULT_PARSEERRORS:
+			// We can get "parse errors" from the compiler, not just from the parser.
+			for (i = 0; i < evalResult->numMessages; i++) {
+				if (evalResult->parseMessages[i]->messageKind == PARSEMESSAGE_ERROR) {
+					fprintf(stderr, "%s: %s\n", benchmark->filename, String_ToC(evalResult->parseMessages[i]->message));
+					return False;
+				}
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	unboxedResult = SmileArg_Unbox(evalResult->value);
+	result = SMILE_VCALL1(unboxedResult.obj, toString, unboxedResult.unboxed);
+
+	if (benchmark->verbose) {
+		// Long results (like the fractal's picture) are cut short; they're still compared in full.
+		fprintf(stderr, "%s: %.60s%s\n", benchmark->filename, String_ToC(result), String_Length(result) > 60 ? "..." : "");
+	}
+
+	if (benchmark->expectedResult == NULL)
+		benchmark->expectedResult = result;
+	else if (!String_Equals(result, benchmark->expectedResult)) {
+		fprintf(stderr, "%s: Result changed between runs, from \"%s\" to \"%s\".\n",
+			benchmark->filename, String_ToC(benchmark->expectedResult), String_ToC(result));
+		return False;
+	}
+
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  The line-count program's input.
+
+static Bool LineCount_Prepare(Benchmark benchmark, const char *programDir)
+{
+	FILE *fp;
+	Int i, j;
+	UInt32 seed;
+
+	if (!Program_Prepare(benchmark, programDir))
+		return False;
+
+	if ((fp = fopen(LINE_COUNT_FILENAME, "wb")) == NULL) {
+		fprintf(stderr, "smilebench: Cannot open \"%s\" for writing.\n", LINE_COUNT_FILENAME);
+		return False;
+	}
+
+	// Lines of pseudorandom length (0 to 127 characters), so that line breaks land at every
+	// possible offset within the program's read buffer.
+	seed = 12345;
+	for (i = 0; i < LINE_COUNT_NUM_LINES; i++) {
+		seed = seed * 1103515245 + 12345;
+		for (j = (seed >> 16) & 127; j > 0; j--) {
+			fputc('a' + (int)(j % 26), fp);
+		}
+		fputc('\n', fp);
+	}
+
+	fclose(fp);
+
+	_inputFile = Path_Resolve(Path_GetCurrentDir(), String_FromC(LINE_COUNT_FILENAME));
+	return True;
+}
+
+static Bool LineCount_Cleanup(Benchmark benchmark)
+{
+	UNUSED(benchmark);
+
+	_inputFile = NULL;
+	remove(LINE_COUNT_FILENAME);
+	return True;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  The table of programs.
+
+struct BenchmarkStruct ProgramBenchmarks[] = {
+	{ "fib", "smile", "fib.sm", Program_Prepare, Program_Run, NULL },
+	{ "nbody", "smile", "nbody.sm", Program_Prepare, Program_Run, NULL },
+	{ "fractal", "smile", "fractal.sm", Program_Prepare, Program_Run, NULL },
+	{ "binary-trees", "smile", "binary-trees.sm", Program_Prepare, Program_Run, NULL },
+	{ "string-building", "smile", "string-building.sm", Program_Prepare, Program_Run, NULL },
+	{ "list-sort", "smile", "list-sort.sm", Program_Prepare, Program_Run, NULL },
+	{ "dictionary-churn", "smile", "dictionary-churn.sm", Program_Prepare, Program_Run, NULL },
+	{ "line-count", "smile", "line-count.sm", LineCount_Prepare, Program_Run, LineCount_Cleanup },
+};
+
+Int NumProgramBenchmarks = sizeof(ProgramBenchmarks) / sizeof(struct BenchmarkStruct);
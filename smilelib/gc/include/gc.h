@@ -526,6 +526,27 @@ GC_API int GC_CALL GC_try_to_collect(GC_stop_func /* stop_func */);
 GC_API void GC_CALL GC_set_stop_func(GC_stop_func /* stop_func */);
 GC_API GC_stop_func GC_CALL GC_get_stop_func(void);
 
+/* Set and get the client notifier on collection events (backported     */
+/* from collector v7.6, as a subset of its events).  START and END      */
+/* bracket each stretch of collection work done on behalf of the        */
+/* client (a full collection, or one incremental step); the MARK and    */
+/* RECLAIM events bracket the phases inside it.  The notifier is called */
+/* with the allocation lock held, and so must not allocate or call any  */
+/* other GC_ routines.  May be 0.  Both the setter and getter acquire   */
+/* the GC lock.                                                         */
+typedef enum {
+    GC_EVENT_START,
+    GC_EVENT_MARK_START,
+    GC_EVENT_MARK_END,
+    GC_EVENT_RECLAIM_START,
+    GC_EVENT_RECLAIM_END,
+    GC_EVENT_END
+} GC_EventType;
+
+typedef void (GC_CALLBACK * GC_on_collection_event_proc)(GC_EventType);
+GC_API void GC_CALL GC_set_on_collection_event(GC_on_collection_event_proc);
+GC_API GC_on_collection_event_proc GC_CALL GC_get_on_collection_event(void);
+
 /* Return the number of bytes in the heap.  Excludes collector private  */
 /* data structures.  Excludes the unmapped memory (returned to the OS). */
 /* Includes empty blocks and fragmentation loss.  Includes some pages   */
@@ -329,6 +329,31 @@ GC_API GC_start_callback_proc GC_CALL GC_get_start_callback(void)
     return fn;
 }
 
+/* Backported from collector v7.6 (see GC_set_on_collection_event).   */
+STATIC GC_on_collection_event_proc GC_on_collection_event = 0;
+
+GC_API void GC_CALL GC_set_on_collection_event(GC_on_collection_event_proc fn)
+{
+    DCL_LOCK_STATE;
+    LOCK();
+    GC_on_collection_event = fn;
+    UNLOCK();
+}
+
+GC_API GC_on_collection_event_proc GC_CALL GC_get_on_collection_event(void)
+{
+    GC_on_collection_event_proc fn;
+    DCL_LOCK_STATE;
+    LOCK();
+    fn = GC_on_collection_event;
+    UNLOCK();
+    return fn;
+}
+
+#define GC_NOTIFY_EVENT(event) do { \
+    if (GC_on_collection_event != 0) (*GC_on_collection_event)(event); \
+  } while (0)
+
 GC_INLINE void GC_notify_full_gc(void)
 {
     if (GC_start_call_back != 0) {
@@ -359,6 +384,7 @@ STATIC void GC_maybe_gc(void)
             n_partial_gcs = 0;
             return;
         } else {
+          GC_NOTIFY_EVENT(GC_EVENT_START);
 #         ifdef PARALLEL_MARK
             if (GC_parallel)
               GC_wait_for_reclaim();
@@ -399,6 +425,7 @@ STATIC void GC_maybe_gc(void)
                 GC_n_attempts++;
             }
         }
+        GC_NOTIFY_EVENT(GC_EVENT_END);
     }
 }
 
@@ -408,14 +435,26 @@ STATIC void GC_maybe_gc(void)
  * not GC_never_stop_func then abort if stop_func returns TRUE.
  * Return TRUE if we successfully completed the collection.
  */
+STATIC GC_bool GC_try_to_collect_notified(GC_stop_func stop_func);
+
 GC_INNER GC_bool GC_try_to_collect_inner(GC_stop_func stop_func)
+{
+    GC_bool result;
+
+    ASSERT_CANCEL_DISABLED();
+    if (GC_dont_gc || (*stop_func)()) return FALSE;
+    GC_NOTIFY_EVENT(GC_EVENT_START);
+    result = GC_try_to_collect_notified(stop_func);
+    GC_NOTIFY_EVENT(GC_EVENT_END);
+    return result;
+}
+
+STATIC GC_bool GC_try_to_collect_notified(GC_stop_func stop_func)
 {
 #   ifndef SMALL_CONFIG
       CLOCK_TYPE start_time = 0; /* initialized to prevent warning. */
       CLOCK_TYPE current_time;
 #   endif
-    ASSERT_CANCEL_DISABLED();
-    if (GC_dont_gc || (*stop_func)()) return FALSE;
     if (GC_incremental && GC_collection_in_progress()) {
       if (GC_print_stats) {
         GC_log_printf(
@@ -506,6 +545,7 @@ GC_INNER void GC_collect_a_little_inner(int n)
     if (GC_dont_gc) return;
     DISABLE_CANCEL(cancel_state);
     if (GC_incremental && GC_collection_in_progress()) {
+        GC_NOTIFY_EVENT(GC_EVENT_START);
         for (i = GC_deficit; i < GC_RATE*n; i++) {
             if (GC_mark_some((ptr_t)0)) {
                 /* Need to finish a collection */
@@ -536,6 +576,7 @@ GC_INNER void GC_collect_a_little_inner(int n)
         }
         if (GC_deficit > 0) GC_deficit -= GC_RATE*n;
         if (GC_deficit < 0) GC_deficit = 0;
+        GC_NOTIFY_EVENT(GC_EVENT_END);
     } else {
         GC_maybe_gc();
     }
@@ -597,6 +638,7 @@ STATIC GC_bool GC_stopped_mark(GC_stop_func stop_func)
         GET_TIME(start_time);
 #   endif
 
+    GC_NOTIFY_EVENT(GC_EVENT_MARK_START);
     STOP_WORLD();
 #   ifdef THREAD_LOCAL_ALLOC
       GC_world_stopped = TRUE;
@@ -629,6 +671,7 @@ STATIC GC_bool GC_stopped_mark(GC_stop_func stop_func)
               GC_world_stopped = FALSE;
 #           endif
             START_WORLD();
+            GC_NOTIFY_EVENT(GC_EVENT_MARK_END);
             return(FALSE);
           }
           if (GC_mark_some(GC_approx_sp())) break;
@@ -651,6 +694,7 @@ STATIC GC_bool GC_stopped_mark(GC_stop_func stop_func)
       GC_world_stopped = FALSE;
 #   endif
     START_WORLD();
+    GC_NOTIFY_EVENT(GC_EVENT_MARK_END);
 #   ifndef SMALL_CONFIG
       if (GC_print_stats) {
         unsigned long time_diff;
@@ -825,6 +869,7 @@ STATIC void GC_finish_collection(void)
         GC_check_tls();
 #   endif
 
+    GC_NOTIFY_EVENT(GC_EVENT_RECLAIM_START);
 #   ifndef SMALL_CONFIG
       if (GC_print_stats)
         GET_TIME(start_time);
@@ -939,6 +984,8 @@ STATIC void GC_finish_collection(void)
       GC_unmap_old();
 #   endif
 
+    GC_NOTIFY_EVENT(GC_EVENT_RECLAIM_END);
+
 #   ifndef SMALL_CONFIG
       if (GC_print_stats) {
         GET_TIME(done_time);
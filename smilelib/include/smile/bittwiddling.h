@@ -6,6 +6,10 @@
 #include <smile/types.h>
 #endif
 
+#ifndef __SMILE_MEM_H__
+#include <smile/mem.h>
+#endif
+
 Inline UInt32 NextPowerOfTwo32(UInt32 v)
 {
 	v--;
@@ -48,4 +52,135 @@ Inline Int NextPowerOfTwo(Int v)
 	return v;
 }
 
-#endif
+//-------------------------------------------------------------------------------------------------
+//  Word-at-a-time byte operations.
+//
+//  These treat a UInt64 as eight independent byte "lanes," which lets us scan or transform
+//  text eight bytes per step in plain portable C, without depending on any compiler's
+//  vector intrinsics.
+
+#define BYTEWORD_ONES ((UInt64)0x0101010101010101ULL)
+#define BYTEWORD_HIGHS ((UInt64)0x8080808080808080ULL)
+#define BYTEWORD_LOWS ((UInt64)0x7F7F7F7F7F7F7F7FULL)
+
+/// <summary>
+/// Read eight bytes from the given (possibly unaligned) address as a single word.
+/// </summary>
+Inline UInt64 ByteWord_Load(const Byte *src)
+{
+	UInt64 word;
+	MemCpy(&word, src, sizeof(UInt64));
+	return word;
+}
+
+/// <summary>
+/// Write a word out as eight bytes to the given (possibly unaligned) address.
+/// </summary>
+Inline void ByteWord_Store(Byte *dest, UInt64 word)
+{
+	MemCpy(dest, &word, sizeof(UInt64));
+}
+
+/// <summary>
+/// Determine whether any byte in the word has its high bit set (i.e., is not 7-bit ASCII).
+/// </summary>
+Inline Bool ByteWord_HasNonAscii(UInt64 word)
+{
+	return (word & BYTEWORD_HIGHS) != 0;
+}
+
+/// <summary>
+/// Produce a mask with the high bit set in exactly those byte lanes of the word that are nonzero.
+/// This is exact:  It has no false positives from carries between lanes.
+/// </summary>
+Inline UInt64 ByteWord_NonZeroLanes(UInt64 word)
+{
+	return (((word & BYTEWORD_LOWS) + BYTEWORD_LOWS) | word) & BYTEWORD_HIGHS;
+}
+
+/// <summary>
+/// Produce a mask with the high bit set in exactly those byte lanes of the word that are equal
+/// to the given byte.
+/// </summary>
+Inline UInt64 ByteWord_MatchByte(UInt64 word, Byte b)
+{
+	return ~ByteWord_NonZeroLanes(word ^ (BYTEWORD_ONES * b)) & BYTEWORD_HIGHS;
+}
+
+/// <summary>
+/// Produce a mask with the high bit set in exactly those byte lanes of the word whose value
+/// lies in the range [lo, hi].  All bytes in the word must be 7-bit ASCII, and 'lo' and 'hi'
+/// must both be in the range of 1 to 127.
+/// </summary>
+Inline UInt64 ByteWord_MatchAsciiRange(UInt64 word, Byte lo, Byte hi)
+{
+	UInt64 atLeastLo = word + BYTEWORD_ONES * (Byte)(0x80 - lo);
+	UInt64 aboveHi = word + BYTEWORD_ONES * (Byte)(0x7F - hi);
+	return atLeastLo & ~aboveHi & BYTEWORD_HIGHS;
+}
+
+/// <summary>
+/// Convert every 'A' through 'Z' in the word to 'a' through 'z'.  All bytes in the word must be 7-bit ASCII.
+/// </summary>
+Inline UInt64 ByteWord_AsciiToLower(UInt64 word)
+{
+	return word | (ByteWord_MatchAsciiRange(word, 'A', 'Z') >> 2);
+}
+
+/// <summary>
+/// Convert every 'a' through 'z' in the word to 'A' through 'Z'.  All bytes in the word must be 7-bit ASCII.
+/// </summary>
+Inline UInt64 ByteWord_AsciiToUpper(UInt64 word)
+{
+	return word & ~(ByteWord_MatchAsciiRange(word, 'a', 'z') >> 2);
+}
+
+/// <summary>
+/// Given a mask of byte lanes (such as from ByteWord_MatchByte()), return the offset of the
+/// first lane in memory order that is set.  The mask must not be zero.
+/// </summary>
+Inline Int ByteWord_FirstMatch(UInt64 mask)
+{
+#	if SMILE_ENDIAN == SMILE_ENDIAN_BIG
+		return (Int)(UInt64_CountLeadingZeros(mask) >> 3);
+#	else
+		return (Int)(UInt64_CountTrailingZeros(mask) >> 3);
+#	endif
+}
+
+/// <summary>
+/// Given a mask of byte lanes (such as from ByteWord_MatchByte()), return the offset of the
+/// last lane in memory order that is set.  The mask must not be zero.
+/// </summary>
+Inline Int ByteWord_LastMatch(UInt64 mask)
+{
+#	if SMILE_ENDIAN == SMILE_ENDIAN_BIG
+		return (Int)(UInt64_CountTrailingZeros(mask) >> 3);
+#	else
+		return (Int)((63 - UInt64_CountLeadingZeros(mask)) >> 3);
+#	endif
+}
+
+/// <summary>
+/// Produce a mask with the high bit set in each of the first 'count' byte lanes of a word, in
+/// memory order.  The count must be in the range of 0 to 7.
+/// </summary>
+Inline UInt64 ByteWord_LanesBefore(Int count)
+{
+#	if SMILE_ENDIAN == SMILE_ENDIAN_BIG
+		return ~(~(UInt64)0 >> (count << 3)) & BYTEWORD_HIGHS;
+#	else
+		return (((UInt64)1 << (count << 3)) - 1) & BYTEWORD_HIGHS;
+#	endif
+}
+
+/// <summary>
+/// Given a mask of byte lanes (such as from ByteWord_MatchByte()), count how many lanes are set.
+/// This multiplies the lane bits together into the top byte, so it needs no population-count instruction.
+/// </summary>
+Inline Int ByteWord_CountMatches(UInt64 mask)
+{
+	return (Int)(((mask >> 7) * BYTEWORD_ONES) >> 56);
+}
+
+#endif
\ No newline at end of file
@@ -23,15 +23,33 @@ struct Int32DictNode {
 	void *value;				// The value for this node.
 };
 
+/// <summary>
+/// The maximum number of key/value pairs an Int32Dict stores inline, before it switches over to
+/// separately-allocated buckets and heap.
+/// </summary>
+#define INT32DICT_SMALL_SIZE 8
+
 /// <summary>
 /// The internal implementation of an Int32Dict.
+///
+/// Most dictionaries (object properties, especially) only ever hold a handful of keys, so a new
+/// dictionary starts out "small," with its pairs stored in the inline arrays below and found by
+/// a linear scan; this needs no allocations beyond the dictionary itself.  Adding a pair past
+/// INT32DICT_SMALL_SIZE promotes it to the usual hashed form, in which 'heap' is non-NULL.
+///
+/// A small dictionary's buckets point at the shared, always-empty Int32Dict_SmallBuckets, so the
+/// ordinary hashed search simply misses, and only then checks for (and scans) the inline pairs.
+/// That keeps large dictionaries' lookups exactly as fast as they were before small ones existed.
 /// </summary>
 struct Int32DictInt {
-	Int32 *buckets;				// The buckets contain pointers into the heap, indexed by masked hash code.
-	struct Int32DictNode *heap;	// The heap, which holds all of the key/value pairs as Node structs.
+	Int32 *buckets;				// The buckets contain pointers into the heap, indexed by masked hash code (Int32Dict_SmallBuckets while small).
+	struct Int32DictNode *heap;	// The heap, which holds all of the key/value pairs as Node structs (NULL while small).
 	Int32 mask;					// The current size of both the heap and buckets.  Always equal to 2^n - 1 for some n.
 	Int32 firstFree;			// The first free node in the heap (successive free nodes follow the 'next' pointers).
-	Int32 count;				// The number of allocated nodes in the heap.
+	Int32 count;				// The number of allocated nodes in the heap (or pairs in the inline arrays).
+	UInt32 smallFilter;			// While small, bit (key & 31) is set for every key present, so most misses skip the scan.
+	Int32 smallKeys[INT32DICT_SMALL_SIZE];	// The keys, while the dictionary is small.
+	void *smallValues[INT32DICT_SMALL_SIZE];	// The values, while the dictionary is small.
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -65,6 +83,8 @@ typedef void *(*Int32Dict_ValueCloner)(Int32 key, void *value, void *param);
 //-------------------------------------------------------------------------------------------------
 //  External parts of the implementation
 
+SMILE_API_DATA Int32 Int32Dict_SmallBuckets[1];
+
 SMILE_API_FUNC Int32 Int32DictInt_Append(struct Int32DictInt *intDict, Int32 key, const void *value);
 
 SMILE_API_FUNC Int32 *Int32Dict_GetKeys(Int32Dict intDict);
@@ -81,11 +101,32 @@ SMILE_API_FUNC DictStats Int32Dict_ComputeStats(Int32Dict intDict);
 //-------------------------------------------------------------------------------------------------
 //  Inline parts of the implementation
 
+/// <summary>
+/// Find the index of the given key in a small dictionary's inline arrays.
+/// </summary>
+/// <param name="self">The casted pointer to the implementation of the dictionary, which must be small.</param>
+/// <param name="key">The key to search for.</param>
+/// <returns>The index of the key in the inline arrays, or -1 if the key is not in the dictionary.</returns>
+Inline Int32 Int32DictInt_FindSmall(struct Int32DictInt *self, Int32 key)
+{
+	Int32 i, count = self->count;
+
+	if (!(self->smallFilter & ((UInt32)1 << (key & 31))))
+		return -1;
+
+	for (i = 0; i < count; i++) {
+		if (self->smallKeys[i] == key)
+			return i;
+	}
+	return -1;
+}
+
 /// <summary>
 /// Construct a new, empty dictionary, and control its allocation behavior.
 /// </summary>
 /// <param name="newSize">The initial allocation size of the dictionary, which is the number of
-/// items the dictionary can hold without it needing to invoke another reallocation.</param>
+/// items the dictionary can hold without it needing to invoke another reallocation.  Sizes up to
+/// INT32DICT_SMALL_SIZE produce a small dictionary that needs no allocations of its own.</param>
 /// <returns>The new, empty dictionary.</returns>
 Inline Int32Dict Int32Dict_CreateWithSize(Int32 newSize)
 {
@@ -103,7 +144,7 @@ Inline Int32Dict Int32Dict_CreateWithSize(Int32 newSize)
 /// <returns>The new, empty dictionary.</returns>
 Inline Int32Dict Int32Dict_Create(void)
 {
-	return Int32Dict_CreateWithSize(16);
+	return Int32Dict_CreateWithSize(INT32DICT_SMALL_SIZE);
 }
 
 /// <summary>
@@ -111,7 +152,7 @@ Inline Int32Dict Int32Dict_Create(void)
 /// </summary>
 Inline void Int32Dict_Clear(Int32Dict intDict)
 {
-	Int32Dict_ClearWithSize(intDict, 16);
+	Int32Dict_ClearWithSize(intDict, INT32DICT_SMALL_SIZE);
 }
 
 /// <summary>
@@ -128,7 +169,7 @@ Inline Bool Int32Dict_ContainsKey(Int32Dict intDict, Int32 key)
 			return True;
 		},
 		{
-			return False;
+			return heap == NULL && Int32DictInt_FindSmall(self, key) >= 0;
 		})
 }
 
@@ -147,7 +188,9 @@ Inline Bool Int32Dict_Add(Int32Dict intDict, Int32 key, const void *value)
 			return False;
 		},
 		{
-			Int32DictInt_Append((struct Int32DictInt *)intDict, key, value);
+			if (heap == NULL && Int32DictInt_FindSmall(self, key) >= 0)
+				return False;
+			Int32DictInt_Append(self, key, value);
 			return True;
 		})
 }
@@ -176,6 +219,8 @@ Inline void *Int32Dict_GetValue(Int32Dict intDict, Int32 key)
 			return node->value;
 		},
 		{
+			if (heap == NULL && (nodeIndex = Int32DictInt_FindSmall(self, key)) >= 0)
+				return self->smallValues[nodeIndex];
 			return NULL;
 		})
 }
@@ -196,6 +241,10 @@ Inline Bool Int32Dict_ReplaceValue(Int32Dict intDict, Int32 key, void *value)
 			return True;
 		},
 		{
+			if (heap == NULL && (nodeIndex = Int32DictInt_FindSmall(self, key)) >= 0) {
+				self->smallValues[nodeIndex] = value;
+				return True;
+			}
 			return False;
 		})
 }
@@ -216,7 +265,11 @@ Inline Bool Int32Dict_SetValue(Int32Dict intDict, Int32 key, void *value)
 			return True;
 		},
 		{
-			Int32DictInt_Append((struct Int32DictInt *)intDict, key, value);
+			if (heap == NULL && (nodeIndex = Int32DictInt_FindSmall(self, key)) >= 0) {
+				self->smallValues[nodeIndex] = value;
+				return True;
+			}
+			Int32DictInt_Append(self, key, value);
 			return False;
 		})
 }
@@ -239,6 +292,10 @@ Inline Bool Int32Dict_TryGetValue(Int32Dict intDict, Int32 key, void **value)
 			return True;
 		},
 		{
+			if (heap == NULL && (nodeIndex = Int32DictInt_FindSmall(self, key)) >= 0) {
+				*value = self->smallValues[nodeIndex];
+				return True;
+			}
 			*value = NULL;
 			return False;
 		})
@@ -93,6 +93,8 @@ SMILE_API_FUNC SmileObject Smile_ParseInScope(String text, String filename,
 	ExternalVar *vars, Int numVars,
 	ParseMessage **parseMessages, Int *numParseMessages, ParseScope *moduleScope);
 SMILE_API_FUNC EvalResult Smile_EvalInScope(ClosureInfo globalClosureInfo, SmileObject expression);
+SMILE_API_FUNC Compiler Smile_CreateIncrementalCompiler(ClosureInfo globalClosureInfo);
+SMILE_API_FUNC EvalResult Smile_EvalIncrementally(Compiler compiler, SmileObject expression);
 
 SMILE_API_DATA Bool Stdio_Invoked;
 
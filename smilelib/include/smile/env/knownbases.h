@@ -20,6 +20,7 @@ struct KnownBasesStruct {
 	SmileUserObject         Float32, Float64, Float128;
 	SmileUserObject     Enumerable;
 	SmileUserObject       List;
+	SmileUserObject       Sequence;
 	SmileUserObject       String;
 	SmileUserObject       Range;
 	SmileUserObject         NumericRange;
@@ -60,6 +61,7 @@ struct KnownBasesStruct {
 	SmileUserObject     Symbol;
 	SmileUserObject     Exception;
 	SmileUserObject     Handle;
+	SmileUserObject     Runtime;
 };
 
 extern void KnownBases_Preload(struct KnownBasesStruct *knownBases);
@@ -172,7 +172,7 @@ typedef struct KnownSymbolsStruct {
 
 	// Typename symbols.
 	Symbol Actor_, Array_, ArrayBase_, Bool_, BoolArray_, Char_, CharRange_, Closure, Enumerable_, Exception_, Facade_, FacadeProper_, Fn_, Handle_;
-	Symbol List_, Map_, MapBase_, MathException, Null_, Object_, Program_, Random_, Range_;
+	Symbol List_, Map_, MapBase_, MathException, Null_, Object_, Program_, Random_, Range_, Runtime_, Sequence_;
 	Symbol Regex_, String_, StringArray_, StringMap_, Symbol_, SymbolArray_, SymbolMap_, Uni_, UniRange_, UserObject_;
 
 	// Numeric typename symbols.
@@ -199,7 +199,7 @@ typedef struct KnownSymbolsStruct {
 	Symbol Float128_, Float128Array_, Float128Range_, Float128Map_;
 
 	// General symbols.
-	Symbol a, abs, acos, add_c_slashes, alnum_q, alpha_q, apply, apply_method, arguments, asin, assertions, assigned_name, atan, atan2;
+	Symbol a, abs, acos, add_c_slashes, alnum_q, alpha_q, apply, apply_method, arguments, array, asin, assertions, assigned_name, atan, atan2;
 	Symbol base_, big_float, big_int, big_real, bit_and, bit_not, bit_or, bit_xor, body, bool_, byte_, byte_array, byte_range;
 	Symbol call, call_method, camelCase, CamelCase, case_fold, case_insensitive, case_sensitive, category, ceil, char_, chip, chop;
 	Symbol cident_q, clip, clone, closure, cmp, code_at, code_length, column, combine, compare, compare_i, compose, composed_q, cons, contains, contains_i, control_q, context, cos, count, count64;
@@ -230,7 +230,7 @@ typedef struct KnownSymbolsStruct {
 	Symbol real_, real32_, real32_range, real64_, real64_range, real128_;
 	Symbol reexport, rem, repeat, replace, replacement, resize, rest, result;
 	Symbol reverse, reverse_bits, reverse_bytes, right, rot_13;
-	Symbol separator, separator_line, separator_paragraph, separator_space;
+	Symbol separator, separator_line, separator_paragraph, separator_space, sequence;
 	Symbol set_object_security, set_once, set_property, sign, sin, space_q, splice, split, sprintf;
 	Symbol sqrt, sqrt_domain, stack_trace, start, starts_with, starts_with_i, step, stepping;
 	Symbol string_, strip_c_slashes, studied_, study, substr, substring, symbol;
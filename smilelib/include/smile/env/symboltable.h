@@ -13,29 +13,51 @@
 #include <smile/string.h>
 #endif
 
-#ifndef __SMILE_DICT_STRINGINTDICT_H__
-#include <smile/dict/stringintdict.h>
-#endif
+//-------------------------------------------------------------------------------------------------
+//  Public type declarations
+
+// A symbol is (currently) a magic integer that is not zero (zero is an invalid symbol ID).
+typedef Int32 Symbol;
 
 //-------------------------------------------------------------------------------------------------
 //  Internal types
 
+/// <summary>
+/// A single name-to-symbol mapping.  Entries are never modified once they're published in a
+/// lookup table, so readers may use them without taking any locks.
+/// </summary>
+struct SymbolTableEntry {
+	String name;	// The symbol's name.
+	UInt32 hash;	// The hash code of the symbol's name.
+	Symbol symbol;	// The symbol's ID.
+};
+
+/// <summary>
+/// An open-addressed (linear-probing) hash table of symbol entries.  Slots only ever go from
+/// NULL to an entry; the table is replaced wholesale, not resized in place, when it fills up.
+/// </summary>
+struct SymbolTableLookup {
+	Int mask;	// The number of slots, minus one (the number of slots is always a power of two).
+	struct SymbolTableEntry **slots;	// The slots, each of which is NULL or a published entry.
+};
+
 /// <summary>
 /// The internal implementation of the Smile shared symbol table.
+///
+/// Lookups are lock-free, so any number of lexers on any number of threads may read the table at
+/// once.  Adding a symbol takes a short CAS-based write lock, writes the new name, and only then
+/// publishes it with an atomic store.  Growing either array copies it and atomically swaps in the
+/// copy; readers still holding the old one keep seeing a consistent (if slightly stale) snapshot,
+/// and the garbage collector reclaims it once they're done.
 /// </summary>
 struct SymbolTableInt {
 	String *symbolNames;	// This is the set of known symbols, in registration order.
-	Int count;	// The number of registered symbols.
+	Int32 count;	// The number of registered symbols.
 	Int max;	// The current maximum size of the symbol arrays.
-	StringIntDict symbolLookup;	// A lookup table for finding symbol IDs by their names, quickly.
+	struct SymbolTableLookup *symbolLookup;	// A lookup table for finding symbol IDs by their names, quickly.
+	Int32 writeLock;	// Nonzero while a thread is adding a symbol.
 };
 
-//-------------------------------------------------------------------------------------------------
-//  Public type declarations
-
-// A symbol is (currently) a magic integer that is not zero (zero is an invalid symbol ID).
-typedef Int32 Symbol;
-
 typedef struct SymbolTableStruct {
 	struct SymbolTableInt _opaque;
 } *SymbolTable;
@@ -51,26 +73,6 @@ SMILE_API_FUNC Symbol SymbolTable_GetSymbolNoCreateC(SymbolTable symbolTable, co
 SMILE_API_FUNC String SymbolTable_GetName(SymbolTable symbolTable, Symbol symbol);
 SMILE_API_FUNC const char *SymbolTable_GetNameC(SymbolTable symbolTable, Symbol symbol);
 
-//-------------------------------------------------------------------------------------------------
-//  Inline parts of the implementation.
-
-/// <summary>
-/// Add a known-new symbol to a known-large-enough symbol table.  This is unsafe in the general
-/// case, but safe during the initialization of the symbol table initially.
-/// </summary>
-/// <param name="symbolTable">The symbol table to which the new symbol should be added.</param>
-/// <param name="name">The name of the new symbol, which must not already exist in the symbol table.</param>
-/// <returns>The new symbol.</returns>
-Inline Symbol SymbolTableInt_AddFast(SymbolTable symbolTable, String name)
-{
-	struct SymbolTableInt *table = (struct SymbolTableInt *)symbolTable;
-	Symbol symbol;
-
-	// Add the symbol to the table, and return it.  This skips all the usual preexistence checks.
-	table->symbolNames[symbol = (Symbol)table->count++] = name;
-	StringIntDictInt_Append((struct StringIntDictInt *)(table->symbolLookup), name, String_Hash(name), symbol);
-
-	return symbol;
-}
+SMILE_API_FUNC Symbol SymbolTableInt_AddFast(SymbolTable symbolTable, String name);
 
 #endif
@@ -61,6 +61,7 @@ typedef struct ByteCodeSegmentStruct {
 	ByteCode byteCodes;
 	Int32 numByteCodes;
 	Int32 maxByteCodes;
+	Symbol functionName;		// The name the function this is the body of was assigned to, if any (for profiling).
 } *ByteCodeSegment;
 
 //-------------------------------------------------------------------------------------------------
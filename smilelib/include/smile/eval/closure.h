@@ -157,6 +157,8 @@ typedef struct ClosureStateMachineStruct {
 //-------------------------------------------------------------------------------------------------
 // External Implementation.
 
+SMILE_API_DATA UInt64 Closure_NumLocalsCreated;	// How many times Closure_CreateLocal() has been called.
+
 SMILE_API_FUNC ClosureInfo ClosureInfo_Create(ClosureInfo parent, Int kind);
 
 SMILE_API_FUNC String ClosureInfo_StringifyVariableNames(ClosureInfo closureInfo);
@@ -160,12 +160,14 @@ typedef struct CompiledTablesStruct {
 /// <summary>
 /// This represents the data collected during a compile process, and current state of the compile.
 /// </summary>
-typedef struct CompilerStruct {
+struct CompilerStruct {
 	CompiledTables compiledTables;			// The tables collected during the parse.
 	CompilerFunction currentFunction;		// The current function being compiled (all code exists in a function).
 	CompileScope currentScope;				// The current compile scope (for resolving symbols).
 	SmileList firstMessage, lastMessage;	// Any errors/warnings encountered while compiling.
-} *Compiler;
+	CompileScope globalScope;				// The outermost scope, kept across incremental compiles (NULL if not incremental).
+	Int32 numGlobalsDeclared;				// How many global variables have been declared in 'globalScope'.
+};
 
 //-------------------------------------------------------------------------------------------------
 //  External API.
@@ -0,0 +1,44 @@
+#ifndef __SMILE_EVAL_CONSTANTPOOL_H__
+#define __SMILE_EVAL_CONSTANTPOOL_H__
+
+#ifndef __SMILE_TYPES_H__
+#include <smile/types.h>
+#endif
+
+#ifndef __SMILE_STRING_H__
+#include <smile/string.h>
+#endif
+
+#ifndef __SMILE_SMILETYPES_SMILEOBJECT_H__
+#include <smile/smiletypes/smileobject.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  The constant pool.
+//
+//  Every constant the compiler emits into a CompiledTables (strings, Integer128 literals, and
+//  quoted lists) passes through here first, so that equal constants from different compiles
+//  (different modules, REPL lines, or calls to eval) end up as the same object.  The pool
+//  only holds its entries weakly:  Once no compiled code refers to a constant anymore, the
+//  collector is free to reclaim it, and its entry quietly disappears.
+//
+//  Quoted lists are shared, not copied, so they should be treated as literals:  Destructively
+//  modifying one will be visible through every other quote of an equal list.  Lists that carry
+//  source positions (which is to say, anything straight out of the parser) are never shared,
+//  since each one's positions belong to its own file and line.
+
+SMILE_API_FUNC SmileObject ConstantPool_Intern(SmileObject obj);
+SMILE_API_FUNC void ConstantPool_Reset(void);
+SMILE_API_FUNC Int ConstantPool_Count(void);
+
+/// <summary>
+/// Find the pooled string equal to the given string, adding it to the pool if there isn't one.
+/// </summary>
+/// <param name="string">The string to intern.</param>
+/// <returns>The one pooled instance of that string's content.</returns>
+Inline String ConstantPool_InternString(String string)
+{
+	return (String)ConstantPool_Intern((SmileObject)string);
+}
+
+#endif
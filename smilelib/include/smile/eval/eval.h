@@ -75,5 +75,18 @@ Inline EscapeContinuation EscapeContinuation_Create(Int escapeKind)
 SMILE_API_FUNC void Eval_BeforeRecurse(struct EvalStateStruct *evalState);
 SMILE_API_FUNC void Eval_AfterRecurse(struct EvalStateStruct *evalState);
 
+//-------------------------------------------------------------------------------------------------
+//  Runtime counters
+//
+//  These only ever count up, for the life of the process (they survive environment resets), and
+//  are what the 'Runtime' object reports.  The instruction count is kept per thread, and summed
+//  when it's read.  The others, like the profiler's data, are process-wide and aren't synchronized,
+//  so they may undercount a little while several threads are running.
+
+SMILE_API_DATA UInt64 Eval_NumStateMachineSteps;	// Steps taken by state machines (iterations of 'each', 'map', etc.).
+SMILE_API_DATA UInt64 Eval_NumExceptionsThrown;		// Objects thrown by Smile_Throw(), whether caught or not.
+
+SMILE_API_FUNC UInt64 Eval_GetNumInstructions(void);	// Instructions executed by eval().
+
 #endif
 
@@ -140,9 +140,12 @@ enum Opcode {
 	Op_StpProp	= 0x72,		// -2 | int32			; Store and pop the stack top into the given property of the given object.
 	Op_73		= 0x73,		
 	Op_LdMember	= 0x74,		// -2, +1				; Call 'get-member', passing member (top-1) and object (top-2).
-	Op_StMember	= 0x75,		// -3, +1				; Call 'set-member', passing value (top-1), member (top-2), and object (top-3).  Results in the stack top value.
-							// ; Warning: Op_StMember MUST ALWAYS be preceded by an otherwise-unnecessary Op_LdNull instruction!
-	Op_StpMember = 0x76,	// -3					; Call 'set-member', passing value (top-1), member (top-2), and object (top-3).  Pops the stack top value.
+	Op_StMember	= 0x75,		// -3, +1				; Call 'set-member', passing value (top-1), member (top-2), and object (top-3).  Results in the stack top value,
+							// ; with set-member's own result pushed above it.
+							// ; Warning: Op_StMember MUST ALWAYS be preceded by an otherwise-unnecessary Op_LdNull instruction,
+							// ; and followed by an Op_Pop1 to discard set-member's result!
+	Op_StpMember = 0x76,	// -3, +1				; Call 'set-member', passing value (top-1), member (top-2), and object (top-3).  Pops the stack top value,
+							// ; leaving only set-member's own result, which must be discarded with an Op_Pop1.
 	Op_77		= 0x77,		
 	Op_78		= 0x78,		
 	Op_79		= 0x79,		
@@ -0,0 +1,65 @@
+#ifndef __SMILE_EVAL_PROFILER_H__
+#define __SMILE_EVAL_PROFILER_H__
+
+#ifndef __SMILE_TYPES_H__
+#include <smile/types.h>
+#endif
+
+#ifndef __SMILE_STRING_H__
+#include <smile/string.h>
+#endif
+
+#ifndef __SMILE_EVAL_BYTECODE_H__
+#include <smile/eval/bytecode.h>
+#endif
+
+#ifndef __SMILE_EVAL_CLOSURE_H__
+#include <smile/eval/closure.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  The profiler.
+//
+//  While the profiler is running, eval() reports every instruction it executes, which lets the
+//  profiler count instructions and wall time for each function (each ByteCodeSegment, which is
+//  one-to-one with a UserFunctionInfo).  A timer signal periodically asks for a sample, and the
+//  next instruction to execute records the current stack (its segment and byte code, and those
+//  of every return continuation above it) as a folded stack, in the "frame;frame;frame count"
+//  format that flamegraph.pl reads.
+//
+//  The signal handler itself only sets a flag; the stack is walked by eval() at the next
+//  instruction boundary, where the closures and segments are guaranteed to be consistent.
+//
+//  The allocation profiler samples about one allocation in every N made through the GC_MALLOC*
+//  macros (see smile/gc.h), and charges each sample to the instruction eval() was running at
+//  the time, by kind of object:  Its SMILE_KIND if it's a Smile object, or else its C type.
+//
+//  The profilers' data is process-wide, so only one thread should be profiled at a time.
+
+/// <summary>
+/// What the profiler knows about one function.
+/// </summary>
+typedef struct ProfileEntryStruct {
+	ByteCodeSegment segment;		// The function body this entry describes.
+	Int64 numInstructions;			// The number of instructions executed in this function.
+	Int64 numSamples;				// The number of samples taken while this function was on top.
+	UInt64 ticks;					// Wall time spent in this function, not counting its callees.
+} *ProfileEntry;
+
+SMILE_API_DATA Bool Profiler_IsRunning;
+
+SMILE_API_FUNC void Profiler_Start(Int sampleMicroseconds);
+SMILE_API_FUNC void Profiler_Stop(void);
+SMILE_API_FUNC void Profiler_Step(ByteCodeSegment segment, Closure closure, ByteCode byteCode);
+
+SMILE_API_FUNC void Profiler_StartAllocations(Int sampleEvery);
+SMILE_API_FUNC void Profiler_StopAllocations(void);
+
+SMILE_API_FUNC ProfileEntry Profiler_GetEntry(ByteCodeSegment segment);
+SMILE_API_FUNC Int64 Profiler_GetNumSamples(void);
+SMILE_API_FUNC String Profiler_GetFunctionLabel(ByteCodeSegment segment);
+SMILE_API_FUNC String Profiler_GetFoldedStacks(void);
+SMILE_API_FUNC String Profiler_GetSummary(void);
+SMILE_API_FUNC String Profiler_GetAllocationReport(Int maxSites);
+
+#endif
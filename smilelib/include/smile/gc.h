@@ -2,6 +2,10 @@
 #ifndef __SMILE_GC_H__
 #define __SMILE_GC_H__
 
+#ifndef __SMILE_TYPES_H__
+#include <smile/types.h>
+#endif
+
 #ifdef _DEBUG
 #	ifndef GC_DEBUG
 #		define GC_DEBUG
@@ -28,12 +32,51 @@
 #pragma warning(pop)
 #endif
 
+//-------------------------------------------------------------------------------------------------
+//  Allocation sampling.
+//
+//  Every allocation made through these macros counts down Profiler_AllocationCountdown, and
+//  takes the slow path through Profiler_SampleAllocation() when it runs out, which is how the
+//  allocation profiler (see smile/eval/profiler.h) sees one allocation in every N.  When the
+//  allocation profiler is off, the countdown starts at Int32Max, so the slow path is almost
+//  never taken, and the cost of an allocation is one extra decrement-and-test.
+
+SMILE_API_DATA Int32 Profiler_AllocationCountdown;
+SMILE_API_FUNC void *Profiler_SampleAllocation(size_t size, Bool isAtomic, const char *typeName);
+
+#ifdef GC_DEBUG
+#	define GC_MALLOC_UNSAMPLED(__n__) GC_debug_malloc((__n__), GC_EXTRAS)
+#	define GC_MALLOC_ATOMIC_UNSAMPLED(__n__) GC_debug_malloc_atomic((__n__), GC_EXTRAS)
+#else
+#	define GC_MALLOC_UNSAMPLED(__n__) GC_malloc(__n__)
+#	define GC_MALLOC_ATOMIC_UNSAMPLED(__n__) GC_malloc_atomic(__n__)
+#endif
+
+/// <summary>Allocate memory from the collector, giving the allocation profiler a chance to sample it.</summary>
+/// <param name="__n__">The number of bytes to allocate.</param>
+/// <param name="__isAtomic__">Whether the memory will never contain pointers (a compile-time constant).</param>
+/// <param name="__typeName__">The C type being allocated, as a string constant, or NULL if unknown.</param>
+/// <returns>A pointer to the new memory, or NULL if the allocation failed.</returns>
+#define GC_MALLOC_SAMPLED(__n__, __isAtomic__, __typeName__) \
+	( --Profiler_AllocationCountdown > 0 \
+		? ((__isAtomic__) ? GC_MALLOC_ATOMIC_UNSAMPLED(__n__) : GC_MALLOC_UNSAMPLED(__n__)) \
+		: Profiler_SampleAllocation((__n__), (__isAtomic__), (__typeName__)) )
+
+#undef GC_MALLOC
+#define GC_MALLOC(__n__) GC_MALLOC_SAMPLED((__n__), False, NULL)
+
+#undef GC_MALLOC_ATOMIC
+#define GC_MALLOC_ATOMIC(__n__) GC_MALLOC_SAMPLED((__n__), True, NULL)
+
+//-------------------------------------------------------------------------------------------------
+//  Typed allocation.
+
 /// <summary>Allocate a raw array of the given type.  Raw arrays must not contain pointers within them,
 /// so they are more efficient for garbage collection than structured arrays.</summary>
 /// <param name="__t__">The type of the data elements in the array.</param>
 /// <param name="__n__">The number of data elements in the array.</param>
 /// <returns>A pointer to the start of the new array, or NULL if the allocation failed.</returns>
-#define GC_MALLOC_RAW_ARRAY(__t__, __n__) ( (__t__ *) GC_MALLOC_ATOMIC( sizeof(__t__) * (__n__) ) )
+#define GC_MALLOC_RAW_ARRAY(__t__, __n__) ( (__t__ *) GC_MALLOC_SAMPLED( sizeof(__t__) * (__n__), True, #__t__ "[]" ) )
 
 /// <summary>Allocate a raw byte array, which must not contain pointers.</summary>
 /// <param name="__n__">The number of bytes in the array.</param>
@@ -49,12 +92,12 @@
 /// <summary>Allocate a struct of known type.</summary>
 /// <param name="__t__">The type the new struct.</param>
 /// <returns>A pointer to the new object, or NULL if the allocation failed.</returns>
-#define GC_MALLOC_STRUCT(__t__) ( (__t__ *) GC_MALLOC( sizeof(__t__) ) )
+#define GC_MALLOC_STRUCT(__t__) ( (__t__ *) GC_MALLOC_SAMPLED( sizeof(__t__), False, #__t__ ) )
 
 /// <summary>Allocate an array of the given type.  Arrays created by this may contain pointers to other data.</summary>
 /// <param name="__t__">The type of the data elements in the array.</param>
 /// <param name="__n__">The number of data elements in the array.</param>
 /// <returns>A pointer to start of the new array, or NULL if the allocation failed.</returns>
-#define GC_MALLOC_STRUCT_ARRAY(__t__, __n__) ((__t__ *) GC_MALLOC( sizeof(__t__) * (__n__) ))
+#define GC_MALLOC_STRUCT_ARRAY(__t__, __n__) ((__t__ *) GC_MALLOC_SAMPLED( sizeof(__t__) * (__n__), False, #__t__ "[]" ))
 
 #endif
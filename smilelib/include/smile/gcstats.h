@@ -0,0 +1,39 @@
+
+#ifndef __SMILE_GCSTATS_H__
+#define __SMILE_GCSTATS_H__
+
+#ifndef __SMILE_TYPES_H__
+#include <smile/types.h>
+#endif
+#ifndef __SMILE_SIMPLESTATS_H__
+#include <smile/simplestats.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  Type declarations
+
+/// <summary>
+/// Statistics on the garbage collector, as collected since Smile_StartGcStats() was called.
+/// </summary>
+typedef struct GcStatsStruct {
+	Bool isIncremental;				// Whether the collector is running in generational/incremental mode.
+	Int64 numCollections;			// The number of complete collections the collector has performed.
+	Int64 heapSize;					// The current size of the heap, in bytes.
+	Int64 totalBytesAllocated;		// The total number of bytes ever allocated.
+
+	double totalPauseMilliseconds;	// The total time the program was stopped for collection work.
+	double totalMarkMilliseconds;	// The part of that total spent marking (with the world stopped).
+	SimpleStats pauseStats;			// Statistics on the lengths of the pauses, in milliseconds.
+} *GcStats;
+
+//-------------------------------------------------------------------------------------------------
+//  Public interface
+
+SMILE_API_FUNC Bool Smile_EnableIncrementalGc(Int maxPauseMilliseconds);
+SMILE_API_FUNC void Smile_StartGcStats(void);
+SMILE_API_FUNC Bool Smile_IsCollectingGcStats(void);
+SMILE_API_FUNC GcStats Smile_GetGcStats(void);
+
+SMILE_API_FUNC String GcStats_ToString(GcStats stats);
+
+#endif
@@ -20,7 +20,8 @@
 		struct SmileObjectInt *base; \
 		struct { \
 			Int length; \
-			Byte text[__size__]; \
+			Byte *text; \
+			Byte data[__size__]; \
 		} _opaque; \
 	}
 
@@ -34,7 +35,7 @@
 	DECLARE_STATIC_STRING_TYPE(__name__##StructType, sizeof(__text__)); \
 	static const struct __name__##StructType __name__##Struct = { \
 		SMILE_KIND_STRING, (SmileVTable)&String_VTableData, (SmileObject)&String_BaseObjectStruct, \
-		{ (sizeof(__text__) - 1), (__text__) } \
+		{ (sizeof(__text__) - 1), (Byte *)__name__##Struct._opaque.data, (__text__) } \
 	}; \
 	const String __name__ = (const String)(&__name__##Struct)
 
@@ -48,7 +49,7 @@
 	DECLARE_STATIC_STRING_TYPE(__name__##StructType, sizeof(__text__)); \
 	static const struct __name__##StructType __name__##Struct = { \
 		SMILE_KIND_STRING, (SmileVTable)&String_VTableData, (SmileObject)&String_BaseObjectStruct, \
-		{ (sizeof(__text__) - 1), (__text__) } \
+		{ (sizeof(__text__) - 1), (Byte *)__name__##Struct._opaque.data, (__text__) } \
 	}; \
 	static const String __name__ = (const String)(&__name__##Struct)
 
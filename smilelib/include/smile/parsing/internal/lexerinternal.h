@@ -8,6 +8,9 @@
 #ifndef __SMILE_PARSING_LEXER_H__
 #include <smile/parsing/lexer.h>
 #endif
+#ifndef __SMILE_BITTWIDDLING_H__
+#include <smile/bittwiddling.h>
+#endif
 
 SMILE_INTERNAL_FUNC Int Lexer_ParseName(Lexer lexer, Bool isFirstContentOnLine);
 SMILE_INTERNAL_FUNC Int Lexer_ParsePunctuation(Lexer lexer, Bool isFirstContentOnLine);
@@ -26,12 +29,87 @@ SMILE_INTERNAL_FUNC Int Lexer_ParseSlash(Lexer lexer, Bool isFirstContentOnLine)
 SMILE_INTERNAL_FUNC Int Lexer_ParseDot(Lexer lexer, Bool isFirstContentOnLine);
 SMILE_INTERNAL_FUNC Int Lexer_ParseHyphenOrEquals(Lexer lexer, Int initialChar, Bool isFirstContentOnLine, Bool hasPrecedingWhitespace);
 
+//---------------------------------------------------------------------------
+//  Word-at-a-time scanning.
+//
+//  Comments, string bodies, and runs of whitespace make up most of the bytes in
+//  a typical source file, but almost none of those bytes need any individual
+//  attention.  These skip over them eight bytes at a time, and then leave the
+//  lexer's usual byte-at-a-time code to handle whatever they stopped at (and
+//  the last few bytes of the input).
+
+/// <summary>
+/// Skip forward to the first line break ('\n' or '\r') or the first occurrence of
+/// either of the given bytes, a word at a time.  (Pass the same byte twice if you
+/// only need one.)
+/// </summary>
+/// <returns>The address of the first matching byte, or of some earlier byte within the
+/// last eight bytes of the input.  The caller must continue scanning from there.</returns>
+Inline const Byte *Lexer_SkipToLineBreakOr(const Byte *src, const Byte *end, Byte a, Byte b)
+{
+	UInt64 word, mask;
+
+	while (end - src >= 8) {
+		word = ByteWord_Load(src);
+		mask = ByteWord_MatchByte(word, '\n') | ByteWord_MatchByte(word, '\r')
+			| ByteWord_MatchByte(word, a) | ByteWord_MatchByte(word, b);
+		if (mask)
+			return src + ByteWord_FirstMatch(mask);
+		src += 8;
+	}
+
+	return src;
+}
+
+/// <summary>
+/// Skip forward over a run of whitespace a word at a time, counting any '\n' newlines in it.
+/// Words containing '\r' are left to the caller, since only the byte-at-a-time code
+/// knows how to pair it up with a neighboring '\n'.
+/// </summary>
+/// <param name="lexer">The lexer, whose line number and line start will be updated for
+/// any newlines that are skipped.</param>
+/// <param name="srcPtr">The current input pointer, which will be moved forward.</param>
+/// <param name="end">The end of the input.</param>
+/// <returns>The number of newlines that were skipped.</returns>
+Inline Int Lexer_SkipWhitespaceWords(Lexer lexer, const Byte **srcPtr, const Byte *end)
+{
+	const Byte *src = *srcPtr;
+	UInt64 word, newlines;
+	Int numNewlines = 0;
+
+	while (end - src >= 8) {
+		word = ByteWord_Load(src);
+		if (ByteWord_HasNonAscii(word)
+			|| ByteWord_MatchAsciiRange(word, '\x21', '\x7F')
+			|| ByteWord_MatchByte(word, '\r'))
+			break;
+
+		newlines = ByteWord_MatchByte(word, '\n');
+		if (newlines) {
+			numNewlines += ByteWord_CountMatches(newlines);
+			lexer->lineStart = src + ByteWord_LastMatch(newlines) + 1;
+		}
+		src += 8;
+	}
+
+	if (numNewlines) {
+		// A '\n' at the very end of the run pairs up with a '\r' right after it.
+		if (src[-1] == '\n' && src < end && *src == '\r')
+			lexer->lineStart = ++src;
+		lexer->line += numNewlines;
+	}
+
+	*srcPtr = src;
+	return numNewlines;
+}
+
 //---------------------------------------------------------------------------
 //  Tokenization macros.
 
 // Begin a token at the given start pointer.
 #define START_TOKEN(__startPtr__) \
 	((token->_position.filename = lexer->filename), \
+	 (token->_position.fileId = lexer->fileId), \
 	 (token->_position.line = (Int32)lexer->line), \
 	 (token->_position.lineStart = (Int32)(lexer->lineStart - lexer->input)), \
 	 (token->_position.column = (Int32)((lexer->tokenStart = (__startPtr__)) - lexer->lineStart)), \
@@ -0,0 +1,55 @@
+
+#ifndef __SMILE_PARSING_INTERNAL_PARSEARENA_H__
+#define __SMILE_PARSING_INTERNAL_PARSEARENA_H__
+
+#ifndef __SMILE_TYPES_H__
+#include <smile/types.h>
+#endif
+#ifndef __SMILE_GC_H__
+#include <smile/gc.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  Parse arenas.
+
+// How big each block of a parse arena is.  Requests larger than a quarter of this go straight to the GC.
+#define PARSEARENA_BLOCKSIZE	8192
+
+/// <summary>
+/// A bump-pointer arena for the small, short-lived structures the parser creates by the thousands,
+/// like LexerPositions and copies of Tokens.  Allocating from it is just a pointer increment.
+///
+/// The arena's blocks come from the GC heap, and are scanned like any other object, so anything
+/// allocated here may safely contain pointers to GC objects, and may safely outlive the parse
+/// (a pointer to any part of a block keeps the whole block alive).  Nothing is ever freed
+/// individually:  A block is collected once nothing points into it anymore.
+/// </summary>
+typedef struct ParseArenaStruct {
+	Byte *ptr;		// The next free byte in the current block.
+	Byte *end;		// The end of the current block.
+} *ParseArena;
+
+SMILE_API_FUNC void *ParseArena_AllocSlow(ParseArena arena, Int size);
+
+/// <summary>
+/// Allocate zero-filled memory from the given arena.
+/// </summary>
+/// <param name="arena">The arena to allocate from.</param>
+/// <param name="size">The number of bytes to allocate.</param>
+/// <returns>A pointer to the new memory, aligned suitably for any pointer or 64-bit value.</returns>
+Inline void *ParseArena_Alloc(ParseArena arena, Int size)
+{
+	Byte *ptr;
+
+	size = (size + 7) & ~7;
+	if (arena->end - arena->ptr < size)
+		return ParseArena_AllocSlow(arena, size);
+
+	ptr = arena->ptr;
+	arena->ptr = ptr + size;
+	return ptr;
+}
+
+#define PARSEARENA_ALLOC_STRUCT(__arena__, __t__) ((__t__ *)ParseArena_Alloc((__arena__), sizeof(__t__)))
+
+#endif
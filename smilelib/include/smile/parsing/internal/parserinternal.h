@@ -277,4 +277,50 @@ Inline void Parser_EndScope(Parser parser, Bool keepScopeData)
 		ParseScope_Finish(currentScope);
 }
 
+/// <summary>
+/// Get a copy of a token's position that will outlive the token.  This is the parser's
+/// equivalent of Token_GetPosition(), but it allocates from the parser's arena.
+/// </summary>
+/// <param name="parser">The parser whose arena will hold the position.</param>
+/// <param name="token">The token whose position should be copied.</param>
+/// <returns>A copy of the token's position.</returns>
+Inline LexerPosition Parser_GetTokenPosition(Parser parser, Token token)
+{
+	LexerPosition position = PARSEARENA_ALLOC_STRUCT(&parser->arena, struct LexerPositionStruct);
+	MemCpy(position, &token->_position, sizeof(struct LexerPositionStruct));
+	return position;
+}
+
+/// <summary>
+/// Get the source position recorded in a list cell, as a LexerPosition in the parser's arena.
+/// </summary>
+/// <param name="parser">The parser whose arena will hold the position.</param>
+/// <param name="obj">The object (usually a list cell) to get the source position of.</param>
+/// <returns>The object's source position, or NULL if it has none.</returns>
+Inline LexerPosition Parser_GetSourcePosition(Parser parser, SmileObject obj)
+{
+	struct LexerPositionStruct position;
+	LexerPosition result;
+
+	if (SMILE_KIND(obj) != SMILE_KIND_LIST || SmileList_GetSourcePosition((SmileList)obj, &position) == NULL)
+		return NULL;
+
+	result = PARSEARENA_ALLOC_STRUCT(&parser->arena, struct LexerPositionStruct);
+	MemCpy(result, &position, sizeof(struct LexerPositionStruct));
+	return result;
+}
+
+/// <summary>
+/// Make a copy of a token that will outlive the lexer's ring buffer, in the parser's arena.
+/// </summary>
+/// <param name="parser">The parser whose arena will hold the copy.</param>
+/// <param name="token">The token to copy.</param>
+/// <returns>A copy of the token.</returns>
+Inline Token Parser_CloneToken(Parser parser, Token token)
+{
+	Token newToken = PARSEARENA_ALLOC_STRUCT(&parser->arena, struct TokenStruct);
+	MemCpy(newToken, token, sizeof(struct TokenStruct));
+	return newToken;
+}
+
 #endif
@@ -75,6 +75,7 @@ struct ParserSyntaxTableStruct {
 	Int32Dict firstSets;	// Cached FIRST sets for the nonterminals in this table.  Not copied when we fork the table.
 	Int32Dict followSets;	// Cached FOLLOW sets for the nonterminal nodes in this table.  Not copied when we fork the table.
 	Int32Dict transitionTables;	// Cached transition tables for every nonterminal node in this table.  Not copied when we fork the table.
+	Int32Dict derivedTables;	// Tables forked from this one by adding a single rule, keyed by the rule's hash (see ParserSyntaxTable_AddRule).
 		
 	// Special syntax classes, for fast lookup.  These trees correspond to known built-in syntax-production names.
 	ParserSyntaxClass stmtClass;	
@@ -36,6 +36,7 @@ struct LexerPositionStruct {
 	Int32 column;	// The column within that line (note: tabs count as 1 char)
 	Int32 lineStart;	// The offset of the start of this line from the start of the file.
 	Int32 length;	// The length of the span of content, in characters.
+	Int32 fileId;	// The interned ID of the filename (see Lexer_InternFilename()), or 0 if not yet known.
 };
 
 /// <summary>
@@ -82,6 +83,7 @@ struct LexerStruct {
 
 	// The current filename/line number, for computing LexerPositions.
 	String filename;			// The current filename.
+	Int32 fileId;				// The interned ID of the current filename.
 	Int line;					// The current line number.
 
 	// The most-recently-read token, and a stack of previously-read tokens for ungetting.
@@ -100,6 +102,7 @@ struct LexerStruct {
 //  External parts of the implementation
 
 SMILE_API_FUNC Lexer Lexer_Create(String input, Int start, Int length, String filename, Int firstLine, Int firstColumn);
+SMILE_API_FUNC Bool Lexer_Init(Lexer lexer, String input, Int start, Int length, String filename, Int firstLine, Int firstColumn);
 SMILE_API_FUNC Int Lexer_Next(Lexer lexer);
 SMILE_API_FUNC Int Lexer_DecodeEscapeCode(const Byte **input, const Byte *end, Bool allowUnknowns);
 SMILE_API_FUNC LexerPosition Lexer_GetPosition(Lexer lexer);
@@ -107,6 +110,9 @@ SMILE_API_FUNC LexerPosition LexerPosition_Clone(LexerPosition position);
 SMILE_API_FUNC Token Token_Clone(Token token);
 SMILE_API_FUNC Bool LexerPosition_Equals(LexerPosition a, LexerPosition b);
 
+SMILE_API_FUNC Int32 Lexer_InternFilename(String filename);
+SMILE_API_FUNC String Lexer_GetInternedFilename(Int32 fileId);
+
 //-------------------------------------------------------------------------------------------------
 //  Inline parts of the implementation
 
@@ -31,6 +31,9 @@
 #ifndef __SMILE_PARSING_PARSEMESSAGE_H__
 #include <smile/parsing/parsemessage.h>
 #endif
+#ifndef __SMILE_PARSING_INTERNAL_PARSEARENA_H__
+#include <smile/parsing/internal/parsearena.h>
+#endif
 
 //-------------------------------------------------------------------------------------------------
 //  Public type declarations
@@ -56,6 +59,8 @@ struct ParserStruct {
 	Int numExternalVars;					// How many variables to include.
 
 	ParserIncludeLoader includeLoader;		// A function that knows how to load "include files" from disk (or wherever).
+
+	struct ParseArenaStruct arena;			// Where this parse's positions and other small temporaries are allocated.
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -75,6 +75,11 @@ typedef enum {
 
 	// Raw buffer types.
 	SMILE_KIND_BYTEARRAY			= 0x50,
+
+	// Native container types.
+	SMILE_KIND_ARRAY				= 0x60,
+	SMILE_KIND_MAP					= 0x61,
+	SMILE_KIND_SEQUENCE				= 0x62,
 		
 	// Types used for parsing.	
 	SMILE_KIND_SYNTAX				= 0xF0,
@@ -99,6 +104,8 @@ typedef enum {
 		
 	SMILE_FLAG_WITHSOURCE			= (1 << 11),
 	SMILE_FLAG_EXTERNAL_FUNCTION	= (1 << 12),
+	SMILE_FLAG_STRINGCONCAT			= (1 << 13),
+	SMILE_FLAG_STRINGSLICE			= (1 << 14),
 
 } SmileKind;
 
@@ -66,11 +66,16 @@ typedef struct SmileNonterminalInt *SmileNonterminal;
 
 typedef struct SmileByteArrayInt *SmileByteArray;
 
+typedef struct SmileArrayInt *SmileArray;
+typedef struct SmileMapInt *SmileMap;
+typedef struct SmileSequenceInt *SmileSequence;
+
 typedef struct EvalResultStruct *EvalResult;
 typedef struct ClosureInfoStruct *ClosureInfo;
 typedef struct ClosureStruct *Closure;
 typedef struct ByteCodeSegmentStruct *ByteCodeSegment;
 typedef struct ByteCodeStruct *ByteCode;
+typedef struct CompilerStruct *Compiler;
 
 typedef struct ParserStruct *Parser;
 typedef struct ParseScopeStruct *ParseScope;
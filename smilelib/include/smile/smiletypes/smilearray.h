@@ -0,0 +1,71 @@
+
+#ifndef __SMILE_SMILETYPES_SMILEARRAY_H__
+#define __SMILE_SMILETYPES_SMILEARRAY_H__
+
+#ifndef __SMILE_SMILETYPES_PREDECL_H__
+#include <smile/smiletypes/predecl.h>
+#endif
+
+#ifndef __SMILE_SMILETYPES_SMILEOBJECT_H__
+#include <smile/smiletypes/smileobject.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  Type declarations
+
+/// <summary>
+/// An Array is a growable, contiguous vector of SmileArgs.  Unlike a List, each item is
+/// stored in place (unboxed, if it can be), so indexing is O(1) and appending is amortized O(1).
+/// </summary>
+struct SmileArrayInt {
+	DECLARE_BASE_OBJECT_PROPERTIES;
+	Int length;	// The number of items currently in use.
+	Int max;	// The number of items allocated in the 'items' buffer.
+	SmileArg *items;	// The items themselves, stored contiguously.
+};
+
+//-------------------------------------------------------------------------------------------------
+//  Public interface
+
+SMILE_API_DATA SmileVTable SmileArray_VTable;
+
+SMILE_API_FUNC SmileArray SmileArray_Create(SmileObject base, Int capacity);
+SMILE_API_FUNC SmileArray SmileArray_CreateFromArgs(SmileObject base, const SmileArg *args, Int count);
+SMILE_API_FUNC SmileArray SmileArray_CreateFromList(SmileObject base, SmileList list);
+SMILE_API_FUNC SmileList SmileArray_ToList(SmileArray array);
+SMILE_API_FUNC void SmileArray_EnsureCapacity(SmileArray array, Int capacity);
+SMILE_API_FUNC void SmileArray_Resize(SmileArray array, Int length);
+
+//-------------------------------------------------------------------------------------------------
+//  Inline operations
+
+/// <summary>
+/// Append a single item to the end of the array, growing it if necessary.  This runs in
+/// amortized O(1) time.
+/// </summary>
+/// <param name="array">The array to append to.</param>
+/// <param name="item">The item to append.</param>
+Inline void SmileArray_Append(SmileArray array, SmileArg item)
+{
+	if (array->length >= array->max)
+		SmileArray_EnsureCapacity(array, array->length + 1);
+	array->items[array->length++] = item;
+}
+
+/// <summary>
+/// Retrieve the item at the given index of the array.  The index is not range-checked.
+/// </summary>
+Inline SmileArg SmileArray_Get(SmileArray array, Int index)
+{
+	return array->items[index];
+}
+
+/// <summary>
+/// Replace the item at the given index of the array.  The index is not range-checked.
+/// </summary>
+Inline void SmileArray_Set(SmileArray array, Int index, SmileArg item)
+{
+	array->items[index] = item;
+}
+
+#endif
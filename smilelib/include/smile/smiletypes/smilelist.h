@@ -27,11 +27,20 @@ struct SmileListInt {
 	SmileObject d;
 };
 
+/// <summary>
+/// A list cell that also records where in the source code it came from.  The position is
+/// packed inline as a compact (file, line, column) tuple rather than pointing to a separate
+/// LexerPosition, since the parser creates one of these for nearly every cell of code:  This
+/// makes it the same size on the heap as a plain list cell plus a position pointer, with no
+/// second object to allocate or to keep alive.
+/// </summary>
 struct SmileListWithSourceInt {
 	DECLARE_BASE_OBJECT_PROPERTIES;
 	SmileObject a;
 	SmileObject d;
-	LexerPosition position;
+	Int32 fileId;	// The interned filename (see Lexer_InternFilename()), or -1 if there is no position.
+	Int32 line;		// The line on which this cell's source begins.
+	Int32 column;	// The column within that line.
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -54,6 +63,7 @@ SMILE_API_FUNC Bool SmileList_IsWellFormed(SmileObject probableList);
 SMILE_API_FUNC Bool SmileList_HasCycle(SmileObject probableList);
 SMILE_API_FUNC String SmileList_Join(SmileList list, String glue);
 SMILE_API_FUNC SmileList SmileList_Sort(SmileList list, Int (*cmp)(SmileObject a, SmileObject b, void *param), void *param);
+SMILE_API_FUNC Bool SmileList_TryNativeSort(SmileList list, SmileList *result);
 SMILE_API_FUNC SmileList SmileList_CloneRange(SmileList list, Int start, Int end, SmileList *newTail);
 SMILE_API_FUNC SmileList SmileList_CellAt(SmileList list, Int index);
 SMILE_API_FUNC SmileList SmileList_ApplyStepping(SmileList list, Int stepping);
@@ -106,6 +116,33 @@ Inline Bool SmileObject_IsCallToPattern(SmileObject pattern, SmileObject obj)
 	return SmileObject_DeepCompare(pattern, ((SmileList)obj)->a);
 }
 
+/// <summary>
+/// Copy the source position recorded in a list cell out to the given position object.  Since
+/// list cells don't store a position's line start or length, those will be zero.
+/// </summary>
+/// <param name="list">The list cell to get the source position of.</param>
+/// <param name="position">The position object to fill in.</param>
+/// <returns>The given position object, or NULL if the list cell has no source position.</returns>
+Inline LexerPosition SmileList_GetSourcePosition(SmileList list, LexerPosition position)
+{
+	struct SmileListWithSourceInt *listWithSource;
+
+	if (!(list->kind & SMILE_FLAG_WITHSOURCE))
+		return NULL;
+
+	listWithSource = (struct SmileListWithSourceInt *)list;
+	if (listWithSource->fileId < 0)
+		return NULL;
+
+	position->filename = Lexer_GetInternedFilename(listWithSource->fileId);
+	position->fileId = listWithSource->fileId;
+	position->line = listWithSource->line;
+	position->column = listWithSource->column;
+	position->lineStart = 0;
+	position->length = 0;
+	return position;
+}
+
 Inline SmileList SmileList_Rest(SmileList list)
 {
 	SmileObject d = list->d;
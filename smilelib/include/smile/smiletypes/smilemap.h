@@ -0,0 +1,72 @@
+
+#ifndef __SMILE_SMILETYPES_SMILEMAP_H__
+#define __SMILE_SMILETYPES_SMILEMAP_H__
+
+#ifndef __SMILE_SMILETYPES_PREDECL_H__
+#include <smile/smiletypes/predecl.h>
+#endif
+
+#ifndef __SMILE_SMILETYPES_SMILEOBJECT_H__
+#include <smile/smiletypes/smileobject.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  Type declarations
+
+/// <summary>
+/// A single node (key/value pair) within a Map.  Free nodes have a NULL key object.
+/// </summary>
+struct SmileMapNode {
+	Int32 next;					// The next node in this bucket (relative to the Map's heap).
+	UInt32 hash;				// The cached hash code of the key.
+	SmileArg key;				// The key for this node (unboxed, if it can be).
+	SmileArg value;				// The value for this node (unboxed, if it can be).
+};
+
+/// <summary>
+/// A Map is a hash table keyed by arbitrary Smile values.  It uses the same bucket-and-heap
+/// layout as the C dictionaries, with the key's hash code cached in each node.  Integer64,
+/// Symbol, and String keys are hashed and compared directly, without virtual calls.
+/// </summary>
+struct SmileMapInt {
+	DECLARE_BASE_OBJECT_PROPERTIES;
+	Int32 *buckets;				// The buckets contain indexes into the heap, indexed by masked hash code.
+	struct SmileMapNode *heap;	// The heap, which holds all of the key/value pairs as nodes.
+	Int32 mask;					// The current size of both the heap and buckets.  Always equal to 2^n - 1 for some n.
+	Int32 firstFree;			// The first free node in the heap (successive free nodes follow the 'next' pointers).
+	Int32 count;				// The number of allocated nodes in the heap.
+	Int32 keyKind;				// If nonzero, the only kind of key this Map accepts (StringMap, SymbolMap, etc.).
+};
+
+//-------------------------------------------------------------------------------------------------
+//  Public interface
+
+SMILE_API_DATA SmileVTable SmileMap_VTable;
+
+SMILE_API_FUNC SmileMap SmileMap_Create(SmileObject base, Int keyKind);
+SMILE_API_FUNC SmileMap SmileMap_CreateWithSize(SmileObject base, Int keyKind, Int32 newSize);
+SMILE_API_FUNC SmileMap SmileMap_Clone(SmileMap map);
+SMILE_API_FUNC Bool SmileMap_TryGetValue(SmileMap map, SmileArg key, SmileArg *value);
+SMILE_API_FUNC void SmileMap_SetValue(SmileMap map, SmileArg key, SmileArg value);
+SMILE_API_FUNC Bool SmileMap_Remove(SmileMap map, SmileArg key);
+SMILE_API_FUNC SmileList SmileMap_GetKeys(SmileMap map);
+SMILE_API_FUNC SmileList SmileMap_GetValues(SmileMap map);
+
+/// <summary>
+/// Get the number of key/value pairs in the Map.
+/// </summary>
+Inline Int32 SmileMap_Count(SmileMap map)
+{
+	return map->count;
+}
+
+/// <summary>
+/// Determine if the given key exists in the Map.
+/// </summary>
+Inline Bool SmileMap_ContainsKey(SmileMap map, SmileArg key)
+{
+	SmileArg value;
+	return SmileMap_TryGetValue(map, key, &value);
+}
+
+#endif
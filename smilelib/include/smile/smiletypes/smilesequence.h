@@ -0,0 +1,59 @@
+
+#ifndef __SMILE_SMILETYPES_SMILESEQUENCE_H__
+#define __SMILE_SMILETYPES_SMILESEQUENCE_H__
+
+#ifndef __SMILE_SMILETYPES_PREDECL_H__
+#include <smile/smiletypes/predecl.h>
+#endif
+
+#ifndef __SMILE_SMILETYPES_SMILEOBJECT_H__
+#include <smile/smiletypes/smileobject.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  Type declarations
+
+/// <summary>
+/// The kinds of deferred stages that can be attached to a Sequence.
+/// </summary>
+typedef enum {
+	SMILE_SEQUENCE_STAGE_MAP,		// Replace each item with the result of calling 'function' on it.
+	SMILE_SEQUENCE_STAGE_WHERE,		// Keep only the items for which 'function' returns a truthy value.
+	SMILE_SEQUENCE_STAGE_EACH,		// Call 'function' on each item for its side effects, and keep the item.
+	SMILE_SEQUENCE_STAGE_TAKE,		// Keep only the first 'count' items, and then stop.
+	SMILE_SEQUENCE_STAGE_SKIP,		// Discard the first 'count' items.
+} SmileSequenceStageKind;
+
+/// <summary>
+/// A single deferred stage of a Sequence's pipeline.
+/// </summary>
+struct SmileSequenceStage {
+	Int32 kind;					// What kind of stage this is (a SmileSequenceStageKind).
+	Bool withIndex;				// Whether 'function' wants the index of the item as a second argument.
+	SmileFunction function;		// The user's function, for map/where/each stages.
+	Int64 count;				// The number of items, for take/skip stages.
+};
+
+/// <summary>
+/// A Sequence is a lazy view of a List or an Array.  Calling 'map', 'where', 'take', or 'skip' on
+/// a Sequence doesn't run anything; it returns a new Sequence with one more deferred stage.
+/// Only a terminal operation like 'count', 'first', or 'list' actually walks the source, and
+/// it pushes each item through every stage in turn before fetching the next, so no intermediate
+/// lists are ever built, and it stops pulling items as soon as the answer is known.
+/// </summary>
+struct SmileSequenceInt {
+	DECLARE_BASE_OBJECT_PROPERTIES;
+	SmileObject source;					// The List or Array that the items come from.
+	struct SmileSequenceStage *stages;	// The deferred stages, in the order they're applied.  Never modified once shared.
+	Int32 numStages;					// The number of deferred stages.
+};
+
+//-------------------------------------------------------------------------------------------------
+//  Public interface
+
+SMILE_API_DATA SmileVTable SmileSequence_VTable;
+
+SMILE_API_FUNC SmileSequence SmileSequence_Create(SmileObject source);
+SMILE_API_FUNC SmileSequence SmileSequence_AddStage(SmileSequence sequence, Int32 kind, SmileFunction function, Int64 count);
+
+#endif
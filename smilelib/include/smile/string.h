@@ -44,7 +44,8 @@ struct StringStruct {
 
 	struct {
 		Int length;	// The length of the text array (in bytes, not Unicode code points).
-		Byte text[65536];	// The actual bytes of the string (nul-terminated).  Not actually an array of 65536 bytes, either.
+		Byte *text;	// A pointer to the actual bytes of the string, or NULL for a concatenation that has not yet been flattened.
+		Byte data[65536];	// The bytes of the string, for ordinary strings (nul-terminated).  Not actually an array of 65536 bytes, either.
 	} _opaque;
 };
 
@@ -66,6 +67,21 @@ enum StringWildcardOptions {
 	StringWildcardOptions_CaseInsensitive = (1 << 2),
 };
 
+/// <summary>
+/// A search pattern that has been prepared once for fast, repeated case-insensitive searching.
+/// Patterns that are pure ASCII are stored pre-folded, so searches can compare them directly
+/// against the text without consulting the Unicode case-folding tables; other patterns fall
+/// back to the full Unicode case-folding comparison.
+/// </summary>
+typedef struct StringPatternIStruct {
+	String pattern;	// The original (unfolded) pattern.
+	const Byte *text;	// The bytes of the pattern to compare against (lowercase, if 'isFolded' is set).
+	Bool isAscii;	// Whether the pattern consists only of 7-bit ASCII bytes.
+	Bool isFolded;	// Whether 'text' has already been case-folded.
+	Byte firstLower;	// The first byte of the pattern in lowercase, if it is pure ASCII.
+	Byte firstUpper;	// The first byte of the pattern in uppercase, if it is pure ASCII.
+} *StringPatternI;
+
 //-------------------------------------------------------------------------------------------------
 //  Special common preallocated strings (static, not on the heap).
 
@@ -153,8 +169,11 @@ SMILE_API_FUNC Int String_CompareRange(const String a, Int astart, Int alength,
 
 SMILE_API_FUNC String String_SubstringAt(const String str, Int start);
 SMILE_API_FUNC String String_Substring(const String str, Int start, Int length);
+SMILE_API_FUNC String String_SubstringShared(const String str, Int start, Int length);
 SMILE_API_FUNC String String_SubstringByRange(const String str, Int64 start, Int64 end, Int64 step);
 SMILE_API_FUNC String String_Concat(const String str, const String other);
+SMILE_API_FUNC const Byte *String_FlattenConcat(const String str);
+SMILE_API_FUNC const char *String_TerminateSlice(const String str);
 SMILE_API_FUNC String String_ConcatByte(const String str, Byte ch);
 
 SMILE_API_FUNC Int String_IndexOf(const String str, const String pattern, Int start);
@@ -250,6 +269,11 @@ SMILE_API_FUNC Int String_CountOfI(const String str, const String pattern);
 SMILE_API_FUNC String String_ReplaceI(const String str, const String pattern, const String replacement);
 SMILE_API_FUNC String String_ReplaceWithLimitI(const String str, const String pattern, const String replacement, Int limit);
 
+SMILE_API_FUNC StringPatternI StringPatternI_Create(const String pattern);
+SMILE_API_FUNC void StringPatternI_Init(StringPatternI stringPattern, const String pattern);
+SMILE_API_FUNC Int StringPatternI_IndexOf(const StringPatternI stringPattern, const String str, Int start);
+SMILE_API_FUNC Int StringPatternI_CountOf(const StringPatternI stringPattern, const String str);
+
 SMILE_API_FUNC String String_ToLowerRange(const String str, Int start, Int length);
 SMILE_API_FUNC String String_ToTitleRange(const String str, Int start, Int length);
 SMILE_API_FUNC String String_ToUpperRange(const String str, Int start, Int length);
@@ -325,47 +349,56 @@ SMILE_API_DATA struct String_VTableInt String_VTableData;
 // Foreign reference to String's base object so that we can statically instantiate strings.
 SMILE_API_DATA struct SmileUserObjectInt String_BaseObjectStruct;
 
+/// <summary>
+/// Get the length of the given string, in bytes.
+/// </summary>
+/// <param name="str">The string to obtain the length of.</param>
+/// <returns>The length of that string.</returns>
+#define String_Length(__str__) \
+	((const Int)(__str__)->_opaque.length)
+
 /// <summary>
 /// Retrieve a byte from the string at the given index.  The index must
 /// be valid, or you may read past the end of the string.
 /// </summary>
-/// <param name="__str__">The string to read one byte from.</param>
-/// <param name="__index__">The index within that string of the byte to read.</param>
+/// <param name="str">The string to read one byte from.</param>
+/// <param name="index">The index within that string of the byte to read.</param>
 /// <returns>The byte at the given index.</returns>
-#define String_At(__str__, __index__) \
-	((const Byte)(__str__)->_opaque.text[(__index__)])
+Inline Byte String_At(const String str, Int index)
+{
+	return (str->_opaque.text != NULL ? str->_opaque.text : String_FlattenConcat(str))[index];
+}
 
 /// <summary>
 /// Retrieve a pointer to the underlying byte array in the string.  Note that strings
 /// are immutable, so you should *not* change any data found at this pointer or you
-/// risk dangerous side-effects!  The bytes will be nul-terminated (a C-compatible string),
-/// but may legally contain nul (zero) values within them; you should use String_Length()
-/// to get the actual length of the string.
+/// risk dangerous side-effects!  The bytes may legally contain nul (zero) values within
+/// them; you should use String_Length() to get the actual length of the string.  Long
+/// substrings share their parent string's bytes, so the bytes are not guaranteed to be
+/// nul-terminated; use String_ToC() if you need a C-compatible string.
 /// </summary>
-/// <param name="__str__">The string to obtain the raw bytes of.</param>
+/// <param name="str">The string to obtain the raw bytes of.</param>
 /// <returns>The raw bytes of the string.</returns>
-#define String_GetBytes(__str__) \
-	((const Byte *)(__str__)->_opaque.text)
+Inline const Byte *String_GetBytes(const String str)
+{
+	return str->_opaque.text != NULL ? str->_opaque.text : String_FlattenConcat(str);
+}
 
 /// <summary>
 /// Retrieve a pointer to the underlying byte array in the string.  Note that strings
 /// are immutable, so you should *not* change any data found at this pointer or you
 /// risk dangerous side-effects!  The bytes will be nul-terminated (a C-compatible string),
 /// but may legally contain nul (zero) values within them; you should use String_Length()
-/// to get the actual length of the string.
+/// to get the actual length of the string.  A long substring that shares its parent's bytes
+/// has no terminator of its own, so for one of those, this returns a new copy of its bytes.
 /// </summary>
-/// <param name="__str__">The string to obtain the raw bytes of.</param>
+/// <param name="str">The string to obtain the raw bytes of.</param>
 /// <returns>The raw bytes of the string.</returns>
-#define String_ToC(__str__) \
-	((const char *)(__str__)->_opaque.text)
-
-/// <summary>
-/// Get the length of the given string, in bytes.
-/// </summary>
-/// <param name="str">The string to obtain the length of.</param>
-/// <returns>The length of that string.</returns>
-#define String_Length(__str__) \
-	((const Int)(__str__)->_opaque.length)
+Inline const char *String_ToC(const String str)
+{
+	const Byte *text = String_GetBytes(str);
+	return text[String_Length(str)] == '\0' ? (const char *)text : String_TerminateSlice(str);
+}
 
 /// <summary>
 /// Create a String instance from a C-style (nul-terminated) string.
@@ -395,7 +428,7 @@ Inline Bool String_IsNullOrEmpty(const String str)
 /// <returns>A reasonably-unique hash value for that string.</returns>
 Inline UInt32 String_Hash(const String str)
 {
-	return Smile_Hash(str->_opaque.text, String_Length(str));
+	return Smile_Hash(String_GetBytes(str), String_Length(str));
 }
 
 /// <summary>
@@ -416,7 +449,7 @@ Inline UInt32 String_HashInternal(const Byte *text, Int length)
 /// <returns>A reasonably-unique hash value for that string.</returns>
 Inline UInt64 String_Hash64(const String str)
 {
-	return Smile_Hash64(str->_opaque.text, String_Length(str));
+	return Smile_Hash64(String_GetBytes(str), String_Length(str));
 }
 
 /// <summary>
@@ -561,6 +594,17 @@ Inline Int String_CompareI(const String a, const String b)
 	return String_CompareRangeI(a, 0, String_Length(a), b, 0, String_Length(b), &usedSlowConversion);
 }
 
+/// <summary>
+/// Search through the given string looking for a prepared case-insensitive pattern.
+/// </summary>
+/// <param name="stringPattern">The prepared pattern to search for.</param>
+/// <param name="str">The string to search through.</param>
+/// <returns>True if any part of the string matches the pattern, case-insensitive; False if no part of the string matches the pattern.</returns>
+Inline Bool StringPatternI_Contains(const StringPatternI stringPattern, const String str)
+{
+	return String_Length(stringPattern->pattern) <= String_Length(str) && StringPatternI_IndexOf(stringPattern, str, 0) >= 0;
+}
+
 /// <summary>
 /// Split a string by a given pattern string.
 /// </summary>
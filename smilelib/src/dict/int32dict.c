@@ -22,6 +22,11 @@
 #include <smile/bittwiddling.h>
 #include <smile/dict/int32dict.h>
 
+/// <summary>
+/// The buckets of every small dictionary:  A single bucket that is always empty.
+/// </summary>
+Int32 Int32Dict_SmallBuckets[1] = { -1 };
+
 //-------------------------------------------------------------------------------------------------
 //  Private functions
 
@@ -91,6 +96,26 @@ static void Int32DictInt_Resize(struct Int32DictInt *self, Int32 newLen)
 	newHeap[i].value = NULL;
 }
 
+/// <summary>
+/// Move a full small dictionary's inline pairs out into a freshly-allocated hashed form.
+/// </summary>
+static void Int32DictInt_Promote(struct Int32DictInt *self)
+{
+	Int32 keys[INT32DICT_SMALL_SIZE];
+	void *values[INT32DICT_SMALL_SIZE];
+	Int32 i, count;
+
+	count = self->count;
+	MemCpy(keys, self->smallKeys, sizeof(Int32) * count);
+	MemCpy(values, self->smallValues, sizeof(void *) * count);
+
+	Int32Dict_ClearWithSize((Int32Dict)self, INT32DICT_SMALL_SIZE * 2);
+
+	for (i = 0; i < count; i++) {
+		Int32DictInt_Append(self, keys[i], values[i]);
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 //  Semi-Private interface
 
@@ -106,6 +131,16 @@ Int32 Int32DictInt_Append(struct Int32DictInt *self, Int32 key, const void *valu
 	struct Int32DictNode *heap;
 	Int32 nodeIndex, bucketIndex;
 
+	if (self->heap == NULL) {
+		if (self->count < INT32DICT_SMALL_SIZE) {
+			self->smallKeys[self->count] = key;
+			self->smallValues[self->count] = (void *)value;
+			self->smallFilter |= (UInt32)1 << (key & 31);
+			return self->count++;
+		}
+		Int32DictInt_Promote(self);
+	}
+
 	if (self->firstFree < 0) {
 		Int32DictInt_Resize(self, (self->mask + 1) * 2);
 	}
@@ -150,11 +185,24 @@ Int32Dict Int32Dict_Clone(Int32Dict intDict, Int32Dict_ValueCloner valueCloner,
 	newIntDict = GC_MALLOC_STRUCT(struct Int32DictInt);
 	if (newIntDict == NULL) Smile_Abort_OutOfMemory();
 
+	if (oldIntDict->heap == NULL) {
+		MemCpy(newIntDict, oldIntDict, sizeof(struct Int32DictInt));
+		if (valueCloner != NULL) {
+			for (nodeIndex = 0; nodeIndex < oldIntDict->count; nodeIndex++) {
+				newIntDict->smallValues[nodeIndex] = valueCloner(oldIntDict->smallKeys[nodeIndex], oldIntDict->smallValues[nodeIndex], param);
+			}
+		}
+		return (Int32Dict)newIntDict;
+	}
+
 	newSize = oldIntDict->mask + 1;
 
 	newIntDict->count = oldIntDict->count;
 	newIntDict->firstFree = oldIntDict->firstFree;
 	newIntDict->mask = oldIntDict->mask;
+	newIntDict->smallFilter = 0;
+	MemZero(newIntDict->smallKeys, sizeof(newIntDict->smallKeys));
+	MemZero(newIntDict->smallValues, sizeof(newIntDict->smallValues));
 
 	newIntDict->buckets = buckets = (Int32 *)GC_MALLOC_ATOMIC(sizeof(Int32) * newSize);
 	if (buckets == NULL) Smile_Abort_OutOfMemory();
@@ -220,6 +268,12 @@ Int32DictKeyValuePair Int32Dict_GetFirst(Int32Dict intDict)
 
 	self = (struct Int32DictInt *)intDict;
 
+	if (self->heap == NULL) {
+		result.key = self->count > 0 ? self->smallKeys[0] : 0;
+		result.value = self->count > 0 ? self->smallValues[0] : NULL;
+		return result;
+	}
+
 	buckets = self->buckets;
 	heap = self->heap;
 
@@ -258,6 +312,14 @@ Int32DictKeyValuePair *Int32Dict_GetAll(Int32Dict intDict)
 	pairs = GC_MALLOC_STRUCT_ARRAY(Int32DictKeyValuePair, self->count);
 	if (pairs == NULL) Smile_Abort_OutOfMemory();
 
+	if (self->heap == NULL) {
+		for (nodeIndex = 0; nodeIndex < self->count; nodeIndex++) {
+			pairs[nodeIndex].key = self->smallKeys[nodeIndex];
+			pairs[nodeIndex].value = self->smallValues[nodeIndex];
+		}
+		return pairs;
+	}
+
 	buckets = self->buckets;
 	dest = pairs;
 	heap = self->heap;
@@ -295,6 +357,11 @@ Int32 *Int32Dict_GetKeys(Int32Dict intDict)
 	keys = GC_MALLOC_RAW_ARRAY(Int32, self->count);
 	if (keys == NULL) Smile_Abort_OutOfMemory();
 
+	if (self->heap == NULL) {
+		MemCpy(keys, self->smallKeys, sizeof(Int32) * self->count);
+		return keys;
+	}
+
 	buckets = self->buckets;
 	dest = keys;
 	heap = self->heap;
@@ -330,6 +397,11 @@ void **Int32Dict_GetValues(Int32Dict intDict)
 	values = GC_MALLOC_STRUCT_ARRAY(void *, self->count);
 	if (values == NULL) Smile_Abort_OutOfMemory();
 
+	if (self->heap == NULL) {
+		MemCpy(values, self->smallValues, sizeof(void *) * self->count);
+		return values;
+	}
+
 	buckets = self->buckets;
 	dest = values;
 	heap = self->heap;
@@ -350,7 +422,8 @@ void **Int32Dict_GetValues(Int32Dict intDict)
 /// Delete all key/value pairs in the dictionary, resetting it back to its initial state.
 /// </summary>
 /// <param name="newSize">The new allocation size of the dictionary, which is the number of
-/// items the dictionary can hold without it needing to invoke another reallocation.</param>
+/// items the dictionary can hold without it needing to invoke another reallocation.  Sizes up to
+/// INT32DICT_SMALL_SIZE make the dictionary small again, storing its pairs inline.</param>
 void Int32Dict_ClearWithSize(Int32Dict intDict, Int32 newSize)
 {
 	struct Int32DictInt *self;
@@ -358,19 +431,34 @@ void Int32Dict_ClearWithSize(Int32Dict intDict, Int32 newSize)
 	Int32 *buckets;
 	Int32 i;
 
+	self = (struct Int32DictInt *)intDict;
+
+	// Clear the inline arrays, either for reuse or so they don't hold stale pointers.
+	MemZero(self->smallKeys, sizeof(self->smallKeys));
+	MemZero(self->smallValues, sizeof(self->smallValues));
+
+	if (newSize <= INT32DICT_SMALL_SIZE) {
+		self->buckets = Int32Dict_SmallBuckets;
+		self->heap = NULL;
+		self->mask = 0;
+		self->firstFree = -1;
+		self->count = 0;
+		self->smallFilter = 0;
+		return;
+	}
+
 	if (newSize < 0x10) newSize = 0x10;
 	if (newSize > 0x1000000) newSize = 0x1000000;
 
 	newSize = NextPowerOfTwo32(newSize);
 
-	self = (struct Int32DictInt *)intDict;
-
 	self->buckets = buckets = GC_MALLOC_RAW_ARRAY(Int32, newSize);
 	if (buckets == NULL) Smile_Abort_OutOfMemory();
 	self->heap = heap = GC_MALLOC_STRUCT_ARRAY(struct Int32DictNode, newSize);
 	if (heap == NULL) Smile_Abort_OutOfMemory();
 	self->firstFree = 0;
 	self->count = 0;
+	self->smallFilter = 0;
 	self->mask = newSize - 1;
 
 	for (i = 0; i < newSize; i++) {
@@ -403,6 +491,21 @@ Bool Int32Dict_Remove(Int32Dict intDict, Int32 key)
 	Int32 mask;
 
 	self = (struct Int32DictInt *)intDict;
+
+	if (self->heap == NULL) {
+		// Fill the hole with the last pair, since order doesn't matter.
+		if ((nodeIndex = Int32DictInt_FindSmall(self, key)) < 0)
+			return False;
+		prevIndex = --self->count;
+		self->smallKeys[nodeIndex] = self->smallKeys[prevIndex];
+		self->smallValues[nodeIndex] = self->smallValues[prevIndex];
+		self->smallKeys[prevIndex] = 0;
+		self->smallValues[prevIndex] = NULL;
+		for (self->smallFilter = 0, nodeIndex = 0; nodeIndex < self->count; nodeIndex++)
+			self->smallFilter |= (UInt32)1 << (self->smallKeys[nodeIndex] & 31);
+		return True;
+	}
+
 	heap = self->heap;
 	buckets = self->buckets;
 
@@ -462,6 +565,16 @@ SMILE_API_FUNC DictStats Int32Dict_ComputeStats(Int32Dict intDict)
 	stats->bucketStats = SimpleStats_Create();
 	stats->keyStats = SimpleStats_Create();
 
+	if (heap == NULL) {
+		// A small dictionary is one "bucket" that is searched linearly.
+		stats->heapTotal = INT32DICT_SMALL_SIZE;
+		stats->heapFree = INT32DICT_SMALL_SIZE - self->count;
+		SimpleStats_Add(stats->bucketStats, self->count);
+		for (nodeIndex = 0; nodeIndex < self->count; nodeIndex++)
+			SimpleStats_Add(stats->keyStats, 1);
+		return stats;
+	}
+
 	for (bucketIndex = 0; bucketIndex <= self->mask; bucketIndex++) {
 		numInThisBucket = 0;
 		for (nodeIndex = buckets[bucketIndex]; nodeIndex >= 0; nodeIndex = heap[nodeIndex].next) {
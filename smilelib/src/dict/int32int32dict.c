@@ -40,7 +40,7 @@ static void Int32Int32DictInt_Resize(struct Int32Int32DictInt *self, Int32 newLe
 	if ((PtrInt)newLen > PtrIntMax / sizeof(struct Int32Int32DictNode)) Smile_Abort_OutOfMemory();
 	newBuckets = GC_MALLOC_RAW_ARRAY(Int32, newLen);
 	if (newBuckets == NULL) Smile_Abort_OutOfMemory();
-	newHeap = GC_MALLOC_STRUCT_ARRAY(struct Int32Int32DictNode, newLen);
+	newHeap = GC_MALLOC_RAW_ARRAY(struct Int32Int32DictNode, newLen);
 	if (newHeap == NULL) Smile_Abort_OutOfMemory();
 
 	// The new buckets start out empty.  This runs in O(n) time.
@@ -145,7 +145,7 @@ Int32Int32DictKeyValuePair *Int32Int32Dict_GetAll(Int32Int32Dict intDict)
 	
 	self = (struct Int32Int32DictInt *)intDict;
 
-	pairs = GC_MALLOC_STRUCT_ARRAY(Int32Int32DictKeyValuePair, self->count);
+	pairs = GC_MALLOC_RAW_ARRAY(Int32Int32DictKeyValuePair, self->count);
 	if (pairs == NULL) Smile_Abort_OutOfMemory();
 
 	buckets = self->buckets;
@@ -217,7 +217,7 @@ Int32 *Int32Int32Dict_GetValues(Int32Int32Dict intDict)
 
 	self = (struct Int32Int32DictInt *)intDict;
 
-	values = GC_MALLOC_STRUCT_ARRAY(Int32, self->count);
+	values = GC_MALLOC_RAW_ARRAY(Int32, self->count);
 	if (values == NULL) Smile_Abort_OutOfMemory();
 
 	buckets = self->buckets;
@@ -257,7 +257,7 @@ void Int32Int32Dict_ClearWithSize(Int32Int32Dict intDict, Int32 newSize)
 
 	self->buckets = buckets = GC_MALLOC_RAW_ARRAY(Int32, newSize);
 	if (buckets == NULL) Smile_Abort_OutOfMemory();
-	self->heap = heap = GC_MALLOC_STRUCT_ARRAY(struct Int32Int32DictNode, newSize);
+	self->heap = heap = GC_MALLOC_RAW_ARRAY(struct Int32Int32DictNode, newSize);
 	if (heap == NULL) Smile_Abort_OutOfMemory();
 	self->firstFree = 0;
 	self->count = 0;
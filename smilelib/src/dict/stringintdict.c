@@ -224,7 +224,7 @@ Int *StringIntDict_GetValues(StringIntDict stringDict)
 
 	self = (struct StringIntDictInt *)stringDict;
 
-	values = GC_MALLOC_STRUCT_ARRAY(Int, self->count);
+	values = GC_MALLOC_RAW_ARRAY(Int, self->count);
 	if (values == NULL) Smile_Abort_OutOfMemory();
 
 	buckets = self->buckets;
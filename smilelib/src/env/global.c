@@ -66,13 +66,20 @@ void Smile_InitCommonGlobals(ClosureInfo globalClosureInfo)
 
 	DeclareCommonGlobal(Smile_KnownSymbols.Enumerable_,			Smile_KnownBases.Enumerable);
 	DeclareCommonGlobal(Smile_KnownSymbols.List_,				Smile_KnownBases.List);
+	DeclareCommonGlobal(Smile_KnownSymbols.Sequence_,			Smile_KnownBases.Sequence);
 	DeclareCommonGlobal(Smile_KnownSymbols.String_,				Smile_KnownBases.String);
 	DeclareCommonGlobal(Smile_KnownSymbols.ArrayBase_,			Smile_KnownBases.ArrayBase);
 	DeclareCommonGlobal(Smile_KnownSymbols.Array_,				Smile_KnownBases.Array);
+	DeclareCommonGlobal(Smile_KnownSymbols.MapBase_,			Smile_KnownBases.MapBase);
+	DeclareCommonGlobal(Smile_KnownSymbols.Map_,				Smile_KnownBases.Map);
+	DeclareCommonGlobal(Smile_KnownSymbols.StringMap_,			Smile_KnownBases.StringMap);
+	DeclareCommonGlobal(Smile_KnownSymbols.SymbolMap_,			Smile_KnownBases.SymbolMap);
+	DeclareCommonGlobal(Smile_KnownSymbols.Integer64Map_,		Smile_KnownBases.Integer64Map);
 	DeclareCommonGlobal(Smile_KnownSymbols.Fn_,					Smile_KnownBases.Fn);
 	DeclareCommonGlobal(Smile_KnownSymbols.Bool_,				Smile_KnownBases.Bool);
 	DeclareCommonGlobal(Smile_KnownSymbols.Symbol_,				Smile_KnownBases.Symbol);
 	DeclareCommonGlobal(Smile_KnownSymbols.Exception_,			Smile_KnownBases.Exception);
+	DeclareCommonGlobal(Smile_KnownSymbols.Runtime_,			Smile_KnownBases.Runtime);
 
 	DeclareCommonGlobal(Smile_KnownSymbols.Range_,				Smile_KnownBases.Range);
 	DeclareCommonGlobal(Smile_KnownSymbols.CharRange_,			Smile_KnownBases.CharRange);
@@ -274,13 +281,44 @@ SmileObject Smile_ParseInScope(String text, String filename,
 	return result;
 }
 
-// Helper function for Smile_EvalInScope().
+// Helper function for Smile_EvalInScope() and Smile_EvalIncrementally().
 static Bool DeclareVariableForCompiler(VarInfo varInfo, void *param)
 {
 	CompileScope_DefineSymbol((CompileScope)param, varInfo->symbol, PARSEDECL_GLOBAL, 0);
 	return True;
 }
 
+// Helper function for Smile_EvalInScope() and Smile_EvalIncrementally():  Either report the
+// compiler's errors, or run the global function it produced.
+static EvalResult RunCompiledGlobal(Compiler compiler, UserFunctionInfo globalFunction)
+{
+	EvalResult result;
+
+	// If the compile failed, stop now.
+	if (compiler->firstMessage != NullList) {
+		SmileList parseMessage;
+		Int index;
+
+		result = EvalResult_Create(EVAL_RESULT_PARSEERRORS);
+		result->numMessages = SmileList_Length(compiler->firstMessage);
+		result->parseMessages = GC_MALLOC_STRUCT_ARRAY(ParseMessage, result->numMessages);
+		if (result->parseMessages == NULL)
+			Smile_Abort_OutOfMemory();
+
+		index = 0;
+		for (parseMessage = compiler->firstMessage; SMILE_KIND(parseMessage) != SMILE_KIND_NULL; parseMessage = LIST_REST(parseMessage)) {
+			result->parseMessages[index++] = (ParseMessage)LIST_FIRST(parseMessage);
+		}
+
+		return result;
+	}
+
+	// Now run the compiled bytecode!
+	result = Eval_Run(globalFunction);
+
+	return result;
+}
+
 /// <summary>
 /// Evaluate the given expression in the given scope.
 /// </summary>
@@ -292,7 +330,6 @@ EvalResult Smile_EvalInScope(ClosureInfo globalClosureInfo, SmileObject expressi
 	Compiler compiler;
 	CompileScope compileScope;
 	UserFunctionInfo globalFunction;
-	EvalResult result;
 
 	// Set up the compiler...
 	compiler = Compiler_Create();
@@ -306,27 +343,59 @@ EvalResult Smile_EvalInScope(ClosureInfo globalClosureInfo, SmileObject expressi
 	globalFunction = Compiler_CompileGlobal(compiler, expression);
 	Compiler_EndScope(compiler);
 
-	// If the compile failed, stop now.
-	if (compiler->firstMessage != NullList) {
-		SmileList parseMessage;
-		Int index;
+	return RunCompiledGlobal(compiler, globalFunction);
+}
 
-		result = EvalResult_Create(EVAL_RESULT_PARSEERRORS);
-		result->numMessages = SmileList_Length(compiler->firstMessage);
-		result->parseMessages = GC_MALLOC_STRUCT_ARRAY(ParseMessage, result->numMessages);
-		if (result->parseMessages == NULL)
-			Smile_Abort_OutOfMemory();
+/// <summary>
+/// Create a compiler that can be handed to Smile_EvalIncrementally() over and over again.  Its
+/// compiled tables are kept for the life of the compiler, so each new expression (like a line
+/// typed into a REPL) becomes one more segment appended to the same strings, objects, and
+/// functions, rather than a whole new set of tables.
+/// </summary>
+/// <param name="globalClosureInfo">The global scope in which expressions will be evaluated.</param>
+/// <returns>A new compiler, ready for incremental use.</returns>
+Compiler Smile_CreateIncrementalCompiler(ClosureInfo globalClosureInfo)
+{
+	Compiler compiler;
 
-		index = 0;
-		for (parseMessage = compiler->firstMessage; SMILE_KIND(parseMessage) != SMILE_KIND_NULL; parseMessage = LIST_REST(parseMessage)) {
-			result->parseMessages[index++] = (ParseMessage)LIST_FIRST(parseMessage);
-		}
+	compiler = Compiler_Create();
+	Compiler_SetGlobalClosureInfo(compiler, globalClosureInfo);
 
-		return result;
+	// The outermost scope is never ended; it lives as long as the compiler does.
+	compiler->globalScope = Compiler_BeginScope(compiler, PARSESCOPE_OUTERMOST);
+
+	return compiler;
+}
+
+/// <summary>
+/// Compile the given expression as a new global function, using (and extending) the tables
+/// of a compiler created by Smile_CreateIncrementalCompiler(), and then evaluate it.
+/// </summary>
+/// <param name="compiler">The incremental compiler to use.</param>
+/// <param name="expression">The expression to evaluate, as a tree of Smile objects.</param>
+/// <returns>The result of evaluating the given expression in the compiler's global scope.</returns>
+EvalResult Smile_EvalIncrementally(Compiler compiler, SmileObject expression)
+{
+	VarDict globals;
+	UserFunctionInfo globalFunction;
+
+	// Discard whatever state the previous expression left behind; a failed compile may
+	// have stopped partway through a nested function or scope.
+	compiler->currentFunction = NULL;
+	compiler->currentScope = compiler->globalScope;
+	compiler->firstMessage = NullList;
+	compiler->lastMessage = NullList;
+
+	// Declare any globals that have appeared since the last expression.  Declaring a symbol
+	// twice is harmless, and an undeclared global still compiles to LdX/StX, so it's enough
+	// to walk the dictionary only when its size has changed.
+	globals = compiler->compiledTables->globalClosureInfo->variableDictionary;
+	if (VarDict_Count(globals) != compiler->numGlobalsDeclared) {
+		VarDict_ForEach(globals, DeclareVariableForCompiler, compiler->globalScope);
+		compiler->numGlobalsDeclared = VarDict_Count(globals);
 	}
 
-	// Now run the compiled bytecode!
-	result = Eval_Run(globalFunction);
+	globalFunction = Compiler_CompileGlobal(compiler, expression);
 
-	return result;
+	return RunCompiledGlobal(compiler, globalFunction);
 }
@@ -172,6 +172,7 @@ static void SetupEnumerableTypes(struct KnownBasesStruct *knownBases)
 	SetupMapTypes(knownBases);
 
 	knownBases->List = SmileUserObject_Create((SmileObject)knownBases->Enumerable, Smile_KnownSymbols.List_);
+	knownBases->Sequence = SmileUserObject_Create((SmileObject)knownBases->Enumerable, Smile_KnownSymbols.Sequence_);
 
 	knownBases->String = &String_BaseObjectStruct;
 	SmileUserObject_Init(&String_BaseObjectStruct, (SmileObject)knownBases->Enumerable, Smile_KnownSymbols.String_);
@@ -186,6 +187,7 @@ static void SetupMiscTypes(struct KnownBasesStruct *knownBases)
 	knownBases->Symbol = SmileUserObject_Create((SmileObject)knownBases->Object, Smile_KnownSymbols.Symbol_);
 	knownBases->Exception = SmileUserObject_Create((SmileObject)knownBases->Object, Smile_KnownSymbols.Exception_);
 	knownBases->Handle = SmileUserObject_Create((SmileObject)knownBases->Object, Smile_KnownSymbols.Handle_);
+	knownBases->Runtime = SmileUserObject_Create((SmileObject)knownBases->Object, Smile_KnownSymbols.Runtime_);
 }
 
 void KnownBases_Preload(struct KnownBasesStruct *knownBases)
@@ -203,6 +205,8 @@ void KnownBases_Preload(struct KnownBasesStruct *knownBases)
 
 extern void SmileByte_Setup(SmileUserObject base);
 extern void SmileByteArray_Setup(SmileUserObject base);
+extern void SmileArray_Setup(SmileUserObject base);
+extern void SmileMap_Setup(SmileUserObject base);
 extern void SmileInteger16_Setup(SmileUserObject base);
 extern void SmileInteger32_Setup(SmileUserObject base);
 extern void SmileInteger64_Setup(SmileUserObject base);
@@ -225,15 +229,23 @@ extern void SmileFloat64Range_Setup(SmileUserObject base);
 extern void SmileFunction_Setup(SmileUserObject base);
 extern void SmileList_Setup(SmileUserObject base);
 extern void SmileObject_Setup(SmileUserObject base);
+extern void SmileSequence_Setup(SmileUserObject base);
 extern void String_Setup(SmileUserObject base);
 
 extern void SmileChar_Setup(SmileUserObject base);
 extern void SmileUni_Setup(SmileUserObject base);
 
+extern void SmileRuntime_Setup(SmileUserObject base);
+
 void KnownBases_Setup(struct KnownBasesStruct *knownBases)
 {
 	SmileByte_Setup(knownBases->Byte);
 	SmileByteArray_Setup(knownBases->ByteArray);
+	SmileArray_Setup(knownBases->Array);
+	SmileMap_Setup(knownBases->Map);
+	SmileMap_Setup(knownBases->StringMap);
+	SmileMap_Setup(knownBases->SymbolMap);
+	SmileMap_Setup(knownBases->Integer64Map);
 	SmileInteger16_Setup(knownBases->Integer16);
 	SmileInteger32_Setup(knownBases->Integer32);
 	SmileInteger64_Setup(knownBases->Integer64);
@@ -245,6 +257,7 @@ void KnownBases_Setup(struct KnownBasesStruct *knownBases)
 	SmileFunction_Setup(knownBases->Fn);
 	SmileList_Setup(knownBases->List);
 	SmileObject_Setup(knownBases->Object);
+	SmileSequence_Setup(knownBases->Sequence);
 	String_Setup(knownBases->String);
 
 	SmileCharRange_Setup(knownBases->CharRange);
@@ -261,6 +274,8 @@ void KnownBases_Setup(struct KnownBasesStruct *knownBases)
 	SmileChar_Setup(knownBases->Char);
 	SmileUni_Setup(knownBases->Uni);
 
+	SmileRuntime_Setup(knownBases->Runtime);
+
 	SmileUnboxedBool_Instance->base = (SmileObject)knownBases->Bool;
 	SmileUnboxedSymbol_Instance->base = (SmileObject)knownBases->Symbol;
 }
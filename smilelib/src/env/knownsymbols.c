@@ -284,7 +284,9 @@ STATIC_STRING(Object_, "Object");
 STATIC_STRING(Program_, "Program");
 STATIC_STRING(Random_, "Random");
 STATIC_STRING(Range_, "Range");
+STATIC_STRING(Runtime_, "Runtime");
 STATIC_STRING(Regex_, "Regex");
+STATIC_STRING(Sequence_, "Sequence");
 STATIC_STRING(String_, "String");
 STATIC_STRING(StringArray_, "StringArray");
 STATIC_STRING(StringMap_, "StringMap");
@@ -393,7 +395,9 @@ static void KnownSymbolsInt_PreloadTypenames(SymbolTable symbolTable, KnownSymbo
 	knownSymbols->Program_ = SymbolTableInt_AddFast(symbolTable, Program_);
 	knownSymbols->Random_ = SymbolTableInt_AddFast(symbolTable, Random_);
 	knownSymbols->Range_ = SymbolTableInt_AddFast(symbolTable, Range_);
+	knownSymbols->Runtime_ = SymbolTableInt_AddFast(symbolTable, Runtime_);
 	knownSymbols->Regex_ = SymbolTableInt_AddFast(symbolTable, Regex_);
+	knownSymbols->Sequence_ = SymbolTableInt_AddFast(symbolTable, Sequence_);
 	knownSymbols->String_ = SymbolTableInt_AddFast(symbolTable, String_);
 	knownSymbols->StringArray_ = SymbolTableInt_AddFast(symbolTable, StringArray_);
 	knownSymbols->StringMap_ = SymbolTableInt_AddFast(symbolTable, StringMap_);
@@ -490,6 +494,7 @@ STATIC_STRING(alpha_q, "alpha?");
 STATIC_STRING(apply, "apply");
 STATIC_STRING(apply_method, "apply-method");
 STATIC_STRING(arguments, "arguments");
+STATIC_STRING(array, "array");
 STATIC_STRING(asin_, "asin");
 STATIC_STRING(assertions, "assertions");
 STATIC_STRING(assigned_name, "assigned-name");
@@ -731,6 +736,7 @@ STATIC_STRING(separator, "separator");
 STATIC_STRING(separator_line, "separator-line");
 STATIC_STRING(separator_paragraph, "separator-paragraph");
 STATIC_STRING(separator_space, "separator-space");
+STATIC_STRING(sequence, "sequence");
 STATIC_STRING(set_object_security, "set-object-security");
 STATIC_STRING(set_once, "set-once");
 STATIC_STRING(set_property, "set-property");
@@ -804,6 +810,7 @@ static void KnownSymbolsInt_PreloadGeneralSymbols(SymbolTable symbolTable, Known
 	knownSymbols->apply = SymbolTableInt_AddFast(symbolTable, apply);
 	knownSymbols->apply_method = SymbolTableInt_AddFast(symbolTable, apply_method);
 	knownSymbols->arguments = SymbolTableInt_AddFast(symbolTable, arguments);
+	knownSymbols->array = SymbolTableInt_AddFast(symbolTable, array);
 	knownSymbols->asin = SymbolTableInt_AddFast(symbolTable, asin_);
 	knownSymbols->assertions = SymbolTableInt_AddFast(symbolTable, assertions);
 	knownSymbols->assigned_name = SymbolTableInt_AddFast(symbolTable, assigned_name);
@@ -1045,6 +1052,7 @@ static void KnownSymbolsInt_PreloadGeneralSymbols(SymbolTable symbolTable, Known
 	knownSymbols->separator_line = SymbolTableInt_AddFast(symbolTable, separator_line);
 	knownSymbols->separator_paragraph = SymbolTableInt_AddFast(symbolTable, separator_paragraph);
 	knownSymbols->separator_space = SymbolTableInt_AddFast(symbolTable, separator_space);
+	knownSymbols->sequence = SymbolTableInt_AddFast(symbolTable, sequence);
 	knownSymbols->set_object_security = SymbolTableInt_AddFast(symbolTable, set_object_security);
 	knownSymbols->set_once = SymbolTableInt_AddFast(symbolTable, set_once);
 	knownSymbols->set_property = SymbolTableInt_AddFast(symbolTable, set_property);
@@ -16,35 +16,141 @@
 //---------------------------------------------------------------------------------------
 
 #include <smile/env/symboltable.h>
+#include <smile/atomic.h>
+
+// The initial number of symbol names and lookup slots.  The known symbols alone need about half
+// of the names, and the lookup is kept at most half full.
+#define INITIAL_SYMBOL_TABLE_SIZE 1024
 
 //-------------------------------------------------------------------------------------------------
 //  Private helper functions
 
 /// <summary>
-/// Add a known-new symbol to the symbol table.
+/// Create a new, empty lookup table with the given number of slots, which must be a power of two.
 /// </summary>
-/// <param name="symbolTable">The symbol table to which the new symbol should be added.</param>
+static struct SymbolTableLookup *SymbolTableLookup_Create(Int size)
+{
+	struct SymbolTableLookup *lookup;
+
+	lookup = GC_MALLOC_STRUCT(struct SymbolTableLookup);
+	if (lookup == NULL) Smile_Abort_OutOfMemory();
+
+	lookup->slots = GC_MALLOC_STRUCT_ARRAY(struct SymbolTableEntry *, size);
+	if (lookup->slots == NULL) Smile_Abort_OutOfMemory();
+	MemZero(lookup->slots, sizeof(struct SymbolTableEntry *) * size);
+
+	lookup->mask = size - 1;
+
+	return lookup;
+}
+
+/// <summary>
+/// Store an entry into the first free slot of its probe sequence, and publish it to readers.
+/// The caller must hold the write lock (or be the only thread that can see the lookup table).
+/// </summary>
+static void SymbolTableLookup_Insert(struct SymbolTableLookup *lookup, struct SymbolTableEntry *entry)
+{
+	Int index;
+
+	for (index = entry->hash & lookup->mask; lookup->slots[index] != NULL; index = (index + 1) & lookup->mask) ;
+
+	Atomic_StorePointer((void **)&lookup->slots[index], entry);
+}
+
+/// <summary>
+/// Find the symbol whose name has the given bytes.  This is lock-free, and safe to call from any
+/// thread at any time, even while another thread is adding symbols.
+/// </summary>
+/// <returns>The symbol, or zero if no symbol has that name.</returns>
+static Symbol SymbolTableInt_Find(struct SymbolTableInt *table, const Byte *text, Int length, UInt32 hash)
+{
+	struct SymbolTableLookup *lookup;
+	struct SymbolTableEntry *entry;
+	Int index;
+
+	lookup = (struct SymbolTableLookup *)Atomic_LoadPointer((const void **)&table->symbolLookup);
+
+	for (index = hash & lookup->mask; ; index = (index + 1) & lookup->mask) {
+		entry = (struct SymbolTableEntry *)Atomic_LoadPointer((const void **)&lookup->slots[index]);
+		if (entry == NULL)
+			return 0;
+		if (entry->hash == hash && String_Length(entry->name) == length
+			&& !MemCmp(String_GetBytes(entry->name), text, length))
+			return entry->symbol;
+	}
+}
+
+/// <summary>
+/// Add a known-new symbol to the symbol table.  The caller must hold the write lock (or be the
+/// only thread that can see the symbol table).
+/// </summary>
+/// <param name="table">The symbol table to which the new symbol should be added.</param>
 /// <param name="name">The name of the new symbol, which must not already exist in the symbol table.</param>
+/// <param name="hash">The hash code of the new symbol's name.</param>
 /// <returns>The new symbol.</returns>
-static Symbol SymbolTableInt_AddSymbol(SymbolTable symbolTable, String name)
+static Symbol SymbolTableInt_AddLocked(struct SymbolTableInt *table, String name, UInt32 hash)
 {
-	struct SymbolTableInt *table = (struct SymbolTableInt *)symbolTable;
+	struct SymbolTableLookup *lookup, *newLookup;
+	struct SymbolTableEntry *entry;
 	Symbol symbol;
 	String *newNames;
-	Int newMax;
+	Int newMax, index;
+
+	symbol = table->count;
 
-	// If we've run out of space for symbols, make more.
-	if (table->count >= table->max) {
+	// If we've run out of space for symbol names, make a bigger copy and publish it.
+	if (symbol >= table->max) {
 		newMax = table->max * 2;
 		newNames = GC_MALLOC_STRUCT_ARRAY(String, newMax);
-		MemCpy(newNames, table->symbolNames, sizeof(String) * table->count);
-		table->symbolNames = newNames;
+		if (newNames == NULL) Smile_Abort_OutOfMemory();
+		MemCpy(newNames, table->symbolNames, sizeof(String) * symbol);
+		Atomic_StorePointer((void **)&table->symbolNames, newNames);
 		table->max = newMax;
 	}
 
-	// Add the symbol to the table, and return it.
-	table->symbolNames[symbol = (Symbol)table->count++] = name;
-	StringIntDict_Add(table->symbolLookup, name, symbol);
+	// Record the name first, and then bump the count, so that by the time anyone can find
+	// this symbol in the lookup, its name is already visible.
+	table->symbolNames[symbol] = name;
+	Atomic_StoreInt32(&table->count, symbol + 1);
+
+	entry = GC_MALLOC_STRUCT(struct SymbolTableEntry);
+	if (entry == NULL) Smile_Abort_OutOfMemory();
+	entry->name = name;
+	entry->hash = hash;
+	entry->symbol = symbol;
+
+	// Keep the lookup at most half full, so probe sequences stay short.
+	lookup = table->symbolLookup;
+	if ((Int)(symbol + 1) * 2 > lookup->mask + 1) {
+		newLookup = SymbolTableLookup_Create((lookup->mask + 1) * 2);
+		for (index = 0; index <= lookup->mask; index++) {
+			if (lookup->slots[index] != NULL)
+				SymbolTableLookup_Insert(newLookup, lookup->slots[index]);
+		}
+		Atomic_StorePointer((void **)&table->symbolLookup, newLookup);
+		lookup = newLookup;
+	}
+
+	SymbolTableLookup_Insert(lookup, entry);
+
+	return symbol;
+}
+
+/// <summary>
+/// Find or add the symbol with the given name.  The lookup is retried once the write lock is
+/// held, since another thread may have added the same name in the meantime.
+/// </summary>
+static Symbol SymbolTableInt_FindOrAdd(struct SymbolTableInt *table, String name, UInt32 hash)
+{
+	Symbol symbol;
+
+	while (!Atomic_CompareAndSwapInt32(&table->writeLock, 0, 1)) ;
+
+	symbol = SymbolTableInt_Find(table, String_GetBytes(name), String_Length(name), hash);
+	if (symbol == 0)
+		symbol = SymbolTableInt_AddLocked(table, name, hash);
+
+	Atomic_StoreInt32(&table->writeLock, 0);
 
 	return symbol;
 }
@@ -63,20 +169,34 @@ SymbolTable SymbolTable_Create(void)
 	table = GC_MALLOC_STRUCT(struct SymbolTableInt);
 	if (table == NULL) Smile_Abort_OutOfMemory();
 
-	table->symbolNames = GC_MALLOC_STRUCT_ARRAY(String, 1024);
+	table->symbolNames = GC_MALLOC_STRUCT_ARRAY(String, INITIAL_SYMBOL_TABLE_SIZE);
 	if (table->symbolNames == NULL) Smile_Abort_OutOfMemory();
 
 	// Symbol zero is always preallocated as the empty string.
 	table->symbolNames[0] = String_Empty;
 
 	table->count = 1;
-	table->max = 1024;
+	table->max = INITIAL_SYMBOL_TABLE_SIZE;
+	table->writeLock = 0;
 
-	table->symbolLookup = StringIntDict_CreateWithSize(1024);
+	table->symbolLookup = SymbolTableLookup_Create(INITIAL_SYMBOL_TABLE_SIZE * 2);
 
 	return (SymbolTable)table;
 }
 
+/// <summary>
+/// Add a known-new symbol to a symbol table that no other thread can see yet.  This is unsafe in
+/// the general case, but safe during the initialization of the symbol table initially.
+/// </summary>
+/// <param name="symbolTable">The symbol table to which the new symbol should be added.</param>
+/// <param name="name">The name of the new symbol, which must not already exist in the symbol table.</param>
+/// <returns>The new symbol.</returns>
+Symbol SymbolTableInt_AddFast(SymbolTable symbolTable, String name)
+{
+	// This skips all the usual preexistence checks, and the write lock.
+	return SymbolTableInt_AddLocked((struct SymbolTableInt *)symbolTable, name, String_Hash(name));
+}
+
 /// <summary>
 /// Find or create in the given symbol table a symbol that matches the given name.
 /// </summary>
@@ -86,9 +206,12 @@ SymbolTable SymbolTable_Create(void)
 /// or a new value if it did not already exist in the table.</returns>
 Symbol SymbolTable_GetSymbol(SymbolTable symbolTable, String name)
 {
+	struct SymbolTableInt *table = (struct SymbolTableInt *)symbolTable;
+	UInt32 hash = String_Hash(name);
 	Symbol symbol;
-	if ((symbol = (Symbol)StringIntDict_GetValue(((struct SymbolTableInt *)symbolTable)->symbolLookup, name)) == 0)
-		return SymbolTableInt_AddSymbol(symbolTable, name);
+
+	if ((symbol = SymbolTableInt_Find(table, String_GetBytes(name), String_Length(name), hash)) == 0)
+		return SymbolTableInt_FindOrAdd(table, name, hash);
 
 	return symbol;
 }
@@ -102,9 +225,13 @@ Symbol SymbolTable_GetSymbol(SymbolTable symbolTable, String name)
 /// or a new value if it did not already exist in the table.</returns>
 Symbol SymbolTable_GetSymbolC(SymbolTable symbolTable, const char *name)
 {
+	struct SymbolTableInt *table = (struct SymbolTableInt *)symbolTable;
+	Int length = StrLen(name);
+	UInt32 hash = String_HashInternal((const Byte *)name, length);
 	Symbol symbol;
-	if ((symbol = (Symbol)StringIntDict_GetValueC(((struct SymbolTableInt *)symbolTable)->symbolLookup, name)) == 0)
-		return SymbolTableInt_AddSymbol(symbolTable, String_FromC(name));
+
+	if ((symbol = SymbolTableInt_Find(table, (const Byte *)name, length, hash)) == 0)
+		return SymbolTableInt_FindOrAdd(table, String_Create((const Byte *)name, length), hash);
 
 	return symbol;
 }
@@ -117,7 +244,7 @@ Symbol SymbolTable_GetSymbolC(SymbolTable symbolTable, const char *name)
 /// <returns>The symbol, if it was found in the symbol table, or zero if it was not found.</returns>
 Symbol SymbolTable_GetSymbolNoCreate(SymbolTable symbolTable, String name)
 {
-	return (Symbol)StringIntDict_GetValue(((struct SymbolTableInt *)symbolTable)->symbolLookup, name);
+	return SymbolTableInt_Find((struct SymbolTableInt *)symbolTable, String_GetBytes(name), String_Length(name), String_Hash(name));
 }
 
 /// <summary>
@@ -128,7 +255,8 @@ Symbol SymbolTable_GetSymbolNoCreate(SymbolTable symbolTable, String name)
 /// <returns>The symbol, if it was found in the symbol table, or zero if it was not found.</returns>
 Symbol SymbolTable_GetSymbolNoCreateC(SymbolTable symbolTable, const char *name)
 {
-	return (Symbol)StringIntDict_GetValueC(((struct SymbolTableInt *)symbolTable)->symbolLookup, name);
+	Int length = StrLen(name);
+	return SymbolTableInt_Find((struct SymbolTableInt *)symbolTable, (const Byte *)name, length, String_HashInternal((const Byte *)name, length));
 }
 
 /// <summary>
@@ -141,11 +269,14 @@ Symbol SymbolTable_GetSymbolNoCreateC(SymbolTable symbolTable, const char *name)
 String SymbolTable_GetName(SymbolTable symbolTable, Symbol symbol)
 {
 	struct SymbolTableInt *table = (struct SymbolTableInt *)symbolTable;
+	String *symbolNames;
 
-	if ((Int)symbol <= 0 || (Int)symbol >= table->count)
+	// Read the count before the names, since a writer publishes them in the opposite order.
+	if ((Int)symbol <= 0 || (Int)symbol >= (Int)Atomic_LoadInt32(&table->count))
 		return NULL;
 
-	return table->symbolNames[(Int)symbol];
+	symbolNames = (String *)Atomic_LoadPointer((const void **)&table->symbolNames);
+	return symbolNames[(Int)symbol];
 }
 
 /// <summary>
@@ -158,5 +289,5 @@ String SymbolTable_GetName(SymbolTable symbolTable, Symbol symbol)
 const char *SymbolTable_GetNameC(SymbolTable symbolTable, Symbol symbol)
 {
 	String string = SymbolTable_GetName(symbolTable, symbol);
-	return (string != NULL ? (const char *)string->_opaque.text : NULL);
+	return (string != NULL ? String_ToC(string) : NULL);
 }
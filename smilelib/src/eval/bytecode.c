@@ -48,6 +48,7 @@ ByteCodeSegment ByteCodeSegment_CreateWithSize(struct CompiledTablesStruct *comp
 	segment->byteCodes = byteCodes;
 	segment->numByteCodes = 0;
 	segment->maxByteCodes = (Int32)size;
+	segment->functionName = 0;
 
 	return segment;
 }
@@ -18,6 +18,8 @@
 #include <smile/eval/closure.h>
 #include <smile/stringbuilder.h>
 
+UInt64 Closure_NumLocalsCreated;
+
 /// <summary>
 /// Create a new ClosureInfo struct, which contains metadata about a closure.
 /// </summary>
@@ -96,6 +98,8 @@ Closure Closure_CreateLocal(ClosureInfo closureInfo, Closure parent,
 	if (closure == NULL)
 		Smile_Abort_OutOfMemory();
 
+	Closure_NumLocalsCreated++;
+
 	closure->closureInfo = closureInfo;
 	closure->parent = parent;
 	closure->global = parent->global;
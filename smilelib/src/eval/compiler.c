@@ -17,6 +17,7 @@
 
 #include <smile/eval/compiler.h>
 #include <smile/eval/compiler_internal.h>
+#include <smile/eval/constantpool.h>
 #include <smile/smiletypes/smilelist.h>
 #include <smile/smiletypes/smilefunction.h>
 #include <smile/smiletypes/text/smilesymbol.h>
@@ -135,10 +136,14 @@ Compiler Compiler_Create(void)
 
 	compiler->compiledTables = CompiledTables_Create();
 	compiler->currentFunction = NULL;
+	compiler->currentScope = NULL;
 
 	compiler->firstMessage = NullList;
 	compiler->lastMessage = NullList;
 
+	compiler->globalScope = NULL;
+	compiler->numGlobalsDeclared = 0;
+
 	return compiler;
 }
 
@@ -161,7 +166,7 @@ Int Compiler_AddUserFunctionInfo(Compiler compiler, UserFunctionInfo userFunctio
 		if (newUserFunctions == NULL)
 			Smile_Abort_OutOfMemory();
 		if (compiledTables->numUserFunctions > 0)
-			MemCpy(newUserFunctions, compiledTables->userFunctions, compiledTables->numUserFunctions);
+			MemCpy(newUserFunctions, compiledTables->userFunctions, sizeof(UserFunctionInfo) * compiledTables->numUserFunctions);
 		compiledTables->userFunctions = newUserFunctions;
 		compiledTables->maxUserFunctions = newMax;
 	}
@@ -201,7 +206,7 @@ Int Compiler_AddNewSourceLocation(Compiler compiler, String filename, Int line,
 		if (newSourceLocations == NULL)
 			Smile_Abort_OutOfMemory();
 		if (compiledTables->numSourceLocations > 0)
-			MemCpy(newSourceLocations, compiledTables->sourcelocations, compiledTables->numSourceLocations);
+			MemCpy(newSourceLocations, compiledTables->sourcelocations, sizeof(struct CompiledSourceLocationStruct) * compiledTables->numSourceLocations);
 		compiledTables->sourcelocations = newSourceLocations;
 		compiledTables->maxSourceLocations = newMax;
 	}
@@ -371,12 +376,14 @@ Int Compiler_AddString(Compiler compiler, String string)
 		if (newStrings == NULL)
 			Smile_Abort_OutOfMemory();
 		if (compiledTables->numStrings > 0)
-			MemCpy(newStrings, compiledTables->strings, compiledTables->numStrings);
+			MemCpy(newStrings, compiledTables->strings, sizeof(String) * compiledTables->numStrings);
 		compiledTables->strings = newStrings;
 		compiledTables->maxStrings = newMax;
 	}
 
-	// Okay, we have enough space, and it's not there yet, so add it.
+	// Okay, we have enough space, and it's not there yet, so add it (sharing the instance
+	// that any other compile has already made of the same string).
+	string = ConstantPool_InternString(string);
 	index = compiledTables->numStrings++;
 	compiledTables->strings[index] = string;
 	StringIntDict_Add(compiledTables->stringLookup, string, index);
@@ -407,7 +414,7 @@ TillContinuationInfo Compiler_AddTillContinuationInfo(Compiler compiler, UserFun
 		if (newTillInfos == NULL)
 			Smile_Abort_OutOfMemory();
 		if (compiledTables->numTillInfos > 0)
-			MemCpy(newTillInfos, compiledTables->tillInfos, compiledTables->numTillInfos);
+			MemCpy(newTillInfos, compiledTables->tillInfos, sizeof(TillContinuationInfo) * compiledTables->numTillInfos);
 		compiledTables->tillInfos = newTillInfos;
 		compiledTables->maxTillInfos = newMax;
 	}
@@ -423,7 +430,7 @@ TillContinuationInfo Compiler_AddTillContinuationInfo(Compiler compiler, UserFun
 		if (newTillInfos == NULL)
 			Smile_Abort_OutOfMemory();
 		if (compiler->currentFunction->numTillInfos > 0)
-			MemCpy(newTillInfos, compiler->currentFunction->tillInfos, compiler->currentFunction->numTillInfos);
+			MemCpy(newTillInfos, compiler->currentFunction->tillInfos, sizeof(TillContinuationInfo) * compiler->currentFunction->numTillInfos);
 		compiler->currentFunction->tillInfos = newTillInfos;
 		compiler->currentFunction->maxTillInfos = newMax;
 	}
@@ -472,7 +479,7 @@ Int Compiler_AddObject(Compiler compiler, SmileObject obj)
 		if (newObjects == NULL)
 			Smile_Abort_OutOfMemory();
 		if (compiledTables->numObjects > 0)
-			MemCpy(newObjects, compiledTables->objects, compiledTables->numObjects);
+			MemCpy(newObjects, compiledTables->objects, sizeof(SmileObject) * compiledTables->numObjects);
 		compiledTables->objects = newObjects;
 		compiledTables->maxObjects = newMax;
 	}
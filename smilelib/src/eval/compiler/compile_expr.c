@@ -17,6 +17,7 @@
 
 #include <smile/eval/compiler.h>
 #include <smile/eval/compiler_internal.h>
+#include <smile/eval/constantpool.h>
 #include <smile/smiletypes/smilebool.h>
 #include <smile/smiletypes/smilelist.h>
 #include <smile/smiletypes/text/smilesymbol.h>
@@ -102,7 +103,7 @@ CompiledBlock Compiler_CompileExpr(Compiler compiler, SmileObject expr, CompileF
 		case SMILE_KIND_INTEGER64:
 			COMPILE_PRIMITIVE_EXPR(Op_Ld64, int64 = ((SmileInteger64)expr)->value);
 		case SMILE_KIND_INTEGER128:
-			Smile_Abort_FatalError("Integer128 is not yet supported.");
+			COMPILE_PRIMITIVE_EXPR(Op_Ld128, index = Compiler_AddObject(compiler, ConstantPool_Intern(expr)));
 		case SMILE_KIND_BIGINT:
 			Smile_Abort_FatalError("BigInt is not yet supported.");
 
@@ -38,8 +38,10 @@ CompiledBlock Compiler_CompileFn(Compiler compiler, SmileList args, CompileFlags
 	CompiledBlock compiledBlock, childBlock;
 	IntermediateInstruction instr;
 	ByteCodeSegment byteCodeSegment;
+	Symbol assignedName;
 
 	Int oldSourceLocation = Compiler_SetAssignedSymbol(compiler, 0);
+	assignedName = compiler->compiledTables->sourcelocations[oldSourceLocation].assignedName;
 
 	// The [$fn] expression must be of the form:  [$fn [args...] body].
 	if (SMILE_KIND(args) != SMILE_KIND_LIST
@@ -91,6 +93,7 @@ CompiledBlock Compiler_CompileFn(Compiler compiler, SmileList args, CompileFlags
 
 	// Now transform it into finished bytecodes.
 	userFunctionInfo->byteCodeSegment = byteCodeSegment;
+	byteCodeSegment->functionName = assignedName;
 	compilerFunction->stackSize = compiledBlock->maxStackDepth;
 
 	// Make a suitable closure decriptor for it, and an actual function object.
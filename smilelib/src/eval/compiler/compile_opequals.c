@@ -140,14 +140,15 @@ Inline CompiledBlock Compiler_CompileOpEqualsMember(Compiler compiler,
 	// Apply the operator.
 	EMIT1(Op_Met1, -2 + 1, symbol = op);
 
-	// Store the result.
+	// Store the result, and then discard what 'set-member' returned.
 	if (compileFlags & COMPILE_FLAG_NORESULT) {
-		EMIT0(Op_StpMember, -3);
+		EMIT0(Op_StpMember, -3 + 1);
 	}
 	else {
 		EMIT0(Op_LdNull, +1);
-		EMIT0(Op_StMember, -2);
+		EMIT0(Op_StMember, -3 + 1);
 	}
+	EMIT0(Op_Pop1, -1);
 	return compiledBlock;
 }
 
@@ -17,6 +17,7 @@
 
 #include <smile/eval/compiler.h>
 #include <smile/eval/compiler_internal.h>
+#include <smile/eval/constantpool.h>
 #include <smile/smiletypes/smilelist.h>
 #include <smile/smiletypes/text/smilesymbol.h>
 #include <smile/parsing/parsemessage.h>
@@ -53,9 +54,9 @@ CompiledBlock Compiler_CompileQuote(Compiler compiler, SmileList args, CompileFl
 		return compiledBlock;
 	}
 	else {
-		// Load the quoted form as a literal stored object.
+		// Load the quoted form as a literal stored object, shared with any equal quoted form.
 		compiledBlock = CompiledBlock_Create();
-		objectIndex = Compiler_AddObject(compiler, args->a);
+		objectIndex = Compiler_AddObject(compiler, ConstantPool_Intern(args->a));
 		EMIT1(Op_LdObj, +1, index = objectIndex);
 		return compiledBlock;
 	}
@@ -119,13 +119,17 @@ Inline CompiledBlock Compiler_CompileSetMember(Compiler compiler, SmileList args
 
 	Compiler_SetSourceLocationFromList(compiler, args);
 
+	// 'set-member' is an ordinary method call, so it always leaves its own result on the stack
+	// top; we don't want that, so it's popped right afterward.
 	if (compileFlags & COMPILE_FLAG_NORESULT) {
-		EMIT0(Op_StpMember, -3);
+		EMIT0(Op_StpMember, -3 + 1);
+		EMIT0(Op_Pop1, -1);
 		return compiledBlock;
 	}
 	else {
 		EMIT0(Op_LdNull, +1);
-		EMIT0(Op_StMember, -2);
+		EMIT0(Op_StMember, -3 + 1);
+		EMIT0(Op_Pop1, -1);
 		return compiledBlock;
 	}
 }
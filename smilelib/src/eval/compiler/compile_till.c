@@ -237,7 +237,7 @@ static void DefineVariablesForFlags(Compiler compiler, SmileList flags, Int numF
 	tillInfo->symbols = allCompiledTillSymbols = GC_MALLOC_STRUCT_ARRAY(CompiledTillSymbol, numFlags);
 	if (allCompiledTillSymbols == NULL)
 		Smile_Abort_OutOfMemory();
-	tillInfo->branchTargetAddresses = GC_MALLOC_STRUCT_ARRAY(Int32, numFlags);
+	tillInfo->branchTargetAddresses = GC_MALLOC_RAW_ARRAY(Int32, numFlags);
 	if (tillInfo->branchTargetAddresses == NULL)
 		Smile_Abort_OutOfMemory();
 	tillInfo->branchTargetInstructions = GC_MALLOC_STRUCT_ARRAY(IntermediateInstruction, numFlags);
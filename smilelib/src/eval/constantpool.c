@@ -0,0 +1,266 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/gc.h>
+#include <smile/atomic.h>
+#include <smile/eval/constantpool.h>
+#include <smile/smiletypes/smilelist.h>
+
+// How many list cells (in total, at any depth) we'll look at when hashing a quoted list.  Longer
+// lists still intern correctly, since matches are always confirmed with a deep compare; they just
+// all share whatever hash their first cells produce.
+#define MAX_HASHED_CELLS 256
+
+/// <summary>
+/// One slot in the pool's hash table.  The table itself is allocated atomic, so the collector
+/// never sees the pointers in it; each occupied slot's 'hiddenObject' is registered as a
+/// disappearing link instead, which the collector zeroes when the object dies.
+/// </summary>
+typedef struct ConstantPoolSlotStruct {
+	GC_hidden_pointer hiddenObject;	// The pooled object, disguised (0 if empty or collected).
+	UInt32 hash;					// The object's deep hash.
+	Int32 used;						// Nonzero if this slot has ever held an object.
+} *ConstantPoolSlot;
+
+static ConstantPoolSlot _slots;		// The hash table (open addressing, linear probing).
+static Int _mask;					// The table size, minus 1 (the size is always a power of 2).
+static Int _numUsed;				// The number of slots that are live or were once live.
+static Int32 _writeLock = 0;		// A spinlock held while reading or changing the table.
+
+static UInt32 ConstantPool_HashList(SmileList list, Int *budget);
+
+//-------------------------------------------------------------------------------------------------
+//  Hashing.
+
+/// <summary>
+/// Compute a hash of the given object that agrees with SmileObject_DeepCompare():  Atoms use their
+/// own (value-based) hash, and lists combine the hashes of everything in them.
+/// </summary>
+Inline UInt32 ConstantPool_Hash(SmileObject obj, Int *budget)
+{
+	if (SMILE_KIND(obj) == SMILE_KIND_LIST)
+		return ConstantPool_HashList((SmileList)obj, budget);
+	else
+		return SMILE_VCALL(obj, hash);
+}
+
+static UInt32 ConstantPool_HashList(SmileList list, Int *budget)
+{
+	UInt32 hash = 0x5BD1E995;
+
+	for (; SMILE_KIND(list) == SMILE_KIND_LIST && *budget > 0; list = (SmileList)list->d) {
+		--*budget;
+		hash = (hash * 31) ^ ConstantPool_Hash(list->a, budget);
+	}
+
+	return hash;
+}
+
+/// <summary>
+/// Determine whether any cell of the given list, at any depth, carries a source position.  Such a
+/// list can't be shared, since every other compile would then report the first one's file and line.
+/// A list too big to finish checking is assumed to carry positions too.
+/// </summary>
+static Bool ConstantPool_HasSource(SmileList list, Int *budget)
+{
+	for (; SMILE_KIND(list) == SMILE_KIND_LIST; list = (SmileList)list->d) {
+		if (--*budget < 0 || (list->kind & SMILE_FLAG_WITHSOURCE))
+			return True;
+		if (SMILE_KIND(list->a) == SMILE_KIND_LIST && ConstantPool_HasSource((SmileList)list->a, budget))
+			return True;
+	}
+
+	return False;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  The hash table.
+
+/// <summary>
+/// Store the given object in an empty slot, and register the slot as a weak link to it.
+/// </summary>
+Inline void ConstantPool_Fill(ConstantPoolSlot slot, SmileObject obj, void *base, UInt32 hash)
+{
+	slot->hiddenObject = GC_HIDE_POINTER(obj);
+	slot->hash = hash;
+	slot->used = 1;
+	GC_general_register_disappearing_link((void **)&slot->hiddenObject, base);
+}
+
+/// <summary>
+/// Allocate a new table big enough for the live entries of the current one (plus room to grow),
+/// and move those entries across, leaving behind any that have been collected.
+/// </summary>
+static void ConstantPool_Rehash(void)
+{
+	ConstantPoolSlot oldSlots, newSlots, slot;
+	Int oldSize, newSize, newMask, numLive, i, j;
+	SmileObject obj;
+
+	oldSlots = _slots;
+	oldSize = oldSlots != NULL ? _mask + 1 : 0;
+
+	numLive = 0;
+	for (i = 0; i < oldSize; i++) {
+		if (oldSlots[i].hiddenObject != 0)
+			numLive++;
+	}
+
+	// Keep the table at most half full after the rehash.
+	for (newSize = 256; newSize < numLive * 4; newSize <<= 1) ;
+	newMask = newSize - 1;
+
+	newSlots = (ConstantPoolSlot)GC_MALLOC_ATOMIC(sizeof(struct ConstantPoolSlotStruct) * newSize);
+	if (newSlots == NULL)
+		Smile_Abort_OutOfMemory();
+	MemZero(newSlots, sizeof(struct ConstantPoolSlotStruct) * newSize);
+
+	for (i = 0; i < oldSize; i++) {
+		if (oldSlots[i].hiddenObject == 0) continue;
+
+		// Holding the object in a local keeps it alive while its link moves to the new slot.
+		obj = (SmileObject)GC_REVEAL_POINTER(oldSlots[i].hiddenObject);
+		for (j = oldSlots[i].hash & newMask; newSlots[j].used; j = (j + 1) & newMask) ;
+		slot = &newSlots[j];
+		ConstantPool_Fill(slot, obj, GC_base(obj), oldSlots[i].hash);
+		GC_unregister_disappearing_link((void **)&oldSlots[i].hiddenObject);
+	}
+
+	_slots = newSlots;
+	_mask = newMask;
+	_numUsed = numLive;
+}
+
+/// <summary>
+/// Find the pooled constant equal to the given one, adding the given one to the pool if there
+/// isn't one yet.  Strings, Integer128s, and lists are pooled; anything else, anything that
+/// doesn't live in the GC heap (like a static string), and any list that carries source positions
+/// is returned as-is.  This is safe to call from any thread.
+/// </summary>
+/// <param name="obj">The constant to intern.</param>
+/// <returns>The pooled instance of that constant, which may be the given object itself.</returns>
+SmileObject ConstantPool_Intern(SmileObject obj)
+{
+	UInt32 hash;
+	Int i, budget, freeSlot;
+	SmileObject candidate;
+	void *base;
+
+	switch (SMILE_KIND(obj)) {
+		case SMILE_KIND_STRING:
+		case SMILE_KIND_INTEGER128:
+		case SMILE_KIND_LIST:
+			break;
+		default:
+			return obj;
+	}
+
+	base = GC_base(obj);
+	if (base == NULL)
+		return obj;
+
+	budget = MAX_HASHED_CELLS;
+	if (SMILE_KIND(obj) == SMILE_KIND_LIST && ConstantPool_HasSource((SmileList)obj, &budget))
+		return obj;
+
+	while (!Atomic_CompareAndSwapInt32(&_writeLock, 0, 1)) ;
+
+	if (_slots == NULL || _numUsed >= (_mask + 1) / 4 * 3)
+		ConstantPool_Rehash();
+
+	budget = MAX_HASHED_CELLS;
+	hash = ConstantPool_Hash(obj, &budget);
+
+	// Look for it, remembering the first slot whose object has been collected, if any, so we
+	// can reuse that slot if we don't find a match.
+	freeSlot = -1;
+	for (i = hash & _mask; _slots[i].used; i = (i + 1) & _mask) {
+		if (_slots[i].hiddenObject == 0) {
+			if (freeSlot < 0) freeSlot = i;
+			continue;
+		}
+		if (_slots[i].hash != hash) continue;
+
+		candidate = (SmileObject)GC_REVEAL_POINTER(_slots[i].hiddenObject);
+		if (candidate == obj
+			|| (SMILE_KIND(candidate) == SMILE_KIND(obj)
+				&& (SMILE_KIND(obj) == SMILE_KIND_STRING
+					? String_Equals((String)candidate, (String)obj)
+					: SmileObject_DeepCompare(candidate, obj)))) {
+			Atomic_StoreInt32(&_writeLock, 0);
+			return candidate;
+		}
+	}
+
+	if (freeSlot < 0) {
+		freeSlot = i;
+		_numUsed++;
+	}
+
+	ConstantPool_Fill(&_slots[freeSlot], obj, base, hash);
+
+	Atomic_StoreInt32(&_writeLock, 0);
+	return obj;
+}
+
+/// <summary>
+/// Empty the pool.  This is done whenever the environment is reset, since pooled constants
+/// refer to the old environment's base objects.
+/// </summary>
+void ConstantPool_Reset(void)
+{
+	Int i;
+
+	while (!Atomic_CompareAndSwapInt32(&_writeLock, 0, 1)) ;
+
+	if (_slots != NULL) {
+		for (i = 0; i <= _mask; i++) {
+			if (_slots[i].hiddenObject != 0)
+				GC_unregister_disappearing_link((void **)&_slots[i].hiddenObject);
+		}
+	}
+
+	_slots = NULL;
+	_mask = 0;
+	_numUsed = 0;
+
+	Atomic_StoreInt32(&_writeLock, 0);
+}
+
+/// <summary>
+/// Count how many constants are currently in the pool (not counting any that have been
+/// collected).  This is mostly useful for diagnostics and testing.
+/// </summary>
+/// <returns>The number of live pooled constants.</returns>
+Int ConstantPool_Count(void)
+{
+	Int i, count;
+
+	while (!Atomic_CompareAndSwapInt32(&_writeLock, 0, 1)) ;
+
+	count = 0;
+	if (_slots != NULL) {
+		for (i = 0; i <= _mask; i++) {
+			if (_slots[i].hiddenObject != 0)
+				count++;
+		}
+	}
+
+	Atomic_StoreInt32(&_writeLock, 0);
+	return count;
+}
@@ -38,6 +38,8 @@
 #include <smile/smiletypes/numeric/smilefloat32.h>
 #include <smile/smiletypes/numeric/smilefloat64.h>
 #include <smile/env/modules.h>
+#include <smile/eval/profiler.h>
+#include <smile/atomic.h>
 
 #if ENABLE_INSTRUCTION_TRACING
 #include <stdio.h>
@@ -52,6 +54,22 @@ ByteCode _byteCode;
 
 EscapeContinuation _exceptionContinuation;
 
+// The runtime counters (see eval.h).  The instruction counter is bumped on every instruction, so
+// each thread counts into its own InstructionCounter, which eval() looks up once when it starts
+// and then keeps at hand; the counters are all linked together so that reading the total can
+// add them up.  A thread's counter is never freed, so its count stays in the total after it exits.
+typedef struct InstructionCounterStruct {
+	UInt64 count;
+	struct InstructionCounterStruct *next;
+} *InstructionCounter;
+
+static SMILE_THREAD_LOCAL InstructionCounter _instructionCounter;
+static InstructionCounter _instructionCounters;
+static Int32 _instructionCountersWriteLock = 0;
+
+UInt64 Eval_NumStateMachineSteps;
+UInt64 Eval_NumExceptionsThrown;
+
 static Bool Eval_RunCore(void);
 static Bool Is(SmileArg descendant, SmileArg ancestor);
 static void InitModule(ModuleInfo moduleInfo);
@@ -93,6 +111,49 @@ void Eval_AfterRecurse(struct EvalStateStruct *evalState)
 	_exceptionContinuation = evalState->exceptionContinuation;
 }
 
+/// <summary>
+/// Get the current thread's instruction counter, creating it (and adding it to the list of
+/// all counters) the first time the thread asks for it.
+/// </summary>
+static InstructionCounter Eval_GetInstructionCounter(void)
+{
+	InstructionCounter counter = _instructionCounter;
+
+	if (counter == NULL) {
+		counter = GC_MALLOC_STRUCT(struct InstructionCounterStruct);
+		if (counter == NULL)
+			Smile_Abort_OutOfMemory();
+		counter->count = 0;
+
+		while (!Atomic_CompareAndSwapInt32(&_instructionCountersWriteLock, 0, 1)) ;
+		counter->next = _instructionCounters;
+		Atomic_StorePointer((void **)&_instructionCounters, counter);
+		Atomic_StoreInt32(&_instructionCountersWriteLock, 0);
+
+		_instructionCounter = counter;
+	}
+
+	return counter;
+}
+
+/// <summary>
+/// Get how many instructions eval() has executed, in all threads, since the process started.
+/// This adds up every thread's counter without stopping them, so while other threads are running,
+/// it's only a snapshot.
+/// </summary>
+UInt64 Eval_GetNumInstructions(void)
+{
+	InstructionCounter counter;
+	UInt64 total = 0;
+
+	for (counter = (InstructionCounter)Atomic_LoadPointer((const void **)&_instructionCounters);
+		counter != NULL; counter = counter->next) {
+		total += counter->count;
+	}
+
+	return total;
+}
+
 EvalResult Eval_Run(UserFunctionInfo functionInfo)
 {
 	_segment = functionInfo->byteCodeSegment;
@@ -178,11 +239,17 @@ static Bool Eval_RunCore(void)
 	SmileObject target, value;
 	SmileArg arg, arg2;
 	ModuleInfo moduleInfo;
+	InstructionCounter instructionCounter = Eval_GetInstructionCounter();
 
 	LOAD_REGISTERS;
 
 next:
 
+	instructionCounter->count++;
+
+	if (Profiler_IsRunning)
+		Profiler_Step(_segment, closure, byteCode);
+
 #if ENABLE_INSTRUCTION_TRACING
 	STORE_REGISTERS;
 	Eval_DumpCurrentInstruction();
@@ -674,7 +741,8 @@ next:
 			// the one we want to keep.  So there's no real choice here:  We have to
 			// rotate the stack upward into the mandatory Null space, and then clone the
 			// resulting value below the rotated stack values.  Once that's done, we can just
-			// let Op_StpMember do its thing and clean up the stack afterward.
+			// let Op_StpMember do its thing; the compiler follows it with an Op_Pop1 to discard
+			// whatever set-member returned.
 			Closure_SetTemp(closure, 0, Closure_GetTemp(closure, 1));
 			Closure_SetTemp(closure, 1, Closure_GetTemp(closure, 2));
 			Closure_SetTemp(closure, 2, Closure_GetTemp(closure, 3));
@@ -1269,6 +1337,8 @@ next:
 			{
 				Int argc;
 
+				Eval_NumStateMachineSteps++;
+
 				STORE_REGISTERS;
 				if ((argc = ((ClosureStateMachine)closure)->stateMachineBody((ClosureStateMachine)closure)) >= 0) {
 					LOAD_REGISTERS;
@@ -1363,6 +1433,8 @@ void Smile_Throw(SmileObject thrownObject)
 	SmileObject kindObject, messageObject;
 	String message;
 
+	Eval_NumExceptionsThrown++;
+
 	if (_exceptionContinuation != NULL && _exceptionContinuation->isValid) {
 		_exceptionContinuation->result = thrownObject;
 
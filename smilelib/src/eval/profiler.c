@@ -0,0 +1,834 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/gc.h>
+#include <smile/string.h>
+#include <smile/stringbuilder.h>
+#include <smile/dict/stringintdict.h>
+#include <smile/env/env.h>
+#include <smile/eval/compiler.h>
+#include <smile/eval/profiler.h>
+#include <smile/smiletypes/smileobject.h>
+
+#include <stdlib.h>
+
+#if ((SMILE_OS & SMILE_OS_FAMILY) == SMILE_OS_WINDOWS_FAMILY)
+#	define WIN32_LEAN_AND_MEAN
+#	pragma warning(push)
+#	pragma warning(disable: 4255)
+#	include <windows.h>
+#	pragma warning(pop)
+#else
+#	include <signal.h>
+#	include <sys/time.h>
+#endif
+
+// How often to sample the stack if the caller doesn't say.
+#define DEFAULT_SAMPLE_MICROSECONDS 1000
+
+// The most frames we'll record for any one sample.  Deeper stacks keep their innermost frames,
+// and get a single "..." frame at the root in place of the rest.
+#define MAX_SAMPLE_DEPTH 512
+
+// How many allocations to skip between allocation samples if the caller doesn't say.
+#define DEFAULT_ALLOCATION_SAMPLE_EVERY 256
+
+/// <summary>
+/// Whether either profiler is running.  eval() checks this before every instruction, and only
+/// calls Profiler_Step() if it's set.
+/// </summary>
+Bool Profiler_IsRunning = False;
+
+/// <summary>
+/// How many more allocations until the next one is handed to Profiler_SampleAllocation().
+/// </summary>
+Int32 Profiler_AllocationCountdown = Int32Max;
+
+static Bool _isProfilingTime;			// Whether the instruction/time profiler is running.
+static Bool _isProfilingAllocations;	// Whether the allocation profiler is running.
+
+static ByteCodeSegment _stepSegment;	// The segment of the instruction eval() is running.
+static ByteCode _stepByteCode;			// The instruction eval() is running.
+
+// Set by the timer (from a signal handler, or from the timer thread on Windows) when it's
+// time to take another sample.
+static volatile Int32 _samplePending;
+
+static ProfileEntry *_entries;			// Every function we've seen, hashed by segment (open addressing).
+static Int _mask;						// The size of the entry table, minus 1 (always a power of 2).
+static Int _numEntries;					// The number of functions in the entry table.
+
+static ByteCodeSegment _currentSegment;	// The segment eval() was in at the last step.
+static ProfileEntry _currentEntry;		// The entry for that segment.
+static UInt64 _lastTicks;				// When we started attributing time to the current entry.
+
+static StringIntDict _stacks;			// Folded stack -> number of samples with that stack.
+static Int64 _numSamples;				// The total number of samples taken.
+static Int _sampleMicroseconds;			// How often the timer asks for a sample.
+
+/// <summary>
+/// What the allocation profiler knows about one allocation site:  One kind of object, allocated
+/// by one instruction.
+/// </summary>
+typedef struct AllocationSiteStruct {
+	String site;						// The function and source location of the allocating instruction.
+	String what;						// The kind of object (or C type) allocated there.
+	Int64 numSamples;					// How many sampled allocations were made here.
+	Int64 numBytes;						// The total size of those sampled allocations.
+} *AllocationSite;
+
+static AllocationSite *_allocationSites;	// Every allocation site seen, in order of first appearance.
+static Int _numAllocationSites;				// The number of sites in that array.
+static Int _maxAllocationSites;				// The size of that array.
+static StringIntDict _allocationSiteLookup;	// "site\nwhat" -> index of that allocation site.
+static Int64 _numAllocationSamples;			// The total number of allocations sampled.
+static Int64 _numAllocationBytes;			// The total size of the allocations sampled.
+static Int32 _allocationSampleEvery;		// How many allocations per sample, on average.
+static UInt32 _allocationRandom;			// State for picking the distance to the next sample.
+
+// The most recently sampled allocation.  Its contents (like its SMILE_KIND) aren't known until
+// its constructor has filled it in, so it's recorded when the next allocation comes along.
+// The pointer is hidden, so that it doesn't keep the block alive.
+static GC_hidden_pointer _pendingBlock;
+static size_t _pendingSize;
+static Bool _pendingIsAtomic;
+static const char *_pendingTypeName;
+static ByteCodeSegment _pendingSegment;
+static ByteCode _pendingByteCode;
+
+//-------------------------------------------------------------------------------------------------
+//  The sampling timer.
+
+#if ((SMILE_OS & SMILE_OS_FAMILY) == SMILE_OS_WINDOWS_FAMILY)
+
+	static HANDLE _timer;
+
+	static VOID CALLBACK Profiler_OnTimer(PVOID param, BOOLEAN timerOrWaitFired)
+	{
+		UNUSED(param);
+		UNUSED(timerOrWaitFired);
+		_samplePending = 1;
+	}
+
+	static void Profiler_StartTimer(Int microseconds)
+	{
+		DWORD milliseconds = (DWORD)((microseconds + 999) / 1000);
+		if (!CreateTimerQueueTimer(&_timer, NULL, Profiler_OnTimer, NULL, milliseconds, milliseconds, WT_EXECUTEINTIMERTHREAD))
+			_timer = NULL;
+	}
+
+	static void Profiler_StopTimer(void)
+	{
+		if (_timer != NULL) {
+			DeleteTimerQueueTimer(NULL, _timer, INVALID_HANDLE_VALUE);
+			_timer = NULL;
+		}
+	}
+
+#else
+
+	static struct sigaction _oldAction;
+
+	static void Profiler_OnTimer(int signal)
+	{
+		UNUSED(signal);
+		_samplePending = 1;
+	}
+
+	// The timer runs on the process's CPU time (ITIMER_PROF/SIGPROF), the conventional choice
+	// for profilers:  It doesn't disturb programs that use SIGALRM, and it doesn't fill the
+	// profile with samples of a process that's just waiting for input.
+	static void Profiler_StartTimer(Int microseconds)
+	{
+		struct sigaction action;
+		struct itimerval interval;
+
+		MemZero(&action, sizeof(struct sigaction));
+		action.sa_handler = Profiler_OnTimer;
+		action.sa_flags = SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGPROF, &action, &_oldAction);
+
+		interval.it_interval.tv_sec = (long)(microseconds / 1000000);
+		interval.it_interval.tv_usec = (long)(microseconds % 1000000);
+		interval.it_value = interval.it_interval;
+		setitimer(ITIMER_PROF, &interval, NULL);
+	}
+
+	static void Profiler_StopTimer(void)
+	{
+		struct itimerval interval;
+
+		MemZero(&interval, sizeof(struct itimerval));
+		setitimer(ITIMER_PROF, &interval, NULL);
+		sigaction(SIGPROF, &_oldAction, NULL);
+	}
+
+#endif
+
+//-------------------------------------------------------------------------------------------------
+//  The per-function entries.
+
+Inline Int Profiler_HashSegment(ByteCodeSegment segment)
+{
+	PtrInt value = (PtrInt)segment;
+	return (Int)((value >> 4) ^ (value >> 12));
+}
+
+/// <summary>
+/// Double the size of the entry table, rehashing everything already in it.
+/// </summary>
+static void Profiler_GrowEntries(void)
+{
+	ProfileEntry *oldEntries = _entries;
+	Int oldSize = _mask + 1;
+	Int newMask = oldSize * 2 - 1;
+	Int i, j;
+
+	_entries = GC_MALLOC_STRUCT_ARRAY(ProfileEntry, newMask + 1);
+	if (_entries == NULL)
+		Smile_Abort_OutOfMemory();
+	MemZero(_entries, sizeof(ProfileEntry) * (newMask + 1));
+
+	for (i = 0; i < oldSize; i++) {
+		if (oldEntries[i] == NULL) continue;
+		for (j = Profiler_HashSegment(oldEntries[i]->segment) & newMask; _entries[j] != NULL; j = (j + 1) & newMask) ;
+		_entries[j] = oldEntries[i];
+	}
+
+	_mask = newMask;
+}
+
+/// <summary>
+/// Find the entry for the given segment, adding a new one if this is the first time we've
+/// seen it.
+/// </summary>
+static ProfileEntry Profiler_GetOrAddEntry(ByteCodeSegment segment)
+{
+	ProfileEntry entry;
+	Int i;
+
+	for (i = Profiler_HashSegment(segment) & _mask; _entries[i] != NULL; i = (i + 1) & _mask) {
+		if (_entries[i]->segment == segment)
+			return _entries[i];
+	}
+
+	entry = GC_MALLOC_STRUCT(struct ProfileEntryStruct);
+	if (entry == NULL)
+		Smile_Abort_OutOfMemory();
+	entry->segment = segment;
+	entry->numInstructions = 0;
+	entry->numSamples = 0;
+	entry->ticks = 0;
+
+	_entries[i] = entry;
+	if (++_numEntries * 2 > _mask + 1)
+		Profiler_GrowEntries();
+
+	return entry;
+}
+
+/// <summary>
+/// Find the profile entry for the given function's body.
+/// </summary>
+/// <param name="segment">The segment to look up.</param>
+/// <returns>The profile entry for that segment, or NULL if it hasn't run since the
+/// profiler was started.</returns>
+ProfileEntry Profiler_GetEntry(ByteCodeSegment segment)
+{
+	Int i;
+
+	if (_entries == NULL) return NULL;
+
+	for (i = Profiler_HashSegment(segment) & _mask; _entries[i] != NULL; i = (i + 1) & _mask) {
+		if (_entries[i]->segment == segment)
+			return _entries[i];
+	}
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Labels.
+
+/// <summary>
+/// Append the name of the function that the given segment is the body of:  The name it was
+/// assigned to when it was declared, or "<global>" or "<anonymous>" if it doesn't have one.
+/// </summary>
+static void Profiler_AppendFunctionName(StringBuilder stringBuilder, ByteCodeSegment segment)
+{
+	UserFunctionInfo globalFunctionInfo;
+
+	if (segment->functionName != 0) {
+		StringBuilder_AppendString(stringBuilder, SymbolTable_GetName(Smile_SymbolTable, segment->functionName));
+		return;
+	}
+
+	globalFunctionInfo = segment->compiledTables != NULL ? segment->compiledTables->globalFunctionInfo : NULL;
+	if (globalFunctionInfo != NULL && globalFunctionInfo->byteCodeSegment == segment)
+		StringBuilder_AppendFormat(stringBuilder, "<global>");
+	else
+		StringBuilder_AppendFormat(stringBuilder, "<anonymous>");
+}
+
+/// <summary>
+/// Append " (file:line)" for the given instruction, if we know where it came from.
+/// </summary>
+static void Profiler_AppendSourceLocation(StringBuilder stringBuilder, ByteCodeSegment segment, ByteCode byteCode)
+{
+	CompiledSourceLocation sourceLocation;
+
+	if (segment->compiledTables == NULL || byteCode->sourceLocation <= 0) return;
+
+	sourceLocation = &segment->compiledTables->sourcelocations[byteCode->sourceLocation];
+	StringBuilder_AppendFormat(stringBuilder, " (%S:%d)",
+		sourceLocation->filename != NULL ? sourceLocation->filename : String_FromC("?"),
+		(Int)sourceLocation->line);
+}
+
+/// <summary>
+/// Make a label for the given function, of the form "name (file:line)", where the location
+/// is that of the function's first instruction.
+/// </summary>
+/// <param name="segment">The function body to describe.</param>
+/// <returns>A label for that function, as used in the profiler's summary.</returns>
+String Profiler_GetFunctionLabel(ByteCodeSegment segment)
+{
+	DECLARE_INLINE_STRINGBUILDER(stringBuilder, 256);
+	INIT_INLINE_STRINGBUILDER(stringBuilder);
+
+	Profiler_AppendFunctionName(stringBuilder, segment);
+	if (segment->numByteCodes > 0)
+		Profiler_AppendSourceLocation(stringBuilder, segment, segment->byteCodes);
+
+	return StringBuilder_ToString(stringBuilder);
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Sampling.
+
+/// <summary>
+/// Record the current stack as one folded-stack sample.  The frames are found the same way
+/// that exceptions find their stack traces:  The current segment and instruction, and then
+/// each closure's return continuation in turn (whose program counter points just past the
+/// call instruction).
+/// </summary>
+static void Profiler_Sample(ByteCodeSegment segment, Closure closure, ByteCode byteCode)
+{
+	ByteCodeSegment segments[MAX_SAMPLE_DEPTH];
+	ByteCode byteCodes[MAX_SAMPLE_DEPTH];
+	Int depth, i, count;
+	Bool truncated;
+	String stack;
+	DECLARE_INLINE_STRINGBUILDER(stringBuilder, 1024);
+
+	// Collect the frames, innermost first.
+	depth = 0;
+	truncated = False;
+	for (;;) {
+		if (depth >= MAX_SAMPLE_DEPTH) {
+			truncated = True;
+			break;
+		}
+		segments[depth] = segment;
+		byteCodes[depth] = byteCode;
+		depth++;
+
+		if (closure->returnClosure == NULL || closure->returnSegment == NULL)
+			break;
+		segment = closure->returnSegment;
+		byteCode = segment->byteCodes + closure->returnPc - 1;
+		closure = closure->returnClosure;
+	}
+
+	// Write them out outermost first, as flamegraph.pl expects.
+	INIT_INLINE_STRINGBUILDER(stringBuilder);
+	if (truncated)
+		StringBuilder_AppendFormat(stringBuilder, "...;");
+	for (i = depth - 1; i >= 0; i--) {
+		Profiler_AppendFunctionName(stringBuilder, segments[i]);
+		Profiler_AppendSourceLocation(stringBuilder, segments[i], byteCodes[i]);
+		if (i > 0)
+			StringBuilder_AppendByte(stringBuilder, ';');
+	}
+	stack = StringBuilder_ToString(stringBuilder);
+
+	if (StringIntDict_TryGetValue(_stacks, stack, &count))
+		StringIntDict_ReplaceValue(_stacks, stack, count + 1);
+	else
+		StringIntDict_Add(_stacks, stack, 1);
+
+	_numSamples++;
+}
+
+/// <summary>
+/// Account for the instruction that eval() is about to execute.  This is called by eval() for
+/// every instruction while either profiler is running.
+/// </summary>
+/// <param name="segment">The segment that contains the instruction.</param>
+/// <param name="closure">The closure the instruction will run in.</param>
+/// <param name="byteCode">The instruction itself.</param>
+void Profiler_Step(ByteCodeSegment segment, Closure closure, ByteCode byteCode)
+{
+	UInt64 now, sampleStart;
+
+	// Remember where we are, so allocations can be attributed to this instruction.
+	_stepSegment = segment;
+	_stepByteCode = byteCode;
+
+	if (!_isProfilingTime) return;
+
+	// Whenever control moves to another function, charge the time since the last switch to
+	// the function we're leaving.
+	if (segment != _currentSegment) {
+		now = Smile_GetTicks();
+		if (_currentEntry != NULL)
+			_currentEntry->ticks += now - _lastTicks;
+		_lastTicks = now;
+		_currentSegment = segment;
+		_currentEntry = Profiler_GetOrAddEntry(segment);
+	}
+
+	_currentEntry->numInstructions++;
+
+	if (_samplePending) {
+		_samplePending = 0;
+
+		// Don't charge the function for the time it takes us to record the sample.
+		sampleStart = Smile_GetTicks();
+		_currentEntry->numSamples++;
+		Profiler_Sample(segment, closure, byteCode);
+		_lastTicks += Smile_GetTicks() - sampleStart;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Allocation sampling.
+
+/// <summary>
+/// Decide whether the given block looks like a Smile object:  It has a valid kind, an aligned
+/// vtable pointer that isn't into the GC heap (vtables are static data), and an aligned base
+/// pointer.  Other data can pass this test, but only by coincidence.
+/// </summary>
+static Bool Profiler_LooksLikeSmileObject(SmileObject obj, size_t size)
+{
+	const PtrInt alignMask = sizeof(void *) - 1;
+
+	if (size < sizeof(struct SmileObjectInt))
+		return False;
+	if (obj->vtable == NULL || ((PtrInt)obj->vtable & alignMask) != 0 || GC_base((void *)obj->vtable) != NULL)
+		return False;
+	if (((PtrInt)obj->base & alignMask) != 0)
+		return False;
+	return String_Length(SmileKind_GetName(SMILE_KIND(obj))) > 0;
+}
+
+/// <summary>
+/// Describe what kind of thing the given block holds:  Its SMILE_KIND, if it looks like a Smile
+/// object, or else the C type it was allocated as, if known.  Typed raw arrays are never
+/// objects, so they're never inspected.
+/// </summary>
+static String Profiler_DescribeBlock(void *block, size_t size, const char *typeName, Bool isAtomic)
+{
+	if (isAtomic && typeName != NULL)
+		return String_FromC(typeName);
+
+	if (Profiler_LooksLikeSmileObject((SmileObject)block, size))
+		return SmileKind_GetName(SMILE_KIND((SmileObject)block));
+
+	if (typeName != NULL)
+		return String_FromC(typeName);
+
+	return String_FromC(isAtomic ? "<untyped data>" : "<untyped>");
+}
+
+/// <summary>
+/// Add the pending allocation sample to its allocation site's totals.
+/// </summary>
+static void Profiler_RecordPendingAllocation(void)
+{
+	void *block;
+	String what, key;
+	AllocationSite allocationSite, *newSites;
+	Int index;
+	DECLARE_INLINE_STRINGBUILDER(siteBuilder, 256);
+
+	block = GC_REVEAL_POINTER(_pendingBlock);
+	_pendingBlock = 0;
+
+	what = Profiler_DescribeBlock(block, _pendingSize, _pendingTypeName, _pendingIsAtomic);
+
+	INIT_INLINE_STRINGBUILDER(siteBuilder);
+	if (_pendingSegment == NULL)
+		StringBuilder_AppendFormat(siteBuilder, "<runtime>");
+	else {
+		Profiler_AppendFunctionName(siteBuilder, _pendingSegment);
+		Profiler_AppendSourceLocation(siteBuilder, _pendingSegment, _pendingByteCode);
+	}
+	key = String_Format("%S\n%S", StringBuilder_ToString(siteBuilder), what);
+
+	if (StringIntDict_TryGetValue(_allocationSiteLookup, key, &index)) {
+		allocationSite = _allocationSites[index];
+	}
+	else {
+		if (_numAllocationSites >= _maxAllocationSites) {
+			_maxAllocationSites = _maxAllocationSites > 0 ? _maxAllocationSites * 2 : 64;
+			newSites = GC_MALLOC_STRUCT_ARRAY(AllocationSite, _maxAllocationSites);
+			if (newSites == NULL)
+				Smile_Abort_OutOfMemory();
+			if (_numAllocationSites > 0)
+				MemCpy(newSites, _allocationSites, sizeof(AllocationSite) * _numAllocationSites);
+			_allocationSites = newSites;
+		}
+
+		allocationSite = GC_MALLOC_STRUCT(struct AllocationSiteStruct);
+		if (allocationSite == NULL)
+			Smile_Abort_OutOfMemory();
+		allocationSite->site = StringBuilder_ToString(siteBuilder);
+		allocationSite->what = what;
+		allocationSite->numSamples = 0;
+		allocationSite->numBytes = 0;
+
+		index = _numAllocationSites++;
+		_allocationSites[index] = allocationSite;
+		StringIntDict_Add(_allocationSiteLookup, key, index);
+	}
+
+	allocationSite->numSamples++;
+	allocationSite->numBytes += (Int64)_pendingSize;
+	_numAllocationSamples++;
+	_numAllocationBytes += (Int64)_pendingSize;
+}
+
+/// <summary>
+/// Pick how many allocations until the next sample:  A random distance from 1 to just under twice
+/// the sampling rate, so that the average is the sampling rate, but a loop that allocates in a
+/// fixed pattern can't line up with it and always get the same allocation sampled.
+/// </summary>
+static Int32 Profiler_NextAllocationDistance(void)
+{
+	// xorshift32:  Not much of a random-number generator, but more than good enough for this.
+	_allocationRandom ^= _allocationRandom << 13;
+	_allocationRandom ^= _allocationRandom >> 17;
+	_allocationRandom ^= _allocationRandom << 5;
+
+	return (Int32)(_allocationRandom % ((UInt32)_allocationSampleEvery * 2 - 1)) + 1;
+}
+
+/// <summary>
+/// The slow path of GC_MALLOC_SAMPLED(), taken whenever Profiler_AllocationCountdown runs out.
+/// The allocation that runs out the countdown is sampled; and since its contents won't be known
+/// until its constructor is done with it, the countdown is then set to run out again at the
+/// very next allocation, which records the sample before anything else can happen to it.
+/// </summary>
+/// <param name="size">The number of bytes to allocate.</param>
+/// <param name="isAtomic">Whether the memory will never contain pointers.</param>
+/// <param name="typeName">The C type being allocated, if known.</param>
+/// <returns>The new memory, or NULL if the allocation failed.</returns>
+void *Profiler_SampleAllocation(size_t size, Bool isAtomic, const char *typeName)
+{
+	void *block;
+	Int32 distance;
+
+	// Don't sample any of the allocations we make ourselves while recording a sample.
+	Profiler_AllocationCountdown = Int32Max;
+
+	if (!_isProfilingAllocations)
+		return isAtomic ? GC_MALLOC_ATOMIC_UNSAMPLED(size) : GC_MALLOC_UNSAMPLED(size);
+
+	if (_pendingBlock != 0) {
+		Profiler_RecordPendingAllocation();
+
+		// This allocation counts as the first one toward the next sample.
+		distance = Profiler_NextAllocationDistance();
+		if (distance > 1) {
+			block = isAtomic ? GC_MALLOC_ATOMIC_UNSAMPLED(size) : GC_MALLOC_UNSAMPLED(size);
+			Profiler_AllocationCountdown = distance - 1;
+			return block;
+		}
+	}
+
+	block = isAtomic ? GC_MALLOC_ATOMIC_UNSAMPLED(size) : GC_MALLOC_UNSAMPLED(size);
+	if (block == NULL) {
+		Profiler_AllocationCountdown = Profiler_NextAllocationDistance();
+		return NULL;
+	}
+
+	_pendingBlock = GC_HIDE_POINTER(block);
+	_pendingSize = size;
+	_pendingIsAtomic = isAtomic;
+	_pendingTypeName = typeName;
+	_pendingSegment = _stepSegment;
+	_pendingByteCode = _stepByteCode;
+
+	Profiler_AllocationCountdown = 1;
+	return block;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Starting and stopping.
+
+/// <summary>
+/// Start (or restart) the instruction and time profiler, discarding anything it collected before.
+/// </summary>
+/// <param name="sampleMicroseconds">How often to sample the stack, in microseconds of CPU time
+/// (milliseconds, on Windows), or zero to use the default of once per millisecond.</param>
+void Profiler_Start(Int sampleMicroseconds)
+{
+	if (_isProfilingTime)
+		Profiler_Stop();
+
+	_mask = 255;
+	_entries = GC_MALLOC_STRUCT_ARRAY(ProfileEntry, _mask + 1);
+	if (_entries == NULL)
+		Smile_Abort_OutOfMemory();
+	MemZero(_entries, sizeof(ProfileEntry) * (_mask + 1));
+	_numEntries = 0;
+
+	_currentSegment = NULL;
+	_currentEntry = NULL;
+	_lastTicks = Smile_GetTicks();
+
+	_stacks = StringIntDict_Create();
+	_numSamples = 0;
+	_samplePending = 0;
+
+	_sampleMicroseconds = sampleMicroseconds > 0 ? sampleMicroseconds : DEFAULT_SAMPLE_MICROSECONDS;
+	Profiler_StartTimer(_sampleMicroseconds);
+
+	_isProfilingTime = True;
+	Profiler_IsRunning = True;
+}
+
+/// <summary>
+/// Stop the instruction and time profiler.  Everything it collected stays available until it's
+/// started again.
+/// </summary>
+void Profiler_Stop(void)
+{
+	if (!_isProfilingTime) return;
+
+	_isProfilingTime = False;
+	Profiler_IsRunning = _isProfilingAllocations;
+	Profiler_StopTimer();
+
+	if (_currentEntry != NULL)
+		_currentEntry->ticks += Smile_GetTicks() - _lastTicks;
+	_currentSegment = NULL;
+	_currentEntry = NULL;
+}
+
+/// <summary>
+/// Start (or restart) the allocation profiler, discarding anything it collected before.
+/// </summary>
+/// <param name="sampleEvery">Sample one allocation out of this many, or zero to use the
+/// default of one in 256.</param>
+void Profiler_StartAllocations(Int sampleEvery)
+{
+	if (_isProfilingAllocations)
+		Profiler_StopAllocations();
+
+	_allocationSites = NULL;
+	_numAllocationSites = 0;
+	_maxAllocationSites = 0;
+	_allocationSiteLookup = StringIntDict_Create();
+	_numAllocationSamples = 0;
+	_numAllocationBytes = 0;
+	_pendingBlock = 0;
+
+	_allocationSampleEvery = (Int32)(sampleEvery > 0 && sampleEvery < Int32Max / 2 ? sampleEvery : DEFAULT_ALLOCATION_SAMPLE_EVERY);
+
+	_stepSegment = NULL;
+	_stepByteCode = NULL;
+
+	_isProfilingAllocations = True;
+	Profiler_IsRunning = True;
+	_allocationRandom = 0x9E3779B9;
+	Profiler_AllocationCountdown = Profiler_NextAllocationDistance();
+}
+
+/// <summary>
+/// Stop the allocation profiler.  Everything it collected stays available until it's started again.
+/// </summary>
+void Profiler_StopAllocations(void)
+{
+	if (!_isProfilingAllocations) return;
+
+	Profiler_AllocationCountdown = Int32Max;
+	if (_pendingBlock != 0)
+		Profiler_RecordPendingAllocation();
+
+	_isProfilingAllocations = False;
+	Profiler_IsRunning = _isProfilingTime;
+	Profiler_AllocationCountdown = Int32Max;
+}
+
+//-------------------------------------------------------------------------------------------------
+//  Reporting.
+
+/// <summary>
+/// Get the total number of stack samples taken since the profiler was started.
+/// </summary>
+Int64 Profiler_GetNumSamples(void)
+{
+	return _numSamples;
+}
+
+/// <summary>
+/// Get the samples as folded stacks:  One line per distinct stack, of the form
+/// "outer (file:line);...;inner (file:line) count", ready to feed to flamegraph.pl.
+/// </summary>
+/// <returns>The folded stacks, or an empty string if there are no samples.</returns>
+String Profiler_GetFoldedStacks(void)
+{
+	StringIntDictKeyValuePair *pairs;
+	StringBuilder stringBuilder;
+	Int i, count;
+
+	if (_stacks == NULL) return String_Empty;
+
+	count = StringIntDict_Count(_stacks);
+	pairs = StringIntDict_GetAll(_stacks);
+
+	stringBuilder = StringBuilder_Create();
+	for (i = 0; i < count; i++) {
+		StringBuilder_AppendFormat(stringBuilder, "%S %ld\n", pairs[i].key, (Int64)pairs[i].value);
+	}
+
+	return StringBuilder_ToString(stringBuilder);
+}
+
+static int Profiler_CompareEntries(const void *a, const void *b)
+{
+	ProfileEntry x = *(const ProfileEntry *)a;
+	ProfileEntry y = *(const ProfileEntry *)b;
+
+	if (x->ticks != y->ticks)
+		return x->ticks > y->ticks ? -1 : +1;
+	if (x->numInstructions != y->numInstructions)
+		return x->numInstructions > y->numInstructions ? -1 : +1;
+	return 0;
+}
+
+/// <summary>
+/// Get a human-readable table of every function the profiler saw, with its instruction count,
+/// sample count, and self time (time spent in it, not counting its callees), busiest first.
+/// </summary>
+/// <returns>The profile summary.</returns>
+String Profiler_GetSummary(void)
+{
+	ProfileEntry *entries;
+	ProfileEntry entry;
+	StringBuilder stringBuilder;
+	Int64 totalInstructions;
+	Int i, numEntries;
+
+	stringBuilder = StringBuilder_Create();
+
+	entries = GC_MALLOC_STRUCT_ARRAY(ProfileEntry, _numEntries + 1);
+	if (entries == NULL)
+		Smile_Abort_OutOfMemory();
+
+	numEntries = 0;
+	totalInstructions = 0;
+	for (i = 0; _entries != NULL && i <= _mask; i++) {
+		if (_entries[i] == NULL) continue;
+		entries[numEntries++] = _entries[i];
+		totalInstructions += _entries[i]->numInstructions;
+	}
+	qsort(entries, (size_t)numEntries, sizeof(ProfileEntry), Profiler_CompareEntries);
+
+	StringBuilder_AppendFormat(stringBuilder,
+		"Profile:\n"
+		"  Instructions: %ld\n"
+		"  Samples:      %ld (every %d us)\n"
+		"\n"
+		"  Instructions    Samples   Self (us)  Function\n",
+		totalInstructions, _numSamples, _sampleMicroseconds);
+
+	for (i = 0; i < numEntries; i++) {
+		entry = entries[i];
+		StringBuilder_AppendFormat(stringBuilder, "  %12ld %10ld %11ld  %S\n",
+			entry->numInstructions,
+			entry->numSamples,
+			(Int64)Smile_TicksToMicroseconds(entry->ticks),
+			Profiler_GetFunctionLabel(entry->segment));
+	}
+
+	return StringBuilder_ToString(stringBuilder);
+}
+
+static int Profiler_CompareAllocationSites(const void *a, const void *b)
+{
+	AllocationSite x = *(const AllocationSite *)a;
+	AllocationSite y = *(const AllocationSite *)b;
+
+	if (x->numBytes != y->numBytes)
+		return x->numBytes > y->numBytes ? -1 : +1;
+	if (x->numSamples != y->numSamples)
+		return x->numSamples > y->numSamples ? -1 : +1;
+	return 0;
+}
+
+/// <summary>
+/// Get a human-readable table of the allocation sites the allocation profiler saw, with the
+/// kind of object allocated at each, and estimates of how many objects and bytes it allocated
+/// (its sampled totals, scaled up by the sampling rate), biggest first.
+/// </summary>
+/// <param name="maxSites">The most sites to include, or zero to include all of them.</param>
+/// <returns>The allocation report.</returns>
+String Profiler_GetAllocationReport(Int maxSites)
+{
+	AllocationSite *sites;
+	AllocationSite site;
+	StringBuilder stringBuilder;
+	Int i, numSites;
+
+	stringBuilder = StringBuilder_Create();
+
+	numSites = _numAllocationSites;
+	sites = GC_MALLOC_STRUCT_ARRAY(AllocationSite, numSites + 1);
+	if (sites == NULL)
+		Smile_Abort_OutOfMemory();
+	if (numSites > 0)
+		MemCpy(sites, _allocationSites, sizeof(AllocationSite) * numSites);
+	qsort(sites, (size_t)numSites, sizeof(AllocationSite), Profiler_CompareAllocationSites);
+
+	if (maxSites > 0 && numSites > maxSites)
+		numSites = maxSites;
+
+	StringBuilder_AppendFormat(stringBuilder,
+		"Allocations:\n"
+		"  Samples:      %ld (about one in every %d)\n"
+		"  Estimated:    %ld allocations, %ld bytes\n"
+		"\n"
+		"         Count         Bytes  Kind                 Site\n",
+		_numAllocationSamples, (Int)_allocationSampleEvery,
+		_numAllocationSamples * _allocationSampleEvery, _numAllocationBytes * _allocationSampleEvery);
+
+	for (i = 0; i < numSites; i++) {
+		site = sites[i];
+		StringBuilder_AppendFormat(stringBuilder, "  %12ld  %12ld  %S",
+			site->numSamples * _allocationSampleEvery,
+			site->numBytes * _allocationSampleEvery,
+			site->what);
+		StringBuilder_AppendRepeat(stringBuilder, ' ', String_Length(site->what) < 20 ? 21 - String_Length(site->what) : 1);
+		StringBuilder_AppendFormat(stringBuilder, "%S\n", site->site);
+	}
+
+	return StringBuilder_ToString(stringBuilder);
+}
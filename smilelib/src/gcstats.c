@@ -0,0 +1,166 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/gc.h>
+#include <smile/string.h>
+#include <smile/gcstats.h>
+
+// The pause statistics live in static data, not on the GC heap, since they're updated by
+// the collector's event callback in the middle of a collection, when it's unsafe to allocate
+// or to write to any page the collector may be tracking for incremental mode.
+static Bool _gcStatsStarted = False;
+static Bool _gcIsIncremental = False;
+static Int32 _gcDepth = 0;
+static UInt64 _gcPauseStart = 0;
+static UInt64 _gcMarkStart = 0;
+static double _gcTotalPause = 0.0;
+static double _gcTotalMark = 0.0;
+static struct SimpleStatsStruct _gcPauseStats;
+
+/// <summary>
+/// Called by the collector at the start and end of each stretch of collection work, and of
+/// each mark phase within it.  Nested stretches (a full collection started from within an
+/// incremental step) are counted as part of the outermost one, since that's the pause that
+/// the program actually sees.
+/// </summary>
+static void GC_CALLBACK Smile_OnGcEvent(GC_EventType event)
+{
+	double milliseconds;
+
+	switch (event) {
+		case GC_EVENT_START:
+			if (_gcDepth++ == 0)
+				_gcPauseStart = Smile_GetTicks();
+			break;
+
+		case GC_EVENT_END:
+			if (_gcDepth > 0 && --_gcDepth == 0) {
+				milliseconds = Smile_TicksToSeconds(Smile_GetTicks() - _gcPauseStart) * 1000.0;
+				_gcTotalPause += milliseconds;
+				SimpleStats_Add(&_gcPauseStats, milliseconds);
+			}
+			break;
+
+		case GC_EVENT_MARK_START:
+			_gcMarkStart = Smile_GetTicks();
+			break;
+
+		case GC_EVENT_MARK_END:
+			_gcTotalMark += Smile_TicksToSeconds(Smile_GetTicks() - _gcMarkStart) * 1000.0;
+			break;
+
+		default:
+			break;
+	}
+}
+
+/// <summary>
+/// Switch the collector into its generational/incremental mode.  Instead of stopping the
+/// program to trace the whole heap, it traces a little at a time during allocation, and uses
+/// dirty bits (write-protected pages) to find out which objects were changed in the meantime,
+/// so that young garbage can be reclaimed without retracing older objects.
+/// </summary>
+/// <param name="maxPauseMilliseconds">The target for the longest world-stopped pause, or
+/// zero to use the collector's default.  This is a target, not a hard bound.</param>
+/// <returns>True if the platform supports dirty bits and incremental mode is now on; false if
+/// the collector will keep running in its default stop-the-world mode.</returns>
+Bool Smile_EnableIncrementalGc(Int maxPauseMilliseconds)
+{
+	if (GC_incremental_protection_needs() == GC_PROTECTS_NONE)
+		return False;
+
+	if (maxPauseMilliseconds > 0)
+		GC_set_time_limit((unsigned long)maxPauseMilliseconds);
+
+	GC_enable_incremental();
+
+	_gcIsIncremental = True;
+	return True;
+}
+
+/// <summary>
+/// Start (or restart) collecting statistics on the collector's pause times.
+/// </summary>
+void Smile_StartGcStats(void)
+{
+	MemZero(&_gcPauseStats, sizeof(struct SimpleStatsStruct));
+	_gcTotalPause = 0.0;
+	_gcTotalMark = 0.0;
+	_gcDepth = 0;
+
+	if (!_gcStatsStarted) {
+		GC_set_on_collection_event(Smile_OnGcEvent);
+		_gcStatsStarted = True;
+	}
+}
+
+/// <summary>
+/// Determine whether Smile_StartGcStats() has been called, and pause times are being recorded.
+/// </summary>
+Bool Smile_IsCollectingGcStats(void)
+{
+	return _gcStatsStarted;
+}
+
+/// <summary>
+/// Get a snapshot of the collector's statistics.  Pause times are only available if
+/// Smile_StartGcStats() was called first; otherwise, they will all be zero.
+/// </summary>
+/// <returns>A new GcStats object describing the collector's work so far.</returns>
+GcStats Smile_GetGcStats(void)
+{
+	GcStats stats;
+	SimpleStats pauseStats;
+
+	// Copy the pause statistics first, so the allocations below can't change them.
+	pauseStats = SimpleStats_Create();
+	MemCpy(pauseStats, &_gcPauseStats, sizeof(struct SimpleStatsStruct));
+
+	stats = GC_MALLOC_STRUCT(struct GcStatsStruct);
+	if (stats == NULL) Smile_Abort_OutOfMemory();
+
+	stats->isIncremental = _gcIsIncremental;
+	stats->numCollections = (Int64)GC_get_gc_no();
+	stats->heapSize = (Int64)GC_get_heap_size();
+	stats->totalBytesAllocated = (Int64)GC_get_total_bytes();
+	stats->totalPauseMilliseconds = _gcTotalPause;
+	stats->totalMarkMilliseconds = _gcTotalMark;
+	stats->pauseStats = pauseStats;
+
+	return stats;
+}
+
+String GcStats_ToString(GcStats stats)
+{
+	return String_Format(
+		"GC Stats:\n"
+		"  Mode:         %s\n"
+		"  Collections:  %ld\n"
+		"  Heap:         size: %ld, total allocated: %ld\n"
+		"  Pause time:   total: %f ms, marking: %f ms\n"
+		"  Pauses (ms):  %S\n",
+
+		stats->isIncremental ? "incremental" : "stop-the-world",
+		stats->numCollections,
+		stats->heapSize,
+		stats->totalBytesAllocated,
+		stats->totalPauseMilliseconds,
+		stats->totalMarkMilliseconds,
+		SimpleStats_ToString(stats->pauseStats)
+	);
+}
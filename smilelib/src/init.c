@@ -25,6 +25,7 @@
 #include <smile/env/knownsymbols.h>
 #include <smile/env/knownobjects.h>
 #include <smile/env/knownbases.h>
+#include <smile/eval/constantpool.h>
 #include <smile/smiletypes/smilelist.h>
 #include <smile/smiletypes/smileuserobject.h>
 #include <smile/smiletypes/text/smilesymbol.h>
@@ -73,6 +74,7 @@ void Smile_ResetEnvironment(void)
 	MemZero(&Smile_KnownSymbols, sizeof(struct KnownSymbolsStruct));
 	MemZero(&Smile_KnownBases, sizeof(struct KnownBasesStruct));
 	MemZero(&Smile_KnownObjects, sizeof(struct KnownObjectsStruct));
+	ConstantPool_Reset();
 
 	// Now give the garbage collector a chance to make the world as clean as possible.
 	GC_gcollect();
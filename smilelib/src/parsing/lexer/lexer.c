@@ -18,6 +18,7 @@
 #include <smile/parsing/lexer.h>
 #include <smile/parsing/tokenkind.h>
 #include <smile/parsing/identkind.h>
+#include <smile/atomic.h>
 
 #include <smile/internal/staticstring.h>
 #include <smile/parsing/internal/lexerinternal.h>
@@ -51,12 +52,27 @@ STATIC_STRING(KeywordTypeof, "typeof");
 Lexer Lexer_Create(String input, Int start, Int length, String filename, Int firstLine, Int firstColumn)
 {
 	Lexer lexer = GC_MALLOC_STRUCT(struct LexerStruct);
+	if (lexer == NULL)
+		Smile_Abort_OutOfMemory();
+
+	return Lexer_Init(lexer, input, start, length, filename, firstLine, firstColumn) ? lexer : NULL;
+}
+
+/// <summary>
+/// Set up a lexical analyzer in caller-provided storage (such as on the stack), for short-lived
+/// lexers that don't need to be on the GC heap.  The arguments are the same as for Lexer_Create().
+/// </summary>
+/// <returns>True if the lexer was set up, or False if the input coordinates make no sense.</returns>
+Bool Lexer_Init(Lexer lexer, String input, Int start, Int length, String filename, Int firstLine, Int firstColumn)
+{
 	Int inputLength = String_Length(input);
 
 	// If the input coordinates make no sense, abort.  We do this test in such a way that it's safe
 	// even for very large input values.
 	if (start < 0 || length < 0 || start > inputLength || length > inputLength || start + length > inputLength)
-		return NULL;
+		return False;
+
+	MemZero(lexer, sizeof(struct LexerStruct));
 
 	// Set up the read pointers.
 	lexer->input = String_GetBytes(input);
@@ -66,6 +82,7 @@ Lexer Lexer_Create(String input, Int start, Int length, String filename, Int fir
 
 	// Set up the location tracking.
 	lexer->filename = filename;
+	lexer->fileId = Lexer_InternFilename(filename);
 	lexer->line = firstLine;
 
 	// Set up the output ring buffer.
@@ -73,7 +90,7 @@ Lexer Lexer_Create(String input, Int start, Int length, String filename, Int fir
 	lexer->tokenIndex = 0;
 	lexer->ungetCount = 0;
 
-	return lexer;
+	return True;
 }
 
 /// <summary>
@@ -97,6 +114,7 @@ LexerPosition Lexer_GetPosition(Lexer lexer)
 		if (position == NULL)
 			Smile_Abort_OutOfMemory();
 		position->filename = lexer->filename;
+		position->fileId = lexer->fileId;
 		position->line = (Int32)lexer->line;
 		position->lineStart = (Int32)(lexer->lineStart - lexer->input);
 		position->column = (Int32)(lexer->src - lexer->lineStart);
@@ -153,6 +171,89 @@ Token Token_Clone(Token token)
 	return newToken;
 }
 
+//---------------------------------------------------------------------------
+//  Interned filenames.
+//
+//  Source positions stored inside parsed code refer to their files by a small integer ID
+//  rather than by a String pointer, so that they can be packed inline into the code itself.
+//  The table only ever grows, and filenames are few, so lookups by name are a simple scan.
+//  Readers never lock:  The table is replaced wholesale (and the count published after it)
+//  whenever it grows, so any reader sees a consistent snapshot.
+
+static String *_filenames = NULL;		// The interned filenames, indexed by ID; ID 0 means "no file."
+static Int32 _numFilenames = 1;			// The number of IDs in use, including the reserved ID 0.
+static Int32 _maxFilenames = 0;			// The allocated size of the _filenames array.
+static Int32 _filenameWriteLock = 0;	// A spinlock held while adding filenames.
+
+static Int32 Lexer_FindFilename(String *filenames, Int32 count, String filename)
+{
+	Int32 i;
+
+	for (i = count - 1; i > 0; i--) {
+		if (filenames[i] == filename || String_Equals(filenames[i], filename))
+			return i;
+	}
+	return 0;
+}
+
+/// <summary>
+/// Get the ID of the given filename, adding it to the table of known filenames if it is new.
+/// Equal filenames always get the same ID, from any thread.
+/// </summary>
+/// <param name="filename">The filename to look up (may be NULL).</param>
+/// <returns>The filename's ID, which is always positive, or 0 if the filename is NULL.</returns>
+Int32 Lexer_InternFilename(String filename)
+{
+	String *filenames, *newFilenames;
+	Int32 count, fileId;
+
+	if (filename == NULL)
+		return 0;
+
+	count = Atomic_LoadInt32(&_numFilenames);
+	filenames = (String *)Atomic_LoadPointer((const void **)&_filenames);
+	if ((fileId = Lexer_FindFilename(filenames, count, filename)) > 0)
+		return fileId;
+
+	while (!Atomic_CompareAndSwapInt32(&_filenameWriteLock, 0, 1)) ;
+
+	// Someone else may have added it while we waited for the lock.
+	count = _numFilenames;
+	if ((fileId = Lexer_FindFilename(_filenames, count, filename)) == 0) {
+		if (count >= _maxFilenames) {
+			_maxFilenames = _maxFilenames ? _maxFilenames * 2 : 16;
+			newFilenames = GC_MALLOC_STRUCT_ARRAY(String, _maxFilenames);
+			if (newFilenames == NULL)
+				Smile_Abort_OutOfMemory();
+			if (count > 1)
+				MemCpy(newFilenames, _filenames, sizeof(String) * count);
+			Atomic_StorePointer((void **)&_filenames, newFilenames);
+		}
+		fileId = count;
+		_filenames[fileId] = filename;
+		Atomic_StoreInt32(&_numFilenames, count + 1);
+	}
+
+	Atomic_StoreInt32(&_filenameWriteLock, 0);
+	return fileId;
+}
+
+/// <summary>
+/// Get the filename that has the given ID.
+/// </summary>
+/// <param name="fileId">A filename ID returned from Lexer_InternFilename().</param>
+/// <returns>The filename, or NULL if the ID is 0 or unknown.</returns>
+String Lexer_GetInternedFilename(Int32 fileId)
+{
+	String *filenames;
+
+	if (fileId <= 0 || fileId >= Atomic_LoadInt32(&_numFilenames))
+		return NULL;
+
+	filenames = (String *)Atomic_LoadPointer((const void **)&_filenames);
+	return filenames[fileId];
+}
+
 //---------------------------------------------------------------------------
 //  Core lexer.
 
@@ -210,6 +311,8 @@ retryAtSrc:
 		case ' ':
 			// Simple whitespace characters.  We consume as much whitespace as possible for better
 			// performance, since whitespace tends to come in clumps in code.
+			if (Lexer_SkipWhitespaceWords(lexer, &src, end))
+				isFirstContentOnLine = True;
 			while (src < end && (ch = *src) <= '\x20' && ch != '\n' && ch != '\r') src++;
 			hasPrecedingWhitespace = True;
 			goto retryAtSrc;
@@ -220,6 +323,7 @@ retryAtSrc:
 				src++;
 			lexer->line++;
 			lexer->lineStart = src;
+			Lexer_SkipWhitespaceWords(lexer, &src, end);
 			isFirstContentOnLine = True;
 			hasPrecedingWhitespace = True;
 			goto retryAtSrc;
@@ -230,6 +334,7 @@ retryAtSrc:
 				src++;
 			lexer->line++;
 			lexer->lineStart = src;
+			Lexer_SkipWhitespaceWords(lexer, &src, end);
 			isFirstContentOnLine = True;
 			hasPrecedingWhitespace = True;
 			goto retryAtSrc;
@@ -66,6 +66,47 @@ static Bool IsValidRestartCharacter(const Byte *src, const Byte *end)
 	}
 }
 
+/// <summary>
+/// Skip forward over plain ASCII letters, digits, and underscores a word at a time, since those
+/// make up the bulk of most names.  This stops at the first byte that is anything else, and
+/// leaves that for the caller to handle.
+/// </summary>
+/// <param name="srcPtr">The current input pointer, which will be moved forward.</param>
+/// <param name="end">The end of the input.</param>
+/// <returns>True if any ASCII letters were skipped; false if there were none.</returns>
+Inline Bool SkipPlainNameWords(const Byte **srcPtr, const Byte *end)
+{
+	const Byte *src = *srcPtr;
+	UInt64 word, letters, plain;
+	Bool sawLetters = False;
+	Int count;
+
+	while (end - src >= 8) {
+		word = ByteWord_Load(src);
+		if (ByteWord_HasNonAscii(word))
+			break;
+
+		letters = ByteWord_MatchAsciiRange(ByteWord_AsciiToLower(word), 'a', 'z');
+		plain = letters | ByteWord_MatchAsciiRange(word, '0', '9') | ByteWord_MatchByte(word, '_');
+
+		if (plain != BYTEWORD_HIGHS) {
+			// Take just the plain bytes at the start of this word, and then stop.
+			count = ByteWord_FirstMatch(~plain & BYTEWORD_HIGHS);
+			if (letters & ByteWord_LanesBefore(count))
+				sawLetters = True;
+			src += count;
+			break;
+		}
+
+		if (letters)
+			sawLetters = True;
+		src += 8;
+	}
+
+	*srcPtr = src;
+	return sawLetters;
+}
+
 static String ParseNameRaw(Lexer lexer, Bool *hasEscapes)
 {
 	DECLARE_INLINE_STRINGBUILDER(namebuf, 64);
@@ -82,6 +123,9 @@ static String ParseNameRaw(Lexer lexer, Bool *hasEscapes)
 	*hasEscapes = False;
 
 readMoreName:
+	if (SkipPlainNameWords(&src, end))
+		charsets |= ((UInt64)1) << (IDENTKIND_CHARSET_LATIN >> 4);
+
 	if (src < end) {
 		switch (ch = *src) {
 
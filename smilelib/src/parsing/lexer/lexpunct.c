@@ -44,6 +44,7 @@ Int Lexer_ParseSlash(Lexer lexer, Bool isFirstContentOnLine)
 
 		// A // single-line comment.
 		case '/':
+			src = Lexer_SkipToLineBreakOr(src, end, '\n', '\n');
 			while (src < end && (ch = *src) != '\n' && ch != '\r')
 				src++;
 			lexer->src = src;
@@ -54,6 +55,8 @@ Int Lexer_ParseSlash(Lexer lexer, Bool isFirstContentOnLine)
 			startLine = lexer->line;
 
 			for (;;) {
+				src = Lexer_SkipToLineBreakOr(src, end, '*', '*');
+
 				if (src >= end) {
 					START_TOKEN(src - 1);
 					lexer->token->text = String_FormatString(UnterminatedCommentMessage, startLine);
@@ -65,11 +68,13 @@ Int Lexer_ParseSlash(Lexer lexer, Bool isFirstContentOnLine)
 					if (src < end && *src == '\r')
 						src++;
 					lexer->line++;
+					lexer->lineStart = src;
 				}
 				else if (ch == '\r') {
 					if (src < end && *src == '\n')
 						src++;
 					lexer->line++;
+					lexer->lineStart = src;
 				}
 
 				if (ch == '*' && src < end && *src == '/') {
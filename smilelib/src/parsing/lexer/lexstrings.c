@@ -95,6 +95,7 @@ retry:
 				src++;
 			}
 			lexer->line++;
+			lexer->lineStart = src;
 			goto retry;
 
 		// Handle newlines of the second kind.
@@ -109,6 +110,7 @@ retry:
 				src++;
 			}
 			lexer->line++;
+			lexer->lineStart = src;
 			goto retry;
 
 		// If we see quotes, count them up so we know when we've reached the end of the string.
@@ -124,9 +126,11 @@ retry:
 			if (src < end) src++;
 			goto retry;
 
-		// Everything else just gets collected to be appended to the output.
+		// Everything else just gets collected to be appended to the output, so skip ahead
+		// to the next character that needs attention.
 		default:
 			quoteCount = 0;
+			src = Lexer_SkipToLineBreakOr(src, end, '\"', '\\');
 			goto retry;
 	}
 
@@ -271,6 +275,7 @@ retry:
 				src++;
 			}
 			lexer->line++;
+			lexer->lineStart = src;
 			goto retry;
 
 		// Handle newlines of the second kind.
@@ -285,6 +290,7 @@ retry:
 				src++;
 			}
 			lexer->line++;
+			lexer->lineStart = src;
 			goto retry;
 
 		// If we see apostrophes, count them up so we know when we've reached the end of the string.
@@ -293,9 +299,11 @@ retry:
 				break;
 			goto retry;
 
-		// Everything else just gets collected to be appended to the output.
+		// Everything else just gets collected to be appended to the output, so skip ahead
+		// to the next character that needs attention.
 		default:
 			quoteCount = 0;
+			src = Lexer_SkipToLineBreakOr(src, end, '\'', '\'');
 			goto retry;
 	}
 
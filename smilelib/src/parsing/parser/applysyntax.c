@@ -161,11 +161,12 @@ static SmileObject Parser_RecursivelyClone(SmileObject expr)
 
 		case SMILE_KIND_LIST | SMILE_FLAG_WITHSOURCE:
 		{
-			struct SmileListWithSourceInt *oldList = (struct SmileListWithSourceInt *)expr;
+			SmileList oldList = (SmileList)expr;
+			struct LexerPositionStruct position;
 			SmileList newList = SmileList_ConsWithSource(
 				Parser_RecursivelyClone(oldList->a),
 				Parser_RecursivelyClone(oldList->d),
-				oldList->position
+				SmileList_GetSourcePosition(oldList, &position)
 			);
 			return (SmileObject)newList;
 		}
@@ -182,7 +183,7 @@ Inline SmileObject Parser_ApplyListOf(Parser parser, SmileList list, Int32Dict r
 	SmileList head = NullList, tail = NullList;
 
 	for (; SMILE_KIND(list) != SMILE_KIND_NULL; list = LIST_REST(list)) {
-		LexerPosition lexerPosition = (list->kind & SMILE_FLAG_WITHSOURCE) ? ((struct SmileListWithSourceInt *)list)->position : NULL;
+		LexerPosition lexerPosition = Parser_GetSourcePosition(parser, (SmileObject)list);
 		SmileObject oldValue = list->a;
 		SmileObject newValue = Parser_RecursivelyApplyTemplate(parser, oldValue, replacements, lexerPosition);
 
@@ -202,7 +203,7 @@ Inline SmileObject Parser_ApplyListCombine(Parser parser, SmileList list, Int32D
 	SmileList head = NullList, tail = NullList;
 
 	for (; SMILE_KIND(list) != SMILE_KIND_NULL; list = LIST_REST(list)) {
-		LexerPosition lexerPosition = (list->kind & SMILE_FLAG_WITHSOURCE) ? ((struct SmileListWithSourceInt *)list)->position : NULL;
+		LexerPosition lexerPosition = Parser_GetSourcePosition(parser, (SmileObject)list);
 		SmileObject oldValue = list->a;
 		SmileObject newValue = Parser_RecursivelyApplyTemplate(parser, oldValue, replacements, lexerPosition);
 
@@ -215,9 +216,8 @@ Inline SmileObject Parser_ApplyListCombine(Parser parser, SmileList list, Int32D
 		// static content, so we *must* append clones to ensure templates can be reused.
 		for (; SMILE_KIND(newValue) == SMILE_KIND_LIST; newValue = ((SmileList)newValue)->d) {
 			SmileObject newItem = ((SmileList)newValue)->a;
-			LexerPosition newPosition = (newValue->kind & SMILE_FLAG_WITHSOURCE) ? ((struct SmileListWithSourceInt *)list)->position : lexerPosition;
-			if (newPosition != NULL) {
-				LIST_APPEND_WITH_SOURCE(head, tail, newItem, newPosition);
+			if (lexerPosition != NULL) {
+				LIST_APPEND_WITH_SOURCE(head, tail, newItem, lexerPosition);
 			}
 			else {
 				LIST_APPEND(head, tail, newItem);
@@ -230,7 +230,7 @@ Inline SmileObject Parser_ApplyListCombine(Parser parser, SmileList list, Int32D
 
 Inline SmileObject Parser_ApplyListCons(Parser parser, SmileList list, Int32Dict replacements)
 {
-	LexerPosition lexerPosition = (list->kind & SMILE_FLAG_WITHSOURCE) ? ((struct SmileListWithSourceInt *)list)->position : NULL;
+	LexerPosition lexerPosition = Parser_GetSourcePosition(parser, (SmileObject)list);
 
 	SmileObject oldA = list->a;
 	SmileObject newA = Parser_RecursivelyApplyTemplate(parser, oldA, replacements, lexerPosition);
@@ -585,7 +585,7 @@ CustomSyntaxResult Parser_ApplyCustomSyntax(Parser parser, SmileObject *expr, In
 		transitionTable = ParserSyntaxTable_GetTransitionTable(parser, parser->currentScope->syntaxTable, node);
 		if (transitionTable == NULL) {
 			// Couldn't construct a transition table due to a grammar conflict.
-			*parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			*parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Grammar error: In rule '%S', the next state after '%S' is ambiguous",
 					SymbolTable_GetName(Smile_SymbolTable, syntaxClassSymbol),
 					SymbolTable_GetName(Smile_SymbolTable, node->name)));
@@ -619,7 +619,7 @@ CustomSyntaxResult Parser_ApplyCustomSyntax(Parser parser, SmileObject *expr, In
 			// The next node is a nonterminal, so recursively invoke it.
 
 			// Collect the current position, for error-reporting.
-			position = Token_GetPosition(parser->lexer->token);
+			position = Parser_GetTokenPosition(parser, parser->lexer->token);
 			Lexer_Unget(parser->lexer);
 
 			// Recursively traverse the syntax tree.  We record the 'follow' set so that the
@@ -734,7 +734,7 @@ CustomSyntaxResult Parser_ApplyCustomSyntax(Parser parser, SmileObject *expr, In
 		nextTokenAsString = SymbolTable_GetName(Smile_SymbolTable, tokenSymbol);
 
 		// Now make an error message that describes what went wrong.
-		*parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+		*parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 			String_Format("Syntax error: '%S' is not allowed in %S after '%S'",
 				nextTokenAsString, SymbolTable_GetName(Smile_SymbolTable, syntaxClassSymbol), recentNodesAsString));
 
@@ -0,0 +1,48 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/gc.h>
+#include <smile/parsing/internal/parsearena.h>
+
+/// <summary>
+/// Allocate memory from the arena when its current block doesn't have enough room left.
+/// Large requests get their own GC object; small ones start a new block (abandoning whatever
+/// was left in the old one, which stays alive only as long as something still points into it).
+/// </summary>
+/// <param name="arena">The arena to allocate from.</param>
+/// <param name="size">The number of bytes to allocate, already rounded up for alignment.</param>
+/// <returns>A pointer to the new zero-filled memory.</returns>
+void *ParseArena_AllocSlow(ParseArena arena, Int size)
+{
+	Byte *block;
+
+	if (size > PARSEARENA_BLOCKSIZE / 4) {
+		block = (Byte *)GC_MALLOC(size);
+		if (block == NULL)
+			Smile_Abort_OutOfMemory();
+		return block;
+	}
+
+	block = (Byte *)GC_MALLOC(PARSEARENA_BLOCKSIZE);
+	if (block == NULL)
+		Smile_Abort_OutOfMemory();
+
+	arena->ptr = block + size;
+	arena->end = block + PARSEARENA_BLOCKSIZE;
+	return block;
+}
@@ -50,12 +50,12 @@ ParseError Parser_ParseKeywordList(Parser parser, SmileObject *expr)
 
 			// No keyword name?  That's an error.
 			*expr = NullObject;
-			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				MissingKeywordNameMessage);
 			return error;
 		}
 
-		error = ParseScope_DeclareHere(parser->currentScope, token->data.symbol, PARSEDECL_KEYWORD, Token_GetPosition(token), NULL);
+		error = ParseScope_DeclareHere(parser->currentScope, token->data.symbol, PARSEDECL_KEYWORD, Parser_GetTokenPosition(parser, token), NULL);
 		if (error != NULL) {
 			*expr = NullObject;
 			return error;
@@ -85,7 +85,7 @@ ParseError Parser_ParseVarDecls(Parser parser, SmileObject *expr, Int modeFlags,
 	// Wrap it in a list of itself, so it becomes [[\ = x 5]].
 	LIST_INIT(head, tail);
 	if (decl->kind != SMILE_KIND_NULL) {
-		LIST_APPEND_WITH_SOURCE(head, tail, decl, ((struct SmileListWithSourceInt *)decl)->position);
+		LIST_APPEND_WITH_SOURCE(head, tail, decl, Parser_GetSourcePosition(parser, decl));
 	}
 
 	// Every time we see a comma, parse the next declaration, and add it to the list if it
@@ -96,7 +96,7 @@ ParseError Parser_ParseVarDecls(Parser parser, SmileObject *expr, Int modeFlags,
 		if (error != NULL) return error;
 
 		if (decl->kind != SMILE_KIND_NULL) {
-			LIST_APPEND_WITH_SOURCE(head, tail, decl, ((struct SmileListWithSourceInt *)decl)->position);
+			LIST_APPEND_WITH_SOURCE(head, tail, decl, Parser_GetSourcePosition(parser, decl));
 		}
 	}
 
@@ -108,7 +108,7 @@ ParseError Parser_ParseVarDecls(Parser parser, SmileObject *expr, Int modeFlags,
 	*expr = head->kind == SMILE_KIND_NULL
 		? Parser_IgnorableObject
 		: (SmileObject)SmileList_ConsWithSource((SmileObject)Smile_KnownObjects._prognSymbol, (SmileObject)head,
-			((struct SmileListWithSourceInt *)head)->position);
+			Parser_GetSourcePosition(parser, (SmileObject)head));
 	return NULL;
 }
 
@@ -129,7 +129,7 @@ ParseError Parser_ParseDecl(Parser parser, SmileObject *expr, Int modeFlags, Int
 
 		// No variable name?  That's an error.
 		*expr = NullObject;
-		error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+		error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 			declKind == PARSEDECL_AUTO ? MissingAutoNameMessage
 			: declKind == PARSEDECL_CONST ? MissingConstNameMessage
 			: declKind == PARSEDECL_VARIABLE ? MissingVarNameMessage
@@ -149,12 +149,12 @@ ParseError Parser_ParseDecl(Parser parser, SmileObject *expr, Int modeFlags, Int
 		if (error != NULL) return error;
 
 		// Now that we've parsed the value, we can safely declare it in the current scope.
-		error = ParseScope_Declare(parser->currentScope, symbol, declKind, Token_GetPosition(token), NULL);
+		error = ParseScope_Declare(parser->currentScope, symbol, declKind, Parser_GetTokenPosition(parser, token), NULL);
 		if (error != NULL)
 			return error;
 
 		// Build the result, which is a list shaped like [$set symbol rvalue]
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 		*expr =
 			(SmileObject)SmileList_ConsWithSource((SmileObject)Smile_KnownObjects._setSymbol,
 				(SmileObject)SmileList_ConsWithSource((SmileObject)SmileSymbol_Create(symbol),
@@ -171,14 +171,14 @@ ParseError Parser_ParseDecl(Parser parser, SmileObject *expr, Int modeFlags, Int
 		// It's 'auto' or 'const', but with no assignment.  That's an error.
 		Lexer_Unget(parser->lexer);
 		*expr = NullObject;
-		error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+		error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 			declKind == PARSEDECL_AUTO ? MissingAutoRValueMessage : MissingConstRValueMessage);
 		return error;
 	}
 	else {
 
 		// Declare it in the current scope.
-		error = ParseScope_Declare(parser->currentScope, symbol, declKind, Token_GetPosition(token), NULL);
+		error = ParseScope_Declare(parser->currentScope, symbol, declKind, Parser_GetTokenPosition(parser, token), NULL);
 		if (error != NULL)
 			return error;
 
@@ -195,6 +195,7 @@ ParseError Parser_ParseOpEquals(Parser parser, SmileObject *expr, Int modeFlags)
 {
 	ParseError error;
 	Token opToken;
+	Symbol opSymbol;
 	SmileObject lvalue, rvalue;
 	LexerPosition lexerPosition;
 
@@ -213,9 +214,11 @@ ParseError Parser_ParseOpEquals(Parser parser, SmileObject *expr, Int modeFlags)
 
 	// Op-equal assignment to a known variable.
 
-	// First, consume the op-equals part.
+	// First, consume the op-equals part.  The lexer recycles its tokens, so we must copy out
+	// the operator now, before parsing the rvalue reads more tokens over top of it.
 	opToken = Parser_NextToken(parser);		// Consume the operator name.
-	lexerPosition = Token_GetPosition(opToken);
+	opSymbol = opToken->data.symbol;
+	lexerPosition = Parser_GetTokenPosition(parser, opToken);
 	Parser_NextToken(parser);				// Consume the TOKEN_EQUALWITHOUTWHITESPACE.
 
 	// Collect the rvalue.
@@ -225,7 +228,7 @@ ParseError Parser_ParseOpEquals(Parser parser, SmileObject *expr, Int modeFlags)
 	// Build the result, which is a list shaped like [$opset operator lvalue rvalue]
 	*expr =
 		(SmileObject)SmileList_ConsWithSource((SmileObject)Smile_KnownObjects._opsetSymbol,
-			(SmileObject)SmileList_ConsWithSource((SmileObject)SmileSymbol_Create(opToken->data.symbol),
+			(SmileObject)SmileList_ConsWithSource((SmileObject)SmileSymbol_Create(opSymbol),
 				(SmileObject)SmileList_ConsWithSource(lvalue,
 					(SmileObject)SmileList_ConsWithSource(rvalue,
 						NullObject,
@@ -259,10 +262,10 @@ ParseError Parser_ParseEquals(Parser parser, SmileObject *expr, Int modeFlags)
 		// This is a variable declaration-and-assignment statement.
 
 		Parser_NextToken(parser);		// Consume the variable name.
-		position = Token_GetPosition(token);
+		position = Parser_GetTokenPosition(parser, token);
 
 		Parser_NextToken(parser);		// Consume the equal sign.
-		position2 = Token_GetPosition(token2);
+		position2 = Parser_GetTokenPosition(parser, token2);
 
 		// Declare the variable name in this scope.  (We don't need to subsequently check if
 		// we can assign it in this scope, since we just declared it.  If this scope is, say,
@@ -310,7 +313,7 @@ ParseError Parser_ParseEquals(Parser parser, SmileObject *expr, Int modeFlags)
 
 		// It is an lvalue followed by an equal sign, so this is a variable assignment.
 		token2 = Parser_NextToken(parser);
-		position2 = Token_GetPosition(token2);
+		position2 = Parser_GetTokenPosition(parser, token2);
 
 		// Collect the rvalue, recursively.
 		error = Parser_ParseEquals(parser, &rvalue, modeFlags);
@@ -356,7 +359,7 @@ ParseError Parser_ParseClassicSet(Parser parser, SmileObject *result, LexerPosit
 		lvalue = (SmileObject)SmileSymbol_Create(token->data.symbol);
 	
 		// Declare the variable name in this scope.
-		error = ParseScope_Declare(parser->currentScope, token->data.symbol, PARSEDECL_VARIABLE, Token_GetPosition(token), &decl);
+		error = ParseScope_Declare(parser->currentScope, token->data.symbol, PARSEDECL_VARIABLE, Parser_GetTokenPosition(parser, token), &decl);
 		if (error != NULL)
 			return error;
 	}
@@ -67,7 +67,7 @@ ParseError Parser_ParseStmt(Parser parser, SmileObject *expr, Int modeFlags)
 			*expr = (SmileObject)SmileList_ConsWithSource(
 				(SmileObject)SmileSymbol_Create(Smile_KnownSymbols._brk),
 				NullObject,
-				Token_GetPosition(token)
+				Parser_GetTokenPosition(parser, token)
 			);
 			return NULL;
 
@@ -83,21 +83,21 @@ ParseError Parser_ParseStmt(Parser parser, SmileObject *expr, Int modeFlags)
 				case SMILE_SPECIAL_SYMBOL_KEYWORD:
 					return Parser_ParseKeywordList(parser, expr);
 				case SMILE_SPECIAL_SYMBOL_IF:
-					return Parser_ParseIfUnless(parser, expr, modeFlags, False, Token_GetPosition(token));
+					return Parser_ParseIfUnless(parser, expr, modeFlags, False, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_UNLESS:
-					return Parser_ParseIfUnless(parser, expr, modeFlags, True, Token_GetPosition(token));
+					return Parser_ParseIfUnless(parser, expr, modeFlags, True, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_DO:
-					return Parser_ParseDo(parser, expr, modeFlags, Token_GetPosition(token));
+					return Parser_ParseDo(parser, expr, modeFlags, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_WHILE:
-					return Parser_ParseWhileUntil(parser, expr, modeFlags, False, Token_GetPosition(token));
+					return Parser_ParseWhileUntil(parser, expr, modeFlags, False, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_UNTIL:
-					return Parser_ParseWhileUntil(parser, expr, modeFlags, True, Token_GetPosition(token));
+					return Parser_ParseWhileUntil(parser, expr, modeFlags, True, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_RETURN:
-					return Parser_ParseReturn(parser, expr, modeFlags, Token_GetPosition(token));
+					return Parser_ParseReturn(parser, expr, modeFlags, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_TILL:
-					return Parser_ParseTill(parser, expr, modeFlags, Token_GetPosition(token));
+					return Parser_ParseTill(parser, expr, modeFlags, Parser_GetTokenPosition(parser, token));
 				case SMILE_SPECIAL_SYMBOL_TRY:
-					return Parser_ParseTry(parser, expr, modeFlags, Token_GetPosition(token));
+					return Parser_ParseTry(parser, expr, modeFlags, Parser_GetTokenPosition(parser, token));
 			}
 			// Fall through to default case if not a special form.
 
@@ -147,7 +147,7 @@ ParseError Parser_ParseIfUnless(Parser parser, SmileObject *expr, Int modeFlags,
 		&& token->data.symbol == SMILE_SPECIAL_SYMBOL_THEN)) {
 		// Missing 'then' keyword.
 		// We assume that's an error of omission, so we just rewind back a token and then try to keep going.
-		Parser_AddError(parser, Token_GetPosition(token), "Missing 'then' keyword after '%s'.", invert ? "unless" : "if");
+		Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "Missing 'then' keyword after '%s'.", invert ? "unless" : "if");
 		Lexer_Unget(parser->lexer);
 	}
 
@@ -240,7 +240,7 @@ ParseError Parser_ParseDo(Parser parser, SmileObject *expr, Int modeFlags, Lexer
 		&& (token->data.symbol == SMILE_SPECIAL_SYMBOL_WHILE || token->data.symbol == SMILE_SPECIAL_SYMBOL_UNTIL))) {
 		// Missing 'do' keyword.
 		// We assume that's an error of omission, so we just rewind back a token and then try to keep going.
-		Parser_AddError(parser, Token_GetPosition(token), "Missing 'while' or 'until' keyword after 'do'.");
+		Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "Missing 'while' or 'until' keyword after 'do'.");
 		Lexer_Unget(parser->lexer);
 	}
 	invert = token->data.symbol == SMILE_SPECIAL_SYMBOL_UNTIL;
@@ -297,7 +297,7 @@ ParseError Parser_ParseWhileUntil(Parser parser, SmileObject *expr, Int modeFlag
 		&& token->data.symbol == SMILE_SPECIAL_SYMBOL_DO)) {
 		// Missing 'do' keyword.
 		// We assume that's an error of omission, so we just rewind back a token and then try to keep going.
-		Parser_AddError(parser, Token_GetPosition(token), "Missing 'do' keyword after '%s'.", invert ? "until" : "while");
+		Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "Missing 'do' keyword after '%s'.", invert ? "until" : "while");
 		Lexer_Unget(parser->lexer);
 	}
 
@@ -371,7 +371,7 @@ ParseError Parser_ParseTry(Parser parser, SmileObject *expr, Int modeFlags, Lexe
 		&& token->data.symbol == SMILE_SPECIAL_SYMBOL_CATCH)) {
 		// Missing 'catch' keyword.
 		// We assume that's an error of omission, so we just rewind back a token and then try to keep going.
-		Parser_AddError(parser, Token_GetPosition(token), "Missing 'catch' keyword after 'try'.");
+		Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "Missing 'catch' keyword after 'try'.");
 		Lexer_Unget(parser->lexer);
 	}
 
@@ -399,14 +399,14 @@ ParseError Parser_ParseTry(Parser parser, SmileObject *expr, Int modeFlags, Lexe
 			// No recovery past this point; there are no more tokens we can consume in the grammar.
 			Lexer_Unget(parser->lexer);
 			*expr = NullObject;
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), String_FromC("'catch' handler must be a function."));
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), String_FromC("'catch' handler must be a function."));
 		}
 	}
 	else {
 		// No recovery past this point; there are no more tokens we can consume in the grammar.
 		Lexer_Unget(parser->lexer);
 		*expr = NullObject;
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), String_FromC("'catch' handler must be a function."));
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), String_FromC("'catch' handler must be a function."));
 	}
 
 	// Now make the resulting form: [$catch body handler]
@@ -437,7 +437,7 @@ ParseError Parser_ParseOrExpr(Parser parser, SmileObject *expr, Int modeFlags)
 		&& token->data.symbol == SMILE_SPECIAL_SYMBOL_OR
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParseAndExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -475,7 +475,7 @@ ParseError Parser_ParseAndExpr(Parser parser, SmileObject *expr, Int modeFlags)
 		&& token->data.symbol == SMILE_SPECIAL_SYMBOL_AND
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParseNotExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -546,7 +546,7 @@ ParseError Parser_ParseNotExpr(Parser parser, SmileObject *expr, Int modeFlags)
 	// We have unary operators to apply.  So spin out Smile expressions of the form [(expr.unary)] for
 	// each unary operator, going from last (innermost) to first (outermost).
 	for (i = numOperators - 1; i >= 0; i--) {
-		lexerPosition = Token_GetPosition(&unaryOperators[i]);
+		lexerPosition = Parser_GetTokenPosition(parser, &unaryOperators[i]);
 		// Not is a special built-in form:  [$not x]
 		*expr = (SmileObject)SmileList_CreateTwoWithSource(Smile_KnownObjects._notSymbol, *expr, lexerPosition);
 	}
@@ -623,7 +623,7 @@ parseNextOperator:
 		&& (symbolObject = Parser_GetSymbolObjectForCmpOperator(symbol = token->data.symbol)) != NULL
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParseAddExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -684,7 +684,7 @@ parseNextOperator:
 		&& ((symbol = token->data.symbol) == SMILE_SPECIAL_SYMBOL_PLUS || symbol == SMILE_SPECIAL_SYMBOL_MINUS)
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParseMulExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -744,7 +744,7 @@ parseNextOperator:
 		&& ((symbol = token->data.symbol) == SMILE_SPECIAL_SYMBOL_STAR || symbol == SMILE_SPECIAL_SYMBOL_SLASH)
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParseBinaryExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -846,7 +846,7 @@ parseNextOperator:
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)
 		&& Parser_IsAcceptableArbitraryBinaryOperator(parser, symbol = token->data.symbol)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		if ((modeFlags & COLONMODE_MASK) == COLONMODE_MEMBERDECL && Parser_HasLookahead(parser, TOKEN_COLON)) {
 			Lexer_Unget(parser->lexer);
@@ -868,7 +868,7 @@ parseNextOperator:
 			while (Lexer_Peek(parser->lexer) == TOKEN_COMMA) {
 				Lexer_Next(parser->lexer);
 
-				lexerPosition = Token_GetPosition(parser->lexer->token);
+				lexerPosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 
 				parseError = Parser_ParseColonExpr(parser, &rvalue, modeFlags);
 				if (parseError != NULL)
@@ -904,7 +904,7 @@ ParseError Parser_ParseColonExpr(Parser parser, SmileObject *expr, Int modeFlags
 	while ((token = Parser_NextToken(parser))->kind == TOKEN_COLON
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParseRangeExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -933,7 +933,7 @@ ParseError Parser_ParseRangeExpr(Parser parser, SmileObject *expr, Int modeFlags
 	if ((token = Parser_NextToken(parser))->kind == TOKEN_DOTDOT
 		&& ((modeFlags & BINARYLINEBREAKS_MASK) == BINARYLINEBREAKS_ALLOWED || !token->isFirstContentOnLine)) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		parseError = Parser_ParsePrefixExpr(parser, &rvalue, modeFlags);
 		if (parseError != NULL)
@@ -1033,7 +1033,7 @@ ParseError Parser_ParsePrefixExpr(Parser parser, SmileObject *expr, Int modeFlag
 		// for unary terms matches the binary-line-break rule; just as "x - \n y" is illegal,
 		// "- \n y" is also illegal.
 		if (token->isFirstContentOnLine && (modeFlags & BINARYLINEBREAKS_MASK) != BINARYLINEBREAKS_ALLOWED) {
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Expected an expression term on the same line after unary operator '%S'",
 					SymbolTable_GetName(Smile_SymbolTable, lastUnaryTokenSymbol)));
 		}
@@ -1053,7 +1053,7 @@ ParseError Parser_ParsePrefixExpr(Parser parser, SmileObject *expr, Int modeFlag
 	// We have unary operators to apply.  So spin out Smile expressions of the form [(expr.unary)] for
 	// each unary operator, going from last (innermost) to first (outermost).
 	for (i = numOperators - 1; i >= 0; i--) {
-		position = Token_GetPosition(&unaryOperators[i]);
+		position = Parser_GetTokenPosition(parser, &unaryOperators[i]);
 		symbol = unaryOperators[i].data.symbol;
 		if (symbol == SMILE_SPECIAL_SYMBOL_TYPEOF) {
 			// Typeof is a special built-in form:  [$typeof x]
@@ -1097,7 +1097,7 @@ ParseError Parser_ParseConsExpr(Parser parser, SmileObject *expr, Int modeFlags,
 
 	if (Lexer_Next(parser->lexer) == TOKEN_DOUBLEHASH) {
 
-		lexerPosition = Token_GetPosition(parser->lexer->token);
+		lexerPosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 		tail = SmileList_CreateOneWithSource(*expr, lexerPosition);
 		*expr = (SmileObject)tail;
 		isFirst = True;
@@ -1145,13 +1145,13 @@ ParseError Parser_ParseDotExpr(Parser parser, SmileObject *expr, Int modeFlags,
 			|| token->kind == TOKEN_UNKNOWNPUNCTNAME) {
 
 			symbol = token->data.symbol;
-			lexerPosition = Token_GetPosition(token);
+			lexerPosition = Parser_GetTokenPosition(parser, token);
 
 			*expr = (SmileObject)SmileList_CreateDotWithSource(*expr, (SmileObject)SmileSymbol_Create(symbol), lexerPosition);
 		}
 		else {
 			Lexer_Unget(parser->lexer);
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_Format("Expected a property name after '.', not '%S.'", TokenKind_ToString(token->kind)));
 		}
 	}
@@ -1170,12 +1170,12 @@ ParseError Parser_ParseParentheses(Parser parser, SmileObject *result, Int modeF
 
 	// Expect an initial '('; if it's not there, this is a programming error.
 	if (Lexer_Next(parser->lexer) != TOKEN_LEFTPARENTHESIS) {
-		Parser_AddFatalError(parser, Token_GetPosition(parser->lexer->token), "Expected '(' as first token in Parser_ParseParentheses().");
+		Parser_AddFatalError(parser, Parser_GetTokenPosition(parser, parser->lexer->token), "Expected '(' as first token in Parser_ParseParentheses().");
 		*result = NullObject;
 		return NULL;
 	}
 
-	startPosition = Token_GetPosition(parser->lexer->token);
+	startPosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 
 	// Parse the inside of the '(...)' block as an expression, with binary line-breaks allowed.
 	error = Parser_ParseExpr(parser, result, BINARYLINEBREAKS_ALLOWED | COMMAMODE_NORMAL | COLONMODE_MEMBERACCESS);
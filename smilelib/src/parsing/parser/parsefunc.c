@@ -36,7 +36,7 @@ ParseError Parser_ParseFunc(Parser parser, SmileObject *expr, Int modeFlags)
 	ParseError parseError;
 	Token token;
 
-	funcPosition = Token_GetPosition(parser->lexer->token);
+	funcPosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 
 	Parser_BeginScope(parser, PARSESCOPE_FUNCTION);
 
@@ -53,7 +53,7 @@ ParseError Parser_ParseFunc(Parser parser, SmileObject *expr, Int modeFlags)
 
 	if (Lexer_Next(parser->lexer) != TOKEN_BAR) {
 		Lexer_Unget(parser->lexer);
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 			String_Format("Expected |...| to end function parameters starting on line %d", funcPosition->lineStart));
 		*expr = NullObject;
 		Parser_EndScope(parser, False);
@@ -114,7 +114,7 @@ ParseError Parser_ParseParamsOpt(Parser parser, SmileList *params)
 			if (isFirst) {
 				if (parseError != NULL)
 					Parser_AddMessage(parser, parseError);
-				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 					String_Format("Illegal comma found in function parameter list"));
 				// Recover by simply absorbing the comma.
 			}
@@ -145,7 +145,7 @@ ParseError Parser_ParseParamsOpt(Parser parser, SmileList *params)
 					if (paramMetaSymbol == Smile_KnownSymbols.default_) {
 						if (parseError != NULL)
 							Parser_AddMessage(parser, parseError);
-						parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+						parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 							String_Format("Rest argument '%S' cannot have a default value assigned to it.",
 								SymbolTable_GetName(Smile_SymbolTable, paramName)));
 						// Recover by simply continuing.
@@ -160,7 +160,7 @@ ParseError Parser_ParseParamsOpt(Parser parser, SmileList *params)
 			if (Lexer_Peek(parser->lexer) != TOKEN_BAR) {
 				if (parseError != NULL)
 					Parser_AddMessage(parser, parseError);
-				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 					String_Format("Rest argument '%S' must be the last argument in the function declaration.",
 						SymbolTable_GetName(Smile_SymbolTable, paramName)));
 					// Recover by simply continuing.
@@ -212,13 +212,13 @@ ParseError Parser_ParseParam(Parser parser, SmileObject *param, LexerPosition *p
 
 	tokenKind = Lexer_Next(parser->lexer);
 	token = parser->lexer->token;
-	*position = paramPosition = Token_GetPosition(token);
+	*position = paramPosition = Parser_GetTokenPosition(parser, token);
 
 	// Make sure this starts with a valid name for the new function argument.
 	if (tokenKind != TOKEN_ALPHANAME && tokenKind != TOKEN_UNKNOWNALPHANAME
 		&& tokenKind != TOKEN_PUNCTNAME && tokenKind != TOKEN_UNKNOWNPUNCTNAME) {
 		*param = NullObject;
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 			String_Format("Invalid function argument name"));
 	}
 
@@ -244,20 +244,20 @@ ParseError Parser_ParseParam(Parser parser, SmileObject *param, LexerPosition *p
 			*param = NullObject;
 			return parseError;
 		}
-		typePosition = Token_GetPosition(parser->lexer->token);
+		typePosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 
 		// Make sure there's a colon after it.
 		tokenKind = Lexer_Next(parser->lexer);
 		if (tokenKind != TOKEN_COLON) {
 			*param = NullObject;
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Expected a ':' after function argument type"));
 		}
 	
 		// Now get the real function argument name.
 		tokenKind = Lexer_Next(parser->lexer);
 		token = parser->lexer->token;
-		paramPosition = Token_GetPosition(token);
+		paramPosition = Parser_GetTokenPosition(parser, token);
 		if (!(tokenKind == TOKEN_ALPHANAME || tokenKind == TOKEN_UNKNOWNALPHANAME
 			|| tokenKind == TOKEN_PUNCTNAME || tokenKind == TOKEN_UNKNOWNPUNCTNAME)) {
 			*param = NullObject;
@@ -305,7 +305,7 @@ ParseError Parser_ParseParam(Parser parser, SmileObject *param, LexerPosition *p
 		}
 		if (templateKind != TemplateKind_None) {
 			*param = NullObject;
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Default value for argument '%S' is not a constant value.", SymbolTable_GetName(Smile_SymbolTable, nameSymbol)));
 		}
 	
@@ -351,11 +351,11 @@ ParseError Parser_ParseParamType(Parser parser, SmileObject *type)
 	if (token->kind != TOKEN_ALPHANAME && token->kind != TOKEN_PUNCTNAME) {
 		*type = NullObject;
 		if (token->kind == TOKEN_UNKNOWNALPHANAME || token->kind == TOKEN_UNKNOWNPUNCTNAME) {
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_Format("The function argument type name \"{0}\" does not exist.",
 					SymbolTable_GetName(Smile_SymbolTable, token->data.symbol)));
 		}
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 			String_Format("Illegal function argument type name"));
 	}
 
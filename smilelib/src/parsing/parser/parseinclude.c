@@ -83,11 +83,11 @@ ParseError Parser_ParseInclude(Parser parser, SmileObject *expr)
 
 	if ((tokenKind = Lexer_Next(parser->lexer)) != TOKEN_DYNSTRING
 		&& tokenKind != TOKEN_RAWSTRING) {
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 			String_FromC("#include must be followed by a string naming a source file or a package"));
 	}
 
-	position = Token_GetPosition(parser->lexer->token);
+	position = Parser_GetTokenPosition(parser, parser->lexer->token);
 
 	filename = parser->lexer->token->text;
 
@@ -145,10 +145,10 @@ ParseError Parser_ParseInclude(Parser parser, SmileObject *expr)
 
 			// They want to import the #syntax rules exported by this module, so import them all
 			// (it's all-or-nothing, since there can be interdependencies between them).
-			Parser_ExposeSyntax(parser, parser->currentScope, moduleInfo, Token_GetPosition(parser->lexer->token));
+			Parser_ExposeSyntax(parser, parser->currentScope, moduleInfo, Parser_GetTokenPosition(parser, parser->lexer->token));
 		}
 		else {
-			Parser_AddError(parser, Token_GetPosition(parser->lexer->token), "Missing variable name after #include directive");
+			Parser_AddError(parser, Parser_GetTokenPosition(parser, parser->lexer->token), "Missing variable name after #include directive");
 
 			// If this was a comma, they wrote something like "foo, bar,, baz", so we
 			// can recover by just pretending we didn't see two in a row.
@@ -182,7 +182,7 @@ static ParseError Parser_ParseIncludeName(Parser parser, Symbol *oldName, Symbol
 	if (tokenKind != TOKEN_ALPHANAME && tokenKind != TOKEN_UNKNOWNALPHANAME
 		&& tokenKind != TOKEN_PUNCTNAME && tokenKind != TOKEN_UNKNOWNPUNCTNAME) {
 
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 			String_FromC("Missing variable name in #include directive"));
 	}
 
@@ -196,7 +196,7 @@ static ParseError Parser_ParseIncludeName(Parser parser, Symbol *oldName, Symbol
 		if (tokenKind != TOKEN_ALPHANAME && tokenKind != TOKEN_UNKNOWNALPHANAME
 			&& tokenKind != TOKEN_PUNCTNAME && tokenKind != TOKEN_UNKNOWNPUNCTNAME) {
 
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_FromC("Missing variable name after 'as' in #include directive"));
 		}
 
@@ -272,7 +272,10 @@ static ModuleInfo Parser_LoadUserFile(Parser parser, String filename, LexerPosit
 		return moduleInfo;
 	}
 
-	// Parse it!
+	// Parse it!  Note that this parses the file (and, recursively, anything it includes)
+	// serially, on this thread:  Even though included modules are independent of one another,
+	// parsing them in parallel would need a garbage collector that can stop and scan worker
+	// threads, and on Unix the bundled collector is built (and only ships sources) for one thread.
 	expr = Smile_ParseInScope(text, fullIncludePath, NULL, 0, &parseMessages, &numParseMessages, &moduleScope);
 
 	// Record it.
@@ -288,6 +291,8 @@ ParseError Parser_DefaultIncludeLoader(const String fullPath, const LexerPositio
 	StringBuilder stringBuilder;
 	Byte *buffer;
 	size_t readLength;
+	long fileLength;
+	String text;
 	ParseError parseError;
 
 	const int ReadLength = 0x10000;	// Read 64K at a time.
@@ -300,6 +305,24 @@ ParseError Parser_DefaultIncludeLoader(const String fullPath, const LexerPositio
 		return parseError;
 	}
 
+	// Most of the time, we can find out how big the file is, and read it straight into a
+	// string of exactly the right size, with no copying.  But if we can't tell how big it
+	// is, or it changes size while we're reading it, fall back to reading it in pieces.
+	if (fseek(fp, 0, SEEK_END) == 0 && (fileLength = ftell(fp)) > 0 && fseek(fp, 0, SEEK_SET) == 0) {
+		text = String_CreateInternal((Int)fileLength);
+		readLength = fread((Byte *)String_GetBytes(text), 1, (size_t)fileLength, fp);
+		if (readLength == (size_t)fileLength && fgetc(fp) == EOF) {
+			fclose(fp);
+			*result = text;
+			return NULL;
+		}
+		fseek(fp, 0, SEEK_SET);
+	}
+	else {
+		// If the file can't seek, this fails harmlessly, since we haven't moved anyway.
+		fseek(fp, 0, SEEK_SET);
+	}
+
 	// Make a StringBuilder to hold the file we're about to load.  We start it at 64K because
 	// that's enough to hold most (even fairly large!) source files without reallocation.
 	stringBuilder = StringBuilder_CreateWithSize(ReadLength);
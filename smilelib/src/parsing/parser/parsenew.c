@@ -39,7 +39,7 @@ ParseError Parser_ParseNewExpr(Parser parser, SmileObject *expr, Int modeFlags,
 	if (token->kind == TOKEN_LEFTBRACE) {
 		// If we got here, that means it's a curly brace in an rvalue position, so we treat it
 		// as a shorthand object instantiation, same as JavaScript does.
-		newTokenPosition = Token_GetPosition(token);
+		newTokenPosition = Parser_GetTokenPosition(parser, token);
 		base = (SmileObject)Smile_KnownObjects.ObjectSymbol;
 		goto shorthandForm;
 	}
@@ -51,8 +51,8 @@ ParseError Parser_ParseNewExpr(Parser parser, SmileObject *expr, Int modeFlags,
 	}
 
 	// Got the keyword 'new', so parse an object construction after it.
-	newTokenPosition = Token_GetPosition(token);
-	newToken = Token_Clone(token);
+	newTokenPosition = Parser_GetTokenPosition(parser, token);
+	newToken = Parser_CloneToken(parser, token);
 
 	// If we got a '{', then inherit from Object.  Otherwise, inherit from the next expression.
 	if (Parser_HasLookahead(parser, TOKEN_LEFTBRACE)) {
@@ -72,7 +72,7 @@ ParseError Parser_ParseNewExpr(Parser parser, SmileObject *expr, Int modeFlags,
 
 	// If we didn't get a '{' at this point to start the object's members, that's an error.
 	if (Lexer_Next(parser->lexer) != TOKEN_LEFTBRACE) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 			String_FromC("Missing a '{' after 'new'."));
 		*expr = NullObject;
 		return parseError;
@@ -87,7 +87,7 @@ shorthandForm:
 		*expr = NullObject;
 		Parser_Recover(parser, Parser_RightBracesBracketsParentheses_Recovery, Parser_RightBracesBracketsParentheses_Count);
 		if (!membersHaveErrors) {
-			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Missing a '}' to end the members in the 'new' block starting on line %d.", newTokenPosition->line));
 			return parseError;
 		}
@@ -135,10 +135,10 @@ Bool Parser_ParseMembers(Parser parser, SmileObject *expr)
 	while ((token = Parser_NextToken(parser))->kind == TOKEN_ALPHANAME || token->kind == TOKEN_UNKNOWNALPHANAME
 		|| token->kind == TOKEN_PUNCTNAME || token->kind == TOKEN_UNKNOWNPUNCTNAME) {
 		symbol = token->data.symbol;
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 
 		if (Lexer_Next(parser->lexer) != TOKEN_COLON) {
-			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Missing ':' after '%S' member.", SymbolTable_GetName(Smile_SymbolTable, symbol)));
 			Parser_AddMessage(parser, parseError);
 			if (Parser_Recover(parser, Parser_RightBracesColons_Recovery, Parser_RightBracesColons_Count)->kind != TOKEN_COLON) {
@@ -182,7 +182,7 @@ static ParseError Parser_ParseClassicNewMember(Parser parser, SmileObject *resul
 
 	// Consume the '['.
 	token = Parser_NextToken(parser);
-	position = Token_GetPosition(token);
+	position = Parser_GetTokenPosition(parser, token);
 
 	// It should be followed by a name.
 	token = Parser_NextToken(parser);
@@ -102,7 +102,7 @@ ParseError Parser_ParseRawListTerm(Parser parser, SmileObject *result, Int *temp
 			return NULL;
 
 		case TOKEN_DYNSTRING:
-			error = Parser_ParseDynamicString(parser, result, token->text, Token_GetPosition(token));
+			error = Parser_ParseDynamicString(parser, result, token->text, Parser_GetTokenPosition(parser, token));
 			if (error != NULL)
 				return error;
 			*templateKind = (SMILE_KIND(*result) != SMILE_KIND_STRING) ? TemplateKind_Template : TemplateKind_None;
@@ -113,7 +113,7 @@ ParseError Parser_ParseRawListTerm(Parser parser, SmileObject *result, Int *temp
 				SmileList head = NullList, tail = NullList;
 				Int childTemplateKind;
 
-				startPosition = Token_GetPosition(token);
+				startPosition = Parser_GetTokenPosition(parser, token);
 
 				Parser_ParseRawListItemsOpt(parser, &head, &tail, &childTemplateKind, BINARYLINEBREAKS_DISALLOWED | COMMAMODE_NORMAL | COLONMODE_MEMBERACCESS);
 
@@ -135,7 +135,7 @@ ParseError Parser_ParseRawListTerm(Parser parser, SmileObject *result, Int *temp
 				Int childTemplateKind, tokenKind;
 				if ((tokenKind = Lexer_Peek(parser->lexer)) == TOKEN_LEFTPARENTHESIS
 					|| tokenKind == TOKEN_LEFTBRACE) {
-					error = Parser_ParseTerm(parser, result, modeFlags, Token_Clone(token));
+					error = Parser_ParseTerm(parser, result, modeFlags, Parser_CloneToken(parser, token));
 					childTemplateKind = TemplateKind_None;
 				}
 				else {
@@ -173,7 +173,7 @@ ParseError Parser_ParseRawListTerm(Parser parser, SmileObject *result, Int *temp
 				}
 				else {
 					Lexer_Unget(parser->lexer);
-					error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+					error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 						String_FromC("A symbol or a left parenthesis must follow an '@' in a template."));
 					return error;
 				}
@@ -195,7 +195,7 @@ ParseError Parser_ParseRawListTerm(Parser parser, SmileObject *result, Int *temp
 				}
 				else {
 					Lexer_Unget(parser->lexer);
-					error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+					error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 						String_FromC("A symbol must follow an '@@' in a template."));
 					return error;
 				}
@@ -269,18 +269,18 @@ ParseError Parser_ParseRawListTerm(Parser parser, SmileObject *result, Int *temp
 			// an error message, but we do our best to specialize that message according to the most
 			// common mistakes people make.
 			if (token->kind == TOKEN_SEMICOLON) {
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 					String_FromC("Expected a variable or number or other legal expression term, not a semicolon (remember, semicolons don't terminate statements in Smile!)"));
 			}
 			else if (token->kind == TOKEN_COMMA) {
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 					String_FromC("Expected a variable or number or other legal expression term, not a comma (did you mistakenly put commas in a list?)"));
 			}
 			else if (token->kind == TOKEN_ERROR) {
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), token->text);
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), token->text);
 			}
 			else {
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 					String_Format("Expected a variable or number or other legal expression term, not \"%S\".", TokenKind_ToString(token->kind)));
 			}
 			return error;
@@ -306,7 +306,7 @@ ParseError Parser_ParseRawListItemsOpt(Parser parser, SmileList *head, SmileList
 	while ((token = Parser_NextToken(parser))->kind != TOKEN_EOI
 		&& token->kind != TOKEN_RIGHTBRACE && token->kind != TOKEN_RIGHTBRACKET && token->kind != TOKEN_RIGHTPARENTHESIS) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 		Lexer_Unget(parser->lexer);
 
 		if (startPosition == NULL) startPosition = lexerPosition;
@@ -401,7 +401,7 @@ ParseError Parser_ParseRawListDotExpr(Parser parser, SmileObject *result, Int *t
 			|| tokenKind == TOKEN_UNKNOWNPUNCTNAME) {
 
 			symbol = parser->lexer->token->data.symbol;
-			lexerPosition = Token_GetPosition(parser->lexer->token);
+			lexerPosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 
 			if (*templateKind == TemplateKind_None) {
 				// Generate a simple (expr).symbol as output.
@@ -420,7 +420,7 @@ ParseError Parser_ParseRawListDotExpr(Parser parser, SmileObject *result, Int *t
 			}
 		}
 		else {
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_Format("Expected a property name after '.', not '%S.'", TokenKind_ToString(tokenKind)));
 		}
 	}
@@ -443,6 +443,7 @@ static void Parser_TransformListIntoTemplate(SmileList *head, SmileList *tail, L
 	SmileList oldHead, newHead, newTail;
 	SmileObject oldExpr, newExpr;
 	LexerPosition position;
+	struct LexerPositionStruct positionBuffer;
 
 	oldHead = *head;
 
@@ -455,7 +456,7 @@ static void Parser_TransformListIntoTemplate(SmileList *head, SmileList *tail, L
 	// Copy each element from the old list, projecting it...
 	for (; SMILE_KIND(oldHead) != SMILE_KIND_NULL; oldHead = LIST_REST(oldHead)) {
 		oldExpr = oldHead->a;
-		position = ((struct SmileListWithSourceInt *)oldHead)->position;
+		position = SmileList_GetSourcePosition(oldHead, &positionBuffer);
 
 		// Take each element x in the old list, and turn it into [$quote x] in the new list.
 		newExpr = (SmileObject)SmileList_CreateTwoWithSource(Smile_KnownObjects._quoteSymbol, oldExpr, position);
@@ -481,6 +482,7 @@ static void Parser_TransformListIntoSplicedTemplate(SmileList *head, SmileList *
 	SmileList oldHead, newHead, newTail;
 	SmileObject oldExpr, newExpr;
 	LexerPosition position;
+	struct LexerPositionStruct positionBuffer;
 
 	oldHead = *head;
 
@@ -493,7 +495,7 @@ static void Parser_TransformListIntoSplicedTemplate(SmileList *head, SmileList *
 	// Copy each element from the old list, projecting it...
 	for (; SMILE_KIND(oldHead) != SMILE_KIND_NULL; oldHead = LIST_REST(oldHead)) {
 		oldExpr = oldHead->a;
-		position = ((struct SmileListWithSourceInt *)oldHead)->position;
+		position = SmileList_GetSourcePosition(oldHead, &positionBuffer);
 
 		// Take each element x in the old list, and turn it into [$quote [x]] in the new list.
 		newExpr = (SmileObject)SmileList_CreateTwoWithSource(Smile_KnownObjects._quoteSymbol,
@@ -522,6 +524,7 @@ static void Parser_TransformTemplateIntoSplicedTemplate(SmileList *head, SmileLi
 	SmileList oldHead, newHead, newTail;
 	SmileObject oldExpr, newExpr;
 	LexerPosition position;
+	struct LexerPositionStruct positionBuffer;
 
 	oldHead = *head;
 
@@ -534,7 +537,7 @@ static void Parser_TransformTemplateIntoSplicedTemplate(SmileList *head, SmileLi
 	// Copy each element from the old list, projecting it...
 	for (oldHead = LIST_REST(oldHead); SMILE_KIND(oldHead) != SMILE_KIND_NULL; oldHead = LIST_REST(oldHead)) {
 		oldExpr = oldHead->a;
-		position = ((struct SmileListWithSourceInt *)oldHead)->position;
+		position = SmileList_GetSourcePosition(oldHead, &positionBuffer);
 
 		// See if this element x is actually of the form [$quote x].  If it is, we can use a better
 		// replacement for it --- [$quote [x]] --- than the general-purpose cons technique below.
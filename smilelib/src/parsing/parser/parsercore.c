@@ -39,6 +39,7 @@ Parser Parser_Create(void)
 	parser->externalVars = NULL;
 	parser->numExternalVars = 0;
 	parser->includeLoader = Parser_DefaultIncludeLoader;
+	parser->arena.ptr = parser->arena.end = NULL;
 	return parser;
 }
 
@@ -178,7 +179,7 @@ SmileObject Parser_ParseConstant(Parser parser, Lexer lexer, ParseScope scope)
 		result = NullObject;
 	}
 	else if (templateKind != TemplateKind_None) {
-		Parser_AddError(parser, Token_GetPosition(parser->lexer->token), "Template and variable data is not allowed in constant values.");
+		Parser_AddError(parser, Parser_GetTokenPosition(parser, parser->lexer->token), "Template and variable data is not allowed in constant values.");
 		result = NullObject;
 	}
 
@@ -199,16 +200,16 @@ ParseError Parser_ParseScope(Parser parser, SmileObject *expr)
 	STATIC_STRING(expectedCloseBraceError, "Expected ... } to end the scope starting on line %d");
 
 	if ((startToken = Parser_NextToken(parser))->kind != TOKEN_LEFTBRACE) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(startToken), expectedOpenBraceError);
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, startToken), expectedOpenBraceError);
 		return parseError;
 	}
-	startPosition = Token_GetPosition(startToken);
+	startPosition = Parser_GetTokenPosition(parser, startToken);
 
 	*expr = Parser_ParseScopeBody(parser, NULL);
 
 	if ((endToken = Parser_NextToken(parser))->kind != TOKEN_RIGHTBRACE) {
 		*expr = NULL;
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(endToken),
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, endToken),
 			String_FormatString(expectedCloseBraceError, startPosition->line));
 		return parseError;
 	}
@@ -328,7 +329,7 @@ void Parser_ParseExprsOpt(Parser parser, SmileList *head, SmileList *tail, Int m
 	while ((token = Parser_NextToken(parser))->kind != TOKEN_EOI
 		&& token->kind != TOKEN_RIGHTBRACE && token->kind != TOKEN_RIGHTBRACKET && token->kind != TOKEN_RIGHTPARENTHESIS) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 		Lexer_Unget(parser->lexer);
 
 		// Parse the next expression.
@@ -371,7 +372,7 @@ void Parser_ParseCallArgsOpt(Parser parser, SmileList *head, SmileList *tail, In
 	while ((token = Parser_NextToken(parser))->kind != TOKEN_EOI
 		&& token->kind != TOKEN_RIGHTBRACE && token->kind != TOKEN_RIGHTBRACKET && token->kind != TOKEN_RIGHTPARENTHESIS) {
 
-		lexerPosition = Token_GetPosition(token);
+		lexerPosition = Parser_GetTokenPosition(parser, token);
 		Lexer_Unget(parser->lexer);
 
 		// Parse the next expression.
@@ -422,7 +423,7 @@ ParseError Parser_ParseOneExpressionFromText(Parser parser, SmileObject *expr, S
 	if (*expr == Parser_IgnorableObject) *expr = NullObject;
 
 	if ((token = Parser_NextToken(parser))->kind != TOKEN_EOI) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 			String_Format("Unexpected \"%S\" at end of dynamic string expression.", TokenKind_ToString(token->kind)));
 		parser->lexer = oldLexer;
 		*expr = NULL;
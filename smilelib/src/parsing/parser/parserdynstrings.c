@@ -42,14 +42,14 @@ typedef struct DynamicStringPieceStruct {
 //-------------------------------------------------------------------------------------------------
 //  Static prototypes.
 
-static ParseError Parser_SplitDynamicString(Lexer lexer, DynamicStringPiece **dynamicStringPieces, Int *numDynamicStringPieces);
+static ParseError Parser_SplitDynamicString(Parser parser, Lexer lexer, DynamicStringPiece **dynamicStringPieces, Int *numDynamicStringPieces);
 
 //-------------------------------------------------------------------------------------------------
 //  DynamicStringPiece implementation.
 
-static DynamicStringPiece DynamicStringPiece_Create(String text, LexerPosition firstLine, Bool isExpression)
+static DynamicStringPiece DynamicStringPiece_Create(Parser parser, String text, LexerPosition firstLine, Bool isExpression)
 {
-	DynamicStringPiece piece = GC_MALLOC_STRUCT(struct DynamicStringPieceStruct);
+	DynamicStringPiece piece = PARSEARENA_ALLOC_STRUCT(&parser->arena, struct DynamicStringPieceStruct);
 	piece->text = text;
 	piece->firstLine = firstLine;
 	piece->isExpression = isExpression;
@@ -61,7 +61,7 @@ static DynamicStringPiece DynamicStringPiece_Create(String text, LexerPosition f
 
 ParseError Parser_ParseDynamicString(Parser parser, SmileObject *expr, String text, LexerPosition startPosition)
 {
-	Lexer stringLexer;
+	struct LexerStruct stringLexer;
 	DynamicStringPiece *dynamicStringPieces, piece;
 	Int numDynamicStringPieces;
 	ParseError parseError;
@@ -74,9 +74,11 @@ ParseError Parser_ParseDynamicString(Parser parser, SmileObject *expr, String te
 		return NULL;
 	}
 
-	stringLexer = Lexer_Create(text, 0, String_Length(text), startPosition->filename, startPosition->line, startPosition->column);
+	// The lexer here is only used for tracking the current position, and isn't needed after we
+	// return, so it can just live on the stack.
+	Lexer_Init(&stringLexer, text, 0, String_Length(text), startPosition->filename, startPosition->line, startPosition->column);
 
-	parseError = Parser_SplitDynamicString(stringLexer, &dynamicStringPieces, &numDynamicStringPieces);
+	parseError = Parser_SplitDynamicString(parser, &stringLexer, &dynamicStringPieces, &numDynamicStringPieces);
 	if (parseError != NULL) {
 		*expr = NULL;
 		return parseError;
@@ -117,17 +119,18 @@ ParseError Parser_ParseDynamicString(Parser parser, SmileObject *expr, String te
 }
 
 #define MAKE_POSITION() \
-	(position = GC_MALLOC_STRUCT(struct LexerPositionStruct), \
+	(position = PARSEARENA_ALLOC_STRUCT(&parser->arena, struct LexerPositionStruct), \
 	 position->filename = lexer->filename, \
+	 position->fileId = lexer->fileId, \
 	 position->line = (Int32)lexer->line, \
 	 position->lineStart = (Int32)(lexer->lineStart - lexer->input), \
 	 position->column = (Int32)(src - lexer->lineStart), \
 	 position->length = 0)
 
-static ParseError Parser_SplitDynamicString(Lexer lexer, DynamicStringPiece **dynamicStringPieces, Int *numDynamicStringPieces)
+static ParseError Parser_SplitDynamicString(Parser parser, Lexer lexer, DynamicStringPiece **dynamicStringPieces, Int *numDynamicStringPieces)
 {
 	Array pieces;
-	StringBuilder builder;
+	DECLARE_INLINE_STRINGBUILDER(builder, 256);
 	Bool inParsedContent;
 	Byte ch;
 	const Byte *src, *end;
@@ -138,7 +141,7 @@ static ParseError Parser_SplitDynamicString(Lexer lexer, DynamicStringPiece **dy
 
 	pieces = Array_Create(sizeof(DynamicStringPiece), 16, False);
 
-	builder = StringBuilder_Create();
+	INIT_INLINE_STRINGBUILDER(builder);
 
 	inParsedContent = False;
 
@@ -180,7 +183,7 @@ static ParseError Parser_SplitDynamicString(Lexer lexer, DynamicStringPiece **dy
 					MAKE_POSITION();
 					if (StringBuilder_GetLength(builder) > 0) {
 						dest = (DynamicStringPiece *)Array_Push(pieces);
-						*dest = DynamicStringPiece_Create(StringBuilder_ToString(builder), position, False);
+						*dest = DynamicStringPiece_Create(parser, StringBuilder_ToString(builder), position, False);
 						StringBuilder_SetLength(builder, 0);
 					}
 				}
@@ -237,7 +240,7 @@ static ParseError Parser_SplitDynamicString(Lexer lexer, DynamicStringPiece **dy
 				inParsedContent = False;
 				dest = (DynamicStringPiece *)Array_Push(pieces);
 				MAKE_POSITION();
-				*dest = DynamicStringPiece_Create(StringBuilder_ToString(builder), position, True);
+				*dest = DynamicStringPiece_Create(parser, StringBuilder_ToString(builder), position, True);
 				StringBuilder_SetLength(builder, 0);
 			}
 			else {
@@ -258,7 +261,7 @@ static ParseError Parser_SplitDynamicString(Lexer lexer, DynamicStringPiece **dy
 	if (StringBuilder_GetLength(builder) > 0) {
 		MAKE_POSITION();
 		dest = (DynamicStringPiece *)Array_Push(pieces);
-		*dest = DynamicStringPiece_Create(StringBuilder_ToString(builder), position, False);
+		*dest = DynamicStringPiece_Create(parser, StringBuilder_ToString(builder), position, False);
 	}
 
 	*dynamicStringPieces = pieces->data;
@@ -27,17 +27,31 @@
 #include <smile/internal/staticstring.h>
 
 static ParserSyntaxNode ParserSyntaxNode_CreateInternal(Symbol name, Symbol variable, Int repetitionKind, Int repetitionSep, LexerPosition position);
+static ParserSyntaxNode ParserSyntaxNode_VFork(ParserSyntaxNode node);
 
 static ParserSyntaxClass ParserSyntaxClass_CreateNew(void);
 static void *ParserSyntaxClass_DictClone(Int32 key, void *value, void *param);
+static Int32Dict ParserSyntaxClass_CloneDict(Int32Dict dict);
 static ParserSyntaxClass ParserSyntaxClass_VFork(ParserSyntaxClass cls);
-static ParserSyntaxClass ParserSyntaxClass_FindOrCreate(ParserSyntaxTable *table, Symbol nonterminal);
-static Bool ParserSyntaxClass_Extend(Parser parser, LexerPosition position,
-	ParserSyntaxClass cls, ParserSyntaxNode parent,
+static Bool ParserSyntaxClass_Extend(Parser parser, LexerPosition position, ParserSyntaxNode parent,
 	Symbol name, Symbol variable, Int repetitionKind, Int repetitionSep,
-	ParserSyntaxNode *resultingNode, ParserSyntaxClass *resultingCls);
+	ParserSyntaxNode *resultingNode);
 
 static ParserSyntaxTable ParserSyntaxTable_VFork(ParserSyntaxTable table);
+static void ParserSyntaxTable_SetSpecialClass(ParserSyntaxTable table, Symbol nonterminal, ParserSyntaxClass syntaxClass);
+static void ParserSyntaxTable_ClearCaches(ParserSyntaxTable table);
+static ParserSyntaxTable ParserSyntaxTable_FindDerivedTable(ParserSyntaxTable table, SmileSyntax rule, UInt32 ruleHash);
+static void ParserSyntaxTable_AddDerivedTable(ParserSyntaxTable table, SmileSyntax rule, UInt32 ruleHash, ParserSyntaxTable derivedTable);
+
+/// <summary>
+/// One entry in a syntax table's memo of the tables derived from it (see ParserSyntaxTable_AddRule).
+/// Entries whose rules have the same hash are chained together.
+/// </summary>
+typedef struct ParserSyntaxDerivationStruct {
+	SmileSyntax rule;	// The rule that was added to the base table.
+	ParserSyntaxTable table;	// The resulting table, which holds a reference from this entry.
+	struct ParserSyntaxDerivationStruct *next;	// The next entry with the same rule hash, if any.
+} *ParserSyntaxDerivation;
 
 static UInt32 UniqueNodeID = 0;
 
@@ -94,6 +108,35 @@ static ParserSyntaxNode ParserSyntaxNode_CreateInternal(Symbol name, Symbol vari
 	return syntaxNode;
 }
 
+/// <summary>
+/// Given a syntax node that may or may not be unique, make it unique by virtually cloning
+/// it, so that new children may be safely added to it.  If the node is shared by more than
+/// one parent, this makes a shallow clone with a reference count of 1 (whose children are
+/// shared in turn), and releases the caller's reference to the original; otherwise, the
+/// node is returned as-is.
+/// </summary>
+/// <param name="node">The original, possibly non-unique node.</param>
+/// <returns>The unique-ified syntax node, which the caller must store in place of the original.</returns>
+static ParserSyntaxNode ParserSyntaxNode_VFork(ParserSyntaxNode node)
+{
+	ParserSyntaxNode newNode;
+
+	if (node->referenceCount <= 1)
+		return node;
+
+	newNode = GC_MALLOC_STRUCT(struct ParserSyntaxNodeStruct);
+	MemCpy(newNode, node, sizeof(struct ParserSyntaxNodeStruct));
+
+	newNode->referenceCount = 1;
+	newNode->nodeID = Atomic_IncrementInt32((Int32 *)&UniqueNodeID);
+	newNode->nextTerminals = ParserSyntaxClass_CloneDict(node->nextTerminals);
+	newNode->nextNonterminals = ParserSyntaxClass_CloneDict(node->nextNonterminals);
+
+	node->referenceCount--;
+
+	return newNode;
+}
+
 //-------------------------------------------------------------------------------------------------
 //  ParserSyntaxClass functions.
 
@@ -130,15 +173,24 @@ static void *ParserSyntaxClass_DictClone(Int32 key, void *value, void *param)
 	return value;
 }
 
+/// <summary>
+/// Make a copy-on-write clone of one of a syntax class's or syntax node's child dictionaries
+/// (which may be NULL, if it has no children of that kind).
+/// </summary>
+static Int32Dict ParserSyntaxClass_CloneDict(Int32Dict dict)
+{
+	return dict != NULL ? Int32Dict_Clone(dict, ParserSyntaxClass_DictClone, NULL) : NULL;
+}
+
 /// <summary>
 /// Given a syntax class that may or may not be unique, make it unique by virtually
 /// cloning it, so that updates may be safely applied to it.  If the incoming class
-/// has a reference count of 1 or more, this will make a shallow clone with a reference
-/// count of 1 and return the clone; if the incoming class has a reference count of 1
-/// or less, it will be returned directly.
+/// has a reference count of more than 1, this will make a shallow clone with a reference
+/// count of 1, release the caller's reference to the original, and return the clone; if
+/// the incoming class has a reference count of 1 or less, it will be returned directly.
 /// </summary>
 /// <param name="cls">The original, possibly non-unique class.</param>
-/// <returns>The unique-ified syntax class.</returns>
+/// <returns>The unique-ified syntax class, which the caller must store in place of the original.</returns>
 static ParserSyntaxClass ParserSyntaxClass_VFork(ParserSyntaxClass cls)
 {
 	ParserSyntaxClass newCls;
@@ -149,99 +201,31 @@ static ParserSyntaxClass ParserSyntaxClass_VFork(ParserSyntaxClass cls)
 	newCls = GC_MALLOC_STRUCT(struct ParserSyntaxClassStruct);
 
 	newCls->referenceCount = 1;
-	newCls->nextTerminals = Int32Dict_Clone(cls->nextTerminals, ParserSyntaxClass_DictClone, NULL);
-	newCls->nextNonterminals = Int32Dict_Clone(cls->nextNonterminals, ParserSyntaxClass_DictClone, NULL);
-
-	return newCls;
-}
-
-/// <summary>
-/// Find or create a syntax class object that holds all the rules associated with
-/// a given nonterminal class, like 'STMT', within the current syntax table.
-/// </summary>
-/// <param name="table">A pointer to the syntax table in which to find or create the syntax class.
-/// If the table is non-unique and a class must be created, the table will be virtually forked.</param>
-/// <param name="nonterminal">The nonterminal describing which syntax class to find or create.</param>
-/// <returns>A new or preexisting syntax class that contains all of the rules for the
-/// given nonterminal class.  If newly-created, it will be correctly registered with
-/// the syntax table.</returns>
-static ParserSyntaxClass ParserSyntaxClass_FindOrCreate(ParserSyntaxTable *table, Symbol nonterminal)
-{
-	ParserSyntaxClass syntaxClass;
+	newCls->nodeID = Atomic_IncrementInt32((Int32 *)&UniqueNodeID);
+	newCls->nextTerminals = ParserSyntaxClass_CloneDict(cls->nextTerminals);
+	newCls->nextNonterminals = ParserSyntaxClass_CloneDict(cls->nextNonterminals);
+	newCls->replacement = cls->replacement;
 
-	// Find or create the syntax class.
-	if (Int32Dict_TryGetValue((*table)->syntaxClasses, nonterminal, (void **)&syntaxClass))
-		return syntaxClass;
+	cls->referenceCount--;
 
-	// Virtually fork the syntax table, if it's not unique.  This makes a shallow copy of
-	// the table, propagating its reference count out to the syntax classes it points to.
-	if ((*table)->referenceCount > 1) {
-		*table = ParserSyntaxTable_VFork(*table);
-	}
-
-	// Didn't find it, so create it.
-	syntaxClass = ParserSyntaxClass_CreateNew();
-	Int32Dict_Add((*table)->syntaxClasses, nonterminal, syntaxClass);
-
-	// We now have to remember certain special nonterminals when they are registered so
-	// that the parser doesn't have to work too hard to parse custom syntax rules.  These
-	// nine nonterminals are the hook points that allow anyone to glue the root of their
-	// own custom syntax rules into the standard Smile parsing logic.
-
-	// Optimization note:
-	//
-	// By using a switch statement on special symbols here, we ensure that the cost to
-	// track the special classes is still O(1) time (it would be O(n) or at best O(lg n)
-	// if we used if-statements against arbitary symbols).
-
-	switch (nonterminal) {
-	case SMILE_SPECIAL_SYMBOL_STMT:
-		(*table)->stmtClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_EXPR:
-		(*table)->exprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_CMPEXPR:
-		(*table)->cmpExprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_ADDEXPR:
-		(*table)->addExprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_MULEXPR:
-		(*table)->mulExprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_BINARYEXPR:
-		(*table)->binaryExprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_PREFIXEXPR:
-		(*table)->prefixExprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_POSTFIXEXPR:
-		(*table)->postfixExprClass = syntaxClass;
-		break;
-	case SMILE_SPECIAL_SYMBOL_TERM:
-		(*table)->termClass = syntaxClass;
-		break;
-	}
-
-	return syntaxClass;
+	return newCls;
 }
 
 /// <summary>
-/// Extend the given syntax class (nonterminal-specific tree) with the data describing a new
+/// Extend a syntax class (nonterminal-specific tree) with the data describing a new
 /// node that will belong to some parent node within it.
 /// </summary>
 ///
 /// <remarks>
-/// <p>This function applies copy-on-write behavior to the syntax class, virtually-forking the
-/// syntax class if multiple syntax tables point to it.  After ensuring that it is unique, this
-/// function then allocates and injects a new tree node under the provided parent.  Because
-/// calling this may result in a new syntax class coming into existence, this returns a pointer
-/// to the syntax class that contains the resulting node, which may or may not be the original
-/// syntax class.</p>
+/// <p>Syntax trees are shared between syntax tables (copy-on-write), so this function expects
+/// that the parent node (or class root) has already been made unique by the caller.  It then
+/// finds or allocates the child node under the parent, and makes that child unique in turn
+/// (virtually forking it, if other trees also point to it), so that the path from the class
+/// root down to the resulting node never contains any node shared with another table.</p>
 ///
 /// <p>Note that if there is a preexisting node under the parent that matches the provided data,
-/// this function does <em>not</em> allocate a new node, but merely returns the preexisting node.</p>
+/// this function does <em>not</em> allocate a new node, but merely returns the preexisting node
+/// (or its unique fork).</p>
 ///
 /// <p>And, finally, note also that this function expressly prohibits forking the tree on a
 /// nonterminal node, to match the Smile syntax rules:  If the parent node already has a node
@@ -252,90 +236,60 @@ static ParserSyntaxClass ParserSyntaxClass_FindOrCreate(ParserSyntaxTable *table
 ///
 /// <param name="parser">The parser that owns this syntax tree.</param>
 /// <param name="position">The lexer position at which the new node was parsed.</param>
-/// <param name="cls">The syntax class to extend.</param>
-/// <param name="parent">A parent node within this syntax class under which the new child node
-/// will be added.</param>
+/// <param name="parent">A unique parent node (or class root) within a syntax class under which
+/// the new child node will be added.</param>
 /// <param name="name">The keyword/symbol or nonterminal name.</param>
 /// <param name="variable">The variable to emit on a nonterminal match, 0 if this is a keyword/symbol.</param>
 /// <param name="repetitionKind">The kind of repetition to use, if this is a nonterminal reference.
 /// Either 0 (no repetition), '?' for optional, '*' for zero-or-more, '+' for one-or-more.</param>
 /// <param name="repetitionSep">The separator for the repetition, if this is a nonterminal reference.
 /// Either 0 (no separator), ',' for comma, or ';' for semicolon.</param>
-/// <param name="resultingNode">This will be filled in with a pointer to the found or newly-created child node.</param>
-/// <param name="resultingCls">This will be filled in with a pointer to the original or vforked syntax class,
-/// wherever the new node was added.</param>
+/// <param name="resultingNode">This will be filled in with a pointer to the found or newly-created
+/// child node, which is always unique.</param>
 ///
 /// <returns>True on success, or False if an error occurred.  The parser will be updated to
-/// include the error, if there was an error.  Note that the values of 'resultingNode' and 'resultingCls'
-/// are meaningless if False is returned.</returns>
-static Bool ParserSyntaxClass_Extend(Parser parser, LexerPosition position,
-	ParserSyntaxClass cls, ParserSyntaxNode parent,
+/// include the error, if there was an error.  Note that the value of 'resultingNode'
+/// is meaningless if False is returned.</returns>
+static Bool ParserSyntaxClass_Extend(Parser parser, LexerPosition position, ParserSyntaxNode parent,
 	Symbol name, Symbol variable, Int repetitionKind, Int repetitionSep,
-	ParserSyntaxNode *resultingNode, ParserSyntaxClass *resultingCls)
+	ParserSyntaxNode *resultingNode)
 {
-	ParserSyntaxClass newCls = cls;
-	ParserSyntaxNode syntaxNode;
+	ParserSyntaxNode syntaxNode, uniqueNode;
 	Int32Dict nextDict;
 
-	if (parent == NULL) {
-		parent = (ParserSyntaxNode)cls;
-	}
+	nextDict = variable ? parent->nextNonterminals : parent->nextTerminals;
 
-	if ((!variable && parent->nextTerminals == NULL) || (variable && parent->nextNonterminals == NULL)) {
+	if (nextDict == NULL) {
 		// No dictionary at this level yet, so create one, and add the new node to it.
-		if (newCls->referenceCount > 1) {
-			newCls = ParserSyntaxClass_VFork(newCls);
-		}
 		nextDict = variable	? (parent->nextNonterminals	= Int32Dict_CreateWithSize(4))
 			: (parent->nextTerminals	= Int32Dict_CreateWithSize(4));
 		syntaxNode = ParserSyntaxNode_CreateInternal(name, variable, repetitionKind, repetitionSep, position);
 		Int32Dict_Add(nextDict, name, syntaxNode);
 	}
-	else if (variable) {
-		// This is a nonterminal that we'd like to add to a preexisting dictionary.
-		
-		if (!Int32Dict_TryGetValue(parent->nextNonterminals, name, (void **)&syntaxNode)) {
-			// Nonterminal doesn't exist yet, so it's safe to add it.
-			if (newCls->referenceCount > 1) {
-				newCls = ParserSyntaxClass_VFork(newCls);
-			}
-			syntaxNode = ParserSyntaxNode_CreateInternal(name, variable, repetitionKind, repetitionSep, position);
-			Int32Dict_Add(parent->nextNonterminals, name, syntaxNode);
-		}
-		if (syntaxNode->name == name && (syntaxNode->repetitionKind != repetitionKind || syntaxNode->repetitionSep != repetitionSep)) {
-			// Error: Can't fork nonterminal --> nonterminal with different repeat behavior.
-			Parser_AddError(parser, position, "Cannot add syntax rule because the nonterminal \"%S %S\" has different repeat behavior from other nonterminals in the same position in their rules.",
-				SymbolTable_GetName(Smile_SymbolTable, name),
-				SymbolTable_GetName(Smile_SymbolTable, variable));
-			return False;
-		}
-		else {
-			// A nonterminal correctly mimicked in a new rule.
-			// Nothing to do here.
-		}
+	else if (!Int32Dict_TryGetValue(nextDict, name, (void **)&syntaxNode)) {
+		// Terminal or nonterminal doesn't exist yet, so it's safe to add it.
+		syntaxNode = ParserSyntaxNode_CreateInternal(name, variable, repetitionKind, repetitionSep, position);
+		Int32Dict_Add(nextDict, name, syntaxNode);
+	}
+	else if (variable && (syntaxNode->repetitionKind != repetitionKind || syntaxNode->repetitionSep != repetitionSep)) {
+		// Error: Can't fork nonterminal --> nonterminal with different repeat behavior.
+		Parser_AddError(parser, position, "Cannot add syntax rule because the nonterminal \"%S %S\" has different repeat behavior from other nonterminals in the same position in their rules.",
+			SymbolTable_GetName(Smile_SymbolTable, name),
+			SymbolTable_GetName(Smile_SymbolTable, variable));
+		return False;
 	}
 	else {
-		// This is a nonterminal that we'd like to add to a preexisting dictionary.
-
-		if (Int32Dict_TryGetValue(parent->nextTerminals, name, (void **)&syntaxNode)) {
-			// Just a terminal, correctly mimicked in a new rule.
-			// Nothing to do here.
-		}
-		else {
-			// Terminal doesn't exist yet, so it's safe to add it.
-			if (newCls->referenceCount > 1) {
-				newCls = ParserSyntaxClass_VFork(newCls);
-			}
-			syntaxNode = ParserSyntaxNode_CreateInternal(name, variable, repetitionKind, repetitionSep, position);
-			Int32Dict_Add(parent->nextTerminals, name, syntaxNode);
+		// A terminal or nonterminal correctly mimicked in a new rule.  We may be about to
+		// add to it, so if it's shared with another tree, swap in a private copy.
+		uniqueNode = ParserSyntaxNode_VFork(syntaxNode);
+		if (uniqueNode != syntaxNode) {
+			Int32Dict_ReplaceValue(nextDict, name, uniqueNode);
+			syntaxNode = uniqueNode;
 		}
 	}
 
 	// Finally, now that we either found or created it, return it.
 	*resultingNode = syntaxNode;
-	*resultingCls = newCls;
-
-	// And return the (possibly-cloned/new) syntax class.
 	return True;
 }
 
@@ -355,6 +309,8 @@ ParserSyntaxTable ParserSyntaxTable_CreateNew(void)
 
 	syntaxTable->firstSets = NULL;
 	syntaxTable->followSets = NULL;
+	syntaxTable->transitionTables = NULL;
+	syntaxTable->derivedTables = NULL;
 
 	syntaxTable->stmtClass = NULL;
 	syntaxTable->exprClass = NULL;
@@ -390,6 +346,8 @@ static ParserSyntaxTable ParserSyntaxTable_VFork(ParserSyntaxTable table)
 
 	newTable->firstSets = NULL;
 	newTable->followSets = NULL;
+	newTable->transitionTables = NULL;
+	newTable->derivedTables = NULL;
 
 	newTable->stmtClass = table->stmtClass;
 	newTable->exprClass = table->exprClass;
@@ -404,6 +362,130 @@ static ParserSyntaxTable ParserSyntaxTable_VFork(ParserSyntaxTable table)
 	return newTable;
 }
 
+/// <summary>
+/// Record the given syntax class in the table's fast-lookup slot for its nonterminal, if
+/// it is one of the special built-in nonterminals.
+/// </summary>
+static void ParserSyntaxTable_SetSpecialClass(ParserSyntaxTable table, Symbol nonterminal, ParserSyntaxClass syntaxClass)
+{
+	// Optimization note:
+	//
+	// By using a switch statement on special symbols here, we ensure that the cost to
+	// track the special classes is still O(1) time (it would be O(n) or at best O(lg n)
+	// if we used if-statements against arbitary symbols).
+
+	switch (nonterminal) {
+		case SMILE_SPECIAL_SYMBOL_STMT:
+			table->stmtClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_EXPR:
+			table->exprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_CMPEXPR:
+			table->cmpExprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_ADDEXPR:
+			table->addExprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_MULEXPR:
+			table->mulExprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_BINARYEXPR:
+			table->binaryExprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_PREFIXEXPR:
+			table->prefixExprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_POSTFIXEXPR:
+			table->postfixExprClass = syntaxClass;
+			break;
+		case SMILE_SPECIAL_SYMBOL_TERM:
+			table->termClass = syntaxClass;
+			break;
+	}
+}
+
+/// <summary>
+/// Discard everything computed from the table's current rules, because it's about to be
+/// modified in place.  This includes the memo of tables derived from it, which releases
+/// its references to them.
+/// </summary>
+static void ParserSyntaxTable_ClearCaches(ParserSyntaxTable table)
+{
+	ParserSyntaxDerivation *derivations, derivation;
+	Int32 count;
+
+	table->firstSets = NULL;
+	table->followSets = NULL;
+	table->transitionTables = NULL;
+
+	if (table->derivedTables != NULL) {
+		derivations = (ParserSyntaxDerivation *)Int32Dict_GetValues(table->derivedTables);
+		count = Int32Dict_Count(table->derivedTables);
+		while (count--) {
+			for (derivation = *derivations++; derivation != NULL; derivation = derivation->next) {
+				ParserSyntaxTable_RemoveRef(derivation->table);
+			}
+		}
+		table->derivedTables = NULL;
+	}
+}
+
+/// <summary>
+/// Find a table that was previously derived from the given (unmodified) table by adding
+/// a rule with the same content as the given rule.
+/// </summary>
+/// <param name="table">The base table.</param>
+/// <param name="rule">The rule that is about to be added to the base table.</param>
+/// <param name="ruleHash">The rule's content hash.</param>
+/// <returns>The previously-derived table, or NULL if there isn't one.</returns>
+static ParserSyntaxTable ParserSyntaxTable_FindDerivedTable(ParserSyntaxTable table, SmileSyntax rule, UInt32 ruleHash)
+{
+	ParserSyntaxDerivation derivation;
+
+	if (table->derivedTables == NULL
+		|| !Int32Dict_TryGetValue(table->derivedTables, (Int32)ruleHash, (void **)&derivation))
+		return NULL;
+
+	for (; derivation != NULL; derivation = derivation->next) {
+		if (derivation->rule == rule || SmileObject_DeepCompare((SmileObject)derivation->rule, (SmileObject)rule))
+			return derivation->table;
+	}
+
+	return NULL;
+}
+
+/// <summary>
+/// Remember that adding the given rule to the given table produced the given derived table.
+/// The memo holds a reference to the derived table, so that it can never be modified in place
+/// and will always describe exactly the base table's rules plus the one new rule.
+/// </summary>
+/// <param name="table">The base table.</param>
+/// <param name="rule">The rule that was added to the base table.</param>
+/// <param name="ruleHash">The rule's content hash.</param>
+/// <param name="derivedTable">The resulting table.</param>
+static void ParserSyntaxTable_AddDerivedTable(ParserSyntaxTable table, SmileSyntax rule, UInt32 ruleHash, ParserSyntaxTable derivedTable)
+{
+	ParserSyntaxDerivation derivation, next;
+
+	if (table->derivedTables == NULL)
+		table->derivedTables = Int32Dict_CreateWithSize(4);
+
+	if (!Int32Dict_TryGetValue(table->derivedTables, (Int32)ruleHash, (void **)&next))
+		next = NULL;
+
+	derivation = GC_MALLOC_STRUCT(struct ParserSyntaxDerivationStruct);
+	if (derivation == NULL)
+		Smile_Abort_OutOfMemory();
+
+	derivation->rule = rule;
+	derivation->table = derivedTable;
+	derivation->next = next;
+
+	Int32Dict_SetValue(table->derivedTables, (Int32)ruleHash, derivation);
+	ParserSyntaxTable_AddRef(derivedTable);
+}
+
 static void ParserSyntaxTable_RecursivelyComputeFirstSet(ParserSyntaxTable table, Symbol nonterminal,
 	Int32Int32Dict firstSet, Int32Int32Dict nonterminalsSeen)
 {
@@ -653,7 +735,7 @@ Int32Int32Dict ParserSyntaxTable_GetFollowSet(ParserSyntaxTable table, ParserSyn
 
 	if (!Int32Dict_TryGetValue(table->followSets, node->nodeID, (void **)&followSet)) {
 		followSet = ParserSyntaxTable_ComputeFollowSet(table, node);
-		Int32Dict_Add(table->firstSets, node->nodeID, followSet);
+		Int32Dict_Add(table->followSets, node->nodeID, followSet);
 	}
 
 	return followSet;
@@ -687,18 +769,30 @@ Int32Dict ParserSyntaxTable_GetTransitionTable(Parser parser, ParserSyntaxTable
 /// Add a new syntax rule to the existing syntax table, virtually forking the table
 /// as necessary.
 /// </summary>
+/// <remarks>
+/// A table that is shared by more than one scope is never modified:  Instead, the scope
+/// that is adding the rule gets a fork of it, and only the path from the rule's class root
+/// down to its final node is copied, while everything else stays shared with the original.
+/// The original also remembers which table it was forked into for which rule, so when the
+/// same rule (by content) is added to the same shared table again --- as when a module's
+/// #syntax is included into many scopes under a common parent --- the scope simply receives
+/// the same derived table again, along with any FIRST/FOLLOW sets and transition tables
+/// that have already been computed for it.
+/// </remarks>
 /// <param name="parser">The parser that owns this syntax table.  This will be used
 /// for error-reporting if the rule is invalid.</param>
 /// <param name="table">The table that will contain the new syntax rule.
 /// If more than one scope references this table, it will be virtually forked, and
-/// the new copy will be the one that gets the new rule.</param>
+/// the new copy will be the one that gets the new rule.  On failure, a shared table
+/// is left unchanged.</param>
 /// <param name="rule">The new rule to add to this syntax table.</param>
 /// <returns>True on success, or False if one or more errors was produced.</returns>
 Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyntax rule)
 {
-	ParserSyntaxTable syntaxTable;
-	ParserSyntaxClass syntaxClass, newSyntaxClass;
+	ParserSyntaxTable baseTable, syntaxTable;
+	ParserSyntaxClass syntaxClass, uniqueSyntaxClass;
 	ParserSyntaxNode node, parentNode;
+	UInt32 ruleHash;
 	SmileList pattern;
 	SmileList replacementVariables, replacementVariablesTail;
 	SmileNonterminal nonterminal;
@@ -711,11 +805,22 @@ Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyn
 	replacementVariables = replacementVariablesTail = NullList;
 
 	// First, ensure that the syntax table can be safely modified by vforking it as
-	// necessary.
-	syntaxTable = *table;
-	if (syntaxTable->referenceCount > 1) {
-		syntaxTable = ParserSyntaxTable_VFork(syntaxTable);
-		*table = syntaxTable;
+	// necessary.  If it's shared, we may have already derived the table we want from it.
+	baseTable = *table;
+	ruleHash = 0;
+	if (baseTable->referenceCount > 1) {
+		ruleHash = SMILE_VCALL(rule, hash);
+		if ((syntaxTable = ParserSyntaxTable_FindDerivedTable(baseTable, rule, ruleHash)) != NULL) {
+			ParserSyntaxTable_AddRef(syntaxTable);
+			ParserSyntaxTable_RemoveRef(baseTable);
+			*table = syntaxTable;
+			return True;
+		}
+		syntaxTable = ParserSyntaxTable_VFork(baseTable);
+	}
+	else {
+		syntaxTable = baseTable;
+		ParserSyntaxTable_ClearCaches(syntaxTable);
 	}
 
 	// Locate the appropriate class within the syntax table for the new rule's
@@ -727,34 +832,16 @@ Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyn
 		Int32Dict_Add(syntaxTable->syntaxClasses, rule->nonterminal, syntaxClass);
 
 		// If this is a special class, glue it into the special slots in this syntax table.
-		switch (rule->nonterminal) {
-			case SMILE_SPECIAL_SYMBOL_STMT:
-				syntaxTable->stmtClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_EXPR:
-				syntaxTable->exprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_CMPEXPR:
-				syntaxTable->cmpExprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_ADDEXPR:
-				syntaxTable->addExprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_MULEXPR:
-				syntaxTable->mulExprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_BINARYEXPR:
-				syntaxTable->binaryExprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_PREFIXEXPR:
-				syntaxTable->prefixExprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_POSTFIXEXPR:
-				syntaxTable->postfixExprClass = syntaxClass;
-				break;
-			case SMILE_SPECIAL_SYMBOL_TERM:
-				syntaxTable->termClass = syntaxClass;
-				break;
+		ParserSyntaxTable_SetSpecialClass(syntaxTable, rule->nonterminal, syntaxClass);
+	}
+	else {
+		// Found a preexisting class, but it may be shared with other tables, so make sure
+		// we have our own copy of it before we change it.
+		uniqueSyntaxClass = ParserSyntaxClass_VFork(syntaxClass);
+		if (uniqueSyntaxClass != syntaxClass) {
+			syntaxClass = uniqueSyntaxClass;
+			Int32Dict_ReplaceValue(syntaxTable->syntaxClasses, rule->nonterminal, syntaxClass);
+			ParserSyntaxTable_SetSpecialClass(syntaxTable, rule->nonterminal, syntaxClass);
 		}
 	}
 
@@ -762,7 +849,8 @@ Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyn
 	// So walk down the rule's pattern and repeatedly invoke Extend() to search for
 	// or build the tree of syntax nodes for it.
 	numNodes = 0;
-	parentNode = node = NULL;
+	parentNode = (ParserSyntaxNode)syntaxClass;
+	node = NULL;
 	for (pattern = rule->pattern; pattern != NullList; pattern = LIST_REST(pattern)) {
 
 		// As a safety check against broken dynamic data structures, we limit syntax trees
@@ -786,9 +874,9 @@ Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyn
 		
 			case SMILE_KIND_SYMBOL:
 				// This is a terminal in the pattern (i.e., a keyword or symbol).
-				if (!ParserSyntaxClass_Extend(parser, rule->position, syntaxClass, parentNode,
+				if (!ParserSyntaxClass_Extend(parser, rule->position, parentNode,
 					((SmileSymbol)pattern->a)->symbol, 0, 0, 0,
-					&node, &newSyntaxClass))
+					&node))
 					return False;
 				break;
 			
@@ -842,9 +930,9 @@ Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyn
 				}
 			
 				// We have the requirements figured out now, so add the node to the syntax class.
-				if (!ParserSyntaxClass_Extend(parser, rule->position, syntaxClass, parentNode,
+				if (!ParserSyntaxClass_Extend(parser, rule->position, parentNode,
 					nonterminal->nonterminal, nonterminal->name, repeatKind, repeatSeparator,
-					&node, &newSyntaxClass))
+					&node))
 					return False;
 			
 				// Save this nonterminal's variable name; we'll need it later, when resolving the variables during application.
@@ -886,6 +974,14 @@ Bool ParserSyntaxTable_AddRule(Parser parser, ParserSyntaxTable *table, SmileSyn
 		*destSymbol++ = ((SmileSymbol)(replacementVariables->a))->symbol;
 	}
 
+	// If we forked a shared table, the calling scope now moves over to the fork, and
+	// the original remembers it for anyone else who adds this same rule.
+	if (syntaxTable != baseTable) {
+		ParserSyntaxTable_AddDerivedTable(baseTable, rule, ruleHash, syntaxTable);
+		ParserSyntaxTable_RemoveRef(baseTable);
+		*table = syntaxTable;
+	}
+
 	return True;
 }
 
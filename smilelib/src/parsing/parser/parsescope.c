@@ -333,11 +333,11 @@ static ParseError Parser_ParseNameSublist(Parser parser, SmileList *result)
 			case TOKEN_PUNCTNAME:
 			case TOKEN_UNKNOWNPUNCTNAME:
 				name = token->data.symbol;
-				LIST_APPEND_WITH_SOURCE(head, tail, SmileSymbol_Create(name), Token_GetPosition(token));
+				LIST_APPEND_WITH_SOURCE(head, tail, SmileSymbol_Create(name), Parser_GetTokenPosition(parser, token));
 				break;
 
 			default:
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), String_FromC("Missing name for [$scope] variable."));
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), String_FromC("Missing name for [$scope] variable."));
 				Parser_AddMessage(parser, error);
 				break;
 		}
@@ -368,7 +368,7 @@ static ParseError Parser_ParseClassicScopeVariableNames(Parser parser, SmileList
 
 			case TOKEN_LEFTBRACKET:
 				{
-					LexerPosition lexerPosition = Token_GetPosition(token);
+					LexerPosition lexerPosition = Parser_GetTokenPosition(parser, token);
 					SmileList sublist;
 					error = Parser_ParseNameSublist(parser, &sublist);
 					if (error != NULL) return error;
@@ -385,12 +385,12 @@ static ParseError Parser_ParseClassicScopeVariableNames(Parser parser, SmileList
 			case TOKEN_PUNCTNAME:
 			case TOKEN_UNKNOWNPUNCTNAME:
 				name = token->data.symbol;
-				LIST_APPEND_WITH_SOURCE(head, tail, SmileSymbol_Create(name), Token_GetPosition(token));
+				LIST_APPEND_WITH_SOURCE(head, tail, SmileSymbol_Create(name), Parser_GetTokenPosition(parser, token));
 				break;
 
 			default:
 			missingName:
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), String_FromC("Missing name for [$scope] variable."));
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), String_FromC("Missing name for [$scope] variable."));
 				Parser_AddMessage(parser, error);
 				break;
 		}
@@ -120,7 +120,7 @@ SMILE_INTERNAL_FUNC ParseError Parser_ParseSyntax(Parser parser, SmileObject *ex
 
 	// First, read the syntax predicate's leading nonterminal.
 	token = Parser_NextToken(parser);
-	rulePosition = Token_GetPosition(token);
+	rulePosition = Parser_GetTokenPosition(parser, token);
 	if (token->kind != TOKEN_ALPHANAME && token->kind != TOKEN_PUNCTNAME
 		&& token->kind != TOKEN_UNKNOWNALPHANAME && token->kind != TOKEN_UNKNOWNPUNCTNAME) {
 		*expr = NullObject;
@@ -140,14 +140,14 @@ SMILE_INTERNAL_FUNC ParseError Parser_ParseSyntax(Parser parser, SmileObject *ex
 	token = Parser_NextToken(parser);
 	if (token->kind != TOKEN_COLON) {
 		*expr = NullObject;
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), MissingSyntaxColon);
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), MissingSyntaxColon);
 	}
 
 	// There must be a left bracket next to start the pattern.
 	token = Parser_NextToken(parser);
 	if (token->kind != TOKEN_LEFTBRACKET) {
 		*expr = NullObject;
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), MissingSyntaxLeftBracket);
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), MissingSyntaxLeftBracket);
 	}
 
 	// Parse the pattern.
@@ -162,7 +162,7 @@ SMILE_INTERNAL_FUNC ParseError Parser_ParseSyntax(Parser parser, SmileObject *ex
 	token = Parser_NextToken(parser);
 	if (token->kind != TOKEN_RIGHTBRACKET) {
 		*expr = NullObject;
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), MissingSyntaxRightBracket);
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), MissingSyntaxRightBracket);
 	}
 
 	// Now, ensure that the special '=>' (implies) symbol exists.
@@ -170,9 +170,9 @@ SMILE_INTERNAL_FUNC ParseError Parser_ParseSyntax(Parser parser, SmileObject *ex
 	if (!(token->kind == TOKEN_PUNCTNAME || token->kind == TOKEN_UNKNOWNPUNCTNAME)
 		|| token->data.symbol != Smile_KnownSymbols.implies) {
 		*expr = NullObject;
-		return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), MissingSyntaxImpliesSymbol);
+		return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), MissingSyntaxImpliesSymbol);
 	}
-	impliesPosition = Token_GetPosition(token);
+	impliesPosition = Parser_GetTokenPosition(parser, token);
 
 	// Create a new scope for the syntax rule's substitution expression.
 	Parser_BeginScope(parser, PARSESCOPE_SYNTAX);
@@ -409,7 +409,7 @@ static ParseError Parser_ParseSyntaxTerminal(Parser parser, SmileList **tailRef)
 			tail = *tailRef;
 
 			if (Lexer_Next(parser->lexer) != TOKEN_RIGHTPARENTHESIS) {
-				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token), MalformedSyntaxPatternMismatchedParentheses);
+				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token), MalformedSyntaxPatternMismatchedParentheses);
 				Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 				return parseError;
 			}
@@ -430,7 +430,7 @@ static ParseError Parser_ParseSyntaxTerminal(Parser parser, SmileList **tailRef)
 			tail = *tailRef;
 
 			if (Lexer_Next(parser->lexer) != TOKEN_RIGHTBRACE) {
-				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token), MalformedSyntaxPatternMismatchedBraces);
+				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token), MalformedSyntaxPatternMismatchedBraces);
 				Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 				return parseError;
 			}
@@ -442,7 +442,7 @@ static ParseError Parser_ParseSyntaxTerminal(Parser parser, SmileList **tailRef)
 
 		default:
 			*tailRef = tail;
-			return ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token), MalformedSyntaxPatternKeyword);
+			return ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token), MalformedSyntaxPatternKeyword);
 	}
 }
 
@@ -465,7 +465,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 
 	// Left bracket first.
 	if (Lexer_Next(parser->lexer) != TOKEN_LEFTBRACKET) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token), MalformedSyntaxPatternMismatchedBrackets);
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token), MalformedSyntaxPatternMismatchedBrackets);
 		Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 		return parseError;
 	}
@@ -473,7 +473,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 	// Read the next thing, which should be the nonterminal name.
 	token = Parser_NextToken(parser);
 	if (token->kind != TOKEN_ALPHANAME && token->kind != TOKEN_UNKNOWNALPHANAME) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 			String_FormatString(MalformedSyntaxPatternIllegalNonterminal, token->text));
 		Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 		return parseError;
@@ -493,7 +493,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 		// Now get the real nonterminal name.
 		token = Parser_NextToken(parser);
 		if (token->kind != TOKEN_ALPHANAME && token->kind != TOKEN_UNKNOWNALPHANAME) {
-			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_FormatString(MalformedSyntaxPatternIllegalNonterminal, token->text));
 			Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 			return parseError;
@@ -529,7 +529,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 				repeat = Smile_KnownSymbols.question_mark;
 			}
 			else {
-				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+				parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 					String_FormatString(MalformedSyntaxPatternIllegalNonterminalRepeat, punctuationTail));
 				Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 				return parseError;
@@ -545,7 +545,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 	// Read the next thing, which should be the substitution variable name.
 	token = Parser_NextToken(parser);
 	if (token->kind != TOKEN_ALPHANAME && token->kind != TOKEN_UNKNOWNALPHANAME) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 			String_FormatString(MalformedSyntaxPatternIllegalNonterminalName, token->text));
 		Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 		return parseError;
@@ -556,7 +556,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 	if ((tokenKind = Lexer_Next(parser->lexer)) == TOKEN_COMMA || tokenKind == TOKEN_SEMICOLON) {
 
 		if (!repeat) {
-			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token),
+			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token),
 				String_FormatString(MalformedSyntaxPatternNonterminalRepeatSeparatorMismatch,
 					tokenKind == TOKEN_COMMA ? String_Comma : String_Semicolon));
 			Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
@@ -572,7 +572,7 @@ static ParseError Parser_ParseSyntaxNonterminal(Parser parser, SmileList **tailR
 
 	// Finally, this must finish with a right bracket.
 	if (Lexer_Next(parser->lexer) != TOKEN_RIGHTBRACKET) {
-		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(parser->lexer->token), MalformedSyntaxPatternMismatchedBrackets);
+		parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, parser->lexer->token), MalformedSyntaxPatternMismatchedBrackets);
 		Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 		return parseError;
 	}
@@ -889,7 +889,7 @@ static ParseError Parser_ParseSyntaxNonterminalWithDeclarations(Parser parser, I
 		// Read the next thing, which should be a name of some kind.
 		token = Parser_NextToken(parser);
 		if (token->kind != TOKEN_ALPHANAME && token->kind != TOKEN_UNKNOWNALPHANAME) {
-			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			parseError = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_FormatString(MalformedSyntaxPatternMissingNameAfterWith, token->text));
 			Parser_Recover(parser, _syntaxRecover, _syntaxRecoverCount);
 			return parseError;
@@ -66,7 +66,7 @@ ParseError Parser_ParseTerm(Parser parser, SmileObject *result, Int modeFlags, T
 		return Parser_ParseParentheses(parser, result, modeFlags);
 
 	case TOKEN_LEFTBRACKET:
-		startPosition = Token_GetPosition(token);
+		startPosition = Parser_GetTokenPosition(parser, token);
 		if (Parser_TryParseSpecialForm(parser, startPosition, result, &error))
 			return error;
 
@@ -84,7 +84,7 @@ ParseError Parser_ParseTerm(Parser parser, SmileObject *result, Int modeFlags, T
 		return error;
 
 	case TOKEN_BACKTICK:
-		error = Parser_ParseQuoteBody(parser, result, modeFlags, Token_GetPosition(token));
+		error = Parser_ParseQuoteBody(parser, result, modeFlags, Parser_GetTokenPosition(parser, token));
 		return error;
 
 	case TOKEN_LEFTBRACE:
@@ -96,7 +96,7 @@ ParseError Parser_ParseTerm(Parser parser, SmileObject *result, Int modeFlags, T
 	case TOKEN_PUNCTNAME:
 		if (parseDecl->declKind == PARSEDECL_KEYWORD) {
 			error = ParseMessage_Create(PARSEMESSAGE_ERROR,
-				firstUnaryTokenForErrorReporting != NULL ? Token_GetPosition(firstUnaryTokenForErrorReporting) : Token_GetPosition(token),
+				firstUnaryTokenForErrorReporting != NULL ? Parser_GetTokenPosition(parser, firstUnaryTokenForErrorReporting) : Parser_GetTokenPosition(parser, token),
 				String_Format("\"%S\" is a keyword and cannot be used as a variable or operator", token->text));
 			return error;
 		}
@@ -108,7 +108,7 @@ ParseError Parser_ParseTerm(Parser parser, SmileObject *result, Int modeFlags, T
 		return NULL;
 
 	case TOKEN_DYNSTRING:
-		return Parser_ParseDynamicString(parser, result, token->text, Token_GetPosition(token));
+		return Parser_ParseDynamicString(parser, result, token->text, Parser_GetTokenPosition(parser, token));
 
 	case TOKEN_CHAR:
 		*result = (SmileObject)SmileChar_Create(token->data.ch);
@@ -154,7 +154,7 @@ ParseError Parser_ParseTerm(Parser parser, SmileObject *result, Int modeFlags, T
 	case TOKEN_UNKNOWNPUNCTNAME:
 		// If we get an operator name instead of a variable name, we can't use it as a term.
 		error = ParseMessage_Create(PARSEMESSAGE_ERROR,
-			firstUnaryTokenForErrorReporting != NULL ? Token_GetPosition(firstUnaryTokenForErrorReporting) : Token_GetPosition(token),
+			firstUnaryTokenForErrorReporting != NULL ? Parser_GetTokenPosition(parser, firstUnaryTokenForErrorReporting) : Parser_GetTokenPosition(parser, token),
 			String_Format("\"%S\" is not a known variable name", token->text));
 		return error;
 	
@@ -176,22 +176,22 @@ ParseError Parser_ParseTerm(Parser parser, SmileObject *result, Int modeFlags, T
 		// an error message, but we do our best to specialize that message according to the most
 		// common mistakes people make.
 		if (firstUnaryTokenForErrorReporting != NULL) {
-			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(firstUnaryTokenForErrorReporting),
+			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, firstUnaryTokenForErrorReporting),
 				String_Format("\"%S\" is not a known variable name", firstUnaryTokenForErrorReporting->text));
 		}
 		else if (token->kind == TOKEN_SEMICOLON) {
-			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_FromC("Expected a variable or number or other legal expression term, not a semicolon (remember, semicolons don't terminate statements in Smile!)"));
 		}
 		else if (token->kind == TOKEN_COMMA) {
-			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_FromC("Expected a variable or number or other legal expression term, not a comma (did you mistakenly put commas in a list?)"));
 		}
 		else if (token->kind == TOKEN_ERROR) {
-			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), token->text);
+			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), token->text);
 		}
 		else {
-			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+			error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 				String_Format("Expected a variable or number or other legal expression term, not \"%S\".", TokenKind_ToString(token->kind)));
 		}
 		return error;
@@ -212,7 +212,7 @@ ParseError Parser_ParseAnyName(Parser parser, SmileObject *expr)
 		return NULL;
 	}
 
-	error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token),
+	error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token),
 		String_Format("Expected a name, not \"%S\".", TokenKind_ToString(token->kind)));
 	return error;
 }
@@ -290,7 +290,7 @@ ParseError Parser_ExpectLeftBracket(Parser parser, SmileObject *result, Token fi
 
 	if (!Parser_HasLookahead(parser, TOKEN_LEFTBRACKET)) {
 		error = ParseMessage_Create(PARSEMESSAGE_ERROR,
-			firstUnaryTokenForErrorReporting != NULL ? Token_GetPosition(firstUnaryTokenForErrorReporting) : startPosition,
+			firstUnaryTokenForErrorReporting != NULL ? Parser_GetTokenPosition(parser, firstUnaryTokenForErrorReporting) : startPosition,
 			String_Format("Missing '[' in %s starting on line %d.", name, startPosition->line));
 		Parser_Recover(parser, Parser_RightBracesBracketsParentheses_Recovery, Parser_RightBracesBracketsParentheses_Count);
 		*result = NullObject;
@@ -308,7 +308,7 @@ ParseError Parser_ExpectRightBracket(Parser parser, SmileObject *result, Token f
 	UNUSED(firstUnaryTokenForErrorReporting);
 
 	if (!Parser_HasLookahead(parser, TOKEN_RIGHTBRACKET)) {
-		LexerPosition lexerPosition = Token_GetPosition(parser->lexer->token);
+		LexerPosition lexerPosition = Parser_GetTokenPosition(parser, parser->lexer->token);
 		error = ParseMessage_Create(PARSEMESSAGE_ERROR, lexerPosition,
 			String_Format("Missing ']' in %s starting on line %d.", name, startPosition->line));
 		Parser_Recover(parser, Parser_RightBracesBracketsParentheses_Recovery, Parser_RightBracesBracketsParentheses_Count);
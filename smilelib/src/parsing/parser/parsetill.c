@@ -63,7 +63,7 @@ ParseError Parser_ParseTill(Parser parser, SmileObject *expr, Int modeFlags, Lex
 		&& token->data.symbol == SMILE_SPECIAL_SYMBOL_DO)) {
 		// Missing 'do' keyword.
 		// We assume that's an error of omission, so we just rewind back a token and then try to keep going.
-		Parser_AddError(parser, Token_GetPosition(token), "Missing 'do' keyword after 'till'.");
+		Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "Missing 'do' keyword after 'till'.");
 		Lexer_Unget(parser->lexer);
 	}
 
@@ -121,7 +121,7 @@ ParseError Parser_ParseTillNames(Parser parser, SmileList *names)
 	// Wrap it in a list, so it becomes [x].
 	LIST_INIT(head, tail);
 	if (decl->kind != SMILE_KIND_NULL) {
-		LIST_APPEND_WITH_SOURCE(head, tail, decl, ((struct SmileListWithSourceInt *)decl)->position);
+		LIST_APPEND_WITH_SOURCE(head, tail, decl, Parser_GetSourcePosition(parser, decl));
 	}
 
 	// Every time we see a comma, parse the next name, and add it to the list.
@@ -131,7 +131,7 @@ ParseError Parser_ParseTillNames(Parser parser, SmileList *names)
 		if (error != NULL) return error;
 
 		if (decl->kind != SMILE_KIND_NULL) {
-			LIST_APPEND_WITH_SOURCE(head, tail, decl, ((struct SmileListWithSourceInt *)decl)->position);
+			LIST_APPEND_WITH_SOURCE(head, tail, decl, Parser_GetSourcePosition(parser, decl));
 		}
 	}
 
@@ -158,13 +158,13 @@ ParseError Parser_ParseTillName(Parser parser, SmileObject *expr)
 
 		// No variable name?  That's an error.
 		*expr = NullObject;
-		error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), String_FromC("Missing flag name after 'till'."));
+		error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), String_FromC("Missing flag name after 'till'."));
 		return error;
 	}
 
 	// Declare it in the current scope.
 	symbol = token->data.symbol;
-	error = ParseScope_DeclareHere(parser->currentScope, symbol, PARSEDECL_TILL, Token_GetPosition(token), NULL);
+	error = ParseScope_DeclareHere(parser->currentScope, symbol, PARSEDECL_TILL, Parser_GetTokenPosition(parser, token), NULL);
 	if (error != NULL)
 		return error;
 
@@ -200,13 +200,13 @@ ParseError Parser_ParseWhens(Parser parser, SmileObject *expr, Int32Int32Dict ti
 			Lexer_Unget(parser->lexer);
 			break;
 		}
-		position = Token_GetPosition(token);
+		position = Parser_GetTokenPosition(parser, token);
 
 		// There should be a symbol that follows it.
 		if (!(((token = Parser_NextToken(parser))->kind == TOKEN_ALPHANAME || token->kind == TOKEN_UNKNOWNALPHANAME
 			|| token->kind == TOKEN_PUNCTNAME || token->kind == TOKEN_UNKNOWNPUNCTNAME))) {
 			// Not a symbol, so complain, but rewind a token and keep going if we can.
-			Parser_AddError(parser, Token_GetPosition(token), "Missing till-flag name after 'when'.");
+			Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "Missing till-flag name after 'when'.");
 			Lexer_Unget(parser->lexer);
 			flagName = 0;
 		}
@@ -215,14 +215,14 @@ ParseError Parser_ParseWhens(Parser parser, SmileObject *expr, Int32Int32Dict ti
 
 			// That symbol should be one of the flag names declared in the 'till'.
 			if (!Int32Int32Dict_ContainsKey(tillFlags, flagName)) {
-				Parser_AddError(parser, Token_GetPosition(token), "'%S' is not a name declared in this 'till' loop.",
+				Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "'%S' is not a name declared in this 'till' loop.",
 					SymbolTable_GetName(Smile_SymbolTable, flagName));
 				// Try to keep going anyway.
 			}
 			else {
 				// That symbol shouldn't have been used already for this 'till'.
 				if (!Int32Dict_Add(usedSymbolDict, flagName, NULL)) {
-					Parser_AddError(parser, Token_GetPosition(token), "'when %S' was used multiple times for the same 'till' loop.",
+					Parser_AddError(parser, Parser_GetTokenPosition(parser, token), "'when %S' was used multiple times for the same 'till' loop.",
 						SymbolTable_GetName(Smile_SymbolTable, flagName));
 					// Keep going with the parse.
 				}
@@ -261,7 +261,7 @@ static ParseError Parser_ParseClassicTillWhen(Parser parser, SmileObject *result
 
 	// Consume the '['.
 	token = Parser_NextToken(parser);
-	position = Token_GetPosition(token);
+	position = Parser_GetTokenPosition(parser, token);
 
 	// It should be followed by a name.
 	token = Parser_NextToken(parser);
@@ -362,11 +362,11 @@ static ParseError Parser_ParseClassicTillFlagNames(Parser parser, SmileList *res
 			case TOKEN_PUNCTNAME:
 			case TOKEN_UNKNOWNPUNCTNAME:
 				name = token->data.symbol;
-				LIST_APPEND_WITH_SOURCE(head, tail, SmileSymbol_Create(name), Token_GetPosition(token));
+				LIST_APPEND_WITH_SOURCE(head, tail, SmileSymbol_Create(name), Parser_GetTokenPosition(parser, token));
 				break;
 
 			default:
-				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Token_GetPosition(token), String_FromC("Missing name for [$till] flag."));
+				error = ParseMessage_Create(PARSEMESSAGE_ERROR, Parser_GetTokenPosition(parser, token), String_FromC("Missing name for [$till] flag."));
 				Parser_AddMessage(parser, error);
 				break;
 		}
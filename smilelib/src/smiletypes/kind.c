@@ -67,6 +67,10 @@ STATIC_STRING(BigReal_, "bigReal");
 
 STATIC_STRING(ByteArray_, "ByteArray");
 
+STATIC_STRING(Array_, "Array");
+STATIC_STRING(Map_, "Map");
+STATIC_STRING(Sequence_, "Sequence");
+
 STATIC_STRING(Syntax_, "Syntax");
 STATIC_STRING(Nonterminal_, "Nonterminal");
 
@@ -127,6 +131,11 @@ String SmileKind_GetName(Int kind)
 		// Raw buffer types.
 		case SMILE_KIND_BYTEARRAY: return ByteArray_;
 
+		// Native container types.
+		case SMILE_KIND_ARRAY: return Array_;
+		case SMILE_KIND_MAP: return Map_;
+		case SMILE_KIND_SEQUENCE: return Sequence_;
+
 		// Types used for parsing.	
 		case SMILE_KIND_SYNTAX: return Syntax_;
 		case SMILE_KIND_NONTERMINAL: return Nonterminal_;
@@ -207,6 +216,11 @@ Symbol SmileKind_GetTypeOf(Int smileKind)
 		// Raw buffer types.
 		case SMILE_KIND_BYTEARRAY: return Smile_KnownSymbols.byte_array;
 
+		// Native container types.
+		case SMILE_KIND_ARRAY: return Smile_KnownSymbols.array;
+		case SMILE_KIND_MAP: return Smile_KnownSymbols.map;
+		case SMILE_KIND_SEQUENCE: return Smile_KnownSymbols.sequence;
+
 		// Types used for parsing.	
 		case SMILE_KIND_SYNTAX: return Smile_KnownSymbols.syntax;
 		case SMILE_KIND_NONTERMINAL: return Smile_KnownSymbols.nonterminal;
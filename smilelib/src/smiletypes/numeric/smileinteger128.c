@@ -24,7 +24,8 @@ SMILE_EASY_OBJECT_VTABLE(SmileInteger128);
 
 SmileInteger128 SmileInteger128_CreateInternal(Int128 value)
 {
-	SmileInteger128 smileInt = GC_MALLOC_STRUCT(struct SmileInteger128Int);
+	// We MALLOC_ATOMIC here because the base is a known pointer that will never be collected.
+	SmileInteger128 smileInt = (SmileInteger128)GC_MALLOC_ATOMIC(sizeof(struct SmileInteger128Int));
 	if (smileInt == NULL) Smile_Abort_OutOfMemory();
 	smileInt->base = (SmileObject)Smile_KnownBases.Integer128;
 	smileInt->kind = SMILE_KIND_INTEGER128;
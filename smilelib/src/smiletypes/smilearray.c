@@ -0,0 +1,302 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/easyobject.h>
+#include <smile/smiletypes/smilearray.h>
+#include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/text/smilesymbol.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/stringbuilder.h>
+
+SMILE_EASY_OBJECT_VTABLE(SmileArray);
+
+SMILE_EASY_OBJECT_READONLY_SECURITY(SmileArray);
+SMILE_EASY_OBJECT_NO_CALL(SmileArray, "An Array");
+SMILE_EASY_OBJECT_NO_SOURCE(SmileArray);
+SMILE_EASY_OBJECT_NO_UNBOX(SmileArray)
+
+/// <summary>
+/// The smallest nonzero number of items we'll allocate for an array's buffer.
+/// </summary>
+#define SMILE_ARRAY_MIN_CAPACITY 8
+
+/// <summary>
+/// Create a new, empty Array.
+/// </summary>
+/// <param name="base">The base type this Array inherits from.</param>
+/// <param name="capacity">How many items to preallocate space for, which must be nonnegative.</param>
+/// <returns>The new, empty Array.</returns>
+SmileArray SmileArray_Create(SmileObject base, Int capacity)
+{
+	SmileArray array;
+
+	if (capacity < 0) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_FromC("Cannot create an Array of negative size."));
+	}
+
+	array = GC_MALLOC_STRUCT(struct SmileArrayInt);
+	if (array == NULL) Smile_Abort_OutOfMemory();
+
+	array->base = base;
+	array->kind = SMILE_KIND_ARRAY | SMILE_SECURITY_WRITABLE;
+	array->vtable = SmileArray_VTable;
+	array->length = 0;
+	array->max = capacity;
+
+	if (capacity > 0) {
+		array->items = GC_MALLOC_STRUCT_ARRAY(SmileArg, capacity);
+		if (array->items == NULL) Smile_Abort_OutOfMemory();
+	}
+	else array->items = NULL;
+
+	return array;
+}
+
+/// <summary>
+/// Create a new Array that contains a copy of the given items.
+/// </summary>
+/// <param name="base">The base type this Array inherits from.</param>
+/// <param name="args">The items to copy into the new Array.</param>
+/// <param name="count">The number of items to copy.</param>
+/// <returns>The new Array.</returns>
+SmileArray SmileArray_CreateFromArgs(SmileObject base, const SmileArg *args, Int count)
+{
+	SmileArray array = SmileArray_Create(base, count);
+
+	if (count > 0)
+		MemCpy(array->items, args, sizeof(SmileArg) * count);
+	array->length = count;
+
+	return array;
+}
+
+/// <summary>
+/// Create a new Array that contains the items of the given List, unboxed where possible.
+/// The List must be well-formed.
+/// </summary>
+/// <param name="base">The base type this Array inherits from.</param>
+/// <param name="list">The List whose items should be copied into the new Array.</param>
+/// <returns>The new Array.</returns>
+SmileArray SmileArray_CreateFromList(SmileObject base, SmileList list)
+{
+	SmileArray array;
+	SmileArg *dest;
+	Int length;
+
+	length = SmileList_SafeLength(list);
+	if (length < 0) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_FromC("Cannot create an Array from a List that is not well-formed."));
+	}
+
+	array = SmileArray_Create(base, length);
+
+	for (dest = array->items; SMILE_KIND(list) == SMILE_KIND_LIST; list = LIST_REST(list)) {
+		*dest++ = SmileArg_Unbox(list->a);
+	}
+	array->length = length;
+
+	return array;
+}
+
+/// <summary>
+/// Create a new List that contains the items of the given Array, boxed as necessary.
+/// </summary>
+/// <param name="array">The Array whose items should be copied into the new List.</param>
+/// <returns>The new List (which is NullList if the Array is empty).</returns>
+SmileList SmileArray_ToList(SmileArray array)
+{
+	SmileList head, tail;
+	SmileArg *src, *end;
+
+	LIST_INIT(head, tail);
+
+	for (src = array->items, end = src + array->length; src < end; src++) {
+		LIST_APPEND(head, tail, SmileArg_Box(*src));
+	}
+
+	return head;
+}
+
+/// <summary>
+/// Make sure that the array has room for at least the given number of items, reallocating
+/// its buffer if needed.  The buffer grows geometrically, so repeated appends run in
+/// amortized constant time.
+/// </summary>
+/// <param name="array">The array to grow.</param>
+/// <param name="capacity">The minimum number of items the array must be able to hold.</param>
+void SmileArray_EnsureCapacity(SmileArray array, Int capacity)
+{
+	SmileArg *newItems;
+	Int newMax;
+
+	if (capacity <= array->max) return;
+
+	newMax = array->max < SMILE_ARRAY_MIN_CAPACITY ? SMILE_ARRAY_MIN_CAPACITY : array->max;
+	while (newMax < capacity) {
+		if (newMax > (Int)(PtrIntMax / sizeof(SmileArg) / 2))
+			Smile_Abort_OutOfMemory();
+		newMax *= 2;
+	}
+
+	newItems = GC_MALLOC_STRUCT_ARRAY(SmileArg, newMax);
+	if (newItems == NULL) Smile_Abort_OutOfMemory();
+
+	if (array->length > 0)
+		MemCpy(newItems, array->items, sizeof(SmileArg) * array->length);
+
+	array->items = newItems;
+	array->max = newMax;
+}
+
+/// <summary>
+/// Change the number of items in the array.  New items are filled in with null.
+/// </summary>
+/// <param name="array">The array to resize.</param>
+/// <param name="length">The new number of items in the array, which must be nonnegative.</param>
+void SmileArray_Resize(SmileArray array, Int length)
+{
+	Int i;
+
+	if (length < 0) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_FromC("Cannot resize an Array to negative size."));
+	}
+
+	if (length > array->length) {
+		SmileArray_EnsureCapacity(array, length);
+		for (i = array->length; i < length; i++) {
+			array->items[i] = SmileArg_From(NullObject);
+		}
+	}
+	else {
+		// Clear out the discarded items so the GC can reclaim whatever they refer to.
+		MemZero(array->items + length, sizeof(SmileArg) * (array->length - length));
+	}
+
+	array->length = length;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static Bool SmileArray_CompareEqual(SmileArray self, SmileUnboxedData selfData, SmileObject other, SmileUnboxedData otherData)
+{
+	UNUSED(selfData);
+	UNUSED(otherData);
+
+	return (SmileObject)self == other;
+}
+
+static Bool SmileArray_DeepEqual(SmileArray self, SmileUnboxedData selfData, SmileObject other, SmileUnboxedData otherData, PointerSet visitedPointers)
+{
+	SmileArray otherArray;
+	SmileArg *a, *b, *end;
+
+	UNUSED(selfData);
+	UNUSED(otherData);
+
+	if (SMILE_KIND(other) != SMILE_KIND_ARRAY) return False;
+	otherArray = (SmileArray)other;
+
+	if (self->length != otherArray->length) return False;
+
+	for (a = self->items, b = otherArray->items, end = a + self->length; a < end; a++, b++) {
+		if (SMILE_KIND(a->obj) >= 0x10 && !PointerSet_Add(visitedPointers, a->obj))
+			continue;
+		if (!SMILE_VCALL4(a->obj, deepEqual, a->unboxed, b->obj, b->unboxed, visitedPointers))
+			return False;
+	}
+
+	return True;
+}
+
+static UInt32 SmileArray_Hash(SmileArray self)
+{
+	return Smile_ApplyHashOracle((PtrInt)self);
+}
+
+static SmileObject SmileArray_GetProperty(SmileArray self, Symbol propertyName)
+{
+	if (propertyName == Smile_KnownSymbols.length)
+		return (SmileObject)SmileInteger64_Create(self->length);
+	return self->base->vtable->getProperty(self->base, propertyName);
+}
+
+static void SmileArray_SetProperty(SmileArray self, Symbol propertyName, SmileObject value)
+{
+	if (propertyName != Smile_KnownSymbols.length) {
+		Smile_ThrowException(Smile_KnownSymbols.object_security_error,
+			String_Format("Cannot set property \"%S\" on an Array.",
+				SymbolTable_GetName(Smile_SymbolTable, propertyName)));
+		return;
+	}
+
+	if (SMILE_KIND(value) != SMILE_KIND_INTEGER64) {
+		Smile_ThrowException(Smile_KnownSymbols.object_security_error,
+			String_Format("Cannot set property \"%S\" on an Array from a value that is not an Integer64.",
+				SymbolTable_GetName(Smile_SymbolTable, propertyName)));
+		return;
+	}
+
+	SmileArray_Resize(self, (Int)((SmileInteger64)value)->value);
+}
+
+static Bool SmileArray_HasProperty(SmileArray self, Symbol propertyName)
+{
+	UNUSED(self);
+	return (propertyName == Smile_KnownSymbols.length);
+}
+
+static SmileList SmileArray_GetPropertyNames(SmileArray self)
+{
+	SmileList head, tail;
+
+	UNUSED(self);
+
+	LIST_INIT(head, tail);
+	LIST_APPEND(head, tail, SmileSymbol_Create(Smile_KnownSymbols.length));
+
+	return head;
+}
+
+static Bool SmileArray_ToBool(SmileArray self, SmileUnboxedData unboxedData)
+{
+	UNUSED(self);
+	UNUSED(unboxedData);
+	return True;
+}
+
+static String SmileArray_ToString(SmileArray self, SmileUnboxedData unboxedData)
+{
+	SmileArg *item, *end;
+	DECLARE_INLINE_STRINGBUILDER(stringBuilder, 256);
+
+	UNUSED(unboxedData);
+
+	INIT_INLINE_STRINGBUILDER(stringBuilder);
+	StringBuilder_AppendByte(stringBuilder, '[');
+
+	for (item = self->items, end = item + self->length; item < end; item++) {
+		if (item > self->items)
+			StringBuilder_AppendByte(stringBuilder, ' ');
+		StringBuilder_AppendString(stringBuilder, SMILE_VCALL1(item->obj, toString, item->unboxed));
+	}
+
+	StringBuilder_AppendByte(stringBuilder, ']');
+
+	return StringBuilder_ToString(stringBuilder);
+}
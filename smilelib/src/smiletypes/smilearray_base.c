@@ -0,0 +1,787 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/eval/eval.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/smileuserobject.h>
+#include <smile/smiletypes/smilearray.h>
+#include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/smilesequence.h>
+#include <smile/smiletypes/smilebool.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/smiletypes/range/smileinteger64range.h>
+#include <smile/smiletypes/smilefunction.h>
+#include <smile/smiletypes/base.h>
+#include <smile/internal/staticstring.h>
+
+SMILE_IGNORE_UNUSED_VARIABLES
+
+static Byte _arrayChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_ARRAY,
+	0, 0,
+	0, 0,
+};
+
+static Byte _eachChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_ARRAY,
+	SMILE_KIND_MASK, SMILE_KIND_FUNCTION,
+};
+
+static Byte _fromListChecks[] = {
+	0, 0,
+	SMILE_KIND_MASK & ~SMILE_KIND_LIST_BIT, SMILE_KIND_NULL,
+};
+
+STATIC_STRING(OutOfRangeError, "Index out of range.");
+
+//-------------------------------------------------------------------------------------------------
+// Generic type conversion
+
+SMILE_EXTERNAL_FUNCTION(ToBool)
+{
+	return SmileUnboxedBool_From(True);
+}
+
+SMILE_EXTERNAL_FUNCTION(ToInt)
+{
+	if (SMILE_KIND(argv[0].obj) == SMILE_KIND_ARRAY)
+		return SmileUnboxedInteger64_From(((SmileArray)argv[0].obj)->length);
+
+	return SmileUnboxedInteger64_From(0);
+}
+
+SMILE_EXTERNAL_FUNCTION(ToString)
+{
+	STATIC_STRING(array, "Array");
+
+	if (SMILE_KIND(argv[0].obj) == SMILE_KIND_ARRAY)
+		return SmileArg_From((SmileObject)SMILE_VCALL1(argv[0].obj, toString, argv[0].unboxed));
+
+	return SmileArg_From((SmileObject)array);
+}
+
+SMILE_EXTERNAL_FUNCTION(Hash)
+{
+	return SmileUnboxedInteger64_From(Smile_ApplyHashOracle((PtrInt)argv[0].obj));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Construction and conversion
+
+SMILE_EXTERNAL_FUNCTION(Of)
+{
+	SmileUserObject base = (SmileUserObject)param;
+	Int i;
+
+	i = 0;
+	if (argv[i].obj == (SmileObject)base)
+		i++;
+
+	return SmileArg_From((SmileObject)SmileArray_CreateFromArgs((SmileObject)base, argv + i, argc - i));
+}
+
+SMILE_EXTERNAL_FUNCTION(OfSize)
+{
+	STATIC_STRING(argumentError, "Array.of-size accepts one Integer64 argument (and one optional initial value).");
+	STATIC_STRING(countError, "Array.of-size count must not be negative.");
+
+	SmileUserObject base = (SmileUserObject)param;
+	SmileArray array;
+	SmileArg value;
+	Int64 count;
+	Int i;
+
+	i = 0;
+	if (argv[i].obj == (SmileObject)base)
+		i++;
+
+	// Parse the Integer64 count.
+	if (i >= argc || SMILE_KIND(argv[i].obj) != SMILE_KIND_UNBOXED_INTEGER64)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, argumentError);
+	count = argv[i].unboxed.i64;
+	if (count < 0 || count > PtrIntMax / (Int64)sizeof(SmileArg))
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, countError);
+	i++;
+
+	// Parse an optional initial value.
+	if (i < argc)
+		value = argv[i++];
+	else
+		value = SmileArg_From(NullObject);
+	if (i < argc)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, argumentError);
+
+	// Create and fill the Array.
+	array = SmileArray_Create((SmileObject)base, (Int)count);
+	for (i = 0; i < (Int)count; i++) {
+		array->items[i] = value;
+	}
+	array->length = (Int)count;
+
+	return SmileArg_From((SmileObject)array);
+}
+
+SMILE_EXTERNAL_FUNCTION(FromList)
+{
+	return SmileArg_From((SmileObject)SmileArray_CreateFromList((SmileObject)param, (SmileList)argv[1].obj));
+}
+
+SMILE_EXTERNAL_FUNCTION(ToList)
+{
+	return SmileArg_From((SmileObject)SmileArray_ToList((SmileArray)argv[0].obj));
+}
+
+SMILE_EXTERNAL_FUNCTION(Lazy)
+{
+	return SmileArg_From((SmileObject)SmileSequence_Create(argv[0].obj));
+}
+
+SMILE_EXTERNAL_FUNCTION(Clone)
+{
+	SmileArray array = (SmileArray)argv[0].obj;
+	return SmileArg_From((SmileObject)SmileArray_CreateFromArgs(array->base, array->items, array->length));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Appending and reordering
+
+SMILE_EXTERNAL_FUNCTION(Empty)
+{
+	return SmileUnboxedBool_From(((SmileArray)argv[0].obj)->length == 0);
+}
+
+SMILE_EXTERNAL_FUNCTION(AppendInPlace)
+{
+	SmileArray array = (SmileArray)argv[0].obj;
+	Int i;
+
+	SmileArray_EnsureCapacity(array, array->length + (argc - 1));
+
+	for (i = 1; i < argc; i++) {
+		array->items[array->length++] = argv[i];
+	}
+
+	return argv[0];
+}
+
+SMILE_EXTERNAL_FUNCTION(ReverseInPlace)
+{
+	SmileArray array = (SmileArray)argv[0].obj;
+	SmileArg *start, *end, temp;
+
+	for (start = array->items, end = start + array->length - 1; start < end; start++, end--) {
+		temp = *start;
+		*start = *end;
+		*end = temp;
+	}
+
+	return argv[0];
+}
+
+//-------------------------------------------------------------------------------------------------
+// Get/set members
+
+static Int64 ClipRangeIndex(Int64 index, Int length)
+{
+	if (index < 0) return 0;
+	if (index > (Int64)length - 1) return (Int64)length - 1;
+	return index;
+}
+
+SMILE_EXTERNAL_FUNCTION(GetMember)
+{
+	STATIC_STRING(invalidIndexType, "Index to Array.get-member must be of type Integer64 or Integer64Range.");
+	SmileArray array = (SmileArray)argv[0].obj;
+
+	switch (SMILE_KIND(argv[1].obj)) {
+		case SMILE_KIND_UNBOXED_INTEGER64:
+		{
+			Int64 index = argv[1].unboxed.i64;
+			if (index < 0 || index >= array->length)
+				Smile_ThrowException(Smile_KnownSymbols.native_method_error, OutOfRangeError);
+			return array->items[(Int)index];
+		}
+
+		case SMILE_KIND_INTEGER64RANGE:
+		{
+			SmileInteger64Range range = (SmileInteger64Range)argv[1].obj;
+			Int64 start, end, stepping = range->stepping;
+			SmileArray dest;
+			Int64 i;
+
+			dest = SmileArray_Create((SmileObject)array->base, 0);
+			if (array->length <= 0)
+				return SmileArg_From((SmileObject)dest);
+
+			// A range that lies entirely past either end of the array selects nothing; only
+			// ranges that overlap the array get clipped to it.
+			if (range->start <= range->end
+				? (range->start >= array->length || range->end < 0)
+				: (range->end >= array->length || range->start < 0))
+				return SmileArg_From((SmileObject)dest);
+
+			start = ClipRangeIndex(range->start, array->length);
+			end = ClipRangeIndex(range->end, array->length);
+
+			if (start <= end) {
+				if (stepping < 1) stepping = 1;
+				SmileArray_EnsureCapacity(dest, (Int)((end - start) / stepping + 1));
+				for (i = start; i <= end; i += stepping) {
+					dest->items[dest->length++] = array->items[(Int)i];
+				}
+			}
+			else {
+				if (stepping > -1) stepping = -1;
+				SmileArray_EnsureCapacity(dest, (Int)((start - end) / -stepping + 1));
+				for (i = start; i >= end; i += stepping) {
+					dest->items[dest->length++] = array->items[(Int)i];
+				}
+			}
+
+			return SmileArg_From((SmileObject)dest);
+		}
+
+		default:
+			Smile_ThrowException(Smile_KnownSymbols.native_method_error, invalidIndexType);
+	}
+}
+
+SMILE_EXTERNAL_FUNCTION(SetMember)
+{
+	STATIC_STRING(invalidIndexType, "Index to Array.set-member must be of type Integer64.");
+	SmileArray array = (SmileArray)argv[0].obj;
+	Int64 index;
+
+	if (SMILE_KIND(argv[1].obj) != SMILE_KIND_UNBOXED_INTEGER64)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, invalidIndexType);
+
+	index = argv[1].unboxed.i64;
+	if (index < 0 || index >= array->length)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, OutOfRangeError);
+
+	array->items[(Int)index] = argv[2];
+
+	return argv[2];
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct EachInfoStruct {
+	SmileArray array;
+	SmileFunction function;
+	Int index;
+} *EachInfo;
+
+static Int EachWithOneArg(ClosureStateMachine closure)
+{
+	EachInfo eachInfo = (EachInfo)closure->state;
+
+	// If we've run out of items, we're done.
+	if (eachInfo->index >= eachInfo->array->length) {
+		Closure_Pop(closure);
+		Closure_PushBoxed(closure, eachInfo->array);	// Pop the previous return value and push 'array'.
+		return -1;
+	}
+
+	// Set up to call the user's function with the next item.
+	Closure_Pop(closure);
+	Closure_PushBoxed(closure, eachInfo->function);
+	Closure_Push(closure, eachInfo->array->items[eachInfo->index]);
+
+	eachInfo->index++;	// Move the iterator to the next item.
+
+	return 1;
+}
+
+static Int EachWithTwoArgs(ClosureStateMachine closure)
+{
+	EachInfo eachInfo = (EachInfo)closure->state;
+
+	// If we've run out of items, we're done.
+	if (eachInfo->index >= eachInfo->array->length) {
+		Closure_Pop(closure);
+		Closure_PushBoxed(closure, eachInfo->array);	// Pop the previous return value and push 'array'.
+		return -1;
+	}
+
+	// Set up to call the user's function with the next item and index.
+	Closure_Pop(closure);
+	Closure_PushBoxed(closure, eachInfo->function);
+	Closure_Push(closure, eachInfo->array->items[eachInfo->index]);
+	Closure_PushUnboxedInt64(closure, eachInfo->index);
+
+	eachInfo->index++;	// Move the iterator to the next item.
+
+	return 2;
+}
+
+SMILE_EXTERNAL_FUNCTION(Each)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileArray array = (SmileArray)argv[0].obj;
+	SmileFunction function = (SmileFunction)argv[1].obj;
+	Int minArgs, maxArgs;
+	EachInfo eachInfo;
+	ClosureStateMachine closure;
+	StateMachine stateMachine;
+
+	SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+
+	stateMachine = maxArgs <= 1 ? EachWithOneArg : EachWithTwoArgs;
+	closure = Eval_BeginStateMachine(stateMachine, stateMachine);
+
+	eachInfo = (EachInfo)closure->state;
+	eachInfo->function = function;
+	eachInfo->array = array;
+	eachInfo->index = 0;
+
+	Closure_PushBoxed(closure, NullObject);	// Initial "return" value from 'each'.
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct MapInfoStruct {
+	SmileArray array;
+	SmileArray result;
+	SmileFunction function;
+	Int index;
+	Bool withIndex;
+} *MapInfo;
+
+static Int MapStart(ClosureStateMachine closure)
+{
+	register MapInfo loopInfo = (MapInfo)closure->state;
+
+	//---------- begin first for-loop iteration ----------
+
+	// Condition: If we've run out of items, we're done.
+	if (loopInfo->index >= loopInfo->array->length) {
+		Closure_PushBoxed(closure, loopInfo->result);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the first item.
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, loopInfo->array->items[loopInfo->index]);
+	if (!loopInfo->withIndex) return 1;
+	Closure_PushUnboxedInt64(closure, loopInfo->index);
+	return 2;
+}
+
+static Int MapBody(ClosureStateMachine closure)
+{
+	register MapInfo loopInfo = (MapInfo)closure->state;
+
+	// Body: Append the user function's most recent result to the output array.
+	SmileArray_Append(loopInfo->result, Closure_Pop(closure));
+
+	// Next: Move the iterator to the next item.
+	loopInfo->index++;
+
+	//---------- end previous for-loop iteration ----------
+
+	//---------- begin next for-loop iteration ----------
+
+	// Condition: If we've run out of items, we're done.
+	if (loopInfo->index >= loopInfo->array->length) {
+		Closure_PushBoxed(closure, loopInfo->result);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the next item.
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, loopInfo->array->items[loopInfo->index]);
+	if (!loopInfo->withIndex) return 1;
+	Closure_PushUnboxedInt64(closure, loopInfo->index);
+	return 2;
+}
+
+SMILE_EXTERNAL_FUNCTION(Map)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileArray array = (SmileArray)argv[0].obj;
+	SmileFunction function = (SmileFunction)argv[1].obj;
+	Int minArgs, maxArgs;
+	MapInfo mapInfo;
+	ClosureStateMachine closure;
+
+	SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+
+	closure = Eval_BeginStateMachine(MapStart, MapBody);
+
+	mapInfo = (MapInfo)closure->state;
+	mapInfo->array = array;
+	mapInfo->result = SmileArray_Create(array->base, array->length);
+	mapInfo->function = function;
+	mapInfo->index = 0;
+	mapInfo->withIndex = (maxArgs > 1);
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct WhereInfoStruct {
+	SmileArray array;
+	SmileArray result;
+	SmileFunction function;
+	Int index;
+	Bool withIndex;
+} *WhereInfo;
+
+static Int WhereStart(ClosureStateMachine closure)
+{
+	register WhereInfo loopInfo = (WhereInfo)closure->state;
+
+	//---------- begin first for-loop iteration ----------
+
+	// Condition: If we've run out of items, we're done.
+	if (loopInfo->index >= loopInfo->array->length) {
+		Closure_PushBoxed(closure, loopInfo->result);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the first item.
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, loopInfo->array->items[loopInfo->index]);
+	if (!loopInfo->withIndex) return 1;
+	Closure_PushUnboxedInt64(closure, loopInfo->index);
+	return 2;
+}
+
+static Int WhereBody(ClosureStateMachine closure)
+{
+	register WhereInfo loopInfo = (WhereInfo)closure->state;
+
+	// Body: Get the value from the user's condition.
+	SmileArg fnResult = Closure_Pop(closure);
+	Bool booleanResult = SMILE_VCALL1(fnResult.obj, toBool, fnResult.unboxed);
+
+	// If it's truthy, keep this item.
+	if (booleanResult) {
+		SmileArray_Append(loopInfo->result, loopInfo->array->items[loopInfo->index]);
+	}
+
+	// Next: Move the iterator to the next item.
+	loopInfo->index++;
+
+	//---------- end previous for-loop iteration ----------
+
+	//---------- begin next for-loop iteration ----------
+
+	// Condition: If we've run out of items, we're done.
+	if (loopInfo->index >= loopInfo->array->length) {
+		Closure_PushBoxed(closure, loopInfo->result);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the next item.
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, loopInfo->array->items[loopInfo->index]);
+	if (!loopInfo->withIndex) return 1;
+	Closure_PushUnboxedInt64(closure, loopInfo->index);
+	return 2;
+}
+
+SMILE_EXTERNAL_FUNCTION(Where)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileArray array = (SmileArray)argv[0].obj;
+	SmileFunction function = (SmileFunction)argv[1].obj;
+	Int minArgs, maxArgs;
+	WhereInfo whereInfo;
+	ClosureStateMachine closure;
+
+	SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+
+	closure = Eval_BeginStateMachine(WhereStart, WhereBody);
+
+	whereInfo = (WhereInfo)closure->state;
+	whereInfo->array = array;
+	whereInfo->result = SmileArray_Create(array->base, 0);
+	whereInfo->function = function;
+	whereInfo->index = 0;
+	whereInfo->withIndex = (maxArgs > 1);
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct CountInfoStruct {
+	SmileArray array;
+	SmileFunction function;
+	Int index;
+	Int count;
+} *CountInfo;
+
+static Int CountStart(ClosureStateMachine closure)
+{
+	register CountInfo loopInfo = (CountInfo)closure->state;
+
+	//---------- begin first for-loop iteration ----------
+
+	// Condition: If we've run out of items, we're done.
+	if (loopInfo->index >= loopInfo->array->length) {
+		Closure_PushUnboxedInt64(closure, loopInfo->count);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the first item.
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, loopInfo->array->items[loopInfo->index]);
+	return 1;
+}
+
+static Int CountBody(ClosureStateMachine closure)
+{
+	register CountInfo loopInfo = (CountInfo)closure->state;
+
+	// Body: Get the value from the user's condition.
+	SmileArg fnResult = Closure_Pop(closure);
+	Bool booleanResult = SMILE_VCALL1(fnResult.obj, toBool, fnResult.unboxed);
+
+	// If we found a hit, add it to the count.  (We always add here to avoid the possibility
+	// of a branch misprediction from an if-statement.)
+	loopInfo->count += booleanResult;
+
+	// Next: Move the iterator to the next item.
+	loopInfo->index++;
+
+	//---------- end previous for-loop iteration ----------
+
+	//---------- begin next for-loop iteration ----------
+
+	// Condition: If we've run out of items, we're done.
+	if (loopInfo->index >= loopInfo->array->length) {
+		Closure_PushUnboxedInt64(closure, loopInfo->count);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the next item.
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, loopInfo->array->items[loopInfo->index]);
+	return 1;
+}
+
+SMILE_EXTERNAL_FUNCTION(Count)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileArray array = (SmileArray)argv[0].obj;
+	CountInfo countInfo;
+	ClosureStateMachine closure;
+	SmileArg arg, *item, *end;
+	Int count;
+
+	if (argc < 1) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_Format("'count' requires at least 1 argument, but was called with %d.", argc));
+	}
+	if (SMILE_KIND(argv[0].obj) != SMILE_KIND_ARRAY) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_FromC("Argument 1 to 'count' is of the wrong type."));
+	}
+
+	if (argc == 1) {
+		// Degenerate form: Just return the length of the array.
+		return SmileUnboxedInteger64_From(array->length);
+	}
+
+	if (argc > 2) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_Format("'count' allows at most 2 arguments, but was called with %d.", argc));
+	}
+
+	if (SMILE_KIND(argv[1].obj) != SMILE_KIND_FUNCTION) {
+		// Degenerate form:  Count up any values that are super-equal to the given value.
+		arg = argv[1];
+		for (count = 0, item = array->items, end = item + array->length; item < end; item++) {
+			if (SMILE_VCALL3(item->obj, compareEqual, item->unboxed, arg.obj, arg.unboxed)) {
+				count++;
+			}
+		}
+		return SmileUnboxedInteger64_From(count);
+	}
+
+	closure = Eval_BeginStateMachine(CountStart, CountBody);
+
+	countInfo = (CountInfo)closure->state;
+	countInfo->array = array;
+	countInfo->function = (SmileFunction)argv[1].obj;
+	countInfo->index = 0;
+	countInfo->count = 0;
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct SortInfoStruct {
+	SmileArray array;
+	SmileFunction cmp;
+	InterruptibleListSortInfo actualSortInfo;
+} *SortInfo;
+
+/// <summary>
+/// Copy the sorted list's items back into the array, unboxing them again.
+/// </summary>
+static void CopySortedListToArray(SmileArray array, SmileList sortResult)
+{
+	SmileArg *dest = array->items;
+
+	for (; SMILE_KIND(sortResult) == SMILE_KIND_LIST; sortResult = LIST_REST(sortResult)) {
+		*dest++ = SmileArg_Unbox(sortResult->a);
+	}
+}
+
+/// <summary>
+/// Copy the sorted list's items back into the array, and push the array as the result of the sort.
+/// </summary>
+static Int FinishSort(ClosureStateMachine closure, SortInfo loopInfo, SmileList sortResult)
+{
+	CopySortedListToArray(loopInfo->array, sortResult);
+
+	Closure_PushBoxed(closure, loopInfo->array);
+	return -1;
+}
+
+static Int PushSortComparison(ClosureStateMachine closure, SortInfo loopInfo, SmileObject cmpA, SmileObject cmpB)
+{
+	if (loopInfo->cmp != NULL)
+		Closure_PushBoxed(closure, loopInfo->cmp);
+	else {
+		SmileFunction cmp = (SmileFunction)SMILE_VCALL1(cmpA, getProperty, Smile_KnownSymbols.cmp);
+		if (SMILE_KIND(cmp) != SMILE_KIND_FUNCTION) {
+			Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+				String_FromC("Cannot continue 'sort!': Object does not have an associated 'cmp' method."));
+		}
+		Closure_PushBoxed(closure, cmp);
+	}
+	Closure_UnboxAndPush(closure, cmpA);
+	Closure_UnboxAndPush(closure, cmpB);
+	return 2;
+}
+
+static Int SortStart(ClosureStateMachine closure)
+{
+	register SortInfo loopInfo = (SortInfo)closure->state;
+	SmileObject cmpA, cmpB;
+	SmileList sortResult;
+
+	if (!InterruptibleListSort_Continue(loopInfo->actualSortInfo, 0, &cmpA, &cmpB, &sortResult))
+		return FinishSort(closure, loopInfo, sortResult);
+
+	return PushSortComparison(closure, loopInfo, cmpA, cmpB);
+}
+
+static Int SortBody(ClosureStateMachine closure)
+{
+	register SortInfo loopInfo = (SortInfo)closure->state;
+	SmileArg fnResult;
+	SmileObject cmpA, cmpB;
+	SmileList sortResult;
+
+	// Get the integer comparison result.
+	fnResult = Closure_Pop(closure);
+	if (SMILE_KIND(fnResult.obj) != SMILE_KIND_UNBOXED_INTEGER64)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+			String_FromC("Cannot continue 'sort!': Comparison result must be an Integer64."));
+
+	// Continue doing the actual sorting work, inside-out.
+	if (!InterruptibleListSort_Continue(loopInfo->actualSortInfo, fnResult.unboxed.i64, &cmpA, &cmpB, &sortResult))
+		return FinishSort(closure, loopInfo, sortResult);
+
+	return PushSortComparison(closure, loopInfo, cmpA, cmpB);
+}
+
+SMILE_EXTERNAL_FUNCTION(SortInPlace)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileArray array = (SmileArray)argv[0].obj;
+	SortInfo sortInfo;
+	ClosureStateMachine closure;
+	SmileFunction cmp;
+	SmileList list;
+
+	if (argc < 1)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_Format("'sort!' requires at least 1 argument, but was called with %d.", argc));
+	if (SMILE_KIND(argv[0].obj) != SMILE_KIND_ARRAY)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_FromC("Argument 1 to 'sort!' is of the wrong type."));
+
+	// The interruptible merge sort works on list cells, so we sort a temporary list of the
+	// items and then copy them back in order when it's done.
+	list = SmileArray_ToList(array);
+
+	if (argc == 1) {
+		// Degenerate form: Sort the items using the 'cmp' method on each item.
+		// For arrays of a single primitive type, we can skip calling 'cmp' entirely.
+		if (SmileList_TryNativeSort(list, &list)) {
+			CopySortedListToArray(array, list);
+			return (SmileArg){ (SmileObject)array };
+		}
+		cmp = NULL;
+	}
+	else {
+		if (argc > 2)
+			Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_Format("'sort!' allows at most 2 arguments, but was called with %d.", argc));
+		if (SMILE_KIND(argv[1].obj) != SMILE_KIND_FUNCTION)
+			Smile_ThrowException(Smile_KnownSymbols.native_method_error, String_Format("Argument 2 to 'sort!' must be a function."));
+		cmp = (SmileFunction)argv[1].obj;
+	}
+
+	closure = Eval_BeginStateMachine(SortStart, SortBody);
+
+	sortInfo = (SortInfo)closure->state;
+	sortInfo->array = array;
+	sortInfo->cmp = cmp;
+	sortInfo->actualSortInfo = InterruptibleListSort_Start(list);
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void SmileArray_Setup(SmileUserObject base)
+{
+	SetupFunction("bool", ToBool, NULL, "array", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("int", ToInt, NULL, "array", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("string", ToString, NULL, "array", ARG_CHECK_MIN | ARG_CHECK_MAX, 1, 2, 0, NULL);
+	SetupFunction("hash", Hash, NULL, "array", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+
+	SetupFunction("of", Of, (void *)base, "items", ARG_CHECK_MIN, 1, 0, 0, NULL);
+	SetupFunction("of-size", OfSize, (void *)base, "count value", 0, 0, 0, 0, NULL);
+	SetupFunction("from-list", FromList, (void *)base, "Array list", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _fromListChecks);
+	SetupFunction("list", ToList, NULL, "array", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _arrayChecks);
+	SetupFunction("lazy", Lazy, NULL, "array", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _arrayChecks);
+	SetupFunction("clone", Clone, NULL, "array", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _arrayChecks);
+
+	SetupFunction("empty?", Empty, NULL, "array", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _arrayChecks);
+	SetupFunction("append!", AppendInPlace, NULL, "array items...", ARG_CHECK_MIN | ARG_CHECK_TYPES, 1, 0, 2, _arrayChecks);
+	SetupFunction("reverse!", ReverseInPlace, NULL, "array", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _arrayChecks);
+
+	SetupFunction("get-member", GetMember, NULL, "array index", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _arrayChecks);
+	SetupFunction("set-member", SetMember, NULL, "array index value", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 3, 3, 3, _arrayChecks);
+
+	SetupFunction("each", Each, NULL, "array fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupFunction("map", Map, NULL, "array fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupSynonym("map", "select");
+	SetupSynonym("map", "project");
+	SetupFunction("where", Where, NULL, "array fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupSynonym("where", "filter");
+	SetupFunction("count", Count, NULL, "array fn", ARG_STATE_MACHINE, 0, 0, 0, NULL);
+
+	SetupFunction("sort!", SortInPlace, NULL, "array fn", ARG_STATE_MACHINE, 0, 0, 0, NULL);
+}
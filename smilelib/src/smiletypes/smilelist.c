@@ -16,11 +16,21 @@
 //---------------------------------------------------------------------------------------
 
 #include <smile/types.h>
+#include <smile/numeric/real32.h>
 #include <smile/numeric/real64.h>
 #include <smile/smiletypes/smileobject.h>
 #include <smile/smiletypes/easyobject.h>
 #include <smile/smiletypes/smilelist.h>
 #include <smile/smiletypes/text/smilesymbol.h>
+#include <smile/smiletypes/smilefunction.h>
+#include <smile/smiletypes/numeric/smilebyte.h>
+#include <smile/smiletypes/numeric/smileinteger16.h>
+#include <smile/smiletypes/numeric/smileinteger32.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/smiletypes/numeric/smilefloat32.h>
+#include <smile/smiletypes/numeric/smilefloat64.h>
+#include <smile/smiletypes/numeric/smilereal32.h>
+#include <smile/smiletypes/numeric/smilereal64.h>
 #include <smile/stringbuilder.h>
 
 SMILE_EASY_OBJECT_VTABLE(SmileList);
@@ -50,7 +60,18 @@ SmileList SmileList_ConsWithSource(SmileObject a, SmileObject d, LexerPosition p
 	smileList->vtable = SmileList_VTable;
 	smileList->a = a;
 	smileList->d = d;
-	smileList->position = position;
+
+	// Pack the position into the cell itself; the caller's position object isn't retained.
+	if (position != NULL) {
+		smileList->fileId = position->fileId > 0 || position->filename == NULL
+			? position->fileId : Lexer_InternFilename(position->filename);
+		smileList->line = position->line;
+		smileList->column = position->column;
+	}
+	else {
+		smileList->fileId = -1;
+	}
+
 	return (SmileList)smileList;
 }
 
@@ -566,11 +587,9 @@ static String SmileList_ToString(SmileList self, SmileUnboxedData unboxedData)
 
 static LexerPosition SmileList_GetSourceLocation(SmileList list)
 {
-	if (list->kind & SMILE_FLAG_WITHSOURCE) {
-		struct SmileListWithSourceInt *listWithSource = (struct SmileListWithSourceInt *)list;
-		return listWithSource->position;
-	}
-	else return NULL;
+	struct LexerPositionStruct position;
+
+	return SmileList_GetSourcePosition(list, &position) != NULL ? LexerPosition_Clone(&position) : NULL;
 }
 
 /// <summary>
@@ -652,6 +671,167 @@ SmileList SmileList_Sort(SmileList list, Int (*cmp)(SmileObject a, SmileObject b
 	}
 }
 
+//-------------------------------------------------------------------------------------------------
+//  Native sorting of homogeneous primitive lists.
+
+// Each of these mirrors the built-in 'compare' method of its type exactly, so that sorting
+// natively produces the same ordering that calling 'cmp' from Smile would have produced.
+
+#define NATIVE_COMPARE(__name__, __smileType__, __type__, __lt__, __gt__) \
+	static Int __name__(SmileObject a, SmileObject b, void *param) \
+	{ \
+		__type__ x = ((__smileType__)a)->value; \
+		__type__ y = ((__smileType__)b)->value; \
+		UNUSED(param); \
+		return (__lt__) ? -1 : (__gt__) ? +1 : 0; \
+	}
+
+NATIVE_COMPARE(NativeCompareByte, SmileByte, Byte, x < y, x > y)
+NATIVE_COMPARE(NativeCompareInteger16, SmileInteger16, Int16, x < y, x > y)
+NATIVE_COMPARE(NativeCompareInteger32, SmileInteger32, Int32, x < y, x > y)
+NATIVE_COMPARE(NativeCompareInteger64, SmileInteger64, Int64, x < y, x > y)
+NATIVE_COMPARE(NativeCompareFloat32, SmileFloat32, Float32, x < y, x > y)
+NATIVE_COMPARE(NativeCompareFloat64, SmileFloat64, Float64, x < y, x > y)
+NATIVE_COMPARE(NativeCompareReal32, SmileReal32, Real32, Real32_Lt(x, y), Real32_Gt(x, y))
+NATIVE_COMPARE(NativeCompareReal64, SmileReal64, Real64, Real64_Lt(x, y), Real64_Gt(x, y))
+
+static Int NativeCompareString(SmileObject a, SmileObject b, void *param)
+{
+	Int cmp = String_Compare((String)a, (String)b);
+	UNUSED(param);
+	return cmp < 0 ? -1 : cmp > 0 ? +1 : 0;
+}
+
+#undef NATIVE_COMPARE
+
+// Below this many items, a radix sort's fixed per-pass overhead isn't worth paying.
+#define RADIX_SORT_THRESHOLD 64
+
+typedef struct RadixSortItemStruct {
+	UInt64 key;
+	SmileList cell;
+} RadixSortItem;
+
+/// <summary>
+/// Sort a list of boxed Integer64s using a stable least-significant-digit radix sort,
+/// one byte at a time.  Any pass where every key has the same byte is skipped, so lists
+/// of small or similar numbers take only a few passes.
+/// </summary>
+static SmileList RadixSortInteger64List(SmileList list, Int length)
+{
+	RadixSortItem *items, *temp, *swap;
+	Int counts[8][256];
+	Int i, pass, offset, count;
+	SmileList cell;
+	UInt64 key;
+
+	items = GC_MALLOC_STRUCT_ARRAY(RadixSortItem, length);
+	temp = GC_MALLOC_STRUCT_ARRAY(RadixSortItem, length);
+	if (items == NULL || temp == NULL)
+		Smile_Abort_OutOfMemory();
+
+	// Copy the keys out, flipping the sign bit so that unsigned order matches signed order,
+	// and count all eight byte-histograms in a single pass.
+	MemZero(counts, sizeof(counts));
+	for (cell = list, i = 0; i < length; cell = (SmileList)cell->d, i++) {
+		key = (UInt64)((SmileInteger64)cell->a)->value ^ ((UInt64)1 << 63);
+		items[i].key = key;
+		items[i].cell = cell;
+		for (pass = 0; pass < 8; pass++)
+			counts[pass][(key >> (pass * 8)) & 0xFF]++;
+	}
+
+	for (pass = 0; pass < 8; pass++) {
+		Int shift = pass * 8;
+
+		// If every key has the same byte here, this pass wouldn't change anything.
+		if (counts[pass][(items[0].key >> shift) & 0xFF] == length)
+			continue;
+
+		for (offset = 0, i = 0; i < 256; i++) {
+			count = counts[pass][i];
+			counts[pass][i] = offset;
+			offset += count;
+		}
+		for (i = 0; i < length; i++)
+			temp[counts[pass][(items[i].key >> shift) & 0xFF]++] = items[i];
+
+		swap = items, items = temp, temp = swap;
+	}
+
+	// Relink the existing cells in their new order.
+	for (i = 0; i < length - 1; i++)
+		items[i].cell->d = (SmileObject)items[i + 1].cell;
+	items[length - 1].cell->d = NullObject;
+
+	return items[0].cell;
+}
+
+/// <summary>
+/// Determine whether the given function is the built-in 'compare' method for a primitive type,
+/// i.e., that the user hasn't replaced 'cmp' with a custom comparison.
+/// </summary>
+static Bool IsBuiltInCompare(SmileObject fn)
+{
+	return SMILE_KIND(fn) == SMILE_KIND_FUNCTION
+		&& SmileFunction_IsBuiltIn((SmileFunction)fn)
+		&& String_EqualsC(((SmileFunction)fn)->u.externalFunctionInfo.name, "compare");
+}
+
+/// <summary>
+/// Try to sort the given list "in place" entirely in C, without calling back into Smile.
+/// This only applies when every item in the list is of the same primitive kind (a boxed
+/// integer, float, real, or a String), and when that kind's 'cmp' method is still the
+/// built-in one.  Integer64 lists are radix-sorted; other kinds use the same stable
+/// merge sort as SmileList_Sort() with a C comparison function.  Either way, the resulting
+/// order is identical to what the interruptible sort would produce by calling 'cmp'.
+/// </summary>
+/// <param name="list">The list to sort.  This must not be circular.</param>
+/// <param name="result">On success, this will be set to the sorted list.</param>
+/// <returns>True if the list was sorted natively; False if it was not touched at all, and
+/// must be sorted by calling its 'cmp' method instead.</returns>
+Bool SmileList_TryNativeSort(SmileList list, SmileList *result)
+{
+	Int (*cmp)(SmileObject a, SmileObject b, void *param);
+	SmileList cell;
+	Int kind, length;
+
+	if (SMILE_KIND(list) != SMILE_KIND_LIST)
+		return False;
+
+	kind = SMILE_KIND(list->a);
+	switch (kind) {
+		case SMILE_KIND_BYTE: cmp = NativeCompareByte; break;
+		case SMILE_KIND_INTEGER16: cmp = NativeCompareInteger16; break;
+		case SMILE_KIND_INTEGER32: cmp = NativeCompareInteger32; break;
+		case SMILE_KIND_INTEGER64: cmp = NativeCompareInteger64; break;
+		case SMILE_KIND_FLOAT32: cmp = NativeCompareFloat32; break;
+		case SMILE_KIND_FLOAT64: cmp = NativeCompareFloat64; break;
+		case SMILE_KIND_REAL32: cmp = NativeCompareReal32; break;
+		case SMILE_KIND_REAL64: cmp = NativeCompareReal64; break;
+		case SMILE_KIND_STRING: cmp = NativeCompareString; break;
+		default: return False;
+	}
+
+	// Every item must be the same kind, and the list must be well-formed.
+	for (cell = list, length = 0; SMILE_KIND(cell) == SMILE_KIND_LIST; cell = (SmileList)cell->d, length++) {
+		if (SMILE_KIND(cell->a) != kind)
+			return False;
+	}
+	if (SMILE_KIND(cell) != SMILE_KIND_NULL)
+		return False;
+
+	if (!IsBuiltInCompare(SMILE_VCALL1(list->a, getProperty, Smile_KnownSymbols.cmp)))
+		return False;
+
+	if (kind == SMILE_KIND_INTEGER64 && length >= RADIX_SORT_THRESHOLD)
+		*result = RadixSortInteger64List(list, length);
+	else
+		*result = SmileList_Sort(list, cmp, NULL);
+
+	return True;
+}
+
 struct InterruptibleListSortInfoStruct {
 	SmileList list, p, q, e, tail;
 	Int stepSize, psize, qsize;
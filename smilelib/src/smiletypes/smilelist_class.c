@@ -18,6 +18,8 @@
 #include <smile/smiletypes/smileobject.h>
 #include <smile/smiletypes/smileuserobject.h>
 #include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/smilearray.h>
+#include <smile/smiletypes/smilesequence.h>
 #include <smile/smiletypes/smilebool.h>
 #include <smile/smiletypes/numeric/smileinteger64.h>
 #include <smile/smiletypes/range/smileinteger64range.h>
@@ -254,6 +256,16 @@ SMILE_EXTERNAL_FUNCTION(Clone)
 	return SmileArg_From((SmileObject)clone);
 }
 
+SMILE_EXTERNAL_FUNCTION(Lazy)
+{
+	return SmileArg_From((SmileObject)SmileSequence_Create(argv[0].obj));
+}
+
+SMILE_EXTERNAL_FUNCTION(ToArray)
+{
+	return SmileArg_From((SmileObject)SmileArray_CreateFromList((SmileObject)Smile_KnownBases.Array, (SmileList)argv[0].obj));
+}
+
 SMILE_EXTERNAL_FUNCTION(Reverse)
 {
 	SmileList source = (SmileList)argv[0].obj, clone;
@@ -1174,6 +1186,9 @@ SMILE_EXTERNAL_FUNCTION(SortInPlace)
 
 	if (argc == 1) {
 		// Degenerate form: Sort the list nodes using the 'cmp' method on each node.
+		// For homogeneous lists of primitives, we can skip calling 'cmp' entirely.
+		if (SmileList_TryNativeSort(list, &list))
+			return (SmileArg) { (SmileObject)list };
 		cmp = NULL;
 	}
 	else {
@@ -1223,6 +1238,10 @@ SMILE_EXTERNAL_FUNCTION(Sort)
 	if (list == NULL)
 		Smile_ThrowException(Smile_KnownSymbols.native_method_error, cycleError);
 
+	// For homogeneous lists of primitives, we can skip calling 'cmp' entirely.
+	if (cmp == NULL && SmileList_TryNativeSort(list, &list))
+		return (SmileArg) { (SmileObject)list };
+
 	closure = Eval_BeginStateMachine(SortStart, SortBody);
 
 	sortInfo = (SortInfo)closure->state;
@@ -1596,6 +1615,8 @@ void SmileList_Setup(SmileUserObject base)
 	SetupFunction("cons", Cons, (void *)base, "a b", ARG_CHECK_MIN | ARG_CHECK_MAX, 2, 3, 0, NULL);
 	SetupFunction("combine", Combine, (void *)base, "lists...", ARG_CHECK_MIN, 2, 0, 2, _combineChecks);
 	SetupFunction("clone", Clone, NULL, "list", ARG_CHECK_EXACT, 1, 1, 1, _listChecks);
+	SetupFunction("array", ToArray, NULL, "list", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _listChecks);
+	SetupFunction("lazy", Lazy, NULL, "list", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _listChecks);
 	SetupFunction("reverse", Reverse, NULL, "list", ARG_CHECK_EXACT, 1, 1, 1, _listChecks);
 	SetupFunction("reverse!", ReverseInPlace, NULL, "list", ARG_CHECK_EXACT, 1, 1, 1, _listChecks);
 
@@ -0,0 +1,520 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/bittwiddling.h>
+#include <smile/crypto/dicthash.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/easyobject.h>
+#include <smile/smiletypes/smilemap.h>
+#include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/text/smilesymbol.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/stringbuilder.h>
+
+SMILE_EASY_OBJECT_VTABLE(SmileMap);
+
+SMILE_EASY_OBJECT_READONLY_SECURITY(SmileMap);
+SMILE_EASY_OBJECT_NO_CALL(SmileMap, "A Map");
+SMILE_EASY_OBJECT_NO_SOURCE(SmileMap);
+SMILE_EASY_OBJECT_NO_UNBOX(SmileMap)
+
+/// <summary>
+/// Spread the bits of a 64-bit integer across a 32-bit hash code (Fibonacci hashing).
+/// Integer and symbol keys are often small and dense, so we can't just use their low bits.
+/// </summary>
+Inline UInt32 HashInteger64(UInt64 x)
+{
+	x *= 0x9E3779B97F4A7C15ULL;
+	return (UInt32)(x >> 32) ^ (UInt32)x;
+}
+
+/// <summary>
+/// Compute the hash code of a (normalized) key.  Integer64, Symbol, and String keys are
+/// hashed directly; everything else uses its 'hash' virtual method.
+/// </summary>
+static UInt32 HashKey(SmileArg key)
+{
+	switch (SMILE_KIND(key.obj)) {
+		case SMILE_KIND_UNBOXED_INTEGER64:
+			return HashInteger64((UInt64)key.unboxed.i64);
+		case SMILE_KIND_UNBOXED_SYMBOL:
+			return HashInteger64((UInt64)key.unboxed.symbol);
+		case SMILE_KIND_STRING:
+			return String_Hash((String)key.obj);
+		default:
+			if (SMILE_KIND(key.obj) < 0x10) {
+				// Other unboxed values must be boxed to find their hash codes.
+				SmileObject boxed = SmileArg_Box(key);
+				return SMILE_VCALL(boxed, hash);
+			}
+			return SMILE_VCALL(key.obj, hash);
+	}
+}
+
+/// <summary>
+/// Unbox any boxed primitive key, so that (for example) a boxed Integer64 and an unboxed
+/// Integer64 with the same value both find the same node.
+/// </summary>
+Inline SmileArg NormalizeKey(SmileArg key)
+{
+	return (SMILE_KIND(key.obj) & ~0xF) == 0x10 ? SmileArg_Unbox(key.obj) : key;
+}
+
+/// <summary>
+/// Find the node for the given (normalized) key, or return -1 if there is no such node.
+/// Each of the fast key kinds gets its own search loop, so that the common cases never
+/// make any virtual calls.
+/// </summary>
+static Int32 FindNode(SmileMap map, SmileArg key, UInt32 hash)
+{
+	struct SmileMapNode *heap = map->heap, *node;
+	Int32 nodeIndex = map->buckets[hash & map->mask];
+	Int keyKind = SMILE_KIND(key.obj);
+
+	switch (keyKind) {
+		case SMILE_KIND_UNBOXED_INTEGER64:
+			for (; nodeIndex >= 0; nodeIndex = node->next) {
+				node = heap + nodeIndex;
+				if (node->hash == hash && SMILE_KIND(node->key.obj) == SMILE_KIND_UNBOXED_INTEGER64
+					&& node->key.unboxed.i64 == key.unboxed.i64)
+					return nodeIndex;
+			}
+			return -1;
+
+		case SMILE_KIND_UNBOXED_SYMBOL:
+			for (; nodeIndex >= 0; nodeIndex = node->next) {
+				node = heap + nodeIndex;
+				if (node->hash == hash && SMILE_KIND(node->key.obj) == SMILE_KIND_UNBOXED_SYMBOL
+					&& node->key.unboxed.symbol == key.unboxed.symbol)
+					return nodeIndex;
+			}
+			return -1;
+
+		case SMILE_KIND_STRING:
+			for (; nodeIndex >= 0; nodeIndex = node->next) {
+				node = heap + nodeIndex;
+				if (node->hash == hash && SMILE_KIND(node->key.obj) == SMILE_KIND_STRING
+					&& String_Equals((String)node->key.obj, (String)key.obj))
+					return nodeIndex;
+			}
+			return -1;
+
+		default:
+			for (; nodeIndex >= 0; nodeIndex = node->next) {
+				node = heap + nodeIndex;
+				if (node->hash == hash && SMILE_KIND(node->key.obj) == keyKind
+					&& SMILE_VCALL3(key.obj, compareEqual, key.unboxed, node->key.obj, node->key.unboxed))
+					return nodeIndex;
+			}
+			return -1;
+	}
+}
+
+/// <summary>
+/// Make sure the key is of the kind this Map requires, if it requires one.
+/// </summary>
+static void CheckKeyKind(SmileMap map, SmileArg key)
+{
+	if (map->keyKind && SMILE_KIND(key.obj) != map->keyKind) {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+			String_Format("Cannot use a key of type %S in a Map that only accepts keys of type %S.",
+				SmileKind_GetName(SMILE_KIND(key.obj)), SmileKind_GetName(map->keyKind)));
+	}
+}
+
+/// <summary>
+/// Allocate a fresh, empty buckets array and heap for the map.
+/// </summary>
+static void SmileMapInt_Clear(SmileMap map, Int32 newSize)
+{
+	struct SmileMapNode *heap;
+	Int32 *buckets;
+	Int32 i;
+
+	if (newSize < 0x10) newSize = 0x10;
+	if (newSize > 0x1000000) newSize = 0x1000000;
+
+	newSize = NextPowerOfTwo32(newSize);
+
+	map->buckets = buckets = GC_MALLOC_RAW_ARRAY(Int32, newSize);
+	if (buckets == NULL) Smile_Abort_OutOfMemory();
+	map->heap = heap = GC_MALLOC_STRUCT_ARRAY(struct SmileMapNode, newSize);
+	if (heap == NULL) Smile_Abort_OutOfMemory();
+	map->firstFree = 0;
+	map->count = 0;
+	map->mask = newSize - 1;
+
+	for (i = 0; i < newSize; i++) {
+		buckets[i] = -1;
+	}
+
+	for (i = 0; i < newSize - 1; i++) {
+		heap[i].next = i + 1;
+	}
+	heap[i].next = -1;
+}
+
+/// <summary>
+/// Resize the map to the given number of buckets, rehashing every node using its cached hash.
+/// </summary>
+static void SmileMapInt_Resize(SmileMap map, Int32 newSize)
+{
+	struct SmileMapNode *oldHeap, *node, *newNode;
+	Int32 *newBuckets;
+	Int32 oldSize, newMask, newIndex, i;
+
+	oldHeap = map->heap;
+	oldSize = map->mask + 1;
+
+	SmileMapInt_Clear(map, newSize);
+
+	newBuckets = map->buckets;
+	newMask = map->mask;
+
+	for (i = 0; i < oldSize; i++) {
+		node = oldHeap + i;
+		if (node->key.obj == NULL) continue;
+
+		newIndex = map->firstFree;
+		newNode = map->heap + newIndex;
+		map->firstFree = newNode->next;
+
+		newNode->hash = node->hash;
+		newNode->key = node->key;
+		newNode->value = node->value;
+		newNode->next = newBuckets[node->hash & newMask];
+		newBuckets[node->hash & newMask] = newIndex;
+		map->count++;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Create a new, empty Map.
+/// </summary>
+/// <param name="base">The base type this Map inherits from.</param>
+/// <param name="keyKind">If nonzero, the only kind of key this Map will accept.</param>
+/// <returns>The new, empty Map.</returns>
+SmileMap SmileMap_Create(SmileObject base, Int keyKind)
+{
+	return SmileMap_CreateWithSize(base, keyKind, 16);
+}
+
+/// <summary>
+/// Create a new, empty Map with room for at least the given number of pairs before it grows.
+/// </summary>
+/// <param name="base">The base type this Map inherits from.</param>
+/// <param name="keyKind">If nonzero, the only kind of key this Map will accept.</param>
+/// <param name="newSize">How many key/value pairs to preallocate space for.</param>
+/// <returns>The new, empty Map.</returns>
+SmileMap SmileMap_CreateWithSize(SmileObject base, Int keyKind, Int32 newSize)
+{
+	SmileMap map;
+
+	map = GC_MALLOC_STRUCT(struct SmileMapInt);
+	if (map == NULL) Smile_Abort_OutOfMemory();
+
+	map->base = base;
+	map->kind = SMILE_KIND_MAP | SMILE_SECURITY_WRITABLE;
+	map->vtable = SmileMap_VTable;
+	map->keyKind = (Int32)keyKind;
+
+	SmileMapInt_Clear(map, newSize);
+
+	return map;
+}
+
+/// <summary>
+/// Make a shallow copy of the given Map.  The copy has the same base and key restrictions.
+/// </summary>
+SmileMap SmileMap_Clone(SmileMap map)
+{
+	SmileMap newMap;
+	Int32 size = map->mask + 1;
+
+	newMap = GC_MALLOC_STRUCT(struct SmileMapInt);
+	if (newMap == NULL) Smile_Abort_OutOfMemory();
+
+	newMap->base = map->base;
+	newMap->kind = map->kind;
+	newMap->vtable = map->vtable;
+	newMap->keyKind = map->keyKind;
+	newMap->mask = map->mask;
+	newMap->firstFree = map->firstFree;
+	newMap->count = map->count;
+
+	newMap->buckets = GC_MALLOC_RAW_ARRAY(Int32, size);
+	if (newMap->buckets == NULL) Smile_Abort_OutOfMemory();
+	newMap->heap = GC_MALLOC_STRUCT_ARRAY(struct SmileMapNode, size);
+	if (newMap->heap == NULL) Smile_Abort_OutOfMemory();
+
+	MemCpy(newMap->buckets, map->buckets, sizeof(Int32) * size);
+	MemCpy(newMap->heap, map->heap, sizeof(struct SmileMapNode) * size);
+
+	return newMap;
+}
+
+/// <summary>
+/// Look up the value for the given key.
+/// </summary>
+/// <param name="map">The map to search.</param>
+/// <param name="key">The key to search for.</param>
+/// <param name="value">If the key is found, this is set to its value.</param>
+/// <returns>True if the key was found, False if it was not.</returns>
+Bool SmileMap_TryGetValue(SmileMap map, SmileArg key, SmileArg *value)
+{
+	Int32 nodeIndex;
+
+	key = NormalizeKey(key);
+	nodeIndex = FindNode(map, key, HashKey(key));
+	if (nodeIndex < 0) return False;
+
+	*value = map->heap[nodeIndex].value;
+	return True;
+}
+
+/// <summary>
+/// Add or replace the value for the given key.
+/// </summary>
+/// <param name="map">The map to update.</param>
+/// <param name="key">The key to add or replace.</param>
+/// <param name="value">The new value for that key.</param>
+void SmileMap_SetValue(SmileMap map, SmileArg key, SmileArg value)
+{
+	struct SmileMapNode *node;
+	Int32 nodeIndex;
+	UInt32 hash;
+
+	key = NormalizeKey(key);
+	CheckKeyKind(map, key);
+
+	hash = HashKey(key);
+	nodeIndex = FindNode(map, key, hash);
+	if (nodeIndex >= 0) {
+		map->heap[nodeIndex].value = value;
+		return;
+	}
+
+	if (map->firstFree < 0) {
+		SmileMapInt_Resize(map, (map->mask + 1) * 2);
+	}
+
+	nodeIndex = map->firstFree;
+	node = map->heap + nodeIndex;
+	map->firstFree = node->next;
+
+	node->hash = hash;
+	node->key = key;
+	node->value = value;
+	node->next = map->buckets[hash & map->mask];
+	map->buckets[hash & map->mask] = nodeIndex;
+
+	map->count++;
+}
+
+/// <summary>
+/// Remove the given key (and its value) from the map.
+/// </summary>
+/// <param name="map">The map to update.</param>
+/// <param name="key">The key to remove.</param>
+/// <returns>True if the key was found and removed, False if it did not exist.</returns>
+Bool SmileMap_Remove(SmileMap map, SmileArg key)
+{
+	struct SmileMapNode *heap = map->heap;
+	Int32 nodeIndex, prevIndex, mask = map->mask;
+	UInt32 hash;
+
+	key = NormalizeKey(key);
+	hash = HashKey(key);
+
+	nodeIndex = FindNode(map, key, hash);
+	if (nodeIndex < 0) return False;
+
+	// Find the predecessor of the node in its bucket's chain, and unlink it.
+	prevIndex = map->buckets[hash & mask];
+	if (prevIndex == nodeIndex)
+		map->buckets[hash & mask] = heap[nodeIndex].next;
+	else {
+		while (heap[prevIndex].next != nodeIndex)
+			prevIndex = heap[prevIndex].next;
+		heap[prevIndex].next = heap[nodeIndex].next;
+	}
+
+	heap[nodeIndex].key.obj = NULL;
+	heap[nodeIndex].key.unboxed.i64 = 0;
+	heap[nodeIndex].value.obj = NULL;
+	heap[nodeIndex].value.unboxed.i64 = 0;
+	heap[nodeIndex].next = map->firstFree;
+
+	map->firstFree = nodeIndex;
+	map->count--;
+
+	if (map->count <= ((mask + 1) >> 2) && (mask + 1) > 16) {
+		SmileMapInt_Resize(map, (mask + 1) >> 1);
+	}
+
+	return True;
+}
+
+/// <summary>
+/// Get a List of all of the keys in the map, boxed as necessary, in no particular order.
+/// </summary>
+SmileList SmileMap_GetKeys(SmileMap map)
+{
+	struct SmileMapNode *node, *end;
+	SmileList head, tail;
+
+	LIST_INIT(head, tail);
+
+	for (node = map->heap, end = node + map->mask + 1; node < end; node++) {
+		if (node->key.obj == NULL) continue;
+		LIST_APPEND(head, tail, SmileArg_Box(node->key));
+	}
+
+	return head;
+}
+
+/// <summary>
+/// Get a List of all of the values in the map, boxed as necessary, in the same order as
+/// SmileMap_GetKeys() returns the keys.
+/// </summary>
+SmileList SmileMap_GetValues(SmileMap map)
+{
+	struct SmileMapNode *node, *end;
+	SmileList head, tail;
+
+	LIST_INIT(head, tail);
+
+	for (node = map->heap, end = node + map->mask + 1; node < end; node++) {
+		if (node->key.obj == NULL) continue;
+		LIST_APPEND(head, tail, SmileArg_Box(node->value));
+	}
+
+	return head;
+}
+
+//-------------------------------------------------------------------------------------------------
+
+static Bool SmileMap_CompareEqual(SmileMap self, SmileUnboxedData selfData, SmileObject other, SmileUnboxedData otherData)
+{
+	UNUSED(selfData);
+	UNUSED(otherData);
+
+	return (SmileObject)self == other;
+}
+
+static Bool SmileMap_DeepEqual(SmileMap self, SmileUnboxedData selfData, SmileObject other, SmileUnboxedData otherData, PointerSet visitedPointers)
+{
+	SmileMap otherMap;
+	struct SmileMapNode *node, *end;
+	SmileArg otherValue;
+
+	UNUSED(selfData);
+	UNUSED(otherData);
+
+	if (SMILE_KIND(other) != SMILE_KIND_MAP) return False;
+	otherMap = (SmileMap)other;
+
+	if (self->count != otherMap->count) return False;
+
+	for (node = self->heap, end = node + self->mask + 1; node < end; node++) {
+		if (node->key.obj == NULL) continue;
+		if (!SmileMap_TryGetValue(otherMap, node->key, &otherValue))
+			return False;
+		if (SMILE_KIND(node->value.obj) >= 0x10 && !PointerSet_Add(visitedPointers, node->value.obj))
+			continue;
+		if (!SMILE_VCALL4(node->value.obj, deepEqual, node->value.unboxed, otherValue.obj, otherValue.unboxed, visitedPointers))
+			return False;
+	}
+
+	return True;
+}
+
+static UInt32 SmileMap_Hash(SmileMap self)
+{
+	return Smile_ApplyHashOracle((PtrInt)self);
+}
+
+static SmileObject SmileMap_GetProperty(SmileMap self, Symbol propertyName)
+{
+	if (propertyName == Smile_KnownSymbols.length)
+		return (SmileObject)SmileInteger64_Create(self->count);
+	return self->base->vtable->getProperty(self->base, propertyName);
+}
+
+static void SmileMap_SetProperty(SmileMap self, Symbol propertyName, SmileObject value)
+{
+	UNUSED(self);
+	UNUSED(value);
+
+	Smile_ThrowException(Smile_KnownSymbols.object_security_error,
+		String_Format("Cannot set property \"%S\" on a Map.",
+			SymbolTable_GetName(Smile_SymbolTable, propertyName)));
+}
+
+static Bool SmileMap_HasProperty(SmileMap self, Symbol propertyName)
+{
+	UNUSED(self);
+	return (propertyName == Smile_KnownSymbols.length);
+}
+
+static SmileList SmileMap_GetPropertyNames(SmileMap self)
+{
+	SmileList head, tail;
+
+	UNUSED(self);
+
+	LIST_INIT(head, tail);
+	LIST_APPEND(head, tail, SmileSymbol_Create(Smile_KnownSymbols.length));
+
+	return head;
+}
+
+static Bool SmileMap_ToBool(SmileMap self, SmileUnboxedData unboxedData)
+{
+	UNUSED(self);
+	UNUSED(unboxedData);
+	return True;
+}
+
+static String SmileMap_ToString(SmileMap self, SmileUnboxedData unboxedData)
+{
+	struct SmileMapNode *node, *end;
+	Bool first = True;
+	DECLARE_INLINE_STRINGBUILDER(stringBuilder, 256);
+
+	UNUSED(unboxedData);
+
+	INIT_INLINE_STRINGBUILDER(stringBuilder);
+	StringBuilder_AppendByte(stringBuilder, '{');
+
+	for (node = self->heap, end = node + self->mask + 1; node < end; node++) {
+		if (node->key.obj == NULL) continue;
+		if (!first)
+			StringBuilder_AppendByte(stringBuilder, ' ');
+		first = False;
+		StringBuilder_AppendString(stringBuilder, SMILE_VCALL1(node->key.obj, toString, node->key.unboxed));
+		StringBuilder_AppendByte(stringBuilder, ':');
+		StringBuilder_AppendString(stringBuilder, SMILE_VCALL1(node->value.obj, toString, node->value.unboxed));
+	}
+
+	StringBuilder_AppendByte(stringBuilder, '}');
+
+	return StringBuilder_ToString(stringBuilder);
+}
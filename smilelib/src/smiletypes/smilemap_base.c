@@ -0,0 +1,377 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/eval/eval.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/smileuserobject.h>
+#include <smile/smiletypes/smilemap.h>
+#include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/smilebool.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/smiletypes/smilefunction.h>
+#include <smile/smiletypes/base.h>
+#include <smile/internal/staticstring.h>
+
+SMILE_IGNORE_UNUSED_VARIABLES
+
+static Byte _mapChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_MAP,
+	0, 0,
+	0, 0,
+};
+
+static Byte _eachChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_MAP,
+	SMILE_KIND_MASK, SMILE_KIND_FUNCTION,
+};
+
+/// <summary>
+/// Determine which kind of key a Map derived from the given base should be restricted to,
+/// by walking up its base chain to the nearest of the known map types.
+/// </summary>
+static Int GetKeyKindForBase(SmileObject base)
+{
+	for (; base != NULL && SMILE_KIND(base) == SMILE_KIND_USEROBJECT; base = base->base) {
+		if (base == (SmileObject)Smile_KnownBases.StringMap) return SMILE_KIND_STRING;
+		if (base == (SmileObject)Smile_KnownBases.SymbolMap) return SMILE_KIND_UNBOXED_SYMBOL;
+		if (base == (SmileObject)Smile_KnownBases.Integer64Map) return SMILE_KIND_UNBOXED_INTEGER64;
+		if (base == (SmileObject)Smile_KnownBases.MapBase) return 0;
+	}
+	return 0;
+}
+
+/// <summary>
+/// Find the next in-use node in the map's heap, starting at the given index.
+/// </summary>
+/// <returns>The index of the next in-use node, or -1 if there are no more.</returns>
+Inline Int32 NextNode(SmileMap map, Int32 index)
+{
+	for (; index <= map->mask; index++) {
+		if (map->heap[index].key.obj != NULL)
+			return index;
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Generic type conversion
+
+SMILE_EXTERNAL_FUNCTION(ToBool)
+{
+	return SmileUnboxedBool_From(True);
+}
+
+SMILE_EXTERNAL_FUNCTION(ToInt)
+{
+	if (SMILE_KIND(argv[0].obj) == SMILE_KIND_MAP)
+		return SmileUnboxedInteger64_From(((SmileMap)argv[0].obj)->count);
+
+	return SmileUnboxedInteger64_From(0);
+}
+
+SMILE_EXTERNAL_FUNCTION(ToString)
+{
+	STATIC_STRING(map, "Map");
+
+	if (SMILE_KIND(argv[0].obj) == SMILE_KIND_MAP)
+		return SmileArg_From((SmileObject)SMILE_VCALL1(argv[0].obj, toString, argv[0].unboxed));
+
+	return SmileArg_From((SmileObject)map);
+}
+
+SMILE_EXTERNAL_FUNCTION(Hash)
+{
+	return SmileUnboxedInteger64_From(Smile_ApplyHashOracle((PtrInt)argv[0].obj));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Construction and conversion
+
+SMILE_EXTERNAL_FUNCTION(Of)
+{
+	STATIC_STRING(oddArgumentsError, "Map.of requires an even number of arguments, alternating keys and values.");
+
+	SmileObject base = (SmileObject)param;
+	SmileMap map;
+	Int i;
+
+	i = 0;
+	if (argv[i].obj == base)
+		i++;
+
+	if ((argc - i) & 1)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, oddArgumentsError);
+
+	map = SmileMap_CreateWithSize(base, GetKeyKindForBase(base), (Int32)((argc - i) / 2));
+
+	for (; i < argc; i += 2) {
+		SmileMap_SetValue(map, argv[i], argv[i + 1]);
+	}
+
+	return SmileArg_From((SmileObject)map);
+}
+
+SMILE_EXTERNAL_FUNCTION(Clone)
+{
+	return SmileArg_From((SmileObject)SmileMap_Clone((SmileMap)argv[0].obj));
+}
+
+SMILE_EXTERNAL_FUNCTION(Keys)
+{
+	return SmileArg_From((SmileObject)SmileMap_GetKeys((SmileMap)argv[0].obj));
+}
+
+SMILE_EXTERNAL_FUNCTION(Values)
+{
+	return SmileArg_From((SmileObject)SmileMap_GetValues((SmileMap)argv[0].obj));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Lookup and update
+
+SMILE_EXTERNAL_FUNCTION(Empty)
+{
+	return SmileUnboxedBool_From(((SmileMap)argv[0].obj)->count == 0);
+}
+
+SMILE_EXTERNAL_FUNCTION(Count)
+{
+	return SmileUnboxedInteger64_From(((SmileMap)argv[0].obj)->count);
+}
+
+SMILE_EXTERNAL_FUNCTION(GetMember)
+{
+	SmileArg value;
+
+	if (!SmileMap_TryGetValue((SmileMap)argv[0].obj, argv[1], &value))
+		return SmileArg_From(NullObject);
+
+	return value;
+}
+
+SMILE_EXTERNAL_FUNCTION(SetMember)
+{
+	SmileMap_SetValue((SmileMap)argv[0].obj, argv[1], argv[2]);
+	return argv[2];
+}
+
+SMILE_EXTERNAL_FUNCTION(ContainsKey)
+{
+	return SmileUnboxedBool_From(SmileMap_ContainsKey((SmileMap)argv[0].obj, argv[1]));
+}
+
+SMILE_EXTERNAL_FUNCTION(RemoveInPlace)
+{
+	return SmileUnboxedBool_From(SmileMap_Remove((SmileMap)argv[0].obj, argv[1]));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct EachInfoStruct {
+	SmileMap map;
+	SmileFunction function;
+	Int32 index;
+	Bool withKey;
+} *EachInfo;
+
+static Int EachBody(ClosureStateMachine closure)
+{
+	EachInfo eachInfo = (EachInfo)closure->state;
+	struct SmileMapNode *node;
+
+	// Find the next pair; if we've run out of pairs, we're done.
+	eachInfo->index = NextNode(eachInfo->map, eachInfo->index);
+	if (eachInfo->index < 0) {
+		Closure_Pop(closure);
+		Closure_PushBoxed(closure, eachInfo->map);	// Pop the previous return value and push 'map'.
+		return -1;
+	}
+
+	// Set up to call the user's function with the next value (and its key).
+	node = eachInfo->map->heap + eachInfo->index;
+	Closure_Pop(closure);
+	Closure_PushBoxed(closure, eachInfo->function);
+	Closure_Push(closure, node->value);
+
+	eachInfo->index++;	// Move the iterator past this pair.
+
+	if (!eachInfo->withKey) return 1;
+	Closure_Push(closure, node->key);
+	return 2;
+}
+
+SMILE_EXTERNAL_FUNCTION(Each)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileMap map = (SmileMap)argv[0].obj;
+	SmileFunction function = (SmileFunction)argv[1].obj;
+	Int minArgs, maxArgs;
+	EachInfo eachInfo;
+	ClosureStateMachine closure;
+
+	SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+
+	closure = Eval_BeginStateMachine(EachBody, EachBody);
+
+	eachInfo = (EachInfo)closure->state;
+	eachInfo->function = function;
+	eachInfo->map = map;
+	eachInfo->index = 0;
+	eachInfo->withKey = (maxArgs > 1);
+
+	Closure_PushBoxed(closure, NullObject);	// Initial "return" value from 'each'.
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+typedef struct MapInfoStruct {
+	SmileMap map;
+	SmileMap result;
+	SmileFunction function;
+	SmileArg key, value;	// The pair most recently passed to the user's function.
+	Int32 index;
+	Bool withKey;
+} *MapInfo;
+
+/// <summary>
+/// Find the next pair, and set up to call the user's function with it, or push the result
+/// Map if there are no more pairs.  This is shared by 'map' and 'where'.
+/// </summary>
+static Int PushNextPair(ClosureStateMachine closure, MapInfo loopInfo)
+{
+	struct SmileMapNode *node;
+
+	// Condition: If we've run out of pairs, we're done.
+	loopInfo->index = NextNode(loopInfo->map, loopInfo->index);
+	if (loopInfo->index < 0) {
+		Closure_PushBoxed(closure, loopInfo->result);
+		return -1;
+	}
+
+	// Body: Set up to call the user's function with the next value (and its key).
+	node = loopInfo->map->heap + loopInfo->index;
+	loopInfo->key = node->key;
+	loopInfo->value = node->value;
+	Closure_PushBoxed(closure, loopInfo->function);
+	Closure_Push(closure, node->value);
+	if (!loopInfo->withKey) return 1;
+	Closure_Push(closure, node->key);
+	return 2;
+}
+
+static Int MapStart(ClosureStateMachine closure)
+{
+	return PushNextPair(closure, (MapInfo)closure->state);
+}
+
+static Int MapBody(ClosureStateMachine closure)
+{
+	register MapInfo loopInfo = (MapInfo)closure->state;
+
+	// Body: Store the user function's most recent result under the same key in the output map.
+	SmileMap_SetValue(loopInfo->result, loopInfo->key, Closure_Pop(closure));
+
+	// Next: Move the iterator past this pair.
+	loopInfo->index++;
+
+	return PushNextPair(closure, loopInfo);
+}
+
+static Int WhereBody(ClosureStateMachine closure)
+{
+	register MapInfo loopInfo = (MapInfo)closure->state;
+
+	// Body: Get the value from the user's condition.
+	SmileArg fnResult = Closure_Pop(closure);
+	Bool booleanResult = SMILE_VCALL1(fnResult.obj, toBool, fnResult.unboxed);
+
+	// If it's truthy, keep this pair.
+	if (booleanResult) {
+		SmileMap_SetValue(loopInfo->result, loopInfo->key, loopInfo->value);
+	}
+
+	// Next: Move the iterator past this pair.
+	loopInfo->index++;
+
+	return PushNextPair(closure, loopInfo);
+}
+
+static void BeginMapOrWhere(StateMachine start, StateMachine body, SmileMap map, SmileFunction function, Int32 resultSize)
+{
+	Int minArgs, maxArgs;
+	MapInfo mapInfo;
+	ClosureStateMachine closure;
+
+	SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+
+	closure = Eval_BeginStateMachine(start, body);
+
+	mapInfo = (MapInfo)closure->state;
+	mapInfo->map = map;
+	mapInfo->result = SmileMap_CreateWithSize(map->base, map->keyKind, resultSize);
+	mapInfo->function = function;
+	mapInfo->index = 0;
+	mapInfo->withKey = (maxArgs > 1);
+}
+
+SMILE_EXTERNAL_FUNCTION(Map)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileMap map = (SmileMap)argv[0].obj;
+	BeginMapOrWhere(MapStart, MapBody, map, (SmileFunction)argv[1].obj, map->count);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(Where)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileMap map = (SmileMap)argv[0].obj;
+	BeginMapOrWhere(MapStart, WhereBody, map, (SmileFunction)argv[1].obj, 0);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void SmileMap_Setup(SmileUserObject base)
+{
+	SetupFunction("bool", ToBool, NULL, "map", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("int", ToInt, NULL, "map", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("string", ToString, NULL, "map", ARG_CHECK_MIN | ARG_CHECK_MAX, 1, 2, 0, NULL);
+	SetupFunction("hash", Hash, NULL, "map", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+
+	SetupFunction("of", Of, (void *)base, "pairs", ARG_CHECK_MIN, 1, 0, 0, NULL);
+	SetupFunction("clone", Clone, NULL, "map", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _mapChecks);
+	SetupFunction("keys", Keys, NULL, "map", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _mapChecks);
+	SetupFunction("values", Values, NULL, "map", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _mapChecks);
+
+	SetupFunction("empty?", Empty, NULL, "map", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _mapChecks);
+	SetupFunction("count", Count, NULL, "map", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _mapChecks);
+	SetupFunction("get-member", GetMember, NULL, "map key", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _mapChecks);
+	SetupFunction("set-member", SetMember, NULL, "map key value", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 3, 3, 3, _mapChecks);
+	SetupFunction("contains?", ContainsKey, NULL, "map key", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _mapChecks);
+	SetupSynonym("contains?", "contains-key?");
+	SetupFunction("remove!", RemoveInPlace, NULL, "map key", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _mapChecks);
+
+	SetupFunction("each", Each, NULL, "map fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupFunction("map", Map, NULL, "map fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupSynonym("map", "select");
+	SetupSynonym("map", "project");
+	SetupFunction("where", Where, NULL, "map fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupSynonym("where", "filter");
+}
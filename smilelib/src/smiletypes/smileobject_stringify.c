@@ -39,6 +39,9 @@
 #include <smile/smiletypes/text/smilechar.h>
 #include <smile/smiletypes/text/smileuni.h>
 #include <smile/smiletypes/raw/smilebytearray.h>
+#include <smile/smiletypes/smilearray.h>
+#include <smile/smiletypes/smilemap.h>
+#include <smile/smiletypes/smilesequence.h>
 #include <smile/smiletypes/smilehandle.h>
 #include <smile/internal/staticstring.h>
 #include <smile/numeric/float64.h>
@@ -146,6 +149,7 @@ static void StringifyBadlyFormedList(SmileList list, StringBuilder stringBuilder
 static void StringifyRecursive(SmileObject obj, StringBuilder stringBuilder, Int indent, Bool includeSource)
 {
 	SmileList list;
+	struct LexerPositionStruct position;
 	STATIC_STRING(nullName, "<NULL>");
 
 	if (obj == NULL) {
@@ -176,30 +180,26 @@ static void StringifyRecursive(SmileObject obj, StringBuilder stringBuilder, Int
 					list = LIST_REST(list);
 					isFirst = False;
 				}
-				if (includeSource && (list->kind & SMILE_FLAG_WITHSOURCE)) {
-					String filename = ((struct SmileListWithSourceInt *)list)->position->filename;
-					if (filename != NULL) {
+				if (includeSource && SmileList_GetSourcePosition(list, &position) != NULL) {
+					if (position.filename != NULL) {
 						StringBuilder_AppendFormat(stringBuilder, "\t// %S:%d",
-							Path_GetFilename(filename), ((struct SmileListWithSourceInt *)list)->position->line);
+							Path_GetFilename(position.filename), position.line);
 					}
 					else {
-						StringBuilder_AppendFormat(stringBuilder, "\t// line %d",
-							((struct SmileListWithSourceInt *)list)->position->line);
+						StringBuilder_AppendFormat(stringBuilder, "\t// line %d", position.line);
 					}
 				}
 				StringBuilder_AppendByte(stringBuilder, '\n');
 				while (SMILE_KIND(list) == SMILE_KIND_LIST) {
 					StringBuilder_AppendRepeat(stringBuilder, ' ', (indent + 1) * 4);
 					StringifyRecursive((SmileObject)list->a, stringBuilder, indent + 1, includeSource);
-					if (includeSource && (list->kind & SMILE_FLAG_WITHSOURCE)) {
-						String filename = ((struct SmileListWithSourceInt *)list)->position->filename;
-						if (filename != NULL) {
+					if (includeSource && SmileList_GetSourcePosition(list, &position) != NULL) {
+						if (position.filename != NULL) {
 							StringBuilder_AppendFormat(stringBuilder, "\t// %S:%d",
-								Path_GetFilename(filename), ((struct SmileListWithSourceInt *)list)->position->line);
+								Path_GetFilename(position.filename), position.line);
 						}
 						else {
-							StringBuilder_AppendFormat(stringBuilder, "\t// line %d",
-								((struct SmileListWithSourceInt *)list)->position->line);
+							StringBuilder_AppendFormat(stringBuilder, "\t// line %d", position.line);
 						}
 					}
 					StringBuilder_AppendByte(stringBuilder, '\n');
@@ -291,6 +291,18 @@ static void StringifyRecursive(SmileObject obj, StringBuilder stringBuilder, Int
 		StringBuilder_AppendFormat(stringBuilder, "(ByteArray of %ld)", (Int64)((SmileByteArray)obj)->length);
 		return;
 
+	case SMILE_KIND_ARRAY:
+		StringBuilder_AppendFormat(stringBuilder, "(Array of %ld)", (Int64)((SmileArray)obj)->length);
+		return;
+
+	case SMILE_KIND_MAP:
+		StringBuilder_AppendFormat(stringBuilder, "(Map of %ld)", (Int64)((SmileMap)obj)->count);
+		return;
+
+	case SMILE_KIND_SEQUENCE:
+		StringBuilder_AppendFormat(stringBuilder, "(Sequence of %ld stages)", (Int64)((SmileSequence)obj)->numStages);
+		return;
+
 	case SMILE_KIND_USEROBJECT:
 		{
 			SmileUserObject userObject = (SmileUserObject)obj;
@@ -0,0 +1,148 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/gc.h>
+#include <smile/gcstats.h>
+#include <smile/string.h>
+#include <smile/eval/eval.h>
+#include <smile/eval/closure.h>
+#include <smile/eval/profiler.h>
+#include <smile/smiletypes/base.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/smileuserobject.h>
+#include <smile/smiletypes/smilefunction.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+
+SMILE_IGNORE_UNUSED_VARIABLES
+
+//-------------------------------------------------------------------------------------------------
+//  The 'Runtime' object's methods report live counters from the interpreter and the garbage
+//  collector, so that long-running programs can export metrics and throttle themselves.  Each
+//  one reads its counter at the moment it's called; times are all in microseconds.
+
+static Byte _allocReportChecks[] = {
+	0, 0,
+	SMILE_KIND_MASK, SMILE_KIND_UNBOXED_INTEGER64,
+};
+
+//-------------------------------------------------------------------------------------------------
+// The garbage collector
+
+SMILE_EXTERNAL_FUNCTION(HeapSize)
+{
+	return SmileUnboxedInteger64_From((Int64)GC_get_heap_size());
+}
+
+SMILE_EXTERNAL_FUNCTION(HeapFree)
+{
+	return SmileUnboxedInteger64_From((Int64)GC_get_free_bytes());
+}
+
+SMILE_EXTERNAL_FUNCTION(BytesAllocated)
+{
+	return SmileUnboxedInteger64_From((Int64)GC_get_total_bytes());
+}
+
+SMILE_EXTERNAL_FUNCTION(GcCount)
+{
+	return SmileUnboxedInteger64_From((Int64)GC_get_gc_no());
+}
+
+// Timing the collector's pauses costs a clock read at the start and end of each collection, so
+// it's off until something wants it:  Either the runner's --gc-stats option, or the first call
+// to one of these methods, which starts the timing, and reports no pauses yet.
+static GcStats GetGcStats(void)
+{
+	if (!Smile_IsCollectingGcStats())
+		Smile_StartGcStats();
+	return Smile_GetGcStats();
+}
+
+SMILE_EXTERNAL_FUNCTION(GcPauseTotal)
+{
+	GcStats gcStats = GetGcStats();
+	return SmileUnboxedInteger64_From((Int64)(gcStats->totalPauseMilliseconds * 1000.0));
+}
+
+SMILE_EXTERNAL_FUNCTION(GcPauseMax)
+{
+	GcStats gcStats = GetGcStats();
+	return SmileUnboxedInteger64_From((Int64)(gcStats->pauseStats->max * 1000.0));
+}
+
+//-------------------------------------------------------------------------------------------------
+// The interpreter
+
+SMILE_EXTERNAL_FUNCTION(Instructions)
+{
+	return SmileUnboxedInteger64_From((Int64)Eval_GetNumInstructions());
+}
+
+SMILE_EXTERNAL_FUNCTION(ClosuresCreated)
+{
+	return SmileUnboxedInteger64_From((Int64)Closure_NumLocalsCreated);
+}
+
+SMILE_EXTERNAL_FUNCTION(StateMachineSteps)
+{
+	return SmileUnboxedInteger64_From((Int64)Eval_NumStateMachineSteps);
+}
+
+SMILE_EXTERNAL_FUNCTION(ExceptionsThrown)
+{
+	return SmileUnboxedInteger64_From((Int64)Eval_NumExceptionsThrown);
+}
+
+SMILE_EXTERNAL_FUNCTION(AllocReport)
+{
+	Int64 maxSites = argc > 1 ? argv[1].unboxed.i64 : 0;
+	return SmileArg_From((SmileObject)Profiler_GetAllocationReport(maxSites > 0 ? (Int)maxSites : 0));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Time
+
+SMILE_EXTERNAL_FUNCTION(Ticks)
+{
+	return SmileUnboxedInteger64_From((Int64)Smile_GetTicks());
+}
+
+SMILE_EXTERNAL_FUNCTION(Time)
+{
+	return SmileUnboxedInteger64_From((Int64)Smile_TicksToMicroseconds(Smile_GetTicks() - Smile_StartTicks));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void SmileRuntime_Setup(SmileUserObject base)
+{
+	SetupFunction("heap-size", HeapSize, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("heap-free", HeapFree, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("bytes-allocated", BytesAllocated, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("gc-count", GcCount, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("gc-pause-total", GcPauseTotal, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("gc-pause-max", GcPauseMax, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+
+	SetupFunction("instructions", Instructions, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("closures-created", ClosuresCreated, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("state-machine-steps", StateMachineSteps, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("exceptions-thrown", ExceptionsThrown, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("alloc-report", AllocReport, NULL, "runtime max-sites", ARG_CHECK_MIN | ARG_CHECK_MAX | ARG_CHECK_TYPES, 1, 2, 2, _allocReportChecks);
+
+	SetupFunction("ticks", Ticks, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("time", Time, NULL, "runtime", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+}
@@ -0,0 +1,99 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/types.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/easyobject.h>
+#include <smile/smiletypes/smilesequence.h>
+#include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/smilefunction.h>
+
+SMILE_EASY_OBJECT_VTABLE(SmileSequence);
+
+SMILE_EASY_OBJECT_READONLY_SECURITY(SmileSequence);
+SMILE_EASY_OBJECT_NO_CALL(SmileSequence, "A Sequence");
+SMILE_EASY_OBJECT_NO_SOURCE(SmileSequence);
+SMILE_EASY_OBJECT_NO_UNBOX(SmileSequence)
+SMILE_EASY_OBJECT_NO_PROPERTIES(SmileSequence)
+
+SMILE_EASY_OBJECT_COMPARE(SmileSequence, SMILE_KIND_SEQUENCE, a == b)
+SMILE_EASY_OBJECT_DEEP_COMPARE(SmileSequence, SMILE_KIND_SEQUENCE, a == b)
+SMILE_EASY_OBJECT_HASH(SmileSequence, Smile_ApplyHashOracle((PtrInt)obj))
+SMILE_EASY_OBJECT_TOBOOL(SmileSequence, True)
+SMILE_EASY_OBJECT_TOSTRING(SmileSequence, String_Format("Sequence of %d stages", (Int)obj->numStages))
+
+//-------------------------------------------------------------------------------------------------
+
+/// <summary>
+/// Create a new Sequence that lazily yields the items of the given List or Array, with no stages.
+/// </summary>
+/// <param name="source">The List or Array whose items this Sequence will yield.</param>
+/// <returns>The new Sequence.</returns>
+SmileSequence SmileSequence_Create(SmileObject source)
+{
+	SmileSequence sequence;
+
+	sequence = GC_MALLOC_STRUCT(struct SmileSequenceInt);
+	if (sequence == NULL) Smile_Abort_OutOfMemory();
+
+	sequence->base = (SmileObject)Smile_KnownBases.Sequence;
+	sequence->kind = SMILE_KIND_SEQUENCE;
+	sequence->vtable = SmileSequence_VTable;
+	sequence->source = source;
+	sequence->stages = NULL;
+	sequence->numStages = 0;
+
+	return sequence;
+}
+
+/// <summary>
+/// Make a new Sequence that is the same as the given Sequence, but with one more stage at the
+/// end of its pipeline.  The original Sequence is not modified, so it can still be reused.
+/// </summary>
+/// <param name="sequence">The Sequence to extend.</param>
+/// <param name="kind">What kind of stage to add (a SmileSequenceStageKind).</param>
+/// <param name="function">The user's function for map/where/each stages, or NULL.</param>
+/// <param name="count">The number of items for take/skip stages, or 0.</param>
+/// <returns>The new, longer Sequence.</returns>
+SmileSequence SmileSequence_AddStage(SmileSequence sequence, Int32 kind, SmileFunction function, Int64 count)
+{
+	SmileSequence newSequence;
+	struct SmileSequenceStage *stage;
+	Int minArgs, maxArgs;
+
+	newSequence = SmileSequence_Create(sequence->source);
+	newSequence->base = sequence->base;
+	newSequence->numStages = sequence->numStages + 1;
+	newSequence->stages = GC_MALLOC_STRUCT_ARRAY(struct SmileSequenceStage, newSequence->numStages);
+	if (newSequence->stages == NULL) Smile_Abort_OutOfMemory();
+
+	if (sequence->numStages > 0)
+		MemCpy(newSequence->stages, sequence->stages, sizeof(struct SmileSequenceStage) * sequence->numStages);
+
+	stage = newSequence->stages + sequence->numStages;
+	stage->kind = kind;
+	stage->function = function;
+	stage->count = count;
+
+	if (function != NULL) {
+		SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+		stage->withIndex = (maxArgs > 1);
+	}
+	else stage->withIndex = False;
+
+	return newSequence;
+}
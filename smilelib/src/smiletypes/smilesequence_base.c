@@ -0,0 +1,478 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include <smile/eval/eval.h>
+#include <smile/smiletypes/smileobject.h>
+#include <smile/smiletypes/smileuserobject.h>
+#include <smile/smiletypes/smilesequence.h>
+#include <smile/smiletypes/smilelist.h>
+#include <smile/smiletypes/smilearray.h>
+#include <smile/smiletypes/smilebool.h>
+#include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/smiletypes/smilefunction.h>
+#include <smile/smiletypes/base.h>
+#include <smile/internal/staticstring.h>
+#include <smile/stringbuilder.h>
+
+SMILE_IGNORE_UNUSED_VARIABLES
+
+static Byte _sequenceChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_SEQUENCE,
+};
+
+static Byte _stageChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_SEQUENCE,
+	SMILE_KIND_MASK, SMILE_KIND_FUNCTION,
+};
+
+static Byte _countChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_SEQUENCE,
+	SMILE_KIND_MASK, SMILE_KIND_UNBOXED_INTEGER64,
+};
+
+static Byte _joinChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_SEQUENCE,
+	SMILE_KIND_MASK, SMILE_KIND_STRING,
+};
+
+//-------------------------------------------------------------------------------------------------
+// Generic type conversion
+
+SMILE_EXTERNAL_FUNCTION(ToBool)
+{
+	return SmileUnboxedBool_From(True);
+}
+
+SMILE_EXTERNAL_FUNCTION(ToString)
+{
+	STATIC_STRING(sequence, "Sequence");
+
+	if (SMILE_KIND(argv[0].obj) == SMILE_KIND_SEQUENCE)
+		return SmileArg_From((SmileObject)SMILE_VCALL1(argv[0].obj, toString, argv[0].unboxed));
+
+	return SmileArg_From((SmileObject)sequence);
+}
+
+SMILE_EXTERNAL_FUNCTION(Hash)
+{
+	return SmileUnboxedInteger64_From(Smile_ApplyHashOracle((PtrInt)argv[0].obj));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Construction, and deferred stages
+
+SMILE_EXTERNAL_FUNCTION(Of)
+{
+	STATIC_STRING(sourceError, "Sequence.of requires a List or an Array.");
+
+	SmileObject source = argv[argc - 1].obj;
+
+	if (SMILE_KIND(source) == SMILE_KIND_SEQUENCE)
+		return SmileArg_From(source);
+	if ((SMILE_KIND(source) & ~SMILE_KIND_LIST_BIT) != SMILE_KIND_NULL && SMILE_KIND(source) != SMILE_KIND_ARRAY)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error, sourceError);
+
+	return SmileArg_From((SmileObject)SmileSequence_Create(source));
+}
+
+SMILE_EXTERNAL_FUNCTION(Lazy)
+{
+	return argv[0];
+}
+
+SMILE_EXTERNAL_FUNCTION(Map)
+{
+	return SmileArg_From((SmileObject)SmileSequence_AddStage((SmileSequence)argv[0].obj,
+		SMILE_SEQUENCE_STAGE_MAP, (SmileFunction)argv[1].obj, 0));
+}
+
+SMILE_EXTERNAL_FUNCTION(Where)
+{
+	return SmileArg_From((SmileObject)SmileSequence_AddStage((SmileSequence)argv[0].obj,
+		SMILE_SEQUENCE_STAGE_WHERE, (SmileFunction)argv[1].obj, 0));
+}
+
+SMILE_EXTERNAL_FUNCTION(Take)
+{
+	return SmileArg_From((SmileObject)SmileSequence_AddStage((SmileSequence)argv[0].obj,
+		SMILE_SEQUENCE_STAGE_TAKE, NULL, argv[1].unboxed.i64));
+}
+
+SMILE_EXTERNAL_FUNCTION(Skip)
+{
+	return SmileArg_From((SmileObject)SmileSequence_AddStage((SmileSequence)argv[0].obj,
+		SMILE_SEQUENCE_STAGE_SKIP, NULL, argv[1].unboxed.i64));
+}
+
+//-------------------------------------------------------------------------------------------------
+// The fused pipeline.
+//
+// Every terminal operation runs the same state machine:  It pulls one item at a time from the
+// source, and walks it forward through the stages.  When a stage needs to call a user function,
+// the state machine returns to Eval to make the call, and then resumes at that same stage with
+// the result.  An item that makes it through every stage is handed to the terminal operation,
+// and then the next item is pulled from the source.
+
+typedef enum {
+	SEQUENCE_TERMINAL_EACH,
+	SEQUENCE_TERMINAL_COUNT,
+	SEQUENCE_TERMINAL_FIRST,
+	SEQUENCE_TERMINAL_ANY,
+	SEQUENCE_TERMINAL_LIST,
+	SEQUENCE_TERMINAL_ARRAY,
+	SEQUENCE_TERMINAL_JOIN,
+} SequenceTerminal;
+
+typedef struct SequenceRunStruct {
+	SmileSequence sequence;		// The sequence being run.
+	SmileSequence original;		// The sequence the terminal operation was called on, for 'each'.
+	SmileList list;				// The source cursor, if the source is a List.
+	Int arrayIndex;				// The source cursor, if the source is an Array.
+	Int64 *counters;			// How many items have entered each stage so far.
+	Int32 stage;				// Which stage the current item is in, or -1 if there is no current item.
+	Bool done;					// Whether no more items can come out of the pipeline.
+	Bool found;					// Whether 'first' or 'any?' found an item.
+	Int32 terminal;				// Which terminal operation is collecting the output (a SequenceTerminal).
+	SmileArg item;				// The current item.
+	Int64 count;				// How many items have come out of the pipeline.
+	SmileList resultHead, resultTail;	// The output, for 'list'.
+	SmileArray resultArray;		// The output, for 'array'.
+	StringBuilder stringBuilder;	// The output, for 'join'.
+	String glue;				// The separator, for 'join'.
+} *SequenceRun;
+
+typedef struct SequenceInfoStruct {
+	SequenceRun run;
+} *SequenceInfo;
+
+/// <summary>
+/// Get the next item from the sequence's source.
+/// </summary>
+/// <returns>True if there was another item, or False if the source has been exhausted.</returns>
+static Bool NextSourceItem(SequenceRun run, SmileArg *item)
+{
+	SmileObject source = run->sequence->source;
+
+	if (SMILE_KIND(source) == SMILE_KIND_ARRAY) {
+		SmileArray array = (SmileArray)source;
+		if (run->arrayIndex >= array->length)
+			return False;
+		*item = array->items[run->arrayIndex++];
+		return True;
+	}
+
+	if (SMILE_KIND(run->list) != SMILE_KIND_LIST)
+		return False;
+	*item = SmileArg_Unbox(run->list->a);
+	run->list = LIST_REST(run->list);
+	return True;
+}
+
+/// <summary>
+/// Hand an item that made it out of the end of the pipeline to the terminal operation.
+/// </summary>
+/// <returns>True if the terminal operation needs more items, or False if it has its answer.</returns>
+static Bool CollectItem(SequenceRun run, SmileArg item)
+{
+	String piece;
+
+	switch (run->terminal) {
+		case SEQUENCE_TERMINAL_FIRST:
+		case SEQUENCE_TERMINAL_ANY:
+			run->found = True;
+			return False;
+
+		case SEQUENCE_TERMINAL_LIST:
+			LIST_APPEND(run->resultHead, run->resultTail, SmileArg_Box(item));
+			break;
+
+		case SEQUENCE_TERMINAL_ARRAY:
+			SmileArray_Append(run->resultArray, item);
+			break;
+
+		case SEQUENCE_TERMINAL_JOIN:
+			if (run->count > 0 && String_Length(run->glue) > 0)
+				StringBuilder_AppendString(run->stringBuilder, run->glue);
+			if (SMILE_KIND(item.obj) == SMILE_KIND_STRING)
+				piece = (String)item.obj;
+			else if (SMILE_KIND(item.obj) == SMILE_KIND_NULL)
+				piece = String_Empty;
+			else
+				piece = SMILE_VCALL1(item.obj, toString, item.unboxed);
+			StringBuilder_AppendString(run->stringBuilder, piece);
+			break;
+	}
+
+	run->count++;
+	return True;
+}
+
+/// <summary>
+/// Push the result of the terminal operation, which ends the state machine.
+/// </summary>
+static Int FinishRun(ClosureStateMachine closure, SequenceRun run)
+{
+	switch (run->terminal) {
+		case SEQUENCE_TERMINAL_EACH:
+			Closure_PushBoxed(closure, run->original);
+			break;
+		case SEQUENCE_TERMINAL_COUNT:
+			Closure_PushUnboxedInt64(closure, run->count);
+			break;
+		case SEQUENCE_TERMINAL_FIRST:
+			if (run->found)
+				Closure_Push(closure, run->item);
+			else
+				Closure_PushBoxed(closure, NullObject);
+			break;
+		case SEQUENCE_TERMINAL_ANY:
+			Closure_PushUnboxedBool(closure, run->found);
+			break;
+		case SEQUENCE_TERMINAL_LIST:
+			Closure_PushBoxed(closure, run->resultHead);
+			break;
+		case SEQUENCE_TERMINAL_ARRAY:
+			Closure_PushBoxed(closure, run->resultArray);
+			break;
+		case SEQUENCE_TERMINAL_JOIN:
+			Closure_PushBoxed(closure, StringBuilder_ToString(run->stringBuilder));
+			break;
+	}
+	return -1;
+}
+
+/// <summary>
+/// Move items through the pipeline until either a stage needs to call a user function (in which
+/// case the call is set up and its argument count is returned), or the run is finished.
+/// </summary>
+static Int AdvanceRun(ClosureStateMachine closure, SequenceRun run)
+{
+	SmileSequence sequence = run->sequence;
+	struct SmileSequenceStage *stage;
+	Int64 index;
+
+	for (;;) {
+		// If there's no current item, pull the next one from the source.
+		if (run->stage < 0) {
+			if (run->done || !NextSourceItem(run, &run->item))
+				return FinishRun(closure, run);
+			run->stage = 0;
+		}
+
+		// Walk the current item forward until it's consumed or we need to call a function.
+		for (; run->stage < sequence->numStages; run->stage++) {
+			stage = sequence->stages + run->stage;
+			index = run->counters[run->stage]++;
+
+			switch (stage->kind) {
+				case SMILE_SEQUENCE_STAGE_TAKE:
+					// Once the last item has passed this stage, nothing more can come out of the pipeline.
+					if (index + 1 >= stage->count)
+						run->done = True;
+					continue;
+
+				case SMILE_SEQUENCE_STAGE_SKIP:
+					if (index < stage->count)
+						goto nextItem;
+					continue;
+
+				default:
+					Closure_PushBoxed(closure, stage->function);
+					Closure_Push(closure, run->item);
+					if (!stage->withIndex) return 1;
+					Closure_PushUnboxedInt64(closure, index);
+					return 2;
+			}
+		}
+
+		// The item made it all the way through, so hand it to the terminal operation.
+		if (!CollectItem(run, run->item))
+			return FinishRun(closure, run);
+
+	nextItem:
+		run->stage = -1;
+	}
+}
+
+static Int SequenceStart(ClosureStateMachine closure)
+{
+	return AdvanceRun(closure, ((SequenceInfo)closure->state)->run);
+}
+
+static Int SequenceBody(ClosureStateMachine closure)
+{
+	SequenceRun run = ((SequenceInfo)closure->state)->run;
+	struct SmileSequenceStage *stage = run->sequence->stages + run->stage;
+	SmileArg fnResult = Closure_Pop(closure);
+
+	switch (stage->kind) {
+		case SMILE_SEQUENCE_STAGE_MAP:
+			run->item = fnResult;
+			run->stage++;
+			break;
+
+		case SMILE_SEQUENCE_STAGE_WHERE:
+			if (SMILE_VCALL1(fnResult.obj, toBool, fnResult.unboxed))
+				run->stage++;
+			else
+				run->stage = -1;	// Rejected, so move on to the next item.
+			break;
+
+		case SMILE_SEQUENCE_STAGE_EACH:
+			run->stage++;	// The result is ignored; the item passes through unchanged.
+			break;
+	}
+
+	return AdvanceRun(closure, run);
+}
+
+/// <summary>
+/// Start running the given sequence's pipeline, feeding its output to the given terminal operation.
+/// </summary>
+static SequenceRun BeginRun(SmileSequence sequence, Int32 terminal)
+{
+	ClosureStateMachine closure;
+	SequenceRun run;
+	Int i;
+
+	run = GC_MALLOC_STRUCT(struct SequenceRunStruct);
+	if (run == NULL) Smile_Abort_OutOfMemory();
+
+	run->sequence = sequence;
+	run->list = (SmileList)sequence->source;
+	run->arrayIndex = 0;
+	run->stage = -1;
+	run->terminal = terminal;
+	run->resultHead = run->resultTail = NullList;
+
+	run->counters = GC_MALLOC_RAW_ARRAY(Int64, sequence->numStages + 1);
+	if (run->counters == NULL) Smile_Abort_OutOfMemory();
+	MemZero(run->counters, sizeof(Int64) * (sequence->numStages + 1));
+
+	// A 'take 0' anywhere means nothing can come out, so don't run any stages before it either.
+	for (i = 0; i < sequence->numStages; i++) {
+		if (sequence->stages[i].kind == SMILE_SEQUENCE_STAGE_TAKE && sequence->stages[i].count <= 0)
+			run->done = True;
+	}
+
+	closure = Eval_BeginStateMachine(SequenceStart, SequenceBody);
+	((SequenceInfo)closure->state)->run = run;
+
+	return run;
+}
+
+/// <summary>
+/// Get the sequence for a terminal operation, applying its optional predicate as one more 'where' stage.
+/// </summary>
+static SmileSequence GetTerminalSequence(Int argc, SmileArg *argv, const char *methodName)
+{
+	if (argc > 2)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+			String_Format("'%s' allows at most 2 arguments, but was called with %d.", methodName, argc));
+	if (SMILE_KIND(argv[0].obj) != SMILE_KIND_SEQUENCE)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+			String_Format("Argument 1 to '%s' is of the wrong type.", methodName));
+
+	if (argc < 2)
+		return (SmileSequence)argv[0].obj;
+
+	if (SMILE_KIND(argv[1].obj) != SMILE_KIND_FUNCTION)
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+			String_Format("Argument 2 to '%s' must be a function.", methodName));
+
+	return SmileSequence_AddStage((SmileSequence)argv[0].obj, SMILE_SEQUENCE_STAGE_WHERE, (SmileFunction)argv[1].obj, 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Terminal operations
+
+SMILE_EXTERNAL_FUNCTION(Each)
+{
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	SmileSequence sequence = SmileSequence_AddStage((SmileSequence)argv[0].obj,
+		SMILE_SEQUENCE_STAGE_EACH, (SmileFunction)argv[1].obj, 0);
+	SequenceRun run = BeginRun(sequence, SEQUENCE_TERMINAL_EACH);
+	run->original = (SmileSequence)argv[0].obj;
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(Count)
+{
+	BeginRun(GetTerminalSequence(argc, argv, "count"), SEQUENCE_TERMINAL_COUNT);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(First)
+{
+	BeginRun(GetTerminalSequence(argc, argv, "first"), SEQUENCE_TERMINAL_FIRST);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(Any)
+{
+	BeginRun(GetTerminalSequence(argc, argv, "any?"), SEQUENCE_TERMINAL_ANY);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(ToList)
+{
+	BeginRun((SmileSequence)argv[0].obj, SEQUENCE_TERMINAL_LIST);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(ToArray)
+{
+	SequenceRun run = BeginRun((SmileSequence)argv[0].obj, SEQUENCE_TERMINAL_ARRAY);
+	run->resultArray = SmileArray_Create((SmileObject)Smile_KnownBases.Array, 16);
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+SMILE_EXTERNAL_FUNCTION(Join)
+{
+	SequenceRun run = BeginRun((SmileSequence)argv[0].obj, SEQUENCE_TERMINAL_JOIN);
+	run->stringBuilder = StringBuilder_Create();
+	run->glue = argc > 1 ? (String)argv[1].obj : String_Empty;
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
+void SmileSequence_Setup(SmileUserObject base)
+{
+	SetupFunction("bool", ToBool, NULL, "sequence", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+	SetupFunction("string", ToString, NULL, "sequence", ARG_CHECK_MIN | ARG_CHECK_MAX, 1, 2, 0, NULL);
+	SetupFunction("hash", Hash, NULL, "sequence", ARG_CHECK_EXACT, 1, 1, 0, NULL);
+
+	SetupFunction("of", Of, (void *)base, "source", ARG_CHECK_MIN | ARG_CHECK_MAX, 1, 2, 0, NULL);
+	SetupFunction("lazy", Lazy, NULL, "sequence", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _sequenceChecks);
+
+	SetupFunction("map", Map, NULL, "sequence fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _stageChecks);
+	SetupSynonym("map", "select");
+	SetupSynonym("map", "project");
+	SetupFunction("where", Where, NULL, "sequence fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _stageChecks);
+	SetupSynonym("where", "filter");
+	SetupFunction("take", Take, NULL, "sequence count", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _countChecks);
+	SetupFunction("skip", Skip, NULL, "sequence count", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 2, 2, 2, _countChecks);
+
+	SetupFunction("each", Each, NULL, "sequence fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _stageChecks);
+	SetupFunction("count", Count, NULL, "sequence fn", ARG_STATE_MACHINE, 0, 0, 0, NULL);
+	SetupFunction("first", First, NULL, "sequence fn", ARG_STATE_MACHINE, 0, 0, 0, NULL);
+	SetupFunction("any?", Any, NULL, "sequence fn", ARG_STATE_MACHINE, 0, 0, 0, NULL);
+	SetupFunction("list", ToList, NULL, "sequence", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 1, 1, 1, _sequenceChecks);
+	SetupFunction("array", ToArray, NULL, "sequence", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 1, 1, 1, _sequenceChecks);
+	SetupFunction("join", Join, NULL, "sequence glue", ARG_CHECK_MIN | ARG_CHECK_MAX | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 1, 2, 2, _joinChecks);
+}
@@ -80,6 +80,18 @@ static Byte _eachChecks[] = {
 	SMILE_KIND_MASK, SMILE_KIND_FUNCTION,
 };
 
+static Byte _splitChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_STRING,
+	0, 0,
+	SMILE_KIND_MASK, SMILE_KIND_UNBOXED_INTEGER64,
+};
+
+static Byte _eachSplitChecks[] = {
+	SMILE_KIND_MASK, SMILE_KIND_STRING,
+	0, 0,
+	SMILE_KIND_MASK, SMILE_KIND_FUNCTION,
+};
+
 static Byte _hyphenizeChecks[] = {
 	SMILE_KIND_MASK, SMILE_KIND_STRING,
 	SMILE_KIND_MASK, SMILE_KIND_UNBOXED_BYTE,
@@ -992,13 +1004,13 @@ SMILE_EXTERNAL_FUNCTION(Split)
 	// Decode the pattern.
 	if (patternKind == SMILE_KIND_STRING)
 		pattern = (String)argv[1].obj;
-	else if (patternKind == SMILE_KIND_CHAR)
+	else if (patternKind == SMILE_KIND_UNBOXED_CHAR)
 		pattern = String_CreateRepeat(argv[1].unboxed.i8, 1);
-	else if (patternKind == SMILE_KIND_UNI)
+	else if (patternKind == SMILE_KIND_UNBOXED_UNI)
 		pattern = String_CreateFromUnicode(argv[1].unboxed.uni);
 	else {
 		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
-			String_FromC("The second argument to 'String.split' must be a String, Char, Uni, or Regex."));
+			String_FromC("The second argument to 'String.split' must be a String, Char, or Uni."));
 	}
 
 	// If there's a limit, get the limit.
@@ -1359,6 +1371,154 @@ SMILE_EXTERNAL_FUNCTION(Each)
 
 //-------------------------------------------------------------------------------------------------
 
+typedef struct EachSplitInfoStruct {
+	String initialString;
+	String pattern;
+	SmileFunction function;
+	Int start;
+	Int index;
+	Bool done;
+} *EachSplitInfo;
+
+/// <summary>
+/// Find the next piece of the string being split, exactly as String_SplitWithOptions() would
+/// produce it, but without producing any of the pieces after it.
+/// </summary>
+/// <returns>True if there was another piece (stored in *piece), or False if the split is done.</returns>
+static Bool EachSplitNextPiece(EachSplitInfo eachSplitInfo, String *piece)
+{
+	String str = eachSplitInfo->initialString;
+	Int length = String_Length(str);
+	Int start = eachSplitInfo->start;
+	Int splitIndex;
+
+	if (eachSplitInfo->done)
+		return False;
+
+	// An empty string splits into a single empty piece.
+	if (length == 0) {
+		eachSplitInfo->done = True;
+		*piece = String_Empty;
+		return True;
+	}
+
+	// An empty pattern explodes the string into its individual bytes.
+	if (String_IsNullOrEmpty(eachSplitInfo->pattern)) {
+		if (start >= length) {
+			eachSplitInfo->done = True;
+			return False;
+		}
+		*piece = String_Substring(str, start, 1);
+		eachSplitInfo->start = start + 1;
+		return True;
+	}
+
+	// Otherwise, the next piece runs up to the next instance of the pattern...
+	if ((splitIndex = String_IndexOf(str, eachSplitInfo->pattern, start)) >= 0) {
+		*piece = splitIndex > start ? String_SubstringShared(str, start, splitIndex - start) : String_Empty;
+		eachSplitInfo->start = splitIndex + String_Length(eachSplitInfo->pattern);
+		return True;
+	}
+
+	// ...or to the end of the string, if there's anything left.
+	eachSplitInfo->done = True;
+	if (start >= length)
+		return False;
+	*piece = start > 0 ? String_SubstringShared(str, start, length - start) : str;
+	return True;
+}
+
+static Int EachSplitWithOneArg(ClosureStateMachine closure)
+{
+	EachSplitInfo eachSplitInfo = (EachSplitInfo)closure->state;
+	String piece;
+
+	// If we've run out of pieces, we're done.
+	if (!EachSplitNextPiece(eachSplitInfo, &piece)) {
+		Closure_Pop(closure);
+		Closure_PushBoxed(closure, eachSplitInfo->initialString);	// Pop the previous return value and push 'initialString'.
+		return -1;
+	}
+
+	// Set up to call the user's function with the next piece.
+	Closure_Pop(closure);
+	Closure_PushBoxed(closure, eachSplitInfo->function);
+	Closure_PushBoxed(closure, piece);
+
+	eachSplitInfo->index++;
+
+	return 1;
+}
+
+static Int EachSplitWithTwoArgs(ClosureStateMachine closure)
+{
+	EachSplitInfo eachSplitInfo = (EachSplitInfo)closure->state;
+	String piece;
+
+	// If we've run out of pieces, we're done.
+	if (!EachSplitNextPiece(eachSplitInfo, &piece)) {
+		Closure_Pop(closure);
+		Closure_PushBoxed(closure, eachSplitInfo->initialString);	// Pop the previous return value and push 'initialString'.
+		return -1;
+	}
+
+	// Set up to call the user's function with the next piece and its index.
+	Closure_Pop(closure);
+	Closure_PushBoxed(closure, eachSplitInfo->function);
+	Closure_PushBoxed(closure, piece);
+	Closure_PushUnboxedInt64(closure, eachSplitInfo->index);
+
+	eachSplitInfo->index++;
+
+	return 2;
+}
+
+SMILE_EXTERNAL_FUNCTION(EachSplit)
+{
+	// This splits the string exactly like 'split' does, but it hands each piece to the user's
+	// function as soon as it's found, rather than building a list of all of the pieces first.
+	// We use Eval's state-machine construct to avoid recursing deeper on the C stack.
+	String smileString = (String)argv[0].obj;
+	SmileFunction function = (SmileFunction)argv[2].obj;
+	String pattern;
+	Int patternKind = SMILE_KIND(argv[1].obj);
+	Int minArgs, maxArgs;
+	EachSplitInfo eachSplitInfo;
+	ClosureStateMachine closure;
+	StateMachine stateMachine;
+
+	// Decode the pattern, which may be anything 'split' accepts.
+	if (patternKind == SMILE_KIND_STRING)
+		pattern = (String)argv[1].obj;
+	else if (patternKind == SMILE_KIND_UNBOXED_CHAR)
+		pattern = String_CreateRepeat(argv[1].unboxed.i8, 1);
+	else if (patternKind == SMILE_KIND_UNBOXED_UNI)
+		pattern = String_CreateFromUnicode(argv[1].unboxed.uni);
+	else {
+		Smile_ThrowException(Smile_KnownSymbols.native_method_error,
+			String_FromC("The second argument to 'String.each-split' must be a String, Char, or Uni."));
+	}
+
+	SmileFunction_GetArgCounts(function, &minArgs, &maxArgs);
+
+	stateMachine = maxArgs <= 1 ? EachSplitWithOneArg : EachSplitWithTwoArgs;
+	closure = Eval_BeginStateMachine(stateMachine, stateMachine);
+
+	eachSplitInfo = (EachSplitInfo)closure->state;
+	eachSplitInfo->function = function;
+	eachSplitInfo->initialString = smileString;
+	eachSplitInfo->pattern = pattern;
+	eachSplitInfo->start = 0;
+	eachSplitInfo->index = 0;
+	eachSplitInfo->done = False;
+
+	Closure_PushBoxed(closure, NullObject);	// Initial "return" value from 'each-split'.
+
+	return (SmileArg){ NULL };	// We have to return something, but this value will be ignored.
+}
+
+//-------------------------------------------------------------------------------------------------
+
 typedef struct MapInfoStruct {
 	StringBuilder result;
 	const Byte *ptr, *end;
@@ -1857,7 +2017,7 @@ void String_Setup(SmileUserObject base)
 	SetupFunction("replace~", ReplaceI, NULL, "str pattern replacement", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 3, 3, 3, _stringReplaceChecks);
 	SetupSynonym("replace", "subst");
 	SetupSynonym("replace~", "subst~");
-	SetupFunction("split", Split, NULL, "str pattern limit", ARG_CHECK_MIN | ARG_CHECK_MAX | ARG_CHECK_TYPES, 2, 3, 3, _indexOfChecks);
+	SetupFunction("split", Split, NULL, "str pattern limit", ARG_CHECK_MIN | ARG_CHECK_MAX | ARG_CHECK_TYPES, 2, 3, 3, _splitChecks);
 
 	SetupFunction("trim", Trim, NULL, "string", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _stringChecks);
 	SetupFunction("trim-start", TrimStart, NULL, "string", ARG_CHECK_EXACT | ARG_CHECK_TYPES, 1, 1, 1, _stringChecks);
@@ -1950,6 +2110,7 @@ void String_Setup(SmileUserObject base)
 	SetupFunction("uni-next", UniNext, NULL, "str index", ARG_CHECK_MIN | ARG_CHECK_TYPES, 2, 2, 2, _stringNumberChecks);
 
 	SetupFunction("each", Each, NULL, "string", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
+	SetupFunction("each-split", EachSplit, NULL, "string pattern fn", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 3, 3, 3, _eachSplitChecks);
 	SetupFunction("map", Map, NULL, "string", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
 	SetupFunction("where", Where, NULL, "string", ARG_CHECK_EXACT | ARG_CHECK_TYPES | ARG_STATE_MACHINE, 2, 2, 2, _eachChecks);
 	SetupFunction("count", Count, NULL, "string", ARG_STATE_MACHINE, 0, 0, 0, NULL);
@@ -26,7 +26,8 @@ SMILE_EASY_OBJECT_VTABLE(SmileSymbol);
 
 SmileSymbol SmileSymbol_Create(Symbol symbol)
 {
-	SmileSymbol smileSymbol = GC_MALLOC_STRUCT(struct SmileSymbolInt);
+	// We MALLOC_ATOMIC here because the base is a known pointer that will never be collected.
+	SmileSymbol smileSymbol = (SmileSymbol)GC_MALLOC_ATOMIC(sizeof(struct SmileSymbolInt));
 	if (smileSymbol == NULL) Smile_Abort_OutOfMemory();
 	smileSymbol->base = (SmileObject)Smile_KnownBases.Symbol;
 	smileSymbol->kind = SMILE_KIND_SYMBOL;
@@ -21,9 +21,61 @@
 #include <smile/stringbuilder.h>
 #include <smile/internal/types.h>
 
-// How big the text[] array is in the String's _opaque struct.
+// How big the data[] array is in the String's _opaque struct.
 #define STRING_TEXT_PADDING 65536
 
+// Concatenations shorter than this are simply copied; longer ones are built lazily as concatenation nodes.
+#define STRING_CONCAT_MIN_LENGTH 256
+
+// Substrings shorter than this are simply copied; longer ones may share their parent's bytes.
+#define STRING_SLICE_MIN_LENGTH 64
+
+// A substring is copied rather than shared if its parent is more than this many times larger than
+// it, so that keeping a small piece of a huge string doesn't keep the whole huge string alive.
+#define STRING_SLICE_MAX_PARENT_RATIO 8
+
+// When appending to a concatenation node whose right-hand piece is shorter than this, the two
+// short pieces are merged, so that appending many tiny pieces doesn't create one node per piece.
+#define STRING_CONCAT_MAX_LEAF_LENGTH 128
+
+/// <summary>
+/// A concatenation node:  A String whose bytes are the bytes of two other strings, which aren't
+/// actually copied anywhere until something asks for them.  This has exactly the same header and
+/// length as an ordinary String, and the same SMILE_KIND_STRING kind (with SMILE_FLAG_STRINGCONCAT set),
+/// but its 'text' pointer is NULL until it is flattened by String_FlattenConcat().
+/// </summary>
+typedef struct StringConcatStruct {
+	UInt32 kind;
+	struct SmileVTableInt *vtable;
+	struct SmileObjectInt *base;
+
+	struct {
+		Int length;	// The total length of the two halves, in bytes.
+		Byte *text;	// NULL until flattened; then, the flattened (nul-terminated) bytes.
+		String left;	// The left half of the concatenation (NULL once flattened).
+		String right;	// The right half of the concatenation (NULL once flattened).
+	} _opaque;
+} *StringConcat;
+
+/// <summary>
+/// A slice:  A String whose bytes are a range of some other string's bytes, shared rather than copied.
+/// This has exactly the same header and length as an ordinary String, and the same SMILE_KIND_STRING
+/// kind (with SMILE_FLAG_STRINGSLICE set), but its 'text' points into its parent's bytes, and so its
+/// bytes are not necessarily followed by a nul terminator.  Like any String, a slice never changes
+/// once it has been created.
+/// </summary>
+typedef struct StringSliceStruct {
+	UInt32 kind;
+	struct SmileVTableInt *vtable;
+	struct SmileObjectInt *base;
+
+	struct {
+		Int length;	// The length of the slice, in bytes.
+		Byte *text;	// A pointer to the slice's first byte, somewhere within its parent's bytes.
+		String parent;	// The string whose bytes this slice shares (never itself a slice).
+	} _opaque;
+} *StringSlice;
+
 /// <summary>
 /// Construct a new String instance containing the given substring of text,
 /// starting at the given start index, going for the given length.
@@ -56,6 +108,7 @@ String String_Create(const Byte *text, Int length)
 	str->vtable = (SmileVTable)&String_VTableData;
 	str->base = (SmileObject)&String_BaseObjectStruct;
 	str->_opaque.length = length;
+	str->_opaque.text = str->_opaque.data;
 
 	newText = str->_opaque.text;
 	MemCpy(newText, text, length);
@@ -84,6 +137,7 @@ String String_CreateInternal(Int length)
 	str->vtable = (SmileVTable)&String_VTableData;
 	str->base = (SmileObject)&String_BaseObjectStruct;
 	str->_opaque.length = length;
+	str->_opaque.text = str->_opaque.data;
 	str->_opaque.text[length] = '\0';
 
 	return (String)str;
@@ -372,13 +426,92 @@ Int String_CompareRange(const String a, Int astart, Int alength, const String b,
 	return 0;
 }
 
+/// <summary>
+/// Construct a new slice that shares the given range of the given string's bytes.
+/// </summary>
+static String CreateSlice(const String str, Int start, Int length)
+{
+	StringSlice slice;
+	String owner = (String)str;
+	const Byte *text = String_GetBytes(str);
+
+	// Always share the bytes of whichever string actually owns them, so that slices of slices
+	// don't form chains of parents.
+	if (str->kind & SMILE_FLAG_STRINGSLICE)
+		owner = ((StringSlice)str)->_opaque.parent;
+
+	// Like concatenation nodes, slices contain pointers to heap data, so they must not be
+	// allocated with GC_MALLOC_ATOMIC().
+	slice = GC_MALLOC_STRUCT(struct StringSliceStruct);
+	if (slice == NULL) Smile_Abort_OutOfMemory();
+
+	slice->kind = SMILE_KIND_STRING | SMILE_FLAG_STRINGSLICE;
+	slice->vtable = (SmileVTable)&String_VTableData;
+	slice->base = (SmileObject)&String_BaseObjectStruct;
+	slice->_opaque.length = length;
+	slice->_opaque.text = (Byte *)text + start;
+	slice->_opaque.parent = owner;
+
+	return (String)slice;
+}
+
+/// <summary>
+/// Make a nul-terminated copy of a slice's bytes, for String_ToC().  Slices share their parent's
+/// bytes, so they aren't necessarily followed by a nul terminator.  The slice itself is left as it
+/// is, since other threads may be reading it, so each call returns a fresh copy.
+/// </summary>
+/// <param name="str">The string to terminate.</param>
+/// <returns>A new, nul-terminated copy of the bytes of the string.</returns>
+const char *String_TerminateSlice(const String str)
+{
+	Byte *newText;
+
+	newText = GC_MALLOC_ATOMIC(String_Length(str) + 1);
+	if (newText == NULL) Smile_Abort_OutOfMemory();
+
+	MemCpy(newText, str->_opaque.text, String_Length(str));
+	newText[String_Length(str)] = '\0';
+
+	return (const char *)newText;
+}
+
+/// <summary>
+/// Extract a substring from the given string, sharing the original string's bytes if the substring
+/// is long enough to be worth sharing.  Unlike String_Substring(), this shares the bytes no matter how
+/// much larger the original string is, so it's best used when the caller is going to keep most of
+/// the original string anyway (such as when splitting it into pieces).
+/// </summary>
+/// <param name="str">The string from which a substring will be extracted.</param>
+/// <param name="start">The starting offset within the string.  If this lies outside the string, it will be clipped to the string.</param>
+/// <param name="length">The number of bytes to extract from the string.  If this lies outside the string, it will be clipped to the string.</param>
+/// <returns>The extracted substring.</returns>
+String String_SubstringShared(const String str, Int start, Int length)
+{
+	if (start < 0) {
+		length += start;
+		start = 0;
+	}
+	if (start >= String_Length(str) || length <= 0)
+		return String_Empty;
+	if (length > String_Length(str) - start) {
+		length = String_Length(str) - start;
+	}
+
+	if (length == String_Length(str))
+		return (String)str;
+	if (length < STRING_SLICE_MIN_LENGTH)
+		return String_Create(String_GetBytes(str) + start, length);
+
+	return CreateSlice(str, start, length);
+}
+
 /// <summary>
 /// Extract a substring from the given string that starts at the given index and continues
 /// to the end of the string.
 /// </summary>
 /// <param name="str">The string from which a substring will be extracted.</param>
 /// <param name="start">The starting offset within the string.  If this lies outside the string, it will be clipped to the string.</param>
-/// <returns>The extracted (copied) substring.</returns>
+/// <returns>The extracted substring.</returns>
 String String_SubstringAt(const String str, Int start)
 {
 	if (start < 0) {
@@ -387,17 +520,19 @@ String String_SubstringAt(const String str, Int start)
 	if (start >= String_Length(str))
 		return String_Empty;
 
-	return String_Create(String_GetBytes(str) + start, String_Length(str) - start);
+	return String_Substring(str, start, String_Length(str) - start);
 }
 
 /// <summary>
 /// Extract a substring from the given string that starts at the given index and continues
-/// for 'length' bytes.
+/// for 'length' bytes.  Long substrings share the original string's bytes rather than copying
+/// them, unless the original string is so much larger than the substring that sharing would
+/// keep far more memory alive than it saves.
 /// </summary>
 /// <param name="str">The string from which a substring will be extracted.</param>
 /// <param name="start">The starting offset within the string.  If this lies outside the string, it will be clipped to the string.</param>
 /// <param name="length">The number of bytes to copy from the string.  If this lies outside the string, it will be clipped to the string.</param>
-/// <returns>The extracted (copied) substring.</returns>
+/// <returns>The extracted substring.</returns>
 String String_Substring(const String str, Int start, Int length)
 {
 	if (start < 0) {
@@ -410,7 +545,10 @@ String String_Substring(const String str, Int start, Int length)
 		length = String_Length(str) - start;
 	}
 
-	return String_Create(String_GetBytes(str) + start, length);
+	if (length < STRING_SLICE_MIN_LENGTH || String_Length(str) / STRING_SLICE_MAX_PARENT_RATIO > length)
+		return String_Create(String_GetBytes(str) + start, length);
+
+	return String_SubstringShared(str, start, length);
 }
 
 /// <summary>
@@ -522,6 +660,87 @@ String String_SubstringByRange(const String str, Int64 start, Int64 end, Int64 s
 	}
 }
 
+/// <summary>
+/// Construct a new concatenation node that lazily joins the two given (nonempty) strings.
+/// </summary>
+static String CreateConcat(const String left, const String right)
+{
+	StringConcat node;
+
+	// Unlike ordinary strings, concatenation nodes contain pointers to heap data, so they
+	// must not be allocated with GC_MALLOC_ATOMIC().
+	node = GC_MALLOC_STRUCT(struct StringConcatStruct);
+	if (node == NULL) Smile_Abort_OutOfMemory();
+
+	node->kind = SMILE_KIND_STRING | SMILE_FLAG_STRINGCONCAT;
+	node->vtable = (SmileVTable)&String_VTableData;
+	node->base = (SmileObject)&String_BaseObjectStruct;
+	node->_opaque.length = String_Length(left) + String_Length(right);
+	node->_opaque.text = NULL;
+	node->_opaque.left = left;
+	node->_opaque.right = right;
+
+	return (String)node;
+}
+
+/// <summary>
+/// Copy all of the bytes of the given string, which may be an unflattened concatenation, to 'dest'.
+/// This always loops down the longer half of each node and recurses only into the shorter half,
+/// so even a badly-unbalanced concatenation (like the left-leaning chain built by appending to a
+/// string over and over) never recurses more than log2(length) levels deep.
+/// </summary>
+static void CopyConcatBytes(Byte *dest, String str)
+{
+	StringConcat node;
+	String left, right;
+
+	while (str->_opaque.text == NULL) {
+		node = (StringConcat)str;
+		left = node->_opaque.left;
+		right = node->_opaque.right;
+
+		if (String_Length(left) <= String_Length(right)) {
+			CopyConcatBytes(dest, left);
+			dest += String_Length(left);
+			str = right;
+		}
+		else {
+			CopyConcatBytes(dest + String_Length(left), right);
+			str = left;
+		}
+	}
+
+	MemCpy(dest, str->_opaque.text, String_Length(str));
+}
+
+/// <summary>
+/// Flatten a concatenation node, copying the bytes of its pieces into a single contiguous buffer.
+/// This is called automatically by String_GetBytes() and friends the first time anything needs the
+/// actual bytes of a concatenation; afterward, the node simply refers to its flattened bytes.
+/// </summary>
+/// <param name="str">The string to flatten.</param>
+/// <returns>The (nul-terminated) bytes of the string.</returns>
+const Byte *String_FlattenConcat(const String str)
+{
+	StringConcat node = (StringConcat)str;
+	Byte *newText;
+
+	if (node->_opaque.text != NULL)
+		return node->_opaque.text;
+
+	newText = GC_MALLOC_ATOMIC(node->_opaque.length + 1);
+	if (newText == NULL) Smile_Abort_OutOfMemory();
+
+	CopyConcatBytes(newText, str);
+	newText[node->_opaque.length] = '\0';
+
+	node->_opaque.text = newText;
+	node->_opaque.left = NULL;
+	node->_opaque.right = NULL;
+
+	return newText;
+}
+
 /// <summary>
 /// Construct a new String instance by concatenating exactly two strings together.
 /// </summary>
@@ -531,6 +750,7 @@ String String_SubstringByRange(const String str, Int64 start, Int64 end, Int64 s
 String String_Concat(const String s1, const String s2)
 {
 	String result;
+	StringConcat node;
 	Byte *newText;
 	Int length;
 
@@ -539,6 +759,19 @@ String String_Concat(const String s1, const String s2)
 
 	length = String_Length(s1) + String_Length(s2);
 
+	// Long results are built lazily, so that repeatedly appending to a string takes linear time
+	// instead of quadratic time.  Short pieces appended to a concatenation are merged with its
+	// right-hand piece, so that the concatenation doesn't end up with one node per tiny piece.
+	if (length >= STRING_CONCAT_MIN_LENGTH) {
+		if (s1->_opaque.text == NULL && String_Length(s2) < STRING_CONCAT_MAX_LEAF_LENGTH) {
+			node = (StringConcat)s1;
+			if (node->_opaque.right->_opaque.text != NULL
+				&& String_Length(node->_opaque.right) + String_Length(s2) <= STRING_CONCAT_MAX_LEAF_LENGTH)
+				return CreateConcat(node->_opaque.left, String_Concat(node->_opaque.right, s2));
+		}
+		return CreateConcat(s1, s2);
+	}
+
 	result = String_CreateInternal(length);
 	newText = result->_opaque.text;
 
@@ -569,6 +802,12 @@ String String_ConcatByte(const String str, Byte ch)
 
 	length = String_Length(str) + 1;
 
+	if (length >= STRING_CONCAT_MIN_LENGTH) {
+		result = String_CreateInternal(1);
+		result->_opaque.text[0] = ch;
+		return String_Concat(str, result);
+	}
+
 	result = String_CreateInternal(length);
 	newText = result->_opaque.text;
 
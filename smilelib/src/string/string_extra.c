@@ -24,7 +24,8 @@
 STATIC_STRING(CommaSpace, ", ");
 
 /// <summary>
-/// Split a string by a given pattern string.
+/// Split a string by a given pattern string.  Long pieces share the original string's bytes
+/// rather than copying them.
 /// </summary>
 /// <param name="str">The string to split.</param>
 /// <param name="pattern">The substring on which to split that string.  If this is the empty string, no splitting will be performed.</param>
@@ -54,7 +55,7 @@ Int String_SplitWithOptions(const String str, const String pattern, Int limit, I
 				}
 			}
 			else {
-				*((String *)Array_Push(array)) = String_Substring(str, startIndex, splitIndex - startIndex);
+				*((String *)Array_Push(array)) = String_SubstringShared(str, startIndex, splitIndex - startIndex);
 				limit--;
 			}
 			startIndex = splitIndex + String_Length(pattern);
@@ -72,7 +73,7 @@ Int String_SplitWithOptions(const String str, const String pattern, Int limit, I
 	if (limit > 0) {
 		if (!String_IsNullOrEmpty(str)) {
 			if (startIndex < String_Length(str)) {
-				*((String *)Array_Push(array)) = startIndex > 0 ? String_Substring(str, startIndex, String_Length(str) - startIndex) : str;
+				*((String *)Array_Push(array)) = startIndex > 0 ? String_SubstringShared(str, startIndex, String_Length(str) - startIndex) : str;
 			}
 		}
 		else {
@@ -81,7 +82,7 @@ Int String_SplitWithOptions(const String str, const String pattern, Int limit, I
 	}
 	else {
 		if (startIndex < String_Length(str)) {
-			*((String *)Array_Push(array)) = startIndex > 0 ? String_Substring(str, startIndex, String_Length(str) - startIndex) : str;
+			*((String *)Array_Push(array)) = startIndex > 0 ? String_SubstringShared(str, startIndex, String_Length(str) - startIndex) : str;
 		}
 	}
 
@@ -18,9 +18,11 @@
 #include <smile/gc.h>
 #include <smile/string.h>
 #include <smile/stringbuilder.h>
+#include <smile/bittwiddling.h>
 #include <smile/internal/unicode.h>
 
 static Byte GetCombiningClass(UInt32 ch);
+static void PreparePattern(StringPatternI stringPattern, const String pattern, Bool foldPattern);
 static void SortCombiningCharacters(UInt32 *buffer, UInt32 *temp, Int start, Int length);
 
 /// <summary>
@@ -194,6 +196,22 @@ Int32 String_ExtractUnicodeCharacterInternal(const Byte **start, const Byte *end
 	}
 }
 
+/// <summary>
+/// Convert a single 7-bit ASCII byte to lowercase, which for ASCII is the same as case-folding it.
+/// </summary>
+Inline Byte AsciiToLower(Byte ch)
+{
+	return (Byte)(ch - 'A') < 26 ? (Byte)(ch + ('a' - 'A')) : ch;
+}
+
+/// <summary>
+/// Convert a single 7-bit ASCII byte to uppercase.
+/// </summary>
+Inline Byte AsciiToUpper(Byte ch)
+{
+	return (Byte)(ch - 'a') < 26 ? (Byte)(ch - ('a' - 'A')) : ch;
+}
+
 /// <summary>
 /// Compare substrings in two strings, case-insensitive, to lexically order those substrings,
 /// without extracting the substrings to new string instances if possible.
@@ -218,6 +236,8 @@ Int String_CompareRangeI(const String a, Int astart, Int alength, const String b
 	Int codePageIndexA, codePageIndexB;
 	const Int32 *codePageA, *codePageB;
 	String foldedA, foldedB;
+	UInt64 aword, bword;
+	Int offset;
 
 	if (astart < 0)
 	{
@@ -254,6 +274,28 @@ Int String_CompareRangeI(const String a, Int astart, Int alength, const String b
 	bptr = String_GetBytes(b) + bstart;
 	aend = aptr + alength;
 	bend = bptr + blength;
+
+	// Fast path:  As long as both substrings are plain ASCII, compare them eight bytes at a time,
+	// folding case with bit arithmetic instead of going through the case-folding tables.
+	while (aend - aptr >= (Int)sizeof(UInt64) && bend - bptr >= (Int)sizeof(UInt64))
+	{
+		aword = ByteWord_Load(aptr);
+		bword = ByteWord_Load(bptr);
+		if (ByteWord_HasNonAscii(aword | bword)) break;
+
+		aword = ByteWord_AsciiToLower(aword);
+		bword = ByteWord_AsciiToLower(bword);
+		if (aword != bword)
+		{
+			offset = ByteWord_FirstMatch(ByteWord_NonZeroLanes(aword ^ bword));
+			*usedSlowConversion = False;
+			return AsciiToLower(aptr[offset]) < AsciiToLower(bptr[offset]) ? -1 : +1;
+		}
+
+		aptr += sizeof(UInt64);
+		bptr += sizeof(UInt64);
+	}
+
 	while (aptr < aend && bptr < bend)
 	{
 		// Read one complete Unicode code point from string A.
@@ -321,8 +363,128 @@ Int String_CompareRangeI(const String a, Int astart, Int alength, const String b
 	return 0;
 }
 
+/// <summary>
+/// How a case-conversion table transforms the 7-bit ASCII range, so that ConvertCase() can convert
+/// runs of ASCII eight bytes at a time without consulting the table.
+/// </summary>
+enum {
+	ASCII_CASE_UNCHANGED = 0,	// The table leaves all ASCII characters as they are.
+	ASCII_CASE_LOWER = 1,	// The table converts 'A'-'Z' to 'a'-'z' and leaves all other ASCII as is.
+	ASCII_CASE_UPPER = 2,	// The table converts 'a'-'z' to 'A'-'Z' and leaves all other ASCII as is.
+};
+
+/// <summary>
+/// Convert eight ASCII bytes at once, according to the given ASCII conversion mode.
+/// </summary>
+Inline UInt64 ConvertAsciiWord(UInt64 word, Int asciiCase)
+{
+	switch (asciiCase) {
+		case ASCII_CASE_LOWER:
+			return ByteWord_AsciiToLower(word);
+		case ASCII_CASE_UPPER:
+			return ByteWord_AsciiToUpper(word);
+		default:
+			return word;
+	}
+}
+
+/// <summary>
+/// Convert a single ASCII byte, according to the given ASCII conversion mode.
+/// </summary>
+Inline Byte ConvertAsciiByte(Byte ch, Int asciiCase)
+{
+	switch (asciiCase) {
+		case ASCII_CASE_LOWER:
+			return AsciiToLower(ch);
+		case ASCII_CASE_UPPER:
+			return AsciiToUpper(ch);
+		default:
+			return ch;
+	}
+}
+
+/// <summary>
+/// Convert a run of pure-ASCII bytes from 'src' to 'dest', eight bytes at a time.
+/// </summary>
+static void ConvertAsciiRun(Byte *dest, const Byte *src, Int length, Int asciiCase)
+{
+	while (length >= (Int)sizeof(UInt64)) {
+		ByteWord_Store(dest, ConvertAsciiWord(ByteWord_Load(src), asciiCase));
+		dest += sizeof(UInt64);
+		src += sizeof(UInt64);
+		length -= sizeof(UInt64);
+	}
+	while (length-- > 0) {
+		*dest++ = ConvertAsciiByte(*src++, asciiCase);
+	}
+}
+
+/// <summary>
+/// Find the end of the run of pure-ASCII bytes that starts at text[start].
+/// </summary>
+/// <returns>The index of the first non-ASCII byte at or after 'start', or 'end' if there is none.</returns>
+static Int FindEndOfAscii(const Byte *text, Int start, Int end)
+{
+	UInt64 word;
+
+	while (end - start >= (Int)sizeof(UInt64)) {
+		word = ByteWord_Load(text + start);
+		if (ByteWord_HasNonAscii(word))
+			return start + ByteWord_FirstMatch(word & BYTEWORD_HIGHS);
+		start += sizeof(UInt64);
+	}
+	while (start < end && text[start] < 0x80) {
+		start++;
+	}
+	return start;
+}
+
+/// <summary>
+/// Find the first character in the given range of the string that would be changed by a case conversion.
+/// </summary>
+/// <returns>The byte index of the first character that the conversion would change, or 'end' if the
+/// conversion would leave the whole range exactly as it is.</returns>
+static Int FindFirstCaseChange(const String str, Int start, Int end, const Int32 **caseTable, Int32 caseTableCount, Int asciiCase)
+{
+	const Byte *text = String_GetBytes(str);
+	const Int32 *codePage;
+	Int32 code, newCodeValue;
+	UInt64 word;
+	Int i = start, charStart;
+
+	while (i < end) {
+		// Skip over unchanging ASCII eight bytes at a time.
+		if (end - i >= (Int)sizeof(UInt64)) {
+			word = ByteWord_Load(text + i);
+			if (!ByteWord_HasNonAscii(word) && ConvertAsciiWord(word, asciiCase) == word) {
+				i += sizeof(UInt64);
+				continue;
+			}
+		}
+
+		charStart = i;
+		if (text[i] < 0x80) {
+			if (ConvertAsciiByte(text[i], asciiCase) != text[i]) return charStart;
+			i++;
+			continue;
+		}
+
+		// Non-ASCII characters are unchanged only if they decode cleanly and map to themselves;
+		// anything else (including invalid UTF-8, which becomes U+FFFD) counts as a change.
+		code = String_ExtractUnicodeCharacter(str, &i);
+		if (code < 0 || code == 0xFFFD) return charStart;
+		codePage = ((code >> 8) < caseTableCount ? caseTable[code >> 8] : _identityTable);
+		newCodeValue = code + codePage[code & 0xFF];
+		if (newCodeValue != code) return charStart;
+	}
+
+	return end;
+}
+
 /// <summary>
 /// Shared case-conversion function, using a common lookup-table structure shared by all of the case-conversion functions.
+/// Runs of ASCII are converted eight bytes at a time; only non-ASCII characters go through the tables.  If the
+/// conversion would not change anything, no new string is built at all.
 /// </summary>
 /// <param name="str">The string whose substring you would like to convert.</param>
 /// <param name="start">The start of the substring within that string.</param>
@@ -333,17 +495,19 @@ Int String_CompareRangeI(const String a, Int astart, Int alength, const String b
 /// of code points for each converted code point instead of individual code points.  Only used if the code point delta in the caseTable results
 /// in a zero.</param>
 /// <param name="caseTableCount">The number of pointers to 256-code-point tables found within the caseTable/castTableExtended pointer tables.</param>
+/// <param name="asciiCase">How the caseTable transforms the ASCII range (one of the ASCII_CASE_* values).</param>
 /// <returns>The case-converted string.</returns>
-static String ConvertCase(const String str, Int start, Int length, const Int32 **caseTable, const Int32 ***caseTableExtended, Int32 caseTableCount)
+static String ConvertCase(const String str, Int start, Int length, const Int32 **caseTable, const Int32 ***caseTableExtended, Int32 caseTableCount, Int asciiCase)
 {
 	struct StringBuilderInt sb;
 	StringBuilder stringBuilder;
 	Int32 code, codePageIndex, newCodeValue, numCodeValues;
-	const Int32 *zeroCodePage, *codePage, *codeValues;
+	const Int32 *codePage, *codeValues;
 	const Int32 **extendedCodePage;
-	Int i;
-	Byte ch;
+	Int i, end, runEnd, chunkLength;
 	const Byte *text;
+	Byte chunk[256];
+	String result;
 
 	if (String_IsNullOrEmpty(str)) return (String)str;
 
@@ -361,19 +525,41 @@ static String ConvertCase(const String str, Int start, Int length, const Int32 *
 		length = String_Length(str) - start;
 	}
 
-	stringBuilder = (StringBuilder)&sb;
-	StringBuilder_InitWithSize(stringBuilder, String_Length(str) * 5 / 4);
+	text = String_GetBytes(str);
+	end = start + length;
 
-	zeroCodePage = caseTable[0];
+	// If nothing would change, there's no need to build anything.
+	i = FindFirstCaseChange(str, start, end, caseTable, caseTableCount, asciiCase);
+	if (i >= end)
+		return start == 0 && length == String_Length(str) ? (String)str : String_Substring(str, start, length);
 
-	text = String_GetBytes(str);
-	for (i = start; i < start + length; )
+	// If the rest of the text is pure ASCII, the result is exactly the same size as the
+	// input, so we can convert it directly into a new string without any intermediate copies.
+	if (FindEndOfAscii(text, i, end) >= end)
+	{
+		result = String_CreateInternal(length);
+		MemCpy(result->_opaque.text, text + start, i - start);
+		ConvertAsciiRun(result->_opaque.text + (i - start), text + i, end - i, asciiCase);
+		return result;
+	}
+
+	stringBuilder = (StringBuilder)&sb;
+	StringBuilder_InitWithSize(stringBuilder, length * 5 / 4);
+	StringBuilder_Append(stringBuilder, text, start, i - start);
+
+	while (i < end)
 	{
-		ch = text[i];
-		if (ch < 128)
+		if (text[i] < 128)
 		{
-			i++;
-			StringBuilder_AppendByte(stringBuilder, (Byte)(ch + zeroCodePage[ch]));
+			// Convert the whole run of ASCII, in chunks, eight bytes at a time.
+			runEnd = FindEndOfAscii(text, i, end);
+			while (i < runEnd)
+			{
+				chunkLength = runEnd - i < (Int)sizeof(chunk) ? runEnd - i : (Int)sizeof(chunk);
+				ConvertAsciiRun(chunk, text + i, chunkLength, asciiCase);
+				StringBuilder_Append(stringBuilder, chunk, 0, chunkLength);
+				i += chunkLength;
+			}
 		}
 		else
 		{
@@ -415,7 +601,8 @@ String String_ToLowerRange(const String str, Int start, Int length)
 	return ConvertCase(str, start, length,
 		UnicodeTables_LowercaseTable,
 		UnicodeTables_LowercaseTableExtended,
-		UnicodeTables_LowercaseTableCount);
+		UnicodeTables_LowercaseTableCount,
+		ASCII_CASE_LOWER);
 }
 
 /// <summary>
@@ -431,7 +618,8 @@ String String_ToTitleRange(const String str, Int start, Int length)
 	return ConvertCase(str, start, length,
 		UnicodeTables_TitlecaseTable,
 		UnicodeTables_TitlecaseTableExtended,
-		UnicodeTables_TitlecaseTableCount);
+		UnicodeTables_TitlecaseTableCount,
+		ASCII_CASE_UPPER);
 }
 
 /// <summary>
@@ -447,7 +635,8 @@ String String_ToUpperRange(const String str, Int start, Int length)
 	return ConvertCase(str, start, length,
 		UnicodeTables_UppercaseTable,
 		UnicodeTables_UppercaseTableExtended,
-		UnicodeTables_UppercaseTableCount);
+		UnicodeTables_UppercaseTableCount,
+		ASCII_CASE_UPPER);
 }
 
 /// <summary>
@@ -463,7 +652,8 @@ String String_CaseFoldRange(const String str, Int start, Int length)
 	return ConvertCase(str, start, length,
 		UnicodeTables_CaseFoldingTable,
 		UnicodeTables_CaseFoldingTableExtended,
-		UnicodeTables_CaseFoldingTableCount);
+		UnicodeTables_CaseFoldingTableCount,
+		ASCII_CASE_LOWER);
 }
 
 /// <summary>
@@ -479,7 +669,8 @@ String String_DecomposeRange(const String str, Int start, Int length)
 	return ConvertCase(str, start, length,
 		UnicodeTables_DecompositionTable,
 		UnicodeTables_DecompositionTableExtended,
-		UnicodeTables_DecompositionTableCount);
+		UnicodeTables_DecompositionTableCount,
+		ASCII_CASE_UNCHANGED);
 }
 
 /// <summary>
@@ -1098,30 +1289,219 @@ String String_ConvertKnownCodePageToUtf8Range(const String str, Int start, Int l
 }
 
 /// <summary>
-/// Search through a given string for the first index of a given substring, case-insensitive.
+/// Prepare a pattern for case-insensitive searching.
+/// </summary>
+/// <param name="stringPattern">The pattern structure to fill in.</param>
+/// <param name="pattern">The pattern text to prepare.</param>
+/// <param name="foldPattern">Whether to case-fold a copy of the pattern now (which may allocate
+/// memory), or leave its text unfolded and fold it during each comparison instead.</param>
+static void PreparePattern(StringPatternI stringPattern, const String pattern, Bool foldPattern)
+{
+	const Byte *text, *end;
+	Bool isAscii, hasUpper;
+
+	text = String_GetBytes(pattern);
+	end = text + String_Length(pattern);
+
+	isAscii = True;
+	hasUpper = False;
+	for (; text < end; text++) {
+		if (*text >= 0x80) {
+			isAscii = False;
+			break;
+		}
+		if ((Byte)(*text - 'A') < 26)
+			hasUpper = True;
+	}
+
+	stringPattern->pattern = pattern;
+	stringPattern->text = String_GetBytes(pattern);
+	stringPattern->isAscii = isAscii;
+	stringPattern->isFolded = isAscii && !hasUpper;
+	stringPattern->firstLower = String_Length(pattern) > 0 ? AsciiToLower(String_At(pattern, 0)) : '\0';
+	stringPattern->firstUpper = String_Length(pattern) > 0 ? AsciiToUpper(String_At(pattern, 0)) : '\0';
+
+	if (isAscii && hasUpper && foldPattern) {
+		stringPattern->text = String_GetBytes(String_CaseFold(pattern));
+		stringPattern->isFolded = True;
+	}
+}
+
+/// <summary>
+/// Compare text against a pure-ASCII pattern, case-insensitive, eight bytes at a time.
+/// </summary>
+/// <param name="text">The text to compare against the pattern.  This must have at least 'length' bytes.</param>
+/// <param name="pattern">The pattern bytes to compare against, which must all be 7-bit ASCII.</param>
+/// <param name="length">The number of bytes to compare.</param>
+/// <param name="isFolded">Whether the pattern bytes have already been case-folded.</param>
+/// <returns>1 if the text matches the pattern, 0 if it does not match, or -1 if the text contains
+/// non-ASCII bytes before the first mismatch, in which case the caller must fall back to a full
+/// Unicode-aware comparison.</returns>
+static Int CompareAsciiPatternI(const Byte *text, const Byte *pattern, Int length, Bool isFolded)
+{
+	UInt64 textWord, patternWord;
+	Byte ch;
+
+	while (length >= (Int)sizeof(UInt64)) {
+		textWord = ByteWord_Load(text);
+		if (ByteWord_HasNonAscii(textWord)) return -1;
+		patternWord = ByteWord_Load(pattern);
+		if (!isFolded)
+			patternWord = ByteWord_AsciiToLower(patternWord);
+		if (ByteWord_AsciiToLower(textWord) != patternWord) return 0;
+		text += sizeof(UInt64);
+		pattern += sizeof(UInt64);
+		length -= sizeof(UInt64);
+	}
+
+	while (length-- > 0) {
+		ch = *text++;
+		if (ch >= 0x80) return -1;
+		if (AsciiToLower(ch) != AsciiToLower(*pattern++)) return 0;
+	}
+
+	return 1;
+}
+
+/// <summary>
+/// Prepare a pattern for fast, repeated case-insensitive searching.  The pattern is case-folded
+/// once, up front, so that subsequent searches do not need to fold it again.
+/// </summary>
+/// <param name="pattern">The pattern you would like to search for.</param>
+/// <returns>A new prepared pattern, suitable for passing to StringPatternI_IndexOf() and friends.</returns>
+StringPatternI StringPatternI_Create(const String pattern)
+{
+	StringPatternI stringPattern = GC_MALLOC_STRUCT(struct StringPatternIStruct);
+	if (stringPattern == NULL) Smile_Abort_OutOfMemory();
+	PreparePattern(stringPattern, pattern, True);
+	return stringPattern;
+}
+
+/// <summary>
+/// Prepare a pattern for fast, repeated case-insensitive searching, in a pattern structure you
+/// have already allocated (such as on the stack).
+/// </summary>
+/// <param name="stringPattern">The pattern structure to initialize.</param>
+/// <param name="pattern">The pattern you would like to search for.</param>
+void StringPatternI_Init(StringPatternI stringPattern, const String pattern)
+{
+	PreparePattern(stringPattern, pattern, True);
+}
+
+/// <summary>
+/// Search through a given string for the first index of a prepared pattern, case-insensitive.
+/// Pure-ASCII patterns are matched by skipping eight bytes at a time to each byte that could
+/// start a match, and then comparing the candidate eight bytes at a time; the Unicode case-folding
+/// tables are consulted only where the text contains non-ASCII bytes.
 /// </summary>
+/// <param name="stringPattern">The prepared pattern you would like to search for.</param>
 /// <param name="str">The string you would like to search through.</param>
-/// <param name="pattern">The substring you would like to search for.</param>
 /// <param name="start">The start character index within the string where the search should begin (usually zero).</param>
 /// <returns>The zero-based index of the first match, or -1 if no match is found.</returns>
-Int String_IndexOfI(const String str, const String pattern, Int start)
+Int StringPatternI_IndexOf(const StringPatternI stringPattern, const String str, Int start)
 {
-	Int end, slength, plength;
+	Int end, slength, plength, result;
+	const Byte *text;
+	Byte ch, firstLower, firstUpper;
+	UInt64 word, mask;
 	Bool usedSlowConversion;
 
 	slength = String_Length(str);
-	plength = String_Length(pattern);
+	plength = String_Length(stringPattern->pattern);
 
 	if (start < 0) start = 0;
+	end = slength - plength;
 
-	for (end = slength - plength; start <= end; start++)
-	{
-		if (String_CompareRangeI(pattern, 0, plength, str, start, plength, &usedSlowConversion) == 0)
+	if (!stringPattern->isAscii) {
+		for (; start <= end; start++) {
+			if (String_CompareRangeI(stringPattern->pattern, 0, plength, str, start, plength, &usedSlowConversion) == 0)
+				return start;
+		}
+		return -1;
+	}
+
+	if (plength == 0)
+		return start <= end ? start : -1;
+
+	text = String_GetBytes(str);
+	firstLower = stringPattern->firstLower;
+	firstUpper = stringPattern->firstUpper;
+
+	while (start <= end) {
+
+		// Skip ahead eight bytes at a time to the next byte that could begin a match:  Either
+		// the first pattern character (in either case), or any non-ASCII byte.
+		while (end - start >= (Int)sizeof(UInt64)) {
+			word = ByteWord_Load(text + start);
+			mask = ByteWord_MatchByte(word, firstLower) | ByteWord_MatchByte(word, firstUpper) | (word & BYTEWORD_HIGHS);
+			if (mask) {
+				start += ByteWord_FirstMatch(mask);
+				break;
+			}
+			start += sizeof(UInt64);
+		}
+
+		ch = text[start];
+		if (ch < 0x80 && ch != firstLower && ch != firstUpper) {
+			start++;
+			continue;
+		}
+
+		result = ch < 0x80 ? CompareAsciiPatternI(text + start, stringPattern->text, plength, stringPattern->isFolded) : -1;
+		if (result < 0)
+			result = String_CompareRangeI(stringPattern->pattern, 0, plength, str, start, plength, &usedSlowConversion) == 0;
+		if (result)
 			return start;
+
+		start++;
 	}
+
 	return -1;
 }
 
+/// <summary>
+/// Count the number of instances of a prepared pattern found in the given string.
+/// </summary>
+/// <param name="stringPattern">The prepared pattern to search for in the string.</param>
+/// <param name="str">The string to search in.</param>
+/// <returns>The number of times the pattern can be found within the string,
+/// using a non-overlapping forward linear search.  If the pattern is the empty
+/// string, this will return zero.</returns>
+Int StringPatternI_CountOf(const StringPatternI stringPattern, const String str)
+{
+	Int index, patternLength;
+	Int count;
+
+	if (String_IsNullOrEmpty(stringPattern->pattern) || String_IsNullOrEmpty(str))
+		return 0;
+
+	patternLength = String_Length(stringPattern->pattern);
+	count = 0;
+	index = 0;
+
+	while ((index = StringPatternI_IndexOf(stringPattern, str, index)) >= 0) {
+		count++;
+		index += patternLength;
+	}
+
+	return count;
+}
+
+/// <summary>
+/// Search through a given string for the first index of a given substring, case-insensitive.
+/// </summary>
+/// <param name="str">The string you would like to search through.</param>
+/// <param name="pattern">The substring you would like to search for.</param>
+/// <param name="start">The start character index within the string where the search should begin (usually zero).</param>
+/// <returns>The zero-based index of the first match, or -1 if no match is found.</returns>
+Int String_IndexOfI(const String str, const String pattern, Int start)
+{
+	struct StringPatternIStruct stringPattern;
+
+	PreparePattern(&stringPattern, pattern, False);
+	return StringPatternI_IndexOf(&stringPattern, str, start);
+}
+
 /// <summary>
 /// Search backward through a given string for the last index of a given substring, case-insensitive.
 /// </summary>
@@ -1164,22 +1544,13 @@ Int String_LastIndexOfI(const String str, const String pattern, Int start)
 /// or the empty string, this will return zero.</returns>
 Int String_CountOfI(const String str, const String pattern)
 {
-	Int index, patternLength;
-	Int count;
+	struct StringPatternIStruct stringPattern;
 
 	if (String_IsNullOrEmpty(pattern) || String_IsNullOrEmpty(str))
 		return 0;
 
-	patternLength = String_Length(pattern);
-	count = 0;
-	index = 0;
-
-	while ((index = String_IndexOfI(str, pattern, index)) >= 0) {
-		count++;
-		index += patternLength;
-	}
-
-	return count;
+	PreparePattern(&stringPattern, pattern, False);
+	return StringPatternI_CountOf(&stringPattern, str);
 }
 
 /// <summary>
@@ -1190,7 +1561,13 @@ Int String_CountOfI(const String str, const String pattern)
 /// <returns>True if any part of the string matches the pattern, case-insensitive; False if no part of the string matches the pattern.</returns>
 Bool String_ContainsI(const String str, const String pattern)
 {
-	return String_Length(pattern) <= String_Length(str) && String_IndexOfI(str, pattern, 0) >= 0;
+	struct StringPatternIStruct stringPattern;
+
+	if (String_Length(pattern) > String_Length(str))
+		return False;
+
+	PreparePattern(&stringPattern, pattern, False);
+	return StringPatternI_IndexOf(&stringPattern, str, 0) >= 0;
 }
 
 /// <summary>
@@ -1232,6 +1609,7 @@ Bool String_EndsWithI(const String str, const String pattern)
 String String_ReplaceI(const String str, const String pattern, const String replacement)
 {
 	DECLARE_INLINE_STRINGBUILDER(stringBuilder, 256);
+	struct StringPatternIStruct stringPattern;
 	String r;
 	const Byte *text, *patText, *repText;
 	Int lastEnd, index, patLength, repLength;
@@ -1247,10 +1625,11 @@ String String_ReplaceI(const String str, const String pattern, const String repl
 	repLength = String_Length(r);
 
 	INIT_INLINE_STRINGBUILDER(stringBuilder);
+	PreparePattern(&stringPattern, pattern, False);
 
 	lastEnd = 0;
 	index = 0;
-	while ((index = String_IndexOfI(str, pattern, index)) >= 0) {
+	while ((index = StringPatternI_IndexOf(&stringPattern, str, index)) >= 0) {
 		if (index > lastEnd) {
 			StringBuilder_Append(stringBuilder, text, lastEnd, index - lastEnd);
 		}
@@ -1277,6 +1656,7 @@ String String_ReplaceI(const String str, const String pattern, const String repl
 String String_ReplaceWithLimitI(const String str, const String pattern, const String replacement, Int limit)
 {
 	DECLARE_INLINE_STRINGBUILDER(stringBuilder, 256);
+	struct StringPatternIStruct stringPattern;
 	String r;
 	const Byte *text, *patText, *repText;
 	Int lastEnd, index, patLength, repLength;
@@ -1292,10 +1672,11 @@ String String_ReplaceWithLimitI(const String str, const String pattern, const St
 	repLength = String_Length(r);
 
 	INIT_INLINE_STRINGBUILDER(stringBuilder);
+	PreparePattern(&stringPattern, pattern, False);
 
 	lastEnd = 0;
 	index = 0;
-	while (limit > 0 && (index = String_IndexOfI(str, pattern, index)) >= 0) {
+	while (limit > 0 && (index = StringPatternI_IndexOf(&stringPattern, str, index)) >= 0) {
 		if (index > lastEnd) {
 			StringBuilder_Append(stringBuilder, text, lastEnd, index - lastEnd);
 		}
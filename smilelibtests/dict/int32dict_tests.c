@@ -486,4 +486,112 @@ START_TEST(GetAllReturnsEverything)
 }
 END_TEST
 
+//-------------------------------------------------------------------------------------------------
+//  Small (inline) dictionary tests.
+
+START_TEST(NewDictionariesStartSmallAndNeedNoSeparateStorage)
+{
+	Int32Dict dict = Int32Dict_Create();
+
+	ASSERT(((struct Int32DictInt *)dict)->heap == NULL);
+	ASSERT(((struct Int32DictInt *)dict)->buckets == Int32Dict_SmallBuckets);
+
+	Int32Dict_Add(dict, 5, "five");
+	Int32Dict_Add(dict, 3, "three");
+	ASSERT(((struct Int32DictInt *)dict)->heap == NULL);
+	ASSERT(Int32Dict_Count(dict) == 2);
+	ASSERT(!strcmp((const char *)Int32Dict_GetValue(dict, 3), "three"));
+	ASSERT(Int32Dict_GetValue(dict, 4) == NULL);
+	ASSERT(!Int32Dict_Add(dict, 5, "FIVE"));
+	ASSERT(!strcmp((const char *)Int32Dict_GetValue(dict, 5), "five"));
+}
+END_TEST
+
+START_TEST(SmallDictionariesArePromotedWhenTheyFillUp)
+{
+	Int32Dict dict = Int32Dict_Create();
+	Int32 i;
+
+	for (i = 0; i < INT32DICT_SMALL_SIZE; i++) {
+		Int32Dict_Add(dict, i * 10, (void *)(PtrInt)(i + 1));
+	}
+	ASSERT(((struct Int32DictInt *)dict)->heap == NULL);
+
+	Int32Dict_SetValue(dict, 1000, (void *)(PtrInt)1000);
+	ASSERT(((struct Int32DictInt *)dict)->heap != NULL);
+	ASSERT(Int32Dict_Count(dict) == INT32DICT_SMALL_SIZE + 1);
+
+	for (i = 0; i < INT32DICT_SMALL_SIZE; i++) {
+		ASSERT(Int32Dict_GetValue(dict, i * 10) == (void *)(PtrInt)(i + 1));
+	}
+	ASSERT(Int32Dict_GetValue(dict, 1000) == (void *)(PtrInt)1000);
+}
+END_TEST
+
+START_TEST(CanRemoveAndCloneInSmallDictionaries)
+{
+	Int32Dict dict = Int32Dict_Create(), clone;
+	Int32 *keys;
+
+	Int32Dict_Add(dict, 1, "one");
+	Int32Dict_Add(dict, 2, "two");
+	Int32Dict_Add(dict, 3, "three");
+
+	ASSERT(Int32Dict_Remove(dict, 1));
+	ASSERT(!Int32Dict_Remove(dict, 1));
+	ASSERT(Int32Dict_Count(dict) == 2);
+	ASSERT(!Int32Dict_ContainsKey(dict, 1));
+	ASSERT(!strcmp((const char *)Int32Dict_GetValue(dict, 3), "three"));
+
+	clone = Int32Dict_Clone(dict, NULL, NULL);
+	Int32Dict_Add(clone, 4, "four");
+	ASSERT(Int32Dict_Count(dict) == 2);
+	ASSERT(Int32Dict_Count(clone) == 3);
+	ASSERT(!strcmp((const char *)Int32Dict_GetValue(clone, 2), "two"));
+
+	keys = Int32Dict_GetKeys(dict);
+	ASSERT((keys[0] == 2 && keys[1] == 3) || (keys[0] == 3 && keys[1] == 2));
+}
+END_TEST
+
+//-------------------------------------------------------------------------------------------------
+//  Symbol-key Tests.
+
+START_TEST(LookupsStayCorrectForManySequentialSymbolKeys)
+{
+	Int32Dict dict;
+	Int32 i;
+	void *value;
+
+	// Symbols are handed out sequentially, so this is the shape of key set that object properties
+	// and globals actually see.
+	dict = Int32Dict_Create();
+	for (i = 1; i <= 100000; i++) {
+		ASSERT(Int32Dict_Add(dict, i, (void *)(PtrInt)i));
+	}
+	ASSERT(Int32Dict_Count(dict) == 100000);
+
+	for (i = 1; i <= 100000; i++) {
+		ASSERT(Int32Dict_TryGetValue(dict, i, &value) && value == (void *)(PtrInt)i);
+	}
+
+	// Keys just outside the range, and far outside it, are misses.
+	ASSERT(!Int32Dict_ContainsKey(dict, 0));
+	ASSERT(!Int32Dict_ContainsKey(dict, -1));
+	ASSERT(!Int32Dict_ContainsKey(dict, 100001));
+	ASSERT(!Int32Dict_ContainsKey(dict, 0x7FFFFFFF));
+
+	// Removing every other key leaves the rest findable, and the removed ones gone.
+	for (i = 2; i <= 100000; i += 2) {
+		ASSERT(Int32Dict_Remove(dict, i));
+	}
+	ASSERT(Int32Dict_Count(dict) == 50000);
+
+	for (i = 1; i <= 100000; i++) {
+		ASSERT(Int32Dict_TryGetValue(dict, i, &value) == (i & 1));
+		if (i & 1) ASSERT(value == (void *)(PtrInt)i);
+	}
+}
+END_TEST
+
 #include "int32dict_tests.generated.inc"
@@ -0,0 +1,58 @@
+//---------------------------------------------------------------------------------------
+//  Smile Programming Language Interpreter (Unit Tests)
+//  Copyright 2004-2017 Sean Werkema
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+//---------------------------------------------------------------------------------------
+
+#include "../stdafx.h"
+
+#include <smile/gcstats.h>
+
+TEST_SUITE(GcStatsTests)
+
+START_TEST(GcStatsCountEachCollectionAsOnePause)
+{
+	GcStats before, after;
+
+	Smile_StartGcStats();
+	before = Smile_GetGcStats();
+
+	GC_gcollect();
+	GC_gcollect();
+
+	after = Smile_GetGcStats();
+
+	ASSERT(before->pauseStats->count == 0);
+	ASSERT(after->pauseStats->count == 2);
+	ASSERT(after->numCollections >= before->numCollections + 2);
+	ASSERT(after->totalPauseMilliseconds >= after->totalMarkMilliseconds);
+	ASSERT(after->pauseStats->max <= after->totalPauseMilliseconds);
+}
+END_TEST
+
+START_TEST(GcStatsCanBeRestarted)
+{
+	GcStats stats;
+
+	Smile_StartGcStats();
+	GC_gcollect();
+	Smile_StartGcStats();
+
+	stats = Smile_GetGcStats();
+	ASSERT(stats->pauseStats->count == 0);
+	ASSERT(stats->totalPauseMilliseconds == 0.0);
+}
+END_TEST
+
+#include "gcstats_tests.generated.inc"
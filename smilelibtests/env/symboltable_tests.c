@@ -311,6 +311,33 @@ START_TEST(CanExamineASymbolTableWithoutAlteringItC)
 }
 END_TEST
 
+START_TEST(SymbolTableKeepsAllSymbolsWhenItGrows)
+{
+	SymbolTable symbolTable;
+	Symbol symbols[5000];
+	Int i;
+
+	symbolTable = SymbolTable_Create();
+
+	for (i = 0; i < 5000; i++) {
+		symbols[i] = SymbolTable_GetSymbol(symbolTable, String_Format("sym%d", i));
+		ASSERT(symbols[i] == (Symbol)(i + 1));
+	}
+
+	ASSERT(((struct SymbolTableInt *)symbolTable)->count == 5001);
+	ASSERT(((struct SymbolTableInt *)symbolTable)->max >= 5001);
+
+	for (i = 0; i < 5000; i++) {
+		ASSERT(SymbolTable_GetSymbol(symbolTable, String_Format("sym%d", i)) == symbols[i]);
+		ASSERT(String_Equals(SymbolTable_GetName(symbolTable, symbols[i]), String_Format("sym%d", i)));
+	}
+
+	ASSERT(SymbolTable_GetSymbolNoCreateC(symbolTable, "sym4999") == 5000);
+	ASSERT(SymbolTable_GetSymbolNoCreateC(symbolTable, "sym5000") == 0);
+	ASSERT(SymbolTable_GetName(symbolTable, 5001) == NULL);
+}
+END_TEST
+
 START_TEST(SymbolTablePerformanceTest)
 {
 	SymbolTable symbolTable;
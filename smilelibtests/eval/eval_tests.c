@@ -17,15 +17,24 @@
 
 #include "../stdafx.h"
 
+#include <smile/gcstats.h>
 #include <smile/env/env.h>
 #include <smile/eval/bytecode.h>
 #include <smile/eval/opcode.h>
 #include <smile/eval/compiler.h>
+#include <smile/eval/constantpool.h>
 #include <smile/eval/eval.h>
+#include <smile/eval/closure.h>
+#include <smile/eval/profiler.h>
 #include <smile/parsing/parser.h>
+#include <smile/parsing/internal/parserinternal.h>
 #include <smile/smiletypes/numeric/smileinteger32.h>
 #include <smile/smiletypes/numeric/smileinteger64.h>
+#include <smile/smiletypes/numeric/smileinteger128.h>
 #include <smile/smiletypes/smilebool.h>
+#include <smile/smiletypes/smilearray.h>
+#include <smile/smiletypes/smilemap.h>
+#include <smile/smiletypes/text/smilesymbol.h>
 
 TEST_SUITE(EvalTests)
 
@@ -1063,4 +1072,632 @@ START_TEST(TillLoopEscapesRestoreTheStackState)
 }
 END_TEST
 
+START_TEST(CanEvalEachSplitOverAString)
+{
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var text = \"10,20,,30,40\"\n"
+		"var sum = 0\n"
+		"var count = 0\n"
+		"[text.each-split \",\" |piece index| {\n"
+		"\tcount += 1\n"
+		"\tif piece != \"\" then sum += [piece.int] * index\n"
+		"}]\n"
+		"sum * 100 + count\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == (20 + 90 + 160) * 100 + 5);
+}
+END_TEST
+
+START_TEST(CanEvalEachSplitAndSplitWithACharPattern)
+{
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var text = \"1;22;333\"\n"
+		"var sum = 0\n"
+		"[text.each-split ';' |piece| sum += [piece.int]]\n"
+		"sum * 10 + [[text.split ';'].length]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == (1 + 22 + 333) * 10 + 3);
+}
+END_TEST
+
+START_TEST(CanEvalATillLoopThatEscapesEachSplitEarly)
+{
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var text = \"a;bb;ccc;dddd;eeeee\"\n"
+		"var count = 0\n"
+		"till found-it do {\n"
+		"\t[text.each-split \";\" |piece| {\n"
+		"\t\tcount += 1\n"
+		"\t\tif piece == \"ccc\" then found-it\n"
+		"\t}]\n"
+		"}\n"
+		"count\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == 3);
+}
+END_TEST
+
+START_TEST(CanEvalArrayIndexingAndAppending)
+{
+	SmileArray array;
+
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var a = [Array.of 10 20 30]\n"
+		"[a.append! 40 50]\n"
+		"a:1 = a:1 + a:4\n"
+		"a\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_ARRAY);
+
+	array = (SmileArray)result->value;
+	ASSERT(array->length == 5);
+	ASSERT(SMILE_KIND(array->items[0].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[0].unboxed.i64 == 10);
+	ASSERT(SMILE_KIND(array->items[1].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[1].unboxed.i64 == 70);
+	ASSERT(SMILE_KIND(array->items[4].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[4].unboxed.i64 == 50);
+}
+END_TEST
+
+START_TEST(MemberAssignmentsLeaveTheStackBalanced)
+{
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var add = |x y| x + y\n"
+		"var fill = |a n| {\n"
+		"\tvar i = 0\n"
+		"\ttill done do {\n"
+		"\t\tif i >= n then done\n"
+		"\t\ta:i = 1x\n"
+		"\t\ti += 1\n"
+		"\t}\n"
+		"\t[a.count 1x]\n"
+		"}\n"
+		"var b = [Array.of 1 2 3 4]\n"
+		"[add (b:3 = 7) 100] + [fill [ByteArray.of-size 10000 0x] 10000]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == 107 + 10000);
+}
+END_TEST
+
+START_TEST(ArrayRangesPastTheEndSelectNothing)
+{
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var a = [Array.of 10 20 30]\n"
+		"var past = a:(5..7)\n"
+		"var before = a:(-5..-2)\n"
+		"var overlap = a:(1..7)\n"
+		"var backward = a:(7..1)\n"
+		"past.length * 1000 + before.length * 100 + overlap.length * 10 + backward.length\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == 22);
+}
+END_TEST
+
+START_TEST(CanEvalArrayMapWhereAndEach)
+{
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var a = [`[1 2 3 4 5 6 7 8 9 10].array]\n"
+		"var b = [[a.map |x| x * x].where |x| x mod 2 == 0]\n"
+		"var sum = 0\n"
+		"[b.each |x i| sum += x * (i + 1)]\n"
+		"sum * 100 + b.length\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == (4 * 1 + 16 * 2 + 36 * 3 + 64 * 4 + 100 * 5) * 100 + 5);
+}
+END_TEST
+
+START_TEST(CanEvalArraySortAndConvertBackToAList)
+{
+	static Int64 expectedResult[] = { 1, 2, 3, 5, 8, 13, 21 };
+	Int i;
+	SmileList list;
+
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var a = [`[13 2 21 1 8 3 5].array]\n"
+		"[a.sort!]\n"
+		"[a.list]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_LIST);
+
+	for (i = 0, list = (SmileList)result->value; SMILE_KIND(list) == SMILE_KIND_LIST; list = LIST_REST(list), i++) {
+		ASSERT(SMILE_KIND(list->a) == SMILE_KIND_INTEGER64);
+		ASSERT(((SmileInteger64)list->a)->value == expectedResult[i]);
+	}
+	ASSERT(i == 7);
+}
+END_TEST
+
+START_TEST(CanEvalMapLookupsWithMixedKeys)
+{
+	SmileArray array;
+
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var m = [Map.of 1 \"one\" \"two\" 2 `three 3]\n"
+		"m:1 = \"uno\"\n"
+		"[m.remove! \"two\"]\n"
+		"m:4 = 40\n"
+		"[Array.of m:1 m:`three m:\"two\" m:4 [m.contains? 4] [m.contains? \"two\"] m.length]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_ARRAY);
+
+	array = (SmileArray)result->value;
+	ASSERT(array->length == 7);
+	ASSERT(SMILE_KIND(array->items[0].obj) == SMILE_KIND_STRING && String_EqualsC((String)array->items[0].obj, "uno"));
+	ASSERT(SMILE_KIND(array->items[1].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[1].unboxed.i64 == 3);
+	ASSERT(SMILE_KIND(array->items[2].obj) == SMILE_KIND_NULL);
+	ASSERT(SMILE_KIND(array->items[3].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[3].unboxed.i64 == 40);
+	ASSERT(SMILE_KIND(array->items[4].obj) == SMILE_KIND_UNBOXED_BOOL && array->items[4].unboxed.b);
+	ASSERT(SMILE_KIND(array->items[5].obj) == SMILE_KIND_UNBOXED_BOOL && !array->items[5].unboxed.b);
+	ASSERT(SMILE_KIND(array->items[6].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[6].unboxed.i64 == 3);
+}
+END_TEST
+
+START_TEST(CanEvalIntegerMapGrowthAndIteration)
+{
+	SmileArray array;
+
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var a = [Array.of-size 1000 0]\n"
+		"var m = [Integer64Map.of]\n"
+		"[a.each |x i| m:i = i * 2]\n"
+		"var sum = 0\n"
+		"[m.each |v k| sum += v - k]\n"
+		"var odd = [m.where |v k| k mod 2 == 1]\n"
+		"var doubled = [odd.map |v| v * 2]\n"
+		"[a.each |x i| [m.remove! i]]\n"
+		"[Array.of sum odd.length doubled:999 doubled:10 m.length]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_ARRAY);
+
+	array = (SmileArray)result->value;
+	ASSERT(array->length == 5);
+	ASSERT(SMILE_KIND(array->items[0].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[0].unboxed.i64 == 499500);
+	ASSERT(SMILE_KIND(array->items[1].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[1].unboxed.i64 == 500);
+	ASSERT(SMILE_KIND(array->items[2].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[2].unboxed.i64 == 3996);
+	ASSERT(SMILE_KIND(array->items[3].obj) == SMILE_KIND_NULL);
+	ASSERT(SMILE_KIND(array->items[4].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[4].unboxed.i64 == 0);
+}
+END_TEST
+
+START_TEST(CanEvalNativeSortsOfPrimitiveLists)
+{
+	static const char *expectedStrings[] = { "apple", "banana", "fig", "pear" };
+	SmileArray array;
+	SmileList list;
+	Int i;
+
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var a = [Array.of-size 200 0]\n"
+		"[a.each |x i| a:i = ((i * 37) mod 200) - 100]\n"
+		"var sorted = [[a.list].sort]\n"
+		"var descending = [[a.list].sort |x y| y - x]\n"
+		"var strings = [`[\"pear\" \"apple\" \"fig\" \"banana\"].sort]\n"
+		"[a.sort!]\n"
+		"[Array.of sorted strings descending.a a:0 a:199]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_ARRAY);
+
+	array = (SmileArray)result->value;
+	ASSERT(array->length == 5);
+
+	ASSERT(SMILE_KIND(array->items[0].obj) == SMILE_KIND_LIST);
+	for (i = 0, list = (SmileList)array->items[0].obj; SMILE_KIND(list) == SMILE_KIND_LIST; list = LIST_REST(list), i++) {
+		ASSERT(SMILE_KIND(list->a) == SMILE_KIND_INTEGER64);
+		ASSERT(((SmileInteger64)list->a)->value == i - 100);
+	}
+	ASSERT(i == 200);
+
+	ASSERT(SMILE_KIND(array->items[1].obj) == SMILE_KIND_LIST);
+	for (i = 0, list = (SmileList)array->items[1].obj; SMILE_KIND(list) == SMILE_KIND_LIST; list = LIST_REST(list), i++) {
+		ASSERT(SMILE_KIND(list->a) == SMILE_KIND_STRING);
+		ASSERT(String_EqualsC((String)list->a, expectedStrings[i]));
+	}
+	ASSERT(i == 4);
+
+	ASSERT(SMILE_KIND(array->items[2].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[2].unboxed.i64 == 99);
+	ASSERT(SMILE_KIND(array->items[3].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[3].unboxed.i64 == -100);
+	ASSERT(SMILE_KIND(array->items[4].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[4].unboxed.i64 == 99);
+}
+END_TEST
+
+START_TEST(CanEvalFusedLazySequencePipelines)
+{
+	SmileArray array;
+	SmileList list;
+
+	UserFunctionInfo globalFunctionInfo = Compile(
+		"var calls = 0\n"
+		"var squares = [[`[1 2 3 4 5 6 7 8 9 10].lazy].map |x| { calls += 1\n x * x }]\n"
+		"var big = [[squares.where |x| x > 10].first]\n"
+		"var callsForFirst = calls\n"
+		"var evens = [[[[Array.of 1 2 3 4 5 6 7 8].lazy].where |x| even? x].skip 1]\n"
+		"[Array.of big callsForFirst [evens.count] [[evens.take 2].list] [evens.join \",\"] [evens.any? |x| x > 8] [squares.count]]\n"
+	);
+	EvalResult result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_ARRAY);
+
+	array = (SmileArray)result->value;
+	ASSERT(array->length == 7);
+
+	// 'first' stops pulling items as soon as one makes it through the pipeline.
+	ASSERT(SMILE_KIND(array->items[0].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[0].unboxed.i64 == 16);
+	ASSERT(SMILE_KIND(array->items[1].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[1].unboxed.i64 == 4);
+
+	ASSERT(SMILE_KIND(array->items[2].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[2].unboxed.i64 == 3);
+
+	ASSERT(SMILE_KIND(array->items[3].obj) == SMILE_KIND_LIST);
+	list = (SmileList)array->items[3].obj;
+	ASSERT(SmileList_Length(list) == 2);
+	ASSERT(SMILE_KIND(list->a) == SMILE_KIND_INTEGER64 && ((SmileInteger64)list->a)->value == 4);
+	ASSERT(SMILE_KIND(LIST_SECOND(list)) == SMILE_KIND_INTEGER64 && ((SmileInteger64)LIST_SECOND(list))->value == 6);
+
+	ASSERT(SMILE_KIND(array->items[4].obj) == SMILE_KIND_STRING && String_EqualsC((String)array->items[4].obj, "4,6,8"));
+	ASSERT(SMILE_KIND(array->items[5].obj) == SMILE_KIND_UNBOXED_BOOL && !array->items[5].unboxed.b);
+	ASSERT(SMILE_KIND(array->items[6].obj) == SMILE_KIND_UNBOXED_INTEGER64 && array->items[6].unboxed.i64 == 10);
+}
+END_TEST
+
+static EvalResult EvalIncrementally(Compiler compiler, ParseScope globalScope, const char *text)
+{
+	String source;
+	Lexer lexer;
+	Parser parser;
+	SmileList head, tail;
+	SmileObject expr;
+
+	source = String_FromC(text);
+
+	lexer = Lexer_Create(source, 0, String_Length(source), GetTestScriptName(), 1, 1);
+	lexer->symbolTable = Smile_SymbolTable;
+
+	parser = Parser_Create();
+	parser->lexer = lexer;
+	parser->currentScope = globalScope;
+
+	head = tail = NullList;
+	Parser_ParseExprsOpt(parser, &head, &tail, BINARYLINEBREAKS_DISALLOWED | COMMAMODE_NORMAL | COLONMODE_MEMBERACCESS);
+	ASSERT(parser->firstMessage == NullList);
+
+	expr = (SmileObject)SmileList_ConsWithSource((SmileObject)Smile_KnownObjects._prognSymbol, (SmileObject)head, NULL);
+
+	return Smile_EvalIncrementally(compiler, expr);
+}
+
+START_TEST(CanEvalIncrementallyIntoSharedTables)
+{
+	ClosureInfo globalClosureInfo;
+	ParseScope globalScope;
+	Compiler compiler;
+	EvalResult result;
+	CompiledTables compiledTables;
+	Int i, numStrings;
+	char buffer[64];
+
+	Smile_ResetEnvironment();
+
+	globalClosureInfo = ClosureInfo_Create(NULL, CLOSURE_KIND_GLOBAL);
+	Smile_InitCommonGlobals(globalClosureInfo);
+	Smile_SetGlobalClosureInfo(globalClosureInfo);
+
+	globalScope = ParseScope_CreateRoot();
+	ParseScope_DeclareVariablesFromClosureInfo(globalScope, globalClosureInfo);
+
+	compiler = Smile_CreateIncrementalCompiler(globalClosureInfo);
+	compiledTables = compiler->compiledTables;
+
+	// Functions and variables defined by one input must be usable by later inputs.
+	result = EvalIncrementally(compiler, globalScope, "var f = |x| x * 10");
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	result = EvalIncrementally(compiler, globalScope, "var y = [f 4]");
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+
+	// Enough distinct strings to force the string table to grow a few times.
+	for (i = 0; i < 40; i++) {
+		sprintf(buffer, "var s = \"str%d\"", (int)i);
+		result = EvalIncrementally(compiler, globalScope, buffer);
+		ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	}
+
+	// A failed compile must not disturb the inputs that come after it.  The parser won't let
+	// us assign to 'true', so build the bad expression by hand.
+	result = Smile_EvalIncrementally(compiler, (SmileObject)SmileList_CreateThree(Smile_KnownObjects._setSymbol,
+		SmileSymbol_Create(Smile_KnownSymbols.true_), SmileInteger64_Create(5)));
+	ASSERT(result->evalResultKind == EVAL_RESULT_PARSEERRORS);
+
+	// Repeated constants are shared rather than appended again.
+	numStrings = compiledTables->numStrings;
+	result = EvalIncrementally(compiler, globalScope, "s = \"str0\" + \"str39\"");
+	ASSERT(compiler->compiledTables == compiledTables);
+	ASSERT(compiledTables->numStrings == numStrings);
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_STRING);
+	ASSERT_STRING((String)result->value, "str0str39", 9);
+
+	result = EvalIncrementally(compiler, globalScope, "[f y]");
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == 400);
+}
+END_TEST
+
+// Build the form [$quote [1 2 [x text]]] out of plain list cells, with no source positions.
+static SmileObject QuotedListOf(const char *text)
+{
+	SmileList inner = SmileList_CreateTwo(SmileSymbol_Create(SymbolTable_GetSymbolC(Smile_SymbolTable, "x")),
+		String_FromC(text));
+	SmileList list = SmileList_CreateThree(SmileInteger64_Create(1), SmileInteger64_Create(2), inner);
+	return (SmileObject)SmileList_CreateTwo(Smile_KnownObjects._quoteSymbol, list);
+}
+
+START_TEST(EqualConstantsFromSeparateCompilesAreShared)
+{
+	ClosureInfo globalClosureInfo;
+	ParseScope globalScope;
+	Compiler compiler1, compiler2;
+	EvalResult result1, result2;
+	Int128 bigValue;
+
+	Smile_ResetEnvironment();
+	ASSERT(ConstantPool_Count() == 0);
+
+	globalClosureInfo = ClosureInfo_Create(NULL, CLOSURE_KIND_GLOBAL);
+	Smile_InitCommonGlobals(globalClosureInfo);
+	Smile_SetGlobalClosureInfo(globalClosureInfo);
+
+	globalScope = ParseScope_CreateRoot();
+	ParseScope_DeclareVariablesFromClosureInfo(globalScope, globalClosureInfo);
+
+	// Two compilers means two separate sets of compiled tables.
+	compiler1 = Smile_CreateIncrementalCompiler(globalClosureInfo);
+	compiler2 = Smile_CreateIncrementalCompiler(globalClosureInfo);
+	ASSERT(compiler1->compiledTables != compiler2->compiledTables);
+
+	// Strings.
+	result1 = EvalIncrementally(compiler1, globalScope, "\"shared text\"");
+	result2 = EvalIncrementally(compiler2, globalScope, "\"shared text\"");
+	ASSERT(result1->evalResultKind == EVAL_RESULT_VALUE && result2->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(result1->value == result2->value);
+
+	// Quoted lists without source positions, compared deeply.
+	result1 = Smile_EvalIncrementally(compiler1, QuotedListOf("y"));
+	result2 = Smile_EvalIncrementally(compiler2, QuotedListOf("y"));
+	ASSERT(result1->evalResultKind == EVAL_RESULT_VALUE && result2->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result1->value) == SMILE_KIND_LIST);
+	ASSERT(result1->value == result2->value);
+
+	result2 = Smile_EvalIncrementally(compiler2, QuotedListOf("z"));
+	ASSERT(result2->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(result1->value != result2->value);
+
+	// Quoted lists from the parser carry their own source positions, so they're never shared.
+	result1 = EvalIncrementally(compiler1, globalScope, "`[1 2 [x \"y\"]]");
+	result2 = EvalIncrementally(compiler2, globalScope, "`[1 2 [x \"y\"]]");
+	ASSERT(result1->evalResultKind == EVAL_RESULT_VALUE && result2->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result1->value) == SMILE_KIND_LIST);
+	ASSERT(result1->value != result2->value);
+
+	// Integer128 literals, which the parser doesn't produce, but macros may.
+	bigValue.hi = 1;
+	bigValue.lo = 12345;
+	result1 = Smile_EvalIncrementally(compiler1, (SmileObject)SmileInteger128_CreateInternal(bigValue));
+	result2 = Smile_EvalIncrementally(compiler2, (SmileObject)SmileInteger128_CreateInternal(bigValue));
+	ASSERT(result1->evalResultKind == EVAL_RESULT_VALUE && result2->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result1->value) == SMILE_KIND_INTEGER128);
+	ASSERT(result1->value == result2->value);
+
+	ASSERT(ConstantPool_Count() > 0);
+}
+END_TEST
+
+START_TEST(ProfilerCountsInstructionsPerFunction)
+{
+	UserFunctionInfo globalFunctionInfo;
+	ByteCodeSegment factorialSegment;
+	ProfileEntry globalEntry, factorialEntry;
+	EvalResult result;
+	Int64 numInstructions;
+
+	globalFunctionInfo = Compile(
+		"factorial = |x|\n"
+		"\tif x <= 1 then x\n"
+		"\telse x * [factorial x - 1]\n"
+		"\n"
+		"n = [factorial 10]\n"
+	);
+	factorialSegment = globalFunctionInfo->byteCodeSegment->compiledTables->userFunctions[0]->byteCodeSegment;
+
+	Profiler_Start(0);
+	result = Eval_Run(globalFunctionInfo);
+	Profiler_Stop();
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(((SmileInteger64)result->value)->value == 3628800);
+
+	globalEntry = Profiler_GetEntry(globalFunctionInfo->byteCodeSegment);
+	factorialEntry = Profiler_GetEntry(factorialSegment);
+	ASSERT(globalEntry != NULL);
+	ASSERT(factorialEntry != NULL);
+
+	// Every one of the ten calls runs at least a handful of instructions, and the global
+	// function only runs a few of its own.
+	ASSERT(factorialEntry->numInstructions >= 10 * 4);
+	ASSERT(factorialEntry->numInstructions > globalEntry->numInstructions);
+
+	// Functions are labeled with the name they were assigned to, and where they start.
+	ASSERT(String_StartsWithC(Profiler_GetFunctionLabel(factorialSegment), "factorial ("));
+	ASSERT(String_StartsWithC(Profiler_GetFunctionLabel(globalFunctionInfo->byteCodeSegment), "<global>"));
+
+	// Stopping the profiler stops the counting.
+	numInstructions = factorialEntry->numInstructions;
+	Eval_Run(globalFunctionInfo);
+	ASSERT(factorialEntry->numInstructions == numInstructions);
+}
+END_TEST
+
+START_TEST(AllocationProfilerChargesAllocationsToTheirSourceLines)
+{
+	UserFunctionInfo globalFunctionInfo;
+	EvalResult result;
+	String report;
+
+	globalFunctionInfo = Compile(
+		"build = |n| {\n"
+		"\tvar i = 0, l = null\n"
+		"\ttill done do {\n"
+		"\t\tif i >= n then done\n"
+		"\t\tl = [List.cons i l]\n"
+		"\t\ti = i + 1\n"
+		"\t}\n"
+		"\tl\n"
+		"}\n"
+		"[build 100]\n"
+	);
+
+	// Sample every allocation, so the result is deterministic.
+	Profiler_StartAllocations(1);
+	result = Eval_Run(globalFunctionInfo);
+	Profiler_StopAllocations();
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_LIST);
+
+	// All hundred cons cells were made by line 5 of the build function.
+	report = Profiler_GetAllocationReport(0);
+	ASSERT(String_Contains(report, String_Format("           100          %d  List                 build (%S:5)\n",
+		100 * (Int)sizeof(struct SmileListInt), GetTestScriptName())));
+}
+END_TEST
+
+START_TEST(RuntimeObjectReportsLiveCounters)
+{
+	UserFunctionInfo globalFunctionInfo;
+	EvalResult result;
+	SmileList list;
+	Int64 counts[5];
+	UInt64 numInstructions, numClosures, numSteps;
+	Int i;
+
+	globalFunctionInfo = Compile(
+		"var f = |x| x + 1\n"
+		"var start = [List.of [Runtime.instructions] [Runtime.closures-created] [Runtime.state-machine-steps] [Runtime.time]]\n"
+		"var i = 0\n"
+		"till done do {\n"
+		"\tif i >= 100 then done\n"
+		"\ti = [f i]\n"
+		"}\n"
+		"[[List.of 1 2 3 4 5].each |x| x]\n"
+		"[List.of\n"
+		"\t[Runtime.instructions] - start.a\n"
+		"\t[Runtime.closures-created] - start.d.a\n"
+		"\t[Runtime.state-machine-steps] - start.d.d.a\n"
+		"\t[Runtime.time] - start.d.d.d.a\n"
+		"\t[Runtime.heap-size]\n"
+		"]\n"
+	);
+
+	numInstructions = Eval_GetNumInstructions();
+	numClosures = Closure_NumLocalsCreated;
+	numSteps = Eval_NumStateMachineSteps;
+
+	result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_LIST);
+
+	for (i = 0, list = (SmileList)result->value; i < 5; i++, list = LIST_REST(list)) {
+		ASSERT(SMILE_KIND(list->a) == SMILE_KIND_INTEGER64);
+		counts[i] = ((SmileInteger64)list->a)->value;
+	}
+
+	// A hundred trips around the loop run at least a few instructions each, and each one calls 'f'.
+	ASSERT(counts[0] >= 100 * 4);
+	ASSERT(counts[1] >= 100);
+	ASSERT(counts[2] >= 5);
+	ASSERT(counts[3] >= 0);
+	ASSERT(counts[4] > 0);
+
+	// What the program saw is part of what the interpreter counted.
+	ASSERT(Eval_GetNumInstructions() - numInstructions >= (UInt64)counts[0]);
+	ASSERT(Closure_NumLocalsCreated - numClosures >= (UInt64)counts[1]);
+	ASSERT(Eval_NumStateMachineSteps - numSteps >= (UInt64)counts[2]);
+}
+END_TEST
+
+START_TEST(RuntimeObjectCountsExceptionsThrown)
+{
+	UserFunctionInfo globalFunctionInfo;
+	EvalResult result;
+	UInt64 numExceptions;
+
+	globalFunctionInfo = Compile("[1 2]\n");
+
+	numExceptions = Eval_NumExceptionsThrown;
+	result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_EXCEPTION);
+	ASSERT(Eval_NumExceptionsThrown == numExceptions + 1);
+
+	globalFunctionInfo = Compile("[Runtime.exceptions-thrown]\n");
+	result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value == (Int64)Eval_NumExceptionsThrown);
+}
+END_TEST
+
+START_TEST(RuntimeObjectStartsTimingGcPausesWhenAskedForThem)
+{
+	UserFunctionInfo globalFunctionInfo;
+	EvalResult result;
+
+	globalFunctionInfo = Compile("[Runtime.gc-pause-total]\n");
+	result = Eval_Run(globalFunctionInfo);
+
+	ASSERT(result->evalResultKind == EVAL_RESULT_VALUE);
+	ASSERT(SMILE_KIND(result->value) == SMILE_KIND_INTEGER64);
+	ASSERT(((SmileInteger64)result->value)->value >= 0);
+	ASSERT(Smile_IsCollectingGcStats());
+}
+END_TEST
+
 #include "eval_tests.generated.inc"
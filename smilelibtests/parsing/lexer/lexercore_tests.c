@@ -148,4 +148,32 @@ START_TEST(EqualSeparatorCommentsShouldBeSkipped)
 }
 END_TEST
 
+START_TEST(LongRunsOfWhitespaceAndCommentsShouldTrackLinesAndColumns)
+{
+	Lexer lexer = Setup("                       \t\t\t\t\t                  foo\n"
+		"\n\n\n\n\n\n\n\n\n\n   \n   \n   \n\t\t\t\t\t\t\t\t\t\tbar\n\r"
+		"                                                            \r\n"
+		"// This is a long single-line comment that runs for many words before it ends.\r\n"
+		"/* This is a long multi-line comment that runs for many words.\n"
+		"   It spans several lines, and has a few stars * and ** in it,\r\n"
+		"   and even a slash / or two // before it ends. */ baz\n");
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT(lexer->token->_position.line == 1);
+	ASSERT(lexer->token->_position.column == 46);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT(lexer->token->_position.line == 15);
+	ASSERT(lexer->token->_position.column == 10);
+	ASSERT(lexer->token->isFirstContentOnLine);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT(lexer->token->_position.line == 20);
+	ASSERT(lexer->token->_position.column == 51);
+	ASSERT(lexer->token->isFirstContentOnLine);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_EOI);
+}
+END_TEST
+
 #include "lexercore_tests.generated.inc"
@@ -266,4 +266,25 @@ START_TEST(ShouldRecognizeAlphaOpEqualsForms)
 }
 END_TEST
 
+START_TEST(ShouldRecognizeLongAlphaIdentifiers)
+{
+	Lexer lexer = Setup(
+		"a_very_long_identifier_name_with_digits_0123456789 AnotherLongIdentifierName-withHyphen\n"
+		"abcdefghijklmnop\xCE\xB1 abcdefghijklmnop?\n"
+	);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT_STRING(lexer->token->text, "a_very_long_identifier_name_with_digits_0123456789", 50);
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT_STRING(lexer->token->text, "AnotherLongIdentifierName-withHyphen", 36);
+
+	// Mixing character sets is still an error, even when the Latin part is long.
+	ASSERT(Lexer_Next(lexer) == TOKEN_ERROR);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT_STRING(lexer->token->text, "abcdefghijklmnop?", 17);
+	ASSERT(Lexer_Next(lexer) == TOKEN_EOI);
+}
+END_TEST
+
 #include "lexeridentifier_tests.generated.inc"
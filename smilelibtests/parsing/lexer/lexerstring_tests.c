@@ -211,4 +211,29 @@ START_TEST(ShouldRecognizeMultiLineDynamicStrings)
 }
 END_TEST
 
+START_TEST(ShouldRecognizeLongStrings)
+{
+	Lexer lexer = Setup(
+		"x = \"This is a long string, with a \\\"quote\\\" and a \\\\ backslash, and more text.\"\n"
+		"y = '''This is a long raw string, with an ' and '' in it\n"
+		"that spans two lines of text.''' z\n"
+	);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT(Lexer_Next(lexer) == TOKEN_EQUAL);
+	ASSERT(Lexer_Next(lexer) == TOKEN_DYNSTRING);
+	ASSERT_STRING(lexer->token->text, "This is a long string, with a \\\"quote\\\" and a \\\\ backslash, and more text.", 74);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT(lexer->token->_position.line == 2);
+	ASSERT(Lexer_Next(lexer) == TOKEN_EQUAL);
+	ASSERT(Lexer_Next(lexer) == TOKEN_RAWSTRING);
+	ASSERT_STRING(lexer->token->text, "This is a long raw string, with an ' and '' in it\nthat spans two lines of text.", 79);
+
+	ASSERT(Lexer_Next(lexer) == TOKEN_ALPHANAME);
+	ASSERT(lexer->token->_position.line == 3);
+	ASSERT(Lexer_Next(lexer) == TOKEN_EOI);
+}
+END_TEST
+
 #include "lexerstring_tests.generated.inc"
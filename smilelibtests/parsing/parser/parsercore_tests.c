@@ -455,6 +455,28 @@ START_TEST(CanParseTheColonOperator)
 }
 END_TEST
 
+START_TEST(OpEqualsKeepsItsOperatorAfterALongRValue)
+{
+	static const char *names[] = { "x", "f", "a", "b", "c", "d", "e", "g", "h", "i", "j", "k", "l", "m", "n", "o", "p", "q" };
+	Lexer lexer = SetupLexer("\t x += [f a b c d e g h i j k l m n o p q] \n x -= 1 \n");
+	Parser parser = Parser_Create();
+	ParseScope parseScope = ParseScope_CreateRoot();
+	SmileObject result, expectedResult;
+	Int i;
+
+	for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+		ParseScope_DeclareHere(parseScope, SymbolTable_GetSymbolC(Smile_SymbolTable, names[i]), PARSEDECL_VARIABLE, NULL, NULL);
+	}
+
+	// The rvalue is longer than the lexer's token buffer, so the operator's token gets recycled.
+	result = Parser_Parse(parser, lexer, parseScope);
+
+	expectedResult = SimpleParse("[$progn [$opset + x [f a b c d e g h i j k l m n o p q]] [$opset - x 1] ]");
+
+	ASSERT(RecursiveEquals(result, expectedResult));
+}
+END_TEST
+
 START_TEST(CanParseTheRangeOperator)
 {
 	Lexer lexer = SetupLexer("\t 1..10 \n -5..+5 \n");
@@ -588,4 +610,52 @@ START_TEST(CanParseTheSpecialDoubleHashOperator)
 }
 END_TEST
 
+//-------------------------------------------------------------------------------------------------
+//  Source-position tests.
+
+START_TEST(ParsedListsRememberWhereTheyCameFrom)
+{
+	Lexer lexer = SetupLexer("1 2\n   [3 4]\n");
+	Parser parser = Parser_Create();
+	ParseScope parseScope = ParseScope_CreateRoot();
+	SmileObject result = Parser_Parse(parser, lexer, parseScope);
+	struct LexerPositionStruct positionBuffer;
+	LexerPosition position;
+	SmileList inner;
+
+	ASSERT(SMILE_KIND(result) == SMILE_KIND_LIST);
+	inner = (SmileList)((SmileList)((SmileList)((SmileList)result)->d)->d)->d;
+	ASSERT(SMILE_KIND(inner) == SMILE_KIND_LIST);
+	inner = (SmileList)inner->a;
+	ASSERT(SMILE_KIND(inner) == SMILE_KIND_LIST);
+
+	position = SmileList_GetSourcePosition(inner, &positionBuffer);
+	ASSERT(position == &positionBuffer);
+	ASSERT(String_Equals(position->filename, GetTestScriptName()));
+	ASSERT(position->line == 2);
+	ASSERT(position->column == 4);
+
+	position = SMILE_VCALL(inner, getSourceLocation);
+	ASSERT(position != NULL && position != &positionBuffer);
+	ASSERT(String_Equals(position->filename, GetTestScriptName()));
+	ASSERT(position->line == 2);
+	ASSERT(position->column == 4);
+
+	ASSERT(SmileList_GetSourcePosition(SmileList_Cons(NullObject, NullObject), &positionBuffer) == NULL);
+}
+END_TEST
+
+START_TEST(InternedFilenamesAreStable)
+{
+	Int32 id = Lexer_InternFilename(String_FromC("interned-test.sm"));
+
+	ASSERT(id > 0);
+	ASSERT(Lexer_InternFilename(String_FromC("interned-test.sm")) == id);
+	ASSERT(Lexer_InternFilename(String_FromC("interned-test-2.sm")) != id);
+	ASSERT(String_Equals(Lexer_GetInternedFilename(id), String_FromC("interned-test.sm")));
+	ASSERT(Lexer_InternFilename(NULL) == 0);
+	ASSERT(Lexer_GetInternedFilename(0) == NULL);
+}
+END_TEST
+
 #include "parsercore_tests.generated.inc"
@@ -565,4 +565,88 @@ START_TEST(CannotAddRulesWhoseInitialNonterminalsRepeatZeroOrOneTimes)
 }
 END_TEST
 
+//-------------------------------------------------------------------------------------------------
+//  Shared (copy-on-write) syntax-table tests.
+
+START_TEST(AddingRulesToASharedSyntaxTableDoesNotChangeIt)
+{
+	ParserSyntaxClass parentCls, childCls;
+	ParserSyntaxTable parentTable, childTable;
+	Parser parser = Parser_Create();
+
+	SmileSyntax ifRule = (SmileSyntax)FullParse("#syntax STMT: [if [EXPR x] then [STMT y]] => [$if (x) (y)]");
+	SmileSyntax ifElseRule = (SmileSyntax)FullParse("#syntax STMT: [if [EXPR x] then [STMT y] else [STMT z]] => [$if (x) (y) (z)]");
+
+	parentTable = ParserSyntaxTable_CreateNew();
+	ASSERT(ParserSyntaxTable_AddRule(parser, &parentTable, ifRule));
+
+	// A child scope shares its parent's table until it adds a rule of its own.
+	childTable = parentTable;
+	ParserSyntaxTable_AddRef(childTable);
+	ASSERT(ParserSyntaxTable_AddRule(parser, &childTable, ifElseRule));
+
+	ASSERT(childTable != parentTable);
+	ASSERT(childTable->referenceCount == 2);	// The child scope, and the parent's memo of it.
+	ASSERT(parentTable->referenceCount == 1);
+
+	parentCls = GetSyntaxClassSafely(parentTable, "STMT");
+	childCls = GetSyntaxClassSafely(childTable, "STMT");
+	ASSERT(parentCls != NULL && childCls != NULL && parentCls != childCls);
+	ASSERT(parentTable->stmtClass == parentCls);
+	ASSERT(childTable->stmtClass == childCls);
+
+	// The parent must still have only the original rule, while the child has both.
+	ASSERT(WalkSyntaxPattern(parentCls, "if; EXPR x; then; STMT y") != NULL);
+	ASSERT(WalkSyntaxPattern(parentCls, "if; EXPR x; then; STMT y; else") == NULL);
+	ASSERT(WalkSyntaxPattern(childCls, "if; EXPR x; then; STMT y") != NULL);
+	ASSERT(WalkSyntaxPattern(childCls, "if; EXPR x; then; STMT y; else; STMT z") != NULL);
+
+	// The part of the tree the child didn't change stays shared.
+	ASSERT(WalkSyntaxPattern(parentCls, "if; EXPR x; then; STMT y")->nextTerminals == NULL);
+	ASSERT(WalkSyntaxPattern(childCls, "if; EXPR x")->nextTerminals != NULL);
+
+	ASSERT(Parser_GetErrorCount(parser) == 0);
+}
+END_TEST
+
+START_TEST(AddingTheSameRuleToASharedSyntaxTableReusesTheDerivedTable)
+{
+	ParserSyntaxTable parentTable, firstChildTable, secondChildTable;
+	ParserSyntaxNode node;
+	Int32Dict transitionTable;
+	Parser parser = Parser_Create();
+
+	SmileSyntax rule = (SmileSyntax)FullParse("#syntax STMT: [loop [EXPR x] do [STMT y]] => [$while (x) (y)]");
+	SmileSyntax sameRule = (SmileSyntax)FullParse("#syntax STMT: [loop [EXPR x] do [STMT y]] => [$while (x) (y)]");
+	SmileSyntax otherRule = (SmileSyntax)FullParse("#syntax STMT: [loop [EXPR x] do [STMT y]] => [$till (x) (y)]");
+
+	parentTable = ParserSyntaxTable_CreateNew();
+
+	firstChildTable = parentTable;
+	ParserSyntaxTable_AddRef(firstChildTable);
+	ASSERT(ParserSyntaxTable_AddRule(parser, &firstChildTable, rule));
+	ASSERT(firstChildTable != parentTable);
+
+	node = WalkSyntaxPattern(GetSyntaxClassSafely(firstChildTable, "STMT"), "loop");
+	ASSERT(node != NULL);
+	transitionTable = ParserSyntaxTable_GetTransitionTable(parser, firstChildTable, node);
+	ASSERT(transitionTable != NULL);
+
+	// A second child adding an equal rule gets the same table, with its transition tables already computed.
+	secondChildTable = parentTable;
+	ParserSyntaxTable_AddRef(secondChildTable);
+	ASSERT(ParserSyntaxTable_AddRule(parser, &secondChildTable, sameRule));
+	ASSERT(secondChildTable == firstChildTable);
+	ASSERT(ParserSyntaxTable_GetTransitionTable(parser, secondChildTable, node) == transitionTable);
+
+	// But a different rule gets a different table.
+	secondChildTable = parentTable;
+	ParserSyntaxTable_AddRef(secondChildTable);
+	ASSERT(ParserSyntaxTable_AddRule(parser, &secondChildTable, otherRule));
+	ASSERT(secondChildTable != firstChildTable);
+
+	ASSERT(Parser_GetErrorCount(parser) == 0);
+}
+END_TEST
+
 #include "parsersyntax_table_tests.generated.inc"
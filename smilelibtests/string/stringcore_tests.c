@@ -762,6 +762,42 @@ START_TEST(SubstringExtractsNothingAtOrAfterTheEndOfTheString)
 }
 END_TEST
 
+START_TEST(LongSubstringsShareTheirParentsBytes)
+{
+	String str1 = String_Concat(String_CreateRepeat('a', 100), String_CreateRepeat('b', 100));
+	String str2 = String_Substring(str1, 50, 100);
+	String str3 = String_Substring(str2, 25, 75);
+	String str4 = String_SubstringAt(str1, 100);
+
+	ASSERT(String_Length(str2) == 100);
+	ASSERT(String_GetBytes(str2) == String_GetBytes(str1) + 50);
+	ASSERT(String_GetBytes(str3) == String_GetBytes(str1) + 75);
+	ASSERT(String_GetBytes(str4) == String_GetBytes(str1) + 100);
+	ASSERT(String_Equals(str2, String_Concat(String_CreateRepeat('a', 50), String_CreateRepeat('b', 50))));
+	ASSERT(String_Equals(str4, String_CreateRepeat('b', 100)));
+
+	// Asking for a C string returns a terminated copy, without changing the slice or its parent.
+	ASSERT(String_ToC(str2)[100] == '\0');
+	ASSERT((const Byte *)String_ToC(str2) != String_GetBytes(str2));
+	ASSERT(String_GetBytes(str2) == String_GetBytes(str1) + 50);
+	ASSERT(String_At(str1, 150) == 'b');
+	ASSERT(String_Equals(str3, String_Concat(String_CreateRepeat('a', 25), String_CreateRepeat('b', 50))));
+}
+END_TEST
+
+START_TEST(SmallSubstringsOfHugeStringsAreCopied)
+{
+	String str1 = String_CreateRepeat('x', 10000);
+	String str2 = String_Substring(str1, 100, 100);
+	String str3 = String_Substring(str1, 100, 10);
+
+	ASSERT(String_GetBytes(str2) != String_GetBytes(str1) + 100);
+	ASSERT(String_GetBytes(str3) != String_GetBytes(str1) + 100);
+	ASSERT(String_Equals(str2, String_CreateRepeat('x', 100)));
+	ASSERT(String_GetBytes(str2)[100] == '\0');
+}
+END_TEST
+
 START_TEST(AtExtractsIndividualCharacters)
 {
 	String str = String_FromC("This is a test.");
@@ -812,6 +848,50 @@ START_TEST(ConcatByteTacksOnBytes)
 }
 END_TEST
 
+START_TEST(RepeatedConcatBuildsLongStringsCorrectly)
+{
+	String piece = String_FromC("abcdefghij");
+	String str = String_Empty;
+	StringBuilder stringBuilder = StringBuilder_Create();
+	Int i;
+
+	for (i = 0; i < 1000; i++) {
+		str = String_Concat(str, piece);
+		str = String_ConcatByte(str, (Byte)('0' + i % 10));
+		StringBuilder_AppendString(stringBuilder, piece);
+		StringBuilder_AppendByte(stringBuilder, (Byte)('0' + i % 10));
+	}
+
+	ASSERT(String_Length(str) == 11000);
+	ASSERT(String_Equals(str, StringBuilder_ToString(stringBuilder)));
+	ASSERT(String_Hash(str) == String_Hash(StringBuilder_ToString(stringBuilder)));
+}
+END_TEST
+
+START_TEST(ConcatenatedStringsCanBeSharedAndReused)
+{
+	String head = String_CreateRepeat('x', 300);
+	String tail = String_CreateRepeat('y', 300);
+	String both = String_Concat(head, tail);
+	String withA = String_Concat(both, String_FromC("A"));
+	String withB = String_Concat(both, String_FromC("B"));
+	String doubled = String_Concat(withA, withB);
+
+	ASSERT(String_Length(withA) == 601);
+	ASSERT(String_At(withA, 600) == 'A');
+	ASSERT(String_At(withB, 600) == 'B');
+	ASSERT(String_At(both, 299) == 'x' && String_At(both, 300) == 'y');
+	ASSERT(String_GetBytes(both)[600] == '\0');
+
+	ASSERT(String_Length(doubled) == 1202);
+	ASSERT(String_At(doubled, 600) == 'A');
+	ASSERT(String_At(doubled, 601) == 'x');
+	ASSERT(String_At(doubled, 1201) == 'B');
+	ASSERT(String_IndexOf(doubled, String_FromC("yAx"), 0) == 599);
+	ASSERT(String_Compare(withA, withB) < 0);
+}
+END_TEST
+
 //-------------------------------------------------------------------------------------------------
 //  Content-searching tests
 
@@ -157,6 +157,26 @@ END_TEST
 //-------------------------------------------------------------------------------------------------
 //  Extra-function tests.
 
+START_TEST(SplitSharesTheBytesOfLongPieces)
+{
+	String line = String_CreateRepeat('x', 100);
+	String newline = String_FromC("\n");
+	String text = String_Concat(String_Concat(String_Concat(line, newline), String_Concat(line, newline)), String_FromC("short"));
+	String *pieces;
+	Int numPieces;
+
+	numPieces = String_SplitWithOptions(text, newline, -1, 0, &pieces);
+
+	ASSERT(numPieces == 3);
+	ASSERT(String_GetBytes(pieces[0]) == String_GetBytes(text));
+	ASSERT(String_GetBytes(pieces[1]) == String_GetBytes(text) + 101);
+	ASSERT(String_Equals(pieces[0], line));
+	ASSERT(String_Equals(pieces[1], line));
+	ASSERT_STRING(pieces[2], "short", 5);
+	ASSERT(String_ToC(pieces[1])[100] == '\0');
+}
+END_TEST
+
 START_TEST(RawReverseReordersText)
 {
 	ASSERT_STRING(String_RawReverse(String_Empty), NULL, 0);
@@ -378,6 +378,69 @@ START_TEST(ContainsIDoesNotFindContentWhenItDoesNotExist)
 }
 END_TEST
 
+START_TEST(CompareIShouldLexicallyOrderLongAsciiStringsThatDifferByCase)
+{
+	ASSERT(String_CompareI(String_FromC("The Quick Brown Fox Jumps Over The Lazy Dog"), String_FromC("the quick brown fox jumps over the lazy dog")) == 0);
+	ASSERT(String_CompareI(String_FromC("The Quick Brown Fox Jumps Over The Lazy Dog"), String_FromC("the quick brown fox jumps over the lazy cat")) > 0);
+	ASSERT(String_CompareI(String_FromC("THE QUICK BROWN FOX"), String_FromC("the quick brown fox jumps")) < 0);
+	ASSERT(String_CompareI(String_FromC("Long ASCII prefix, then Wasserschlo\xC3\x9F"), String_FromC("LONG ascii PREFIX, THEN wasserschloss")) == 0);
+}
+END_TEST
+
+START_TEST(IndexOfIFindsNonAsciiMatchesInsideLongAsciiText)
+{
+	String str1 = String_FromC("A long run of plain ASCII text before we reach the Wasserschlo\xC3\x9F at last.");
+	String str2 = String_FromC("SCHLOSS AT");
+	String str3 = String_FromC("\xC3\x9F AT LAST");
+
+	ASSERT(String_IndexOfI(str1, String_FromC("REACH THE"), 0) == 41);
+	ASSERT(String_IndexOfI(str1, str2, 0) == 57);
+	ASSERT(String_IndexOfI(str1, String_FromC("SS AT"), 0) == 62);
+	ASSERT(String_IndexOfI(str1, str3, 0) == 62);
+	ASSERT(String_IndexOfI(str1, String_FromC("SCHLOSS IN"), 0) == -1);
+}
+END_TEST
+
+START_TEST(CountOfIAndReplaceIWorkOnLongAsciiText)
+{
+	String str = String_FromC("Error: disk full; ERROR: retrying; error: giving up; no more errors.");
+
+	ASSERT(String_CountOfI(str, String_FromC("error")) == 4);
+	ASSERT(String_CountOfI(str, String_FromC("ERROR:")) == 3);
+	ASSERT(String_EqualsC(String_ReplaceI(str, String_FromC("error:"), String_FromC("warn:")),
+		"warn: disk full; warn: retrying; warn: giving up; no more errors."));
+}
+END_TEST
+
+START_TEST(PreparedPatternsCanBeSearchedRepeatedly)
+{
+	StringPatternI pattern = StringPatternI_Create(String_FromC("EmErGeNcY"));
+	String str1 = String_FromC("This is a test of the emergency broadcasting system.");
+	String str2 = String_FromC("EMERGENCY! Emergency! emergency!");
+	String str3 = String_FromC("This is only a test.");
+
+	ASSERT(StringPatternI_IndexOf(pattern, str1, 0) == 22);
+	ASSERT(StringPatternI_IndexOf(pattern, str2, 1) == 11);
+	ASSERT(StringPatternI_IndexOf(pattern, str3, 0) == -1);
+	ASSERT(StringPatternI_Contains(pattern, str1));
+	ASSERT(!StringPatternI_Contains(pattern, str3));
+	ASSERT(StringPatternI_CountOf(pattern, str2) == 3);
+}
+END_TEST
+
+START_TEST(PreparedPatternsCanContainUnicode)
+{
+	struct StringPatternIStruct pattern;
+	String str = String_FromC("This is a tesst of the emerg\xC3\x89ncy broadcasting syst\xC3\xA9m.");
+
+	StringPatternI_Init(&pattern, String_FromC("EmErG\xC3\xA9NcY"));
+	ASSERT(StringPatternI_IndexOf(&pattern, str, 0) == 23);
+
+	StringPatternI_Init(&pattern, String_FromC("TE\xC3\x9FT"));
+	ASSERT(StringPatternI_IndexOf(&pattern, str, 0) == 10);
+}
+END_TEST
+
 //-------------------------------------------------------------------------------------------------
 //  Case-Insensitive Starts-With Tests
 
@@ -501,6 +564,29 @@ START_TEST(ToLowerConvertsUnicodeToLowercase)
 }
 END_TEST
 
+START_TEST(ToLowerReturnsTheOriginalStringWhenNothingChanges)
+{
+	String str = String_FromC("pack my box with five dozen liquor jugs.");
+	String unicodeStr = String_FromC("pack my box with five doz\xC3\xA9n liquor jugs.");
+
+	ASSERT(String_ToLower(str) == str);
+	ASSERT(String_ToLower(unicodeStr) == unicodeStr);
+	ASSERT(String_CaseFold(str) == str);
+	ASSERT(String_Decompose(str) == str);
+
+	ASSERT_STRING(String_ToLowerRange(str, 5, 6), "my box", 6);
+}
+END_TEST
+
+START_TEST(ToLowerConvertsLongMixedAsciiAndUnicodeRuns)
+{
+	ASSERT_STRING(String_ToLower(String_FromC("THE QUICK BROWN FOX \xC3\x89\xC3\x89 JUMPS OVER THE LAZY DOG \xC3\x89")),
+		"the quick brown fox \xC3\xA9\xC3\xA9 jumps over the lazy dog \xC3\xA9", 51);
+	ASSERT_STRING(String_ToLowerRange(String_FromC("pack my box WITH FIVE DOZEN liquor jugs."), 12, 15), "with five dozen", 15);
+	ASSERT_STRING(String_ToLowerRange(String_FromC("pack my box WITH FIVE DOZ\xC3\x89N liquor jugs."), 12, 16), "with five doz\xC3\xA9n", 16);
+}
+END_TEST
+
 //-------------------------------------------------------------------------------------------------
 //  ToUpper Tests
 
@@ -525,6 +611,16 @@ START_TEST(ToUpperConvertsUnicodeToUppercase)
 }
 END_TEST
 
+START_TEST(ToUpperReturnsTheOriginalStringWhenNothingChanges)
+{
+	String str = String_FromC("PACK MY BOX WITH FIVE DOZEN LIQUOR JUGS. 0123456789 [@`{~]");
+
+	ASSERT(String_ToUpper(str) == str);
+	ASSERT(String_ToTitle(str) == str);
+	ASSERT(String_ToLower(str) != str);
+}
+END_TEST
+
 //-------------------------------------------------------------------------------------------------
 //  ToTitle Tests
 
@@ -36,6 +36,11 @@ typedef struct CommandLineArgsStruct {
 	Bool printLineInLoop;		// -p
 	Bool outputResult;			// -o
 	Bool warningsAsErrors;		// --warnings-as-errors
+	Bool incrementalGc;			// --gc-incremental[=ms]
+	Int gcPauseTarget;			// --gc-incremental=ms
+	Bool gcStats;				// --gc-stats
+	String profileFile;			// --profile=file
+	Int allocProfile;			// --alloc-profile[=N]
 	SmileList globalDefinitions, globalDefinitionsTail;		// -Dfoo=bar
 	SmileList scriptArgs, scriptArgsTail;					// -- ...args...
 } *CommandLineArgs;
@@ -102,6 +107,19 @@ static void PrintHelp()
 		"  \033[0;1;36m-o             \033[0;37mPrint program's resulting value to Stdout\n"
 		"  \033[0;1;36m-p             \033[0;37mLike '-n', but also add \"Stdout print line\" in the loop\n"
 		"\n"
+		"\033[0;37;1mMemory options:\033[0;37m\n"
+		"  \033[0;1;36m--gc-incremental\033[0;36m[=ms]\n"
+		"                 \033[0;37mCollect garbage incrementally, aiming for pauses under 'ms'\n"
+		"  \033[0;1;36m--gc-stats     \033[0;37mPrint the garbage collector's pause times on exit\n"
+		"\n"
+		"\033[0;37;1mProfiling options:\033[0;37m\n"
+		"  \033[0;1;36m--profile=\033[0;36mfile\n"
+		"                 \033[0;37mProfile the program, writing folded stacks (for flamegraph.pl)\n"
+		"                 to 'file', and printing a per-function summary on exit\n"
+		"  \033[0;1;36m--alloc-profile\033[0;36m[=N]\n"
+		"                 \033[0;37mSample about one allocation in every 'N', and print the top\n"
+		"                 allocation sites on exit\n"
+		"\n"
 		"\033[0;37;1mInformation options:\033[0;37m\n"
 		"  \033[0;1;36m-h --help      \033[0;37mHelp (you're looking at it)\n"
 		"  \033[0;1;36m-q --quiet     \033[0;37mDo not display any warning messages\n"
@@ -223,6 +241,11 @@ static CommandLineArgs CommandLineArgs_Create(void)
 	options->printLineInLoop = False;
 	options->outputResult = False;
 	options->warningsAsErrors = False;
+	options->incrementalGc = False;
+	options->gcPauseTarget = 0;
+	options->gcStats = False;
+	options->profileFile = NULL;
+	options->allocProfile = 0;
 
 	options->globalDefinitions = options->globalDefinitionsTail = NullList;
 	options->scriptArgs = options->scriptArgsTail = NullList;
@@ -264,6 +287,36 @@ static CommandLineArgs ParseCommandLine(int argc, const char **argv)
 								options->verbose = True;
 							}
 							break;
+						case 'a':
+							if (!strcmp(argv[i] + 2, "alloc-profile")) {
+								options->allocProfile = -1;
+							}
+							else if (!strncmp(argv[i] + 2, "alloc-profile=", 14)) {
+								options->allocProfile = (Int)atoi(argv[i] + 16);
+								if (options->allocProfile <= 0) goto unknownArgument;
+							}
+							else goto unknownArgument;
+							break;
+						case 'g':
+							if (!strcmp(argv[i] + 2, "gc-stats")) {
+								options->gcStats = True;
+							}
+							else if (!strcmp(argv[i] + 2, "gc-incremental")) {
+								options->incrementalGc = True;
+							}
+							else if (!strncmp(argv[i] + 2, "gc-incremental=", 15)) {
+								options->incrementalGc = True;
+								options->gcPauseTarget = (Int)atoi(argv[i] + 17);
+								if (options->gcPauseTarget <= 0) goto unknownArgument;
+							}
+							else goto unknownArgument;
+							break;
+						case 'p':
+							if (!strncmp(argv[i] + 2, "profile=", 8) && argv[i][10] != '\0') {
+								options->profileFile = String_FromC(argv[i] + 10);
+							}
+							else goto unknownArgument;
+							break;
 						case 'w':
 							if (!strcmp(argv[i] + 2, "warnings-as-errors")) {
 								options->warningsAsErrors = True;
@@ -422,6 +475,26 @@ static String LoadFile(String filename)
 	return StringBuilder_ToString(stringBuilder);
 }
 
+static void WriteProfile(String filename)
+{
+	FILE *fp;
+	String foldedStacks, summary;
+
+	// The samples go to the file, for flamegraph.pl; the summary goes to stderr, like the GC stats.
+	if ((fp = fopen(String_ToC(filename), "wb")) == NULL) {
+		Error("smile", 0, "Cannot open \"%s\" for writing.", String_ToC(filename));
+	}
+	else {
+		foldedStacks = Profiler_GetFoldedStacks();
+		fwrite(String_GetBytes(foldedStacks), 1, String_Length(foldedStacks), fp);
+		fclose(fp);
+	}
+
+	summary = Profiler_GetSummary();
+	fwrite(String_GetBytes(summary), 1, String_Length(summary), stderr);
+	fflush(stderr);
+}
+
 static ClosureInfo SetupGlobalClosureInfo(CommandLineArgs options)
 {
 	SmileList list;
@@ -602,6 +675,14 @@ static int SmileMain(int argc, const char **argv)
 	if ((options = ParseCommandLine(argc, argv)) == NULL)
 		return -1;
 
+	// Configure the garbage collector before we start allocating in earnest.
+	if (options->incrementalGc) {
+		if (!Smile_EnableIncrementalGc(options->gcPauseTarget) && !options->quiet)
+			Error("smile", 0, "Incremental garbage collection is not supported on this platform.");
+	}
+	if (options->gcStats)
+		Smile_StartGcStats();
+
 	// If they gave us nothing to do, and requested "-v", then print the version number and
 	// exit.  Otherwise, fall into the REPL.
 	if (options->scriptName == NULL && options->script == NULL) {
@@ -648,6 +729,18 @@ static int SmileMain(int argc, const char **argv)
 			Verbose("Wrap with while loop: true");
 		if (options->printLineInLoop)
 			Verbose("Print line in loop: true");
+		if (options->incrementalGc)
+			Verbose("Incremental GC: true");
+		if (options->gcPauseTarget > 0)
+			Verbose("GC pause target: %d ms", (int)options->gcPauseTarget);
+		if (options->gcStats)
+			Verbose("GC stats: true");
+		if (options->profileFile != NULL)
+			Verbose("Profile output: \"%s\"", String_ToC(options->profileFile));
+		if (options->allocProfile > 0)
+			Verbose("Allocation profile: one in %d", (int)options->allocProfile);
+		else if (options->allocProfile < 0)
+			Verbose("Allocation profile: true");
 		if (options->scriptName != NULL) {
 			Verbose("Script name: \"%s\"", String_ToC(options->scriptName));
 			if (options->scriptArgs != NullList)
@@ -682,7 +775,22 @@ static int SmileMain(int argc, const char **argv)
 		result = NullObject;
 	}
 	else {
+		if (options->profileFile != NULL)
+			Profiler_Start(0);
+		if (options->allocProfile != 0)
+			Profiler_StartAllocations(options->allocProfile > 0 ? options->allocProfile : 0);
 		exitCode = ParseAndEval(options, script, scriptName, 1, &result);
+		if (options->profileFile != NULL) {
+			Profiler_Stop();
+			WriteProfile(options->profileFile);
+		}
+		if (options->allocProfile != 0) {
+			String allocationReport;
+			Profiler_StopAllocations();
+			allocationReport = Profiler_GetAllocationReport(25);
+			fwrite(String_GetBytes(allocationReport), 1, String_Length(allocationReport), stderr);
+			fflush(stderr);
+		}
 	}
 
 	// If they requested the result to be outputted, do that now.
@@ -695,6 +803,14 @@ static int SmileMain(int argc, const char **argv)
 		fflush(stdout);
 	}
 
+	// If they requested garbage-collector statistics, report them now, on stderr so they
+	// don't get mixed into the program's own output.
+	if (options->gcStats) {
+		String gcStats = GcStats_ToString(Smile_GetGcStats());
+		fwrite(String_GetBytes(gcStats), 1, String_Length(gcStats), stderr);
+		fflush(stderr);
+	}
+
 	// And we're done.
 	Smile_End();
 
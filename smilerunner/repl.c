@@ -37,7 +37,7 @@
 extern void ListFiles(String commandLine, Bool longMode, Int consoleWidth);
 extern void ShowHelp(String commandLine);
 
-static Int ProcessCommand(String input, ParseScope globalScope, ClosureInfo globalClosureInfo, SmileObject *result);
+static Int ProcessCommand(String input, ParseScope globalScope, Compiler compiler, SmileObject *result);
 
 static ClosureInfo SetupGlobalClosureInfo()
 {
@@ -108,7 +108,7 @@ static Bool PrintParseMessages(Parser parser)
 	return hasErrors;
 }
 
-static Int ParseAndEval(String string, ParseScope globalScope, ClosureInfo globalClosureInfo, SmileObject *result)
+static Int ParseAndEval(String string, ParseScope globalScope, Compiler compiler, SmileObject *result)
 {
 	Lexer lexer;
 	Parser parser;
@@ -137,8 +137,8 @@ static Int ParseAndEval(String string, ParseScope globalScope, ClosureInfo globa
 	// Turn the list of expressions into a [$progn ...].
 	expr = (SmileObject)SmileList_ConsWithSource((SmileObject)Smile_KnownObjects._prognSymbol, (SmileObject)head, NULL);
 
-	// Compile and eval the [$progn] expression.
-	evalResult = Smile_EvalInScope(globalClosureInfo, expr);
+	// Compile and eval the [$progn] expression, appending it to the session's compiled tables.
+	evalResult = Smile_EvalIncrementally(compiler, expr);
 
 	// Expose the current results as variables in the global scope.
 	Smile_SetGlobalVariableC("$a", SMILE_KIND(head) == SMILE_KIND_LIST ? head->a : NullObject);
@@ -309,6 +309,7 @@ void ReplMain()
 {
 	ClosureInfo globalClosureInfo;
 	ParseScope globalScope;
+	Compiler compiler;
 	SmileObject result;
 	String resultText;
 	String input;
@@ -324,6 +325,9 @@ void ReplMain()
 	ParseScope_DeclareHereC(globalScope, "$e", PARSEDECL_GLOBAL, NULL, NULL);
 	ParseScope_DeclareHereC(globalScope, "$_", PARSEDECL_GLOBAL, NULL, NULL);
 
+	// One compiler serves the whole session, so each line only adds to its tables.
+	compiler = Smile_CreateIncrementalCompiler(globalClosureInfo);
+
 #	if ((SMILE_OS & SMILE_OS_FAMILY) == SMILE_OS_WINDOWS_FAMILY)
 		SetConsoleCtrlHandler(NULL, True);
 #	endif
@@ -353,13 +357,13 @@ void ReplMain()
 		add_history(line);
 		free(line);
 
-		commandType = ProcessCommand(input, globalScope, globalClosureInfo, &result);
+		commandType = ProcessCommand(input, globalScope, compiler, &result);
 		if (commandType == ProcessedCommand) continue;
 		if (commandType == ExitCommand) break;
 
 		Stdio_Invoked = False;
 
-		if (!ParseAndEval(input, globalScope, globalClosureInfo, &result))
+		if (!ParseAndEval(input, globalScope, compiler, &result))
 		{
 			if (!Stdio_Invoked) {
 				resultText = SmileObject_Stringify(result);
@@ -377,7 +381,7 @@ void ReplMain()
 #	endif
 }
 
-static Int ProcessCommand(String input, ParseScope globalScope, ClosureInfo globalClosureInfo, SmileObject *result)
+static Int ProcessCommand(String input, ParseScope globalScope, Compiler compiler, SmileObject *result)
 {
 	Byte ch;
 
@@ -456,7 +460,7 @@ static Int ProcessCommand(String input, ParseScope globalScope, ClosureInfo glob
 			if (String_StartsWithC(input, "eval")
 				&& (String_Length(input) == 4 || String_At(input, 4) == ' ')) {
 				String expr = String_SubstringAt(input, 5);
-				if (!ParseAndEval(expr, globalScope, globalClosureInfo, result))
+				if (!ParseAndEval(expr, globalScope, compiler, result))
 				{
 					String resultText = SmileObject_Stringify(*result);
 					printf("%s\n", String_ToC(resultText));
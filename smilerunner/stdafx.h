@@ -29,5 +29,7 @@
 #include <smile/parsing/lexer.h>
 #include <smile/parsing/parser.h>
 #include <smile/eval/eval.h>
+#include <smile/gcstats.h>
+#include <smile/eval/profiler.h>
 
 #endif